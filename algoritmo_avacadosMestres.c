@@ -1,271 +1,139 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <time.h>
 
-/* ===================== ESTRUTURA ===================== */
-/* Estrutura que representa uma sala (nó da árvore binária) */
-typedef struct Sala {
-    char nome[50];
-    char pista[100]; // Nova: cada sala pode ter uma pista associada
-    struct Sala *esquerda;
-    struct Sala *direita;
-} Sala;
-
-/* Estrutura da árvore de pistas (BST) */
-typedef struct PistaNode {
-    char texto[100];
-    struct PistaNode *esquerda;
-    struct PistaNode *direita;
-} PistaNode;
-
-/* ===================== HASH (Pista -> Suspeito) ===================== */
-
-#define HASH_SIZE 31
-
-/* Nó da tabela hash que associa uma pista a um suspeito */
-typedef struct HashNode {
-    char pista[100];
-    char suspeito[50];
-    struct HashNode *next;
-} HashNode;
-
-/* calculaHash()
-   Função simples de hashing: soma dos códigos ASCII mod HASH_SIZE */
-unsigned int calculaHash(const char *s) {
-    unsigned int soma = 0;
-    for (size_t i = 0; i < strlen(s); ++i) soma += (unsigned char)s[i];
-    return soma % HASH_SIZE;
-}
-
-/* inicializarHash()
-   Aloca e inicializa a tabela hash (array de ponteiros). */
-HashNode** inicializarHash(void) {
-    HashNode **tabela = (HashNode**) malloc(sizeof(HashNode*) * HASH_SIZE);
-    if (tabela == NULL) {
-        printf("Erro ao alocar memoria para a tabela hash.\n");
-        exit(1);
-    }
-    for (int i = 0; i < HASH_SIZE; ++i) tabela[i] = NULL;
-    return tabela;
-}
-
-/* inserirNaHash()
-   Insere a associação (pista -> suspeito) na tabela hash.
-   Usa encadeamento separado para tratar colisões. */
-void inserirNaHash(HashNode **tabela, const char *pista, const char *suspeito) {
-    if (pista == NULL || strlen(pista) == 0 || suspeito == NULL) return;
-    unsigned int idx = calculaHash(pista);
-    // inserção no início da lista do bucket
-    HashNode *novo = (HashNode*) malloc(sizeof(HashNode));
-    if (!novo) {
-        printf("Erro ao alocar memoria para HashNode.\n");
-        exit(1);
-    }
-    strcpy(novo->pista, pista);
-    strcpy(novo->suspeito, suspeito);
-    novo->next = tabela[idx];
-    tabela[idx] = novo;
-}
-
-/* encontrarSuspeito()
-   Busca na tabela hash o suspeito associado à pista dada.
-   Retorna ponteiro para o nome do suspeito (string interna) ou NULL se não encontrada. */
-const char* encontrarSuspeito(HashNode **tabela, const char *pista) {
-    if (pista == NULL || strlen(pista) == 0) return NULL;
-    unsigned int idx = calculaHash(pista);
-    HashNode *cur = tabela[idx];
-    while (cur != NULL) {
-        if (strcmp(cur->pista, pista) == 0) return cur->suspeito;
-        cur = cur->next;
-    }
-    return NULL;
-}
-
-/* liberarHash()
-   Libera toda a memória usada pela tabela hash. */
-void liberarHash(HashNode **tabela) {
-    if (tabela == NULL) return;
-    for (int i = 0; i < HASH_SIZE; ++i) {
-        HashNode *cur = tabela[i];
-        while (cur != NULL) {
-            HashNode *tmp = cur;
-            cur = cur->next;
-            free(tmp);
-        }
-    }
-    free(tabela);
-}
+#include "detective.h"
+#include "estatisticas.h"
+#include "interface.h"
+#include "modo_lote.h"
+#include "registro_eventos.h"
+#include "servidor.h"
+#include "simulacao.h"
 
 /* ===================== FUNÇÕES ===================== */
 
-/* criaSala()
-   Cria dinamicamente uma nova sala com o nome especificado. */
-Sala* criarSala(const char *nome, const char *pista) {
-    Sala *novaSala = (Sala*) malloc(sizeof(Sala));
-    if (novaSala == NULL) {
-        printf("Erro ao alocar memoria para a sala.\n");
-        exit(1);
-    }
-    strcpy(novaSala->nome, nome);
-    if (pista != NULL)
-        strcpy(novaSala->pista, pista);
-    else
-        strcpy(novaSala->pista, ""); // sem pista
-    novaSala->esquerda = NULL;
-    novaSala->direita = NULL;
-    return novaSala;
-}
-
-/* inserirPista()
-   Insere uma nova pista na árvore BST em ordem alfabética. */
-PistaNode* inserirPista(PistaNode *raiz, const char *texto) {
-    if (texto == NULL || strlen(texto) == 0) return raiz; // ignora se for vazia
-
-    if (raiz == NULL) {
-        PistaNode *nova = (PistaNode*) malloc(sizeof(PistaNode));
-        if (!nova) {
-            printf("Erro ao alocar memoria para PistaNode.\n");
-            exit(1);
-        }
-        strcpy(nova->texto, texto);
-        nova->esquerda = nova->direita = NULL;
-        return nova;
+/* executarModoLote()
+   Abre o arquivo de partidas ("-" para a entrada padrão), joga todas em
+   lote (em paralelo se numThreads > 1) e informa os totais na saída de erro. */
+int executarModoLote(const DqMansao *mansao, const char *caminho, int numThreads) {
+    FILE *entrada = strcmp(caminho, "-") == 0 ? stdin : fopen(caminho, "r");
+    if (entrada == NULL) {
+        printf("Erro ao abrir o arquivo de partidas %s.\n", caminho);
+        return 1;
     }
 
-    if (strcmp(texto, raiz->texto) < 0)
-        raiz->esquerda = inserirPista(raiz->esquerda, texto);
-    else if (strcmp(texto, raiz->texto) > 0)
-        raiz->direita = inserirPista(raiz->direita, texto);
-
-    return raiz;
-}
-
-/* exibirPistas()
-   Exibe as pistas coletadas em ordem alfabética (in-order traversal). */
-void exibirPistas(PistaNode *raiz) {
-    if (raiz == NULL) return;
-    exibirPistas(raiz->esquerda);
-    printf(" - %s\n", raiz->texto);
-    exibirPistas(raiz->direita);
+    struct timespec inicio, fim;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    ResumoLote resumo = numThreads > 1 ? executarLoteParalelo(entrada, stdout, mansao, numThreads)
+                                       : executarLote(entrada, stdout, mansao);
+    clock_gettime(CLOCK_MONOTONIC, &fim);
+    double segundos = (fim.tv_sec - inicio.tv_sec) + (fim.tv_nsec - inicio.tv_nsec) / 1e9;
+    if (entrada != stdin) fclose(entrada);
+
+    fprintf(stderr, "%lu partidas, %lu movimentos, %lu acusacoes validas em %.3f s (%.0f partidas/s)\n",
+            resumo.sessoes, resumo.movimentos, resumo.acusacoesValidas, segundos,
+            segundos > 0 ? resumo.sessoes / segundos : 0.0);
+    fprintf(stderr, "pool PistaNode: %llu alocacoes em %llu blocos, pico de %u nos por partida\n",
+            (unsigned long long) resumo.nos.alocacoes, (unsigned long long) resumo.nos.blocos, resumo.nos.pico);
+    return 0;
 }
 
-/* liberarBST()
-   Libera toda a árvore de pistas. */
-void liberarBST(PistaNode *raiz) {
-    if (raiz == NULL) return;
-    liberarBST(raiz->esquerda);
-    liberarBST(raiz->direita);
-    free(raiz);
+/* fecharRegistro()
+   Fecha o registro de eventos, se aberto, e informa os totais na saída de
+   erro. Retorna 1 se a gravação falhou. */
+int fecharRegistro(void) {
+    if (!registroEventosAtivo()) return 0;
+    ResumoRegistro r = fecharRegistroEventos();
+    fprintf(stderr, "registro: %llu eventos de %u thread(s), %llu esperas por espaco no anel\n",
+            (unsigned long long) r.eventos, r.aneis, (unsigned long long) r.esperas);
+    if (r.erro) fprintf(stderr, "Erro ao gravar o registro de eventos.\n");
+    return r.erro;
 }
 
-/* contarPistasParaSuspeito()
-   Percorre a BST e conta quantas pistas coletadas apontam para o suspeito indicado
-   usando a tabela hash (pista -> suspeito). */
-int contarPistasParaSuspeito(PistaNode *raiz, HashNode **tabela, const char *suspeito) {
-    if (raiz == NULL) return 0;
-    int contador = 0;
-    // percorre esquerda
-    contador += contarPistasParaSuspeito(raiz->esquerda, tabela, suspeito);
-    // verifica o nó atual
-    const char *s = encontrarSuspeito(tabela, raiz->texto);
-    if (s != NULL && strcmp(s, suspeito) == 0) contador++;
-    // percorre direita
-    contador += contarPistasParaSuspeito(raiz->direita, tabela, suspeito);
-    return contador;
+/* escreverSolucao()
+   Escreve a solução de um suspeito como uma partida do modo lote. */
+static void escreverSolucao(const DqSolucao *sol, void *contexto) {
+    uint32_t *suspeitos = (uint32_t*) contexto;
+    (*suspeitos)++;
+    if (sol->salaFinal == NULL) printf("%s\t-\t-\t-\n", sol->suspeito);
+    else printf("%s\t%u\t%s\t%s;%s\n", sol->suspeito, sol->numMovimentos, sol->salaFinal, sol->movimentos, sol->suspeito);
 }
 
-/* verificarSuspeitoFinal()
-   Solicita ao jogador o nome do suspeito acusado e verifica se há pelo menos
-   duas pistas coletadas que apontam para esse suspeito. */
-void verificarSuspeitoFinal(PistaNode *pistasColetadas, HashNode **tabela) {
-    if (pistasColetadas == NULL) {
-        printf("\nNenhuma pista coletada - não é possível acusar ninguém.\n");
-        return;
-    }
-
-    char acusado[50];
-    printf("\nQuem você acusa? (digite o nome exato do suspeito): ");
-    // lê uma linha segura
-    if (fgets(acusado, sizeof(acusado), stdin) == NULL) {
-        printf("Erro na leitura.\n");
-        return;
-    }
-    // remove '\n' final
-    acusado[strcspn(acusado, "\r\n")] = '\0';
-
-    if (strlen(acusado) == 0) {
-        printf("Nenhum nome fornecido. Acusação cancelada.\n");
-        return;
+/* executarModoResolver()
+   Resolve a mansão (dqResolver()) e escreve, para cada suspeito, a menor
+   sequência de movimentos que reúne pistas suficientes para acusá-lo, no
+   mesmo formato das partidas do modo lote. Os totais vão para a saída de
+   erro. */
+int executarModoResolver(const DqMansao *mansao, int numThreads) {
+    setvbuf(stdout, NULL, _IOFBF, LOTE_TAM_BUFFER_SAIDA);
+    printf("#suspeito\tmovimentos\tsala_final\tpartida\n");
+    struct timespec inicio, fim;
+    clock_gettime(CLOCK_MONOTONIC, &inicio);
+    uint32_t suspeitos = 0;
+    DqContadoresResolver contadores;
+    uint32_t resolvidos = dqResolver(mansao, numThreads, escreverSolucao, &suspeitos, &contadores);
+    if (resolvidos == DQ_RESOLVER_FALHOU) {
+        printf("Erro ao alocar memoria para o resolvedor.\n");
+        return 1;
     }
+    clock_gettime(CLOCK_MONOTONIC, &fim);
+    fflush(stdout);
 
-    int correspondencias = contarPistasParaSuspeito(pistasColetadas, tabela, acusado);
-
-    printf("\nPistas que apontam para %s: %d\n", acusado, correspondencias);
-    if (correspondencias >= 2) {
-        printf("Acusação válida! Há evidências suficientes para prender %s.\n", acusado);
-    } else {
-        printf("Acusação insuficiente. São necessárias pelo menos 2 pistas para uma acusação válida.\n");
-    }
+    double segundos = (fim.tv_sec - inicio.tv_sec) + (fim.tv_nsec - inicio.tv_nsec) / 1e9;
+    fprintf(stderr, "%u de %u suspeitos com solucao; %llu salas em %.3f s, "
+            "%llu tarefas, %llu roubadas\n", resolvidos, suspeitos, (unsigned long long) contadores.salas,
+            segundos, (unsigned long long) contadores.tarefas, (unsigned long long) contadores.roubos);
+    return 0;
 }
 
-/* explorarSalasComPistas()
-   Permite que o jogador navegue pela mansão interativamente.
-   O jogador escolhe 'e' para esquerda, 'd' para direita ou 's' para sair.
-   Cada sala visitada adiciona sua pista (se existir) à BST. */
-void explorarSalasComPistas(Sala *salaAtual, PistaNode **pistas) {
-    char escolha;
-
-    while (1) {
-        printf("\nVocê está em: %s\n", salaAtual->nome);
-
-        // coleta automática da pista da sala
-        if (strlen(salaAtual->pista) > 0) {
-            printf("Você encontrou uma pista: \"%s\"\n", salaAtual->pista);
-            *pistas = inserirPista(*pistas, salaAtual->pista);
-        }
-
-        printf("Escolha um caminho:\n");
-        if (salaAtual->esquerda != NULL) printf(" (e) Ir para %s\n", salaAtual->esquerda->nome);
-        if (salaAtual->direita != NULL) printf(" (d) Ir para %s\n", salaAtual->direita->nome);
-        printf(" (s) Sair do jogo\n");
-        printf(">> ");
-        scanf(" %c", &escolha);
-        // consome newline restante antes de futuras fgets
-        int c;
-        while ((c = getchar()) != '\n' && c != EOF) { /* limpa buffer */ }
+/* escreverResultadoBusca()
+   Escreve uma pista encontrada e o suspeito a que ela aponta. */
+static void escreverResultadoBusca(const char *pista, void *contexto) {
+    const char *suspeito = dqSuspeitoPista((const DqMansao*) contexto, pista);
+    printf("%s\t%s\n", pista, suspeito != NULL ? suspeito : "-");
+}
 
-        if (escolha == 'e' && salaAtual->esquerda != NULL) {
-            salaAtual = salaAtual->esquerda;
-        } 
-        else if (escolha == 'd' && salaAtual->direita != NULL) {
-            salaAtual = salaAtual->direita;
-        } 
-        else if (escolha == 's') {
-            printf("\nVocê decidiu encerrar a exploração.\n");
-            break;
-        } 
-        else {
-            printf("Opção inválida. Tente novamente.\n");
-        }
+/* executarModoBusca()
+   Lista, em ordem alfabética, as pistas do catálogo que contêm o trecho
+   (ou começam com o prefixo, se prefixo), com o suspeito de cada uma.
+   O total e a implementação usada vão para a saída de erro. */
+int executarModoBusca(const DqMansao *mansao, const char *texto, int prefixo) {
+    DqBusca *busca = dqCriarBusca(mansao);
+    if (busca == NULL) {
+        printf("Erro ao alocar memoria para a busca.\n");
+        return 1;
     }
+    setvbuf(stdout, NULL, _IOFBF, LOTE_TAM_BUFFER_SAIDA);
+    printf("#pista\tsuspeito\n");
+    size_t encontradas = prefixo ? dqBuscarPrefixo(busca, NULL, texto, escreverResultadoBusca, (void*) mansao)
+                                 : dqBuscarTrecho(busca, NULL, texto, escreverResultadoBusca, (void*) mansao);
+    fflush(stdout);
+    fprintf(stderr, "%zu de %u pistas (%s)\n", encontradas, dqNumPistas(mansao),
+            prefixo ? "prefixo" : dqImplementacaoBusca(busca));
+    dqLiberarBusca(busca);
+    return 0;
 }
 
-/* liberarArvore()
-   Libera a memória de todas as salas da árvore. */
-void liberarArvore(Sala *raiz) {
-    if (raiz == NULL) return;
-    liberarArvore(raiz->esquerda);
-    liberarArvore(raiz->direita);
-    free(raiz);
+/* executarModoServidor()
+   Atende partidas por um socket Unix (servidor.h) até SIGINT ou SIGTERM
+   e informa os totais na saída de erro. */
+int executarModoServidor(const DqMansao *mansao, const char *caminho) {
+    ResumoServidor resumo;
+    if (executarServidor(mansao, caminho, &resumo) != 0) return 1;
+    fprintf(stderr, "servidor: %llu conexoes (pico de %u simultaneas), %llu partidas, %llu movimentos, "
+            "%llu acusacoes validas\n", (unsigned long long) resumo.conexoes, resumo.picoConexoes,
+            (unsigned long long) resumo.partidas, (unsigned long long) resumo.movimentos,
+            (unsigned long long) resumo.acusacoesValidas);
+    return 0;
 }
 
-
 // Desafio Detective Quest
 // Tema 4 - Árvores e Tabela Hash
 // Este código inicial serve como base para o desenvolvimento das estruturas de navegação, pistas e suspeitos.
 // Use as instruções de cada região para desenvolver o sistema completo com árvore binária, árvore de busca e tabela hash.
 
-int main() {
+int main(int argc, char *argv[]) {
     
     // 🧠 Nível Mestre: Relacionamento de Pistas com Suspeitos via Hash
     //
@@ -280,56 +148,134 @@ int main() {
     // - Em caso de colisão, use lista encadeada para tratar.
     // - Modularize com funções como inicializarHash(), buscarSuspeito(), listarAssociacoes().
 
-    /* Montagem automática da mansão (árvore binária) */
-    Sala *hall = criarSala("Hall de Entrada", "Pegadas misteriosas no tapete");
-    Sala *salaEstar = criarSala("Sala de Estar", "Um copo quebrado no chão");
-    Sala *cozinha = criarSala("Cozinha", "Uma colher suja de veneno");
-    Sala *biblioteca = criarSala("Biblioteca", "Um livro rasgado sobre venenos");
-    Sala *jardim = criarSala("Jardim", "");
-    Sala *porao = criarSala("Porao", "Uma luva ensanguentada");
-    Sala *quarto = criarSala("Quarto Principal", "Perfume forte no travesseiro");
+    // Linha de comando: [mapa] [--lote <arquivo de partidas | ->] [--resolver] [--threads N]
+    //                    [--conjunto arvore|bits] [--protocolo] [--buscar TRECHO | --prefixo P]
+    //                    [--estatisticas json|prometheus[:arquivo]] [--registro eventos.dqe]
+    //                    [--servidor <socket>]
+    const char *caminhoMapa = NULL;
+    const char *caminhoRegistro = NULL;
+    const char *caminhoLote = NULL;
+    const char *caminhoSocket = NULL;
+    const char *conjunto = NULL;
+    int numThreads = 1;
+    int resolver = 0;
+    const char *busca = NULL;
+    int buscaPorPrefixo = 0;
+    FormatoSaida formato = SAIDA_TEXTO;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--lote") == 0 && i + 1 < argc)
+            caminhoLote = argv[++i];
+        else if (strcmp(argv[i], "--resolver") == 0)
+            resolver = 1;
+        else if ((strcmp(argv[i], "--buscar") == 0 || strcmp(argv[i], "--prefixo") == 0) && i + 1 < argc) {
+            buscaPorPrefixo = strcmp(argv[i], "--prefixo") == 0;
+            busca = argv[++i];
+        } else if (strcmp(argv[i], "--protocolo") == 0)
+            formato = SAIDA_PROTOCOLO;
+        else if (strcmp(argv[i], "--estatisticas") == 0 && i + 1 < argc) {
+            if (escreverEstatisticasAoSair(argv[++i]) != 0) {
+                printf("Formato de estatisticas invalido: %s (use json ou prometheus).\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            numThreads = atoi(argv[++i]);
+        else if (strcmp(argv[i], "--conjunto") == 0 && i + 1 < argc)
+            conjunto = argv[++i];
+        else if (strcmp(argv[i], "--registro") == 0 && i + 1 < argc)
+            caminhoRegistro = argv[++i];
+        else if (strcmp(argv[i], "--servidor") == 0 && i + 1 < argc)
+            caminhoSocket = argv[++i];
+        else
+            caminhoMapa = argv[i];
+    }
+
+    /* Montagem da mansão: lida do arquivo informado na linha de comando
+       (texto ou binário .dqm) ou, sem argumentos, a mansão padrão. */
+    DqMansao *mansao;
+    if (caminhoMapa != NULL) {
+        char erro[DQ_TAM_ERRO];
+        mansao = dqAbrirMansao(caminhoMapa, erro, sizeof(erro));
+        if (mansao == NULL) {
+            printf("%s\n", erro);
+            return 1;
+        }
+    } else {
+        mansao = dqMansaoPadrao();
+        if (mansao == NULL) {
+            printf("Erro ao alocar memoria para a mansao.\n");
+            return 1;
+        }
+    }
+    if (conjunto != NULL && dqDefinirConjunto(mansao, conjunto) != 0) {
+        printf("Conjunto de pistas invalido: %s (use arvore ou bits).\n", conjunto);
+        dqFecharMansao(mansao);
+        return 1;
+    }
+
+    // Busca: pistas do catálogo por trecho ou prefixo, sem jogar
+    if (busca != NULL) {
+        int resultado = executarModoBusca(mansao, busca, buscaPorPrefixo);
+        dqFecharMansao(mansao);
+        return resultado;
+    }
 
-    // Estrutura da árvore
-    hall->esquerda = salaEstar;
-    hall->direita = cozinha;
-    salaEstar->esquerda = biblioteca;
-    salaEstar->direita = jardim;
-    cozinha->esquerda = porao;
-    cozinha->direita = quarto;
+    // Resolvedor: as melhores partidas contra cada suspeito, sem jogar
+    if (resolver) {
+        int resultado = executarModoResolver(mansao, numThreads);
+        dqFecharMansao(mansao);
+        return resultado;
+    }
 
-    printf("=== DETECTIVE QUEST ===\n");
-    printf("Bem-vindo à mansão misteriosa!\n");
-    printf("Explore os cômodos, colete pistas e descubra o culpado.\n");
+    // Servidor: muitas partidas ao mesmo tempo, cada uma numa conexão do socket
+    if (caminhoSocket != NULL) {
+        int resultado = executarModoServidor(mansao, caminhoSocket);
+        dqFecharMansao(mansao);
+        return resultado;
+    }
 
-    // Inicializa a tabela hash e preenche as associações pista -> suspeito
-    HashNode **tabela = inicializarHash();
-    // Mapeamento estático (defina conforme sua história)
-    inserirNaHash(tabela, "Pegadas misteriosas no tapete", "Herdeiro");
-    inserirNaHash(tabela, "Um copo quebrado no chão", "Empregada");
-    inserirNaHash(tabela, "Uma colher suja de veneno", "Chefe de Cozinha");
-    inserirNaHash(tabela, "Um livro rasgado sobre venenos", "Chefe de Cozinha");
-    inserirNaHash(tabela, "Uma luva ensanguentada", "Jardineiro");
-    inserirNaHash(tabela, "Perfume forte no travesseiro", "Herdeiro");
+    // Registro de eventos: movimentos e pistas das partidas, gravados por outra thread
+    if (caminhoRegistro != NULL && abrirRegistroEventos(caminhoRegistro, mansao) != 0) {
+        dqFecharMansao(mansao);
+        return 1;
+    }
+
+    // Modo em lote: joga as partidas roteirizadas, sem menus nem perguntas
+    if (caminhoLote != NULL) {
+        int resultado = executarModoLote(mansao, caminhoLote, numThreads);
+        resultado |= fecharRegistro();
+        dqFecharMansao(mansao);
+        return resultado;
+    }
+
+    // Quadros de todas as salas, montados uma vez antes do jogo
+    Renderizador renderizador;
+    prepararRenderizador(&renderizador, mansao, 1, formato);
+    exibirAbertura(&renderizador, "Explore os cômodos, colete pistas e descubra o culpado.");
 
     // Inicia exploração e coleta de pistas
-    PistaNode *pistasColetadas = NULL;
-    explorarSalasComPistas(hall, &pistasColetadas);
+    DqSessao *sessao = dqIniciarSessao(mansao);
+    if (sessao == NULL) {
+        printf("Erro ao alocar memoria para a sessao.\n");
+        exit(1);
+    }
+    explorarSalasComPistas(sessao, &renderizador);
 
     // Exibe pistas coletadas em ordem alfabética
-    printf("\n=== PISTAS COLETADAS ===\n");
-    if (pistasColetadas == NULL)
-        printf("Nenhuma pista coletada.\n");
-    else
-        exibirPistas(pistasColetadas);
+    exibirPistas(sessao, &renderizador);
+
+    // Suspeito mais citado pelas pistas coletadas
+    exibirSuspeitoMaisProvavel(sessao, &renderizador);
+    exibirRanking(mansao, sessao, &renderizador);
 
     // Fase de acusação: pede ao jogador para acusar um suspeito e verifica se há evidências
-    verificarSuspeitoFinal(pistasColetadas, tabela);
+    verificarSuspeitoFinal(sessao, &renderizador);
 
-    // Libera memória
-    liberarArvore(hall);
-    liberarBST(pistasColetadas);
-    liberarHash(tabela);
+    exibirEncerramento(&renderizador);
 
-    printf("\nObrigado por jogar!\n");
-    return 0;
+    // Libera memória
+    int resultado = fecharRegistro();
+    dqEncerrarSessao(sessao);
+    liberarRenderizador(&renderizador);
+    dqFecharMansao(mansao);
+    return resultado;
 }
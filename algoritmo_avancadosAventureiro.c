@@ -2,135 +2,15 @@
 #include <stdlib.h>
 #include <string.h>
 
-/* ===================== ESTRUTURA ===================== */
-/* Estrutura que representa uma sala (nó da árvore binária) */
-typedef struct Sala {
-    char nome[50];
-    char pista[100]; // Nova: cada sala pode ter uma pista associada
-    struct Sala *esquerda;
-    struct Sala *direita;
-} Sala;
-
-/* Estrutura da árvore de pistas (BST) */
-typedef struct PistaNode {
-    char texto[100];
-    struct PistaNode *esquerda;
-    struct PistaNode *direita;
-} PistaNode;
-
-/* ===================== FUNÇÕES ===================== */
-
-/* criaSala()
-   Cria dinamicamente uma nova sala com o nome especificado. */
-Sala* criarSala(const char *nome, const char *pista) {
-    Sala *novaSala = (Sala*) malloc(sizeof(Sala));
-    if (novaSala == NULL) {
-        printf("Erro ao alocar memoria para a sala.\n");
-        exit(1);
-    }
-    strcpy(novaSala->nome, nome);
-    if (pista != NULL)
-        strcpy(novaSala->pista, pista);
-    else
-        strcpy(novaSala->pista, ""); // sem pista
-    novaSala->esquerda = NULL;
-    novaSala->direita = NULL;
-    return novaSala;
-}
-
-/* inserirPista()
-   Insere uma nova pista na árvore BST em ordem alfabética. */
-PistaNode* inserirPista(PistaNode *raiz, const char *texto) {
-    if (texto == NULL || strlen(texto) == 0) return raiz; // ignora se for vazia
-
-    if (raiz == NULL) {
-        PistaNode *nova = (PistaNode*) malloc(sizeof(PistaNode));
-        strcpy(nova->texto, texto);
-        nova->esquerda = nova->direita = NULL;
-        return nova;
-    }
-
-    if (strcmp(texto, raiz->texto) < 0)
-        raiz->esquerda = inserirPista(raiz->esquerda, texto);
-    else if (strcmp(texto, raiz->texto) > 0)
-        raiz->direita = inserirPista(raiz->direita, texto);
-
-    return raiz;
-}
-
-/* exibirPistas()
-   Exibe as pistas coletadas em ordem alfabética (in-order traversal). */
-void exibirPistas(PistaNode *raiz) {
-    if (raiz == NULL) return;
-    exibirPistas(raiz->esquerda);
-    printf(" - %s\n", raiz->texto);
-    exibirPistas(raiz->direita);
-}
-
-/* liberarBST()
-   Libera toda a árvore de pistas. */
-void liberarBST(PistaNode *raiz) {
-    if (raiz == NULL) return;
-    liberarBST(raiz->esquerda);
-    liberarBST(raiz->direita);
-    free(raiz);
-}
-
-/* explorarSalasComPistas()
-   Permite que o jogador navegue pela mansão interativamente.
-   O jogador escolhe 'e' para esquerda, 'd' para direita ou 's' para sair.
-   Cada sala visitada adiciona sua pista (se existir) à BST. */
-void explorarSalasComPistas(Sala *salaAtual, PistaNode **pistas) {
-    char escolha;
-
-    while (1) {
-        printf("\nVocê está em: %s\n", salaAtual->nome);
-
-        // coleta automática da pista da sala
-        if (strlen(salaAtual->pista) > 0) {
-            printf("Você encontrou uma pista: \"%s\"\n", salaAtual->pista);
-            *pistas = inserirPista(*pistas, salaAtual->pista);
-        }
-
-        printf("Escolha um caminho:\n");
-        if (salaAtual->esquerda != NULL) printf(" (e) Ir para %s\n", salaAtual->esquerda->nome);
-        if (salaAtual->direita != NULL) printf(" (d) Ir para %s\n", salaAtual->direita->nome);
-        printf(" (s) Sair do jogo\n");
-        printf(">> ");
-        scanf(" %c", &escolha);
-
-        if (escolha == 'e' && salaAtual->esquerda != NULL) {
-            salaAtual = salaAtual->esquerda;
-        } 
-        else if (escolha == 'd' && salaAtual->direita != NULL) {
-            salaAtual = salaAtual->direita;
-        } 
-        else if (escolha == 's') {
-            printf("\nVocê decidiu encerrar a exploração.\n");
-            break;
-        } 
-        else {
-            printf("Opção inválida. Tente novamente.\n");
-        }
-    }
-}
-
-/* liberarArvore()
-   Libera a memória de todas as salas da árvore. */
-void liberarArvore(Sala *raiz) {
-    if (raiz == NULL) return;
-    liberarArvore(raiz->esquerda);
-    liberarArvore(raiz->direita);
-    free(raiz);
-}
-
+#include "detective.h"
+#include "interface.h"
 
 // Desafio Detective Quest
 // Tema 4 - Árvores e Tabela Hash
 // Este código inicial serve como base para o desenvolvimento das estruturas de navegação, pistas e suspeitos.
 // Use as instruções de cada região para desenvolver o sistema completo com árvore binária, árvore de busca e tabela hash.
 
-int main() {
+int main(int argc, char *argv[]) {
     
     // 🔍 Nível Aventureiro: Armazenamento de Pistas com Árvore de Busca
     // - Crie uma struct Pista com campo texto (string).
@@ -142,43 +22,56 @@ int main() {
     // - Use funções para modularizar: inserirPista(), listarPistas().
     // - A árvore de pistas deve ser exibida quando o jogador quiser revisar evidências.
 
-    /* Montagem automática da mansão (árvore binária) */
-    Sala *hall = criarSala("Hall de Entrada", "Pegadas misteriosas no tapete");
-    Sala *salaEstar = criarSala("Sala de Estar", "Um copo quebrado no chão");
-    Sala *cozinha = criarSala("Cozinha", "Uma colher suja de veneno");
-    Sala *biblioteca = criarSala("Biblioteca", "Um livro rasgado sobre venenos");
-    Sala *jardim = criarSala("Jardim", "");
-    Sala *porao = criarSala("Porao", "Uma luva ensanguentada");
-    Sala *quarto = criarSala("Quarto Principal", "Perfume forte no travesseiro");
+    /* Montagem da mansão: lida do arquivo informado na linha de comando
+       (texto ou binário .dqm) ou, sem argumentos, a mansão padrão. */
+    // Linha de comando: [mapa] [--protocolo]
+    const char *caminhoMapa = NULL;
+    FormatoSaida formato = SAIDA_TEXTO;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--protocolo") == 0)
+            formato = SAIDA_PROTOCOLO;
+        else
+            caminhoMapa = argv[i];
+    }
 
-    // Estrutura da árvore
-    hall->esquerda = salaEstar;
-    hall->direita = cozinha;
-    salaEstar->esquerda = biblioteca;
-    salaEstar->direita = jardim;
-    cozinha->esquerda = porao;
-    cozinha->direita = quarto;
+    DqMansao *mansao;
+    if (caminhoMapa != NULL) {
+        char erro[DQ_TAM_ERRO];
+        mansao = dqAbrirMansao(caminhoMapa, erro, sizeof(erro));
+        if (mansao == NULL) {
+            printf("%s\n", erro);
+            return 1;
+        }
+    } else {
+        mansao = dqMansaoPadrao();
+        if (mansao == NULL) {
+            printf("Erro ao alocar memoria para a mansao.\n");
+            return 1;
+        }
+    }
 
-    printf("=== DETECTIVE QUEST ===\n");
-    printf("Bem-vindo à mansão misteriosa!\n");
-    printf("Explore os cômodos, colete pistas e descubra o culpado.\n");
+    // Quadros de todas as salas, montados uma vez antes do jogo
+    Renderizador renderizador;
+    prepararRenderizador(&renderizador, mansao, 1, formato);
+    exibirAbertura(&renderizador, "Explore os cômodos, colete pistas e descubra o culpado.");
 
     // Inicia exploração e coleta de pistas
-    PistaNode *pistasColetadas = NULL;
-    explorarSalasComPistas(hall, &pistasColetadas);
+    DqSessao *sessao = dqIniciarSessao(mansao);
+    if (sessao == NULL) {
+        printf("Erro ao alocar memoria para a sessao.\n");
+        exit(1);
+    }
+    explorarSalasComPistas(sessao, &renderizador);
 
     // Exibe pistas coletadas em ordem alfabética
-    printf("\n=== PISTAS COLETADAS ===\n");
-    if (pistasColetadas == NULL)
-        printf("Nenhuma pista coletada.\n");
-    else
-        exibirPistas(pistasColetadas);
+    exibirPistas(sessao, &renderizador);
 
-    // Libera memória
-    liberarArvore(hall);
-    liberarBST(pistasColetadas);
+    exibirEncerramento(&renderizador);
 
-    printf("\nObrigado por jogar!\n");
+    // Libera memória
+    dqEncerrarSessao(sessao);
+    liberarRenderizador(&renderizador);
+    dqFecharMansao(mansao);
     return 0;
 }
 
@@ -2,84 +2,15 @@
 #include <stdlib.h>
 #include <string.h>
 
-/* ===================== ESTRUTURA ===================== */
-/* Estrutura que representa uma sala (nó da árvore binária) */
-typedef struct Sala {
-    char nome[50];
-    struct Sala *esquerda;
-    struct Sala *direita;
-} Sala;
-
-/* ===================== FUNÇÕES ===================== */
-
-/* criaSala()
-   Cria dinamicamente uma nova sala com o nome especificado. */
-Sala* criarSala(const char *nome) {
-    Sala *novaSala = (Sala*) malloc(sizeof(Sala));
-    if (novaSala == NULL) {
-        printf("Erro ao alocar memoria para a sala.\n");
-        exit(1);
-    }
-    strcpy(novaSala->nome, nome);
-    novaSala->esquerda = NULL;
-    novaSala->direita = NULL;
-    return novaSala;
-}
-
-/* explorarSalas()
-   Permite que o jogador navegue pela mansão interativamente.
-   O jogador escolhe 'e' para esquerda, 'd' para direita ou 's' para sair. */
-void explorarSalas(Sala *salaAtual) {
-    char escolha;
-
-    while (1) {
-        printf("\nVocê está em: %s\n", salaAtual->nome);
-
-        // Caso o cômodo não tenha saídas, fim da exploração
-        if (salaAtual->esquerda == NULL && salaAtual->direita == NULL) {
-            printf("Não há mais caminhos a seguir. Fim da exploração.\n");
-            break;
-        }
-
-        printf("Escolha um caminho:\n");
-        if (salaAtual->esquerda != NULL) printf(" (e) Ir para %s\n", salaAtual->esquerda->nome);
-        if (salaAtual->direita != NULL) printf(" (d) Ir para %s\n", salaAtual->direita->nome);
-        printf(" (s) Sair do jogo\n");
-        printf(">> ");
-        scanf(" %c", &escolha);
-
-        if (escolha == 'e' && salaAtual->esquerda != NULL) {
-            salaAtual = salaAtual->esquerda;
-        } 
-        else if (escolha == 'd' && salaAtual->direita != NULL) {
-            salaAtual = salaAtual->direita;
-        } 
-        else if (escolha == 's') {
-            printf("Você decidiu encerrar a exploração.\n");
-            break;
-        } 
-        else {
-            printf("Opção inválida. Tente novamente.\n");
-        }
-    }
-}
-
-/* liberarArvore()
-   Libera a memória de todas as salas da árvore. */
-void liberarArvore(Sala *raiz) {
-    if (raiz == NULL) return;
-    liberarArvore(raiz->esquerda);
-    liberarArvore(raiz->direita);
-    free(raiz);
-}
-
+#include "detective.h"
+#include "interface.h"
 
 // Desafio Detective Quest
 // Tema 4 - Árvores e Tabela Hash
 // Este código inicial serve como base para o desenvolvimento das estruturas de navegação, pistas e suspeitos.
 // Use as instruções de cada região para desenvolver o sistema completo com árvore binária, árvore de busca e tabela hash.
 
-int main() {
+int main(int argc, char *argv[]) {
 
     // 🌱 Nível Novato: Mapa da Mansão com Árvore Binária
     //
@@ -92,34 +23,53 @@ int main() {
     // - Use recursão ou laços para caminhar pela árvore.
     // - Nenhuma inserção dinâmica é necessária neste nível.
 
-    /* Montagem automática da mansão (árvore binária) */
-    Sala *hall = criarSala("Hall de Entrada");
-    Sala *salaEstar = criarSala("Sala de Estar");
-    Sala *cozinha = criarSala("Cozinha");
-    Sala *biblioteca = criarSala("Biblioteca");
-    Sala *jardim = criarSala("Jardim");
-    Sala *porao = criarSala("Porao");
-    Sala *quarto = criarSala("Quarto Principal");
+    /* Montagem da mansão: lida do arquivo informado na linha de comando
+       (texto ou binário .dqm) ou, sem argumentos, a mansão padrão. */
+    // Linha de comando: [mapa] [--protocolo]
+    const char *caminhoMapa = NULL;
+    FormatoSaida formato = SAIDA_TEXTO;
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--protocolo") == 0)
+            formato = SAIDA_PROTOCOLO;
+        else
+            caminhoMapa = argv[i];
+    }
 
-    // Estrutura da árvore
-    hall->esquerda = salaEstar;
-    hall->direita = cozinha;
-    salaEstar->esquerda = biblioteca;
-    salaEstar->direita = jardim;
-    cozinha->esquerda = porao;
-    cozinha->direita = quarto;
+    DqMansao *mansao;
+    if (caminhoMapa != NULL) {
+        char erro[DQ_TAM_ERRO];
+        mansao = dqAbrirMansao(caminhoMapa, erro, sizeof(erro));
+        if (mansao == NULL) {
+            printf("%s\n", erro);
+            return 1;
+        }
+    } else {
+        mansao = dqMansaoPadrao();
+        if (mansao == NULL) {
+            printf("Erro ao alocar memoria para a mansao.\n");
+            return 1;
+        }
+    }
 
-    printf("=== DETECTIVE QUEST ===\n");
-    printf("Bem-vindo à mansão misteriosa!\n");
-    printf("Explore os cômodos e descubra o caminho.\n");
+    // Quadros de todas as salas, montados uma vez antes do jogo
+    Renderizador renderizador;
+    prepararRenderizador(&renderizador, mansao, 0, formato);
+    exibirAbertura(&renderizador, "Explore os cômodos e descubra o caminho.");
 
     // Inicia exploração
-    explorarSalas(hall);
+    DqSessao *sessao = dqIniciarSessao(mansao);
+    if (sessao == NULL) {
+        printf("Erro ao alocar memoria para a sessao.\n");
+        exit(1);
+    }
+    explorarSalas(sessao, &renderizador);
 
-    // Libera memória
-    liberarArvore(hall);
+    exibirEncerramento(&renderizador);
 
-    printf("\nObrigado por jogar!\n");
+    // Libera memória
+    dqEncerrarSessao(sessao);
+    liberarRenderizador(&renderizador);
+    dqFecharMansao(mansao);
     return 0;
 }
 
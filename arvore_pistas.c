@@ -0,0 +1,147 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "arvore_pistas.h"
+
+/* atualizarAltura()
+   Recalcula a altura do nó a partir das alturas dos filhos. */
+static void atualizarAltura(PistaNode *no) {
+    int he = alturaPista(no->esquerda);
+    int hd = alturaPista(no->direita);
+    no->altura = (he > hd ? he : hd) + 1;
+}
+
+/* rotacionarDireita() / rotacionarEsquerda()
+   Rotações simples da AVL. Retornam a nova raiz da subárvore. */
+static PistaNode* rotacionarDireita(PistaNode *no) {
+    PistaNode *e = no->esquerda;
+    no->esquerda = e->direita;
+    e->direita = no;
+    atualizarAltura(no);
+    atualizarAltura(e);
+    return e;
+}
+
+static PistaNode* rotacionarEsquerda(PistaNode *no) {
+    PistaNode *d = no->direita;
+    no->direita = d->esquerda;
+    d->esquerda = no;
+    atualizarAltura(no);
+    atualizarAltura(d);
+    return d;
+}
+
+/* balancearPista()
+   Atualiza a altura do nó e aplica a rotação simples ou dupla necessária.
+   Retorna a nova raiz da subárvore. */
+static PistaNode* balancearPista(PistaNode *no) {
+    atualizarAltura(no);
+    int fator = alturaPista(no->esquerda) - alturaPista(no->direita);
+    if (fator > 1) {
+        if (alturaPista(no->esquerda->esquerda) < alturaPista(no->esquerda->direita))
+            no->esquerda = rotacionarEsquerda(no->esquerda);
+        return rotacionarDireita(no);
+    }
+    if (fator < -1) {
+        if (alturaPista(no->direita->direita) < alturaPista(no->direita->esquerda))
+            no->direita = rotacionarDireita(no->direita);
+        return rotacionarEsquerda(no);
+    }
+    return no;
+}
+
+/* novaPista()
+   Cria uma folha com a posição alfabética informada, usando a arena se
+   houver uma ou malloc() caso contrário. */
+static PistaNode* novaPista(ArenaPistas *arena, uint32_t ordem) {
+    PistaNode *nova;
+    if (arena != NULL) {
+        nova = alocarPistaNaArena(arena);
+    } else {
+        nova = (PistaNode*) malloc(sizeof(PistaNode));
+        if (!nova) {
+            printf("Erro ao alocar memoria para PistaNode.\n");
+            exit(1);
+        }
+    }
+    nova->ordem = ordem;
+    nova->altura = 1;
+    nova->esquerda = nova->direita = NULL;
+    return nova;
+}
+
+/* inserirPistaNova()
+   Insere a pista (pela sua posição alfabética) na árvore apontada por raiz,
+   alocando o nó na arena (ou com malloc() se arena for NULL).
+   Retorna 1 se a pista foi inserida ou 0 se já existia.
+   A descida é iterativa e guarda o caminho; na volta os nós são
+   rebalanceados até que a altura de uma subárvore pare de mudar. */
+int inserirPistaNova(PistaNode **raiz, uint32_t ordem, ArenaPistas *arena) {
+    PistaNode **caminho[PISTA_ALTURA_MAXIMA];
+    int profundidade = 0;
+    PistaNode **link = raiz;
+    while (*link != NULL) {
+        uint32_t atual = (*link)->ordem;
+        if (ordem == atual) return 0; // pista já coletada
+        caminho[profundidade++] = link;
+        link = ordem < atual ? &(*link)->esquerda : &(*link)->direita;
+    }
+    *link = novaPista(arena, ordem);
+    EST_CONTAR(EST_PISTAS_INSERIDAS, 1);
+    EST_REGISTRAR(EST_PROFUNDIDADE_PISTA, profundidade);
+
+    while (profundidade > 0) {
+        link = caminho[--profundidade];
+        int alturaAnterior = (*link)->altura;
+        *link = balancearPista(*link);
+        if ((*link)->altura == alturaAnterior) break;
+    }
+    return 1;
+}
+
+/* inserirPista()
+   Insere uma nova pista (id no pool já ordenado) em ordem alfabética e
+   retorna a raiz. */
+PistaNode* inserirPista(PistaNode *raiz, const Internador *pistas, uint32_t idPista) {
+    inserirPistaNova(&raiz, pistas->ordem[idPista], NULL);
+    return raiz;
+}
+
+/* percorrerPistas()
+   Visita as pistas em ordem alfabética (in-order) com pilha explícita,
+   chamando visitar() para cada nó. */
+void percorrerPistas(const PistaNode *raiz,
+                     void (*visitar)(const PistaNode *no, void *contexto),
+                     void *contexto) {
+    const PistaNode *pilha[PISTA_ALTURA_MAXIMA];
+    int topo = 0;
+    const PistaNode *atual = raiz;
+    while (atual != NULL || topo > 0) {
+        while (atual != NULL) {
+            pilha[topo++] = atual;
+            atual = atual->esquerda;
+        }
+        atual = pilha[--topo];
+        visitar(atual, contexto);
+        atual = atual->direita;
+    }
+}
+
+/* liberarBST()
+   Libera toda a árvore de pistas alocada com malloc() sem recursão: enquanto a raiz tiver filho
+   à esquerda ela é rotacionada para a direita; sem filho à esquerda, a raiz
+   é liberada e o percurso segue pela direita. */
+void liberarBST(PistaNode *raiz) {
+    while (raiz != NULL) {
+        if (raiz->esquerda != NULL) {
+            PistaNode *e = raiz->esquerda;
+            raiz->esquerda = e->direita;
+            e->direita = raiz;
+            raiz = e;
+        } else {
+            PistaNode *d = raiz->direita;
+            free(raiz);
+            raiz = d;
+        }
+    }
+}
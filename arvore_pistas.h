@@ -0,0 +1,82 @@
+#ifndef ARVORE_PISTAS_H
+#define ARVORE_PISTAS_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "internador.h"
+#include "pool.h"
+
+/* ===================== ÁRVORE DE PISTAS (AVL) ===================== */
+
+/* Altura máxima de uma AVL com até 2^32 nós é ~46; 64 dá folga para as
+   pilhas fixas usadas na inserção e no percurso iterativos. */
+#define PISTA_ALTURA_MAXIMA 64
+
+/* Estrutura da árvore de pistas (BST balanceada por AVL).
+   O nó não guarda texto: ordem é a posição alfabética da pista no pool de
+   pistas (Internador.ordem), então a árvore fica em ordem alfabética
+   comparando só inteiros, e o id da pista é porOrdem[ordem]. */
+typedef struct PistaNode {
+    uint32_t ordem;
+    int altura;
+    struct PistaNode *esquerda;
+    struct PistaNode *direita;
+} PistaNode;
+
+/* alturaPista()
+   Altura da subárvore (0 para árvore vazia). */
+static inline int alturaPista(const PistaNode *no) {
+    return no != NULL ? no->altura : 0;
+}
+
+/* Número de nós por bloco da arena. */
+#define ARENA_PISTAS_BLOCO 1024
+
+/* Arena de nós de pista: um pool de PistaNode (pool.h), que libera todos os
+   nós de uma vez. Cada sessão tem a sua, ou usa a da thread que a joga,
+   reaproveitada sessão após sessão; assim as threads não disputam o malloc
+   global a cada pista coletada e encerrar uma sessão não percorre a árvore. */
+typedef PoolNos ArenaPistas;
+
+/* inicializarArena() / alocarPistaNaArena() / reiniciarArena() / liberarArena()
+   Operações do pool especializadas para PistaNode. */
+static inline void inicializarArena(ArenaPistas *arena) {
+    inicializarPool(arena, "PistaNode", sizeof(PistaNode), ARENA_PISTAS_BLOCO);
+}
+
+static inline PistaNode* alocarPistaNaArena(ArenaPistas *arena) {
+    return (PistaNode*) alocarDoPool(arena);
+}
+
+static inline void reiniciarArena(ArenaPistas *arena) {
+    reiniciarPool(arena);
+}
+
+static inline void liberarArena(ArenaPistas *arena) {
+    liberarPool(arena);
+}
+
+int inserirPistaNova(PistaNode **raiz, uint32_t ordem, ArenaPistas *arena);
+PistaNode* inserirPista(PistaNode *raiz, const Internador *pistas, uint32_t idPista);
+
+/* contemPista()
+   Retorna 1 se a pista (posição alfabética) está na árvore. */
+static inline int contemPista(const PistaNode *raiz, uint32_t ordem) {
+    while (raiz != NULL && raiz->ordem != ordem) raiz = ordem < raiz->ordem ? raiz->esquerda : raiz->direita;
+    return raiz != NULL;
+}
+
+/* idPistaNo()
+   Id no pool de pistas da pista guardada no nó. */
+static inline uint32_t idPistaNo(const PistaNode *no, const Internador *pistas) {
+    return pistas->porOrdem[no->ordem];
+}
+
+void percorrerPistas(const PistaNode *raiz,
+                     void (*visitar)(const PistaNode *no, void *contexto),
+                     void *contexto);
+void liberarBST(PistaNode *raiz);
+
+#endif
@@ -0,0 +1,207 @@
+#define _POSIX_C_SOURCE 199309L
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "tabela_hash.h"
+
+/* Microbenchmark da tabela hash (pista -> suspeito).
+   Compara a tabela com endereçamento aberto e FNV-1a (tabela_hash.h) com a
+   tabela encadeada original (soma ASCII mod 31), medindo vazão de buscas e
+   comprimento de sondagem, e a mesma tabela depois de congelada com o
+   hash perfeito (internador.h).
+
+   Uso: bench_hash [numero_de_pistas] [numero_de_buscas] */
+
+/* ===================== TABELA ENCADEADA ORIGINAL ===================== */
+
+#define HASH_SIZE_LEGADO 31
+
+typedef struct HashNodeLegado {
+    char pista[100];
+    char suspeito[50];
+    struct HashNodeLegado *next;
+} HashNodeLegado;
+
+unsigned int calculaHashLegado(const char *s) {
+    unsigned int soma = 0;
+    for (size_t i = 0; i < strlen(s); ++i) soma += (unsigned char)s[i];
+    return soma % HASH_SIZE_LEGADO;
+}
+
+HashNodeLegado** inicializarHashLegado(void) {
+    HashNodeLegado **tabela = (HashNodeLegado**) calloc(HASH_SIZE_LEGADO, sizeof(HashNodeLegado*));
+    if (tabela == NULL) {
+        printf("Erro ao alocar memoria para a tabela hash.\n");
+        exit(1);
+    }
+    return tabela;
+}
+
+void inserirNaHashLegado(HashNodeLegado **tabela, const char *pista, const char *suspeito) {
+    unsigned int idx = calculaHashLegado(pista);
+    HashNodeLegado *novo = (HashNodeLegado*) malloc(sizeof(HashNodeLegado));
+    if (!novo) {
+        printf("Erro ao alocar memoria para HashNode.\n");
+        exit(1);
+    }
+    strcpy(novo->pista, pista);
+    strcpy(novo->suspeito, suspeito);
+    novo->next = tabela[idx];
+    tabela[idx] = novo;
+}
+
+/* encontrarSuspeitoLegado()
+   Igual à busca original, mas também acumula quantos nós foram visitados. */
+const char* encontrarSuspeitoLegado(HashNodeLegado **tabela, const char *pista, unsigned long *visitados) {
+    unsigned int idx = calculaHashLegado(pista);
+    HashNodeLegado *cur = tabela[idx];
+    while (cur != NULL) {
+        (*visitados)++;
+        if (strcmp(cur->pista, pista) == 0) return cur->suspeito;
+        cur = cur->next;
+    }
+    return NULL;
+}
+
+void liberarHashLegado(HashNodeLegado **tabela) {
+    for (int i = 0; i < HASH_SIZE_LEGADO; ++i) {
+        HashNodeLegado *cur = tabela[i];
+        while (cur != NULL) {
+            HashNodeLegado *tmp = cur;
+            cur = cur->next;
+            free(tmp);
+        }
+    }
+    free(tabela);
+}
+
+/* ===================== BENCHMARK ===================== */
+
+double agoraSegundos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* gerarPista()
+   Gera pistas no formato do jogo. As pistas ímpares são a pista par anterior
+   escrita de trás para frente: anagramas, o pior caso da soma ASCII. */
+void gerarPista(char *destino, size_t tam, int i) {
+    snprintf(destino, tam, "Pista %07d encontrada no comodo", i - (i % 2));
+    if (i % 2 == 1) {
+        size_t n = strlen(destino);
+        for (size_t a = 0, b = n - 1; a < b; ++a, --b) {
+            char tmp = destino[a];
+            destino[a] = destino[b];
+            destino[b] = tmp;
+        }
+    }
+}
+
+int main(int argc, char *argv[]) {
+    int numPistas = argc > 1 ? atoi(argv[1]) : 20000;
+    int numBuscas = argc > 2 ? atoi(argv[2]) : 200000;
+    if (numPistas <= 0 || numBuscas <= 0) {
+        printf("Uso: %s [numero_de_pistas] [numero_de_buscas]\n", argv[0]);
+        return 1;
+    }
+
+    char (*pistas)[100] = malloc(sizeof(*pistas) * numPistas);
+    if (pistas == NULL) {
+        printf("Erro ao alocar memoria para as pistas.\n");
+        return 1;
+    }
+    for (int i = 0; i < numPistas; ++i) gerarPista(pistas[i], sizeof(pistas[i]), i);
+
+    // Sequência de buscas pseudoaleatória, igual para as duas tabelas
+    int *ordem = malloc(sizeof(int) * numBuscas);
+    if (ordem == NULL) {
+        printf("Erro ao alocar memoria para as buscas.\n");
+        return 1;
+    }
+    unsigned int semente = 12345;
+    for (int i = 0; i < numBuscas; ++i) {
+        semente = semente * 1103515245u + 12345u;
+        ordem[i] = (int)((semente >> 8) % (unsigned int) numPistas);
+    }
+
+    printf("=== BENCHMARK TABELA HASH ===\n");
+    printf("Pistas: %d  Buscas: %d\n\n", numPistas, numBuscas);
+
+    // Tabela encadeada original
+    double t0 = agoraSegundos();
+    HashNodeLegado **legado = inicializarHashLegado();
+    for (int i = 0; i < numPistas; ++i) inserirNaHashLegado(legado, pistas[i], "Suspeito");
+    double tInsercaoLegado = agoraSegundos() - t0;
+
+    unsigned long visitados = 0, encontradosLegado = 0;
+    t0 = agoraSegundos();
+    for (int i = 0; i < numBuscas; ++i)
+        if (encontrarSuspeitoLegado(legado, pistas[ordem[i]], &visitados) != NULL) encontradosLegado++;
+    double tBuscaLegado = agoraSegundos() - t0;
+
+    // Tabela com endereçamento aberto
+    t0 = agoraSegundos();
+    Internador catalogo;
+    inicializarInternador(&catalogo);
+    TabelaHash *tabela = inicializarHash(&catalogo);
+    for (int i = 0; i < numPistas; ++i) inserirNaHash(tabela, pistas[i], "Suspeito");
+    double tInsercao = agoraSegundos() - t0;
+
+    unsigned long encontrados = 0;
+    t0 = agoraSegundos();
+    for (int i = 0; i < numBuscas; ++i)
+        if (encontrarSuspeito(tabela, pistas[ordem[i]]) != NULL) encontrados++;
+    double tBusca = agoraSegundos() - t0;
+
+    double mediaSondagem;
+    uint32_t maxSondagem;
+    estatisticasSondagem(&catalogo, &mediaSondagem, &maxSondagem);
+    uint32_t capIndice = catalogo.capIndice;
+
+    // A mesma tabela congelada com o hash perfeito, que renumera as pistas
+    uint32_t *novaPista = (uint32_t*) malloc(((size_t) catalogo.quantidade + 1) * sizeof(uint32_t));
+    uint32_t *novoSuspeito = (uint32_t*) malloc(((size_t) tabela->suspeitos.quantidade + 1) * sizeof(uint32_t));
+    if (novaPista == NULL || novoSuspeito == NULL) {
+        printf("Erro ao alocar memoria para os ids.\n");
+        exit(1);
+    }
+    for (uint32_t s = 0; s < tabela->suspeitos.quantidade; ++s) novoSuspeito[s] = s;
+    t0 = agoraSegundos();
+    int congelada = congelarInternador(&catalogo, novaPista) == 0;
+    double tCongelar = agoraSegundos() - t0;
+    renumerarTabelaHash(tabela, novaPista, novoSuspeito);
+    free(novaPista);
+    free(novoSuspeito);
+
+    unsigned long encontradosPerfeita = 0;
+    t0 = agoraSegundos();
+    for (int i = 0; i < numBuscas; ++i)
+        if (encontrarSuspeito(tabela, pistas[ordem[i]]) != NULL) encontradosPerfeita++;
+    double tBuscaPerfeita = agoraSegundos() - t0;
+
+    printf("%-22s %14s %14s %14s\n", "Tabela", "insercao (s)", "buscas/s", "sondagem media");
+    printf("%-22s %14.4f %14.0f %14.2f\n", "encadeada (ASCII %31)",
+           tInsercaoLegado, numBuscas / tBuscaLegado, (double) visitados / numBuscas);
+    printf("%-22s %14.4f %14.0f %14.2f\n", "aberta (FNV-1a)",
+           tInsercao, numBuscas / tBusca, mediaSondagem);
+    if (congelada)
+        printf("%-22s %14.4f %14.0f %14.2f\n", "perfeita (CHD)", tCongelar, numBuscas / tBuscaPerfeita, 1.0);
+    printf("\nSondagem maxima (aberta): %u  Capacidade: %u  Carga: %.2f\n",
+           maxSondagem, capIndice, (double) catalogo.quantidade / capIndice);
+    if (congelada)
+        printf("Hash perfeito: %u baldes, %.1f bits por pista\n", catalogo.numBaldes,
+               32.0 * catalogo.numBaldes / catalogo.quantidade);
+    printf("Encontradas: %lu / %lu / %lu\n", encontrados, encontradosLegado, encontradosPerfeita);
+    printf("Aceleracao nas buscas: %.1fx (aberta), %.1fx (perfeita)\n", tBuscaLegado / tBusca,
+           tBuscaLegado / tBuscaPerfeita);
+
+    liberarHashLegado(legado);
+    liberarHash(tabela);
+    liberarInternador(&catalogo);
+    free(ordem);
+    free(pistas);
+    return 0;
+}
@@ -0,0 +1,605 @@
+#define _POSIX_C_SOURCE 200809L
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/resource.h>
+#include <time.h>
+
+#include "arvore_pistas.h"
+#include "busca_pistas.h"
+#include "carregador.h"
+#include "conjunto_pistas.h"
+#include "gerador_mansao.h"
+#include "indice_mansao.h"
+#include "mansao.h"
+#include "retrato_sessao.h"
+#include "sessao.h"
+#include "tabela_hash.h"
+
+/* Benchmark das estruturas do jogo sobre mansões sintéticas
+   (gerador_mansao.h). Para cada forma de mansão mede a construção com
+   criarSala(), a inserção de pistas (árvore com malloc(), árvore na arena e
+   conjunto de bits), encontrarSuspeito(), contarPistasParaSuspeito(), o
+   índice de alcance (indice_mansao.h), os retratos de sessão
+   (retrato_sessao.h), a busca de texto nas pistas (busca_pistas.h) contra
+   o percurso da árvore de pistas, a busca em largura pelo grafo de saídas
+   (mansao.h) e as funções liberar*, informando ns por operação, alocações e o pico de
+   memória residente do processo até aquele ponto.
+
+   Uso: benchmark [--salas N] [--pistas N] [--suspeitos N] [--buscas N]
+                  [--passagens N] [--forma balanceada|degenerada|aleatoria|todas]
+                  [--semente S] [--salvar mapa.txt]
+
+   Com --salvar (e uma única forma) o mapa gerado também é gravado no
+   formato texto, para ser usado pelos jogos ou pelo compilar_mapa. */
+
+/* ===================== CONTAGEM DE ALOCAÇÕES ===================== */
+
+/* malloc/calloc/realloc são substituídos por versões que contam as
+   chamadas e repassam para a glibc. Com AddressSanitizer a contagem fica
+   desligada, porque ele já substitui essas funções. */
+static unsigned long numAlocacoes = 0;
+
+#if !defined(__SANITIZE_ADDRESS__)
+extern void *__libc_malloc(size_t tamanho);
+extern void *__libc_calloc(size_t n, size_t tamanho);
+extern void *__libc_realloc(void *ptr, size_t tamanho);
+
+void *malloc(size_t tamanho) {
+    numAlocacoes++;
+    return __libc_malloc(tamanho);
+}
+
+void *calloc(size_t n, size_t tamanho) {
+    numAlocacoes++;
+    return __libc_calloc(n, tamanho);
+}
+
+void *realloc(void *ptr, size_t tamanho) {
+    numAlocacoes++;
+    return __libc_realloc(ptr, tamanho);
+}
+#endif
+
+/* ===================== MEDIÇÃO ===================== */
+
+/* Estado de uma medição em andamento. */
+typedef struct Medicao {
+    const char *nome;
+    double inicio;
+    unsigned long alocacoesInicio;
+} Medicao;
+
+/* agoraSegundos()
+   Relógio monotônico em segundos. */
+static double agoraSegundos(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+/* picoMemoriaKiB()
+   Maior memória residente do processo até agora, em KiB. */
+static long picoMemoriaKiB(void) {
+    struct rusage uso;
+    getrusage(RUSAGE_SELF, &uso);
+    return uso.ru_maxrss;
+}
+
+static Medicao iniciarMedicao(const char *nome) {
+    Medicao m = { nome, agoraSegundos(), numAlocacoes };
+    return m;
+}
+
+/* imprimirMedicao()
+   Imprime a linha de uma medição: operações, ns/op, alocações e pico de RSS. */
+static void imprimirMedicao(const char *nome, uint64_t operacoes, double segundos, unsigned long alocacoes) {
+    printf("%-36s %12llu %12.1f %12lu %12ld\n", nome, (unsigned long long) operacoes,
+           operacoes ? segundos * 1e9 / operacoes : 0.0, alocacoes, picoMemoriaKiB());
+}
+
+/* terminarMedicao()
+   Encerra a medição iniciada por iniciarMedicao() e imprime a linha. */
+static void terminarMedicao(const Medicao *m, uint64_t operacoes) {
+    imprimirMedicao(m->nome, operacoes, agoraSegundos() - m->inicio, numAlocacoes - m->alocacoesInicio);
+}
+
+/* ===================== CENÁRIOS ===================== */
+
+/* Parâmetros de uma execução do benchmark. */
+typedef struct ConfigBenchmark {
+    ParametrosGerador gerador;
+    uint32_t numBuscas;
+    const char *caminhoSalvar;
+} ConfigBenchmark;
+
+/* ordemInsercao()
+   Ids das pistas do catálogo na ordem em que serão inseridas: alfabética
+   na forma degenerada (pior caso de uma BST sem balanceamento),
+   embaralhada nas demais. */
+static uint32_t* ordemInsercao(const Internador *pistas, FormaMansao forma, uint64_t *estado) {
+    uint32_t n = pistas->quantidade;
+    uint32_t *ids = (uint32_t*) realocarOuSair(NULL, (n ? n : 1) * sizeof(uint32_t), "o benchmark");
+    for (uint32_t i = 0; i < n; ++i) ids[i] = pistas->porOrdem[i];
+    if (forma != FORMA_DEGENERADA) {
+        for (uint32_t i = n; i > 1; --i) {
+            uint32_t j = proximoAleatorio(estado) % i;
+            uint32_t t = ids[i - 1];
+            ids[i - 1] = ids[j];
+            ids[j] = t;
+        }
+    }
+    return ids;
+}
+
+/* medirInsercoes()
+   inserirPista() com malloc() e liberarBST(), inserção na arena e no
+   conjunto de bits, cada uma repetida por 'rodadas' árvores completas. */
+static void medirInsercoes(const MapaCarregado *mapa, const uint32_t *ids, uint32_t rodadas) {
+    const Internador *pistas = &mapa->mansao.pistas;
+    uint32_t n = pistas->quantidade;
+    uint64_t total = (uint64_t) n * rodadas;
+    double tempoInserir = 0, tempoLiberar = 0;
+    unsigned long alocacoesInserir = 0, alocacoesLiberar = 0;
+
+    // inserção e liberação alternam a cada rodada, então são somadas à parte
+    for (uint32_t r = 0; r < rodadas; ++r) {
+        PistaNode *raiz = NULL;
+        Medicao m = iniciarMedicao("inserirPista (malloc)");
+        for (uint32_t i = 0; i < n; ++i) raiz = inserirPista(raiz, pistas, ids[i]);
+        tempoInserir += agoraSegundos() - m.inicio;
+        alocacoesInserir += numAlocacoes - m.alocacoesInicio;
+
+        m = iniciarMedicao("liberarBST");
+        liberarBST(raiz);
+        tempoLiberar += agoraSegundos() - m.inicio;
+        alocacoesLiberar += numAlocacoes - m.alocacoesInicio;
+    }
+    imprimirMedicao("inserirPista (malloc)", total, tempoInserir, alocacoesInserir);
+    imprimirMedicao("liberarBST", total, tempoLiberar, alocacoesLiberar);
+
+    ArenaPistas arena;
+    inicializarArena(&arena);
+    Medicao m = iniciarMedicao("inserirPistaNova (arena)");
+    for (uint32_t r = 0; r < rodadas; ++r) {
+        PistaNode *raiz = NULL;
+        for (uint32_t i = 0; i < n; ++i) inserirPistaNova(&raiz, pistas->ordem[ids[i]], &arena);
+        reiniciarArena(&arena);
+    }
+    terminarMedicao(&m, total);
+    ContadoresPool c = contadoresPool(&arena);
+    printf("  pool %s: %llu alocacoes, %llu blocos, %llu reinicios, pico de %u nos\n", arena.nome,
+           (unsigned long long) c.alocacoes, (unsigned long long) c.blocos,
+           (unsigned long long) c.reinicios, c.pico);
+    liberarArena(&arena);
+
+    if (escolherConjunto(CONJUNTO_BITS, n) == CONJUNTO_BITS) {
+        m = iniciarMedicao("inserirNoConjunto (bits)");
+        for (uint32_t r = 0; r < rodadas; ++r) {
+            ConjuntoPistas c;
+            iniciarConjunto(&c, CONJUNTO_BITS, n, NULL);
+            for (uint32_t i = 0; i < n; ++i) inserirNoConjunto(&c, pistas->ordem[ids[i]]);
+            encerrarConjunto(&c);
+        }
+        terminarMedicao(&m, total);
+    }
+}
+
+/* medirBuscas()
+   encontrarSuspeito() pelo texto de pistas sorteadas. */
+static void medirBuscas(const MapaCarregado *mapa, uint32_t numBuscas, uint64_t *estado) {
+    const Internador *pistas = &mapa->mansao.pistas;
+    if (pistas->quantidade == 0) return;
+    const char **textos = (const char**) realocarOuSair(NULL, (numBuscas ? numBuscas : 1) * sizeof(char*), "o benchmark");
+    for (uint32_t i = 0; i < numBuscas; ++i)
+        textos[i] = textoInternado(pistas, proximoAleatorio(estado) % pistas->quantidade);
+
+    uintptr_t soma = 0;
+    Medicao m = iniciarMedicao("encontrarSuspeito");
+    for (uint32_t i = 0; i < numBuscas; ++i) soma += (uintptr_t) encontrarSuspeito(&mapa->tabela, textos[i]);
+    terminarMedicao(&m, numBuscas);
+    if (soma == 1) printf("(soma de controle improvável)\n");
+    free(textos);
+}
+
+/* medirContagens()
+   contarPistasParaSuspeito() para cada suspeito, com metade do catálogo
+   coletada, na árvore e no conjunto de bits. */
+static void medirContagens(const MapaCarregado *mapa, const uint32_t *ids, uint32_t rodadas) {
+    const TabelaHash *tabela = &mapa->tabela;
+    uint32_t n = tabela->pistas->quantidade;
+    uint32_t suspeitos = numSuspeitos(tabela);
+    if (suspeitos == 0) return;
+
+    for (int t = 0; t < 2; ++t) {
+        TipoConjunto tipo = t == 0 ? CONJUNTO_ARVORE : CONJUNTO_BITS;
+        if (escolherConjunto(tipo, n) != tipo) continue;
+        ArenaPistas arena;
+        inicializarArena(&arena);
+        ConjuntoPistas c;
+        iniciarConjunto(&c, tipo, n, &arena);
+        for (uint32_t i = 0; i < n; i += 2) inserirNoConjunto(&c, tabela->pistas->ordem[ids[i]]);
+
+        long soma = 0;
+        Medicao m = iniciarMedicao(tipo == CONJUNTO_ARVORE ? "contarPistasParaSuspeito (arvore)"
+                                                           : "contarPistasParaSuspeito (bits)");
+        for (uint32_t r = 0; r < rodadas; ++r)
+            for (uint32_t s = 0; s < suspeitos; ++s)
+                soma += contarPistasParaSuspeito(&c, tabela, nomeSuspeito(tabela, s));
+        terminarMedicao(&m, (uint64_t) rodadas * suspeitos);
+        if (soma < 0) printf("(soma de controle improvável)\n");
+        encerrarConjunto(&c);
+        liberarArena(&arena);
+    }
+}
+
+/* contarVisitado()
+   Visitante de percorrerRanking() que só soma os pontos vistos. */
+static void contarVisitado(uint32_t suspeito, uint64_t pontos, void *contexto) {
+    *(uint64_t*) contexto += pontos + suspeito;
+}
+
+/* medirRanking()
+   somarEvidencia() com o catálogo inteiro coletado a cada rodada, e os dez
+   primeiros do ranking consultados numBuscas vezes. */
+static void medirRanking(const MapaCarregado *mapa, const uint32_t *ids, uint32_t rodadas, uint32_t numBuscas) {
+    uint32_t n = mapa->tabela.pistas->quantidade;
+    if (numSuspeitos(&mapa->tabela) == 0) return;
+    Sessao s;
+    iniciarSessao(&s, SALA_ENTRADA, &mapa->tabela, NULL, mapa->conjunto);
+    uint64_t soma = 0;
+    Medicao m = iniciarMedicao("somarEvidencia (ranking)");
+    for (uint32_t r = 0; r < rodadas; ++r) {
+        reiniciarSessao(&s, SALA_ENTRADA);
+        for (uint32_t i = 0; i < n; ++i) soma += somarEvidencia(&s, ids[i]);
+    }
+    terminarMedicao(&m, (uint64_t) rodadas * n);
+    printf("  %u postagens, %s\n", mapa->tabela.numPostagens, mapa->tabela.ponderada ? "ponderadas" : "sem pesos");
+
+    m = iniciarMedicao("percorrerRanking (10 primeiros)");
+    for (uint32_t i = 0; i < numBuscas; ++i) percorrerRanking(&s, 10, contarVisitado, &soma);
+    terminarMedicao(&m, numBuscas);
+    if (soma == 1) printf("(soma de controle improvável)\n");
+    encerrarSessao(&s);
+}
+
+/* medirIndice()
+   Construção do índice de alcance e consultas por sala sorteada: evidências
+   abaixo, distância até a pista mais próxima e melhor caminho para baixo. */
+static void medirIndice(const MapaCarregado *mapa, uint32_t numBuscas, uint64_t *estado) {
+    uint32_t suspeitos = numSuspeitos(&mapa->tabela);
+    IndiceMansao indice;
+    Medicao m = iniciarMedicao("construirIndice");
+    if (construirIndice(&indice, &mapa->mansao, &mapa->tabela) != 0) {
+        printf("  (a mansao nao e uma arvore: sem indice de alcance)\n");
+        return;
+    }
+    terminarMedicao(&m, indice.numAlcancaveis);
+    if (suspeitos == 0 || indice.numAlcancaveis == 0) {
+        liberarIndice(&indice);
+        return;
+    }
+
+    uint32_t *salas = (uint32_t*) realocarOuSair(NULL, (numBuscas ? numBuscas : 1) * sizeof(uint32_t), "o benchmark");
+    for (uint32_t i = 0; i < numBuscas; ++i)
+        salas[i] = indice.salaNaPosicao[proximoAleatorio(estado) % indice.numAlcancaveis];
+
+    uint64_t soma = 0;
+    m = iniciarMedicao("evidenciasAbaixo");
+    for (uint32_t i = 0; i < numBuscas; ++i) soma += evidenciasAbaixo(&indice, salas[i], i % suspeitos);
+    terminarMedicao(&m, numBuscas);
+    m = iniciarMedicao("distanciaPistaSuspeito");
+    for (uint32_t i = 0; i < numBuscas; ++i) soma += distanciaPistaSuspeito(&indice, salas[i], i % suspeitos);
+    terminarMedicao(&m, numBuscas);
+    m = iniciarMedicao("melhorCaminhoSuspeito");
+    for (uint32_t i = 0; i < numBuscas; ++i) soma += melhorCaminhoSuspeito(&indice, salas[i], i % suspeitos);
+    terminarMedicao(&m, numBuscas);
+    if (soma == 1) printf("(soma de controle improvável)\n");
+
+    free(salas);
+    m = iniciarMedicao("liberarIndice");
+    liberarIndice(&indice);
+    terminarMedicao(&m, 1);
+}
+
+/* Sessões retratadas por medirRetratos() e passos de cada partida. */
+#define BENCH_MAX_RETRATOS 100000
+#define BENCH_PASSOS_RETRATO 256
+
+/* medirRetratos()
+   Retratos de sessões com partidas aleatórias: codificação e decodificação
+   na memória e um arquivo com todas, gravado e lido de uma vez. */
+static void medirRetratos(const MapaCarregado *mapa, uint32_t numBuscas, uint64_t *estado) {
+    const Mansao *m = &mapa->mansao;
+    uint32_t n = numBuscas / 10;
+    if (n > BENCH_MAX_RETRATOS) n = BENCH_MAX_RETRATOS;
+    if (n == 0) n = 1;
+    const char *caminho = "benchmark_retratos.dqs";
+
+    Sessao s;
+    iniciarSessao(&s, SALA_ENTRADA, &mapa->tabela, NULL, mapa->conjunto);
+    GravadorRetratos g;
+    iniciarGravadorRetratos(&g, mapa);
+    double tempoCodificar = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        reiniciarSessao(&s, SALA_ENTRADA);
+        coletarPistaDaSala(&s, m);
+        for (uint32_t passo = 0; passo < BENCH_PASSOS_RETRATO; ++passo) {
+            if (moverSessao(&s, m, proximoAleatorio(estado) & 1 ? 'e' : 'd') != MOVIMENTO_OK) break;
+            coletarPistaDaSala(&s, m);
+        }
+        double inicio = agoraSegundos();
+        acrescentarRetrato(&g, &s);
+        tempoCodificar += agoraSegundos() - inicio;
+    }
+    imprimirMedicao("codificarSessao", n, tempoCodificar, 0);
+    printf("  %llu bytes de retratos (%.1f por sessao)\n", (unsigned long long) (g.tam - sizeof(CabecalhoRetratos)),
+           (double) (g.tam - sizeof(CabecalhoRetratos)) / n);
+
+    const uint8_t *dados = g.dados + sizeof(CabecalhoRetratos);
+    size_t pos = 0, usados;
+    int falhas = 0;
+    Medicao med = iniciarMedicao("decodificarSessao");
+    for (uint32_t i = 0; i < n; ++i) {
+        falhas += decodificarSessao(&s, m, dados + pos, g.tam - sizeof(CabecalhoRetratos) - pos, &usados) != 0;
+        pos += usados;
+    }
+    terminarMedicao(&med, n);
+
+    med = iniciarMedicao("gravarRetratos (arquivo)");
+    if (gravarRetratos(&g, caminho) != 0) falhas++;
+    terminarMedicao(&med, n);
+    liberarGravadorRetratos(&g);
+
+    LeitorRetratos l;
+    med = iniciarMedicao("abrirRetratos + lerRetrato");
+    if (abrirRetratos(&l, mapa, caminho) != 0) falhas++;
+    else {
+        while (lerRetrato(&l, &s) == 1) { }
+        if (l.lidas != n) falhas++;
+        fecharRetratos(&l);
+    }
+    terminarMedicao(&med, n);
+    remove(caminho);
+    encerrarSessao(&s);
+    if (falhas) printf("(%d retratos falharam)\n", falhas);
+}
+
+/* Trechos e prefixo procurados por medirBuscaTexto(), tirados das pistas
+   do gerador (o último não aparece em nenhuma). */
+static const char *const trechosBenchmark[] = { "cofre", "Uma luva", "#12", "veneno" };
+#define BENCH_NUM_TRECHOS 4
+#define BENCH_PREFIXO "Uma c"
+
+/* Contexto do percurso da árvore em medirBuscaTexto(). */
+typedef struct PercursoTexto {
+    const Internador *pistas;
+    const char *texto;
+    size_t tam;
+    uint32_t encontradas;
+} PercursoTexto;
+
+/* visitarTrecho() / visitarPrefixo()
+   Conta as pistas do percurso em ordem que contêm o trecho (strstr()) ou
+   começam com o prefixo (strncmp()). */
+static void visitarTrecho(const PistaNode *no, void *contexto) {
+    PercursoTexto *p = (PercursoTexto*) contexto;
+    if (strstr(textoInternado(p->pistas, idPistaNo(no, p->pistas)), p->texto) != NULL) p->encontradas++;
+}
+
+static void visitarPrefixo(const PistaNode *no, void *contexto) {
+    PercursoTexto *p = (PercursoTexto*) contexto;
+    if (strncmp(textoInternado(p->pistas, idPistaNo(no, p->pistas)), p->texto, p->tam) == 0) p->encontradas++;
+}
+
+/* contarOrdem()
+   Conta as pistas entregues por buscarTrecho(). */
+static void contarOrdem(uint32_t ordem, void *contexto) {
+    (void) ordem;
+    (*(uint32_t*) contexto)++;
+}
+
+/* medirBuscaTexto()
+   Busca por trecho e por prefixo em todo o catálogo: percurso em ordem da
+   árvore de pistas comparando nó a nó e o bloco de busca_pistas.h, com cada
+   varredura disponível. Cada operação é uma consulta completa. */
+static void medirBuscaTexto(const MapaCarregado *mapa, uint32_t numBuscas) {
+    const Internador *pistas = &mapa->mansao.pistas;
+    uint32_t n = pistas->quantidade;
+    if (n == 0) return;
+    uint32_t rodadas = numBuscas / n / BENCH_NUM_TRECHOS;
+    if (rodadas == 0) rodadas = 1;
+    uint64_t consultas = (uint64_t) rodadas * BENCH_NUM_TRECHOS;
+
+    PistaNode *raiz = NULL;
+    for (uint32_t i = 0; i < n; ++i) raiz = inserirPista(raiz, pistas, i);
+    BuscaPistas busca;
+    Medicao m = iniciarMedicao("construirBusca");
+    construirBusca(&busca, pistas);
+    terminarMedicao(&m, n);
+
+    uint32_t esperadas[BENCH_NUM_TRECHOS];
+    m = iniciarMedicao("trecho: percurso da arvore");
+    for (uint32_t r = 0; r < rodadas; ++r)
+        for (int t = 0; t < BENCH_NUM_TRECHOS; ++t) {
+            PercursoTexto p = { pistas, trechosBenchmark[t], 0, 0 };
+            percorrerPistas(raiz, visitarTrecho, &p);
+            esperadas[t] = p.encontradas;
+        }
+    terminarMedicao(&m, consultas);
+
+    static const char *const variantes[] = { "escalar", "sse2", "avx2" };
+    int falhas = 0;
+    for (int v = 0; v < 3; ++v) {
+        if (escolherImplementacaoBusca(&busca, variantes[v]) != 0) continue;
+        char nome[64];
+        snprintf(nome, sizeof(nome), "trecho: buscarTrecho (%s)", variantes[v]);
+        m = iniciarMedicao(nome);
+        for (uint32_t r = 0; r < rodadas; ++r)
+            for (int t = 0; t < BENCH_NUM_TRECHOS; ++t) {
+                uint32_t encontradas = 0;
+                buscarTrecho(&busca, trechosBenchmark[t], contarOrdem, &encontradas);
+                falhas += encontradas != esperadas[t];
+            }
+        terminarMedicao(&m, consultas);
+    }
+
+    PercursoTexto prefixo = { pistas, BENCH_PREFIXO, strlen(BENCH_PREFIXO), 0 };
+    m = iniciarMedicao("prefixo: percurso da arvore");
+    for (uint32_t r = 0; r < rodadas; ++r) {
+        prefixo.encontradas = 0;
+        percorrerPistas(raiz, visitarPrefixo, &prefixo);
+    }
+    terminarMedicao(&m, rodadas);
+    uint32_t primeira = 0, fim = 0;
+    m = iniciarMedicao("prefixo: intervaloPrefixo");
+    for (uint32_t r = 0; r < rodadas; ++r) intervaloPrefixo(&busca, BENCH_PREFIXO, &primeira, &fim);
+    terminarMedicao(&m, rodadas);
+    falhas += fim - primeira != prefixo.encontradas;
+
+    if (falhas) printf("(%d buscas de texto divergiram do percurso da arvore)\n", falhas);
+    liberarBusca(&busca);
+    liberarBST(raiz);
+}
+
+/* medirGrafo()
+   Busca em largura pelo grafo de saídas a partir da entrada, em ns por
+   saída percorrida. */
+static void medirGrafo(const MapaCarregado *mapa) {
+    const Mansao *m = &mapa->mansao;
+    uint32_t *ordem = (uint32_t*) realocarOuSair(NULL, (size_t) m->numSalas * sizeof(uint32_t), "o benchmark");
+    Medicao med = iniciarMedicao("percorrerGrafo (por saida)");
+    uint32_t alcancadas = percorrerGrafo(m, SALA_ENTRADA, ordem);
+    terminarMedicao(&med, m->numSaidas ? m->numSaidas : 1);
+    if (alcancadas == 0) printf("(entrada fora do grafo)\n");
+    free(ordem);
+}
+
+/* executarCenario()
+   Gera uma mansão da forma pedida e mede todas as operações sobre ela. */
+static int executarCenario(const ConfigBenchmark *cfg, FormaMansao forma) {
+    ParametrosGerador p = cfg->gerador;
+    p.forma = forma;
+    uint64_t estado = iniciarAleatorio(p.semente);
+    MapaCarregado mapa;
+
+    printf("\n--- mansao %s: %u salas, %u pistas, %u suspeitos, %u passagens ---\n",
+           nomeForma(forma), p.numSalas, p.numPistas, p.numSuspeitos, p.numPassagens);
+    printf("%-36s %12s %12s %12s %12s\n", "operacao", "ops", "ns/op", "alocacoes", "pico RSS KiB");
+
+    inicializarMapa(&mapa);
+    Medicao m = iniciarMedicao("inserirNaHash (catalogo)");
+    gerarCatalogo(&mapa, &p, &estado);
+    terminarMedicao(&m, p.numPistas);
+
+    m = iniciarMedicao("criarSala + conectarSalas");
+    gerarSalas(&mapa, &p, &estado);
+    terminarMedicao(&m, p.numSalas);
+
+    m = iniciarMedicao("finalizarMapa");
+    finalizarMapa(&mapa);
+    terminarMedicao(&m, mapa.mansao.pistas.quantidade);
+
+    if (cfg->caminhoSalvar != NULL && salvarMapaTexto(cfg->caminhoSalvar, &mapa.mansao, &mapa.tabela) != 0) {
+        printf("Erro ao gravar o mapa %s.\n", cfg->caminhoSalvar);
+        liberarMapa(&mapa);
+        return -1;
+    }
+
+    uint32_t n = mapa.mansao.pistas.quantidade;
+    uint32_t rodadas = n ? cfg->numBuscas / n : 0;
+    if (rodadas == 0) rodadas = 1;
+    uint32_t *ids = ordemInsercao(&mapa.mansao.pistas, forma, &estado);
+    medirInsercoes(&mapa, ids, rodadas);
+    medirBuscas(&mapa, cfg->numBuscas, &estado);
+    medirContagens(&mapa, ids, rodadas);
+    medirRanking(&mapa, ids, rodadas, cfg->numBuscas);
+    medirIndice(&mapa, cfg->numBuscas, &estado);
+    medirRetratos(&mapa, cfg->numBuscas, &estado);
+    medirBuscaTexto(&mapa, cfg->numBuscas);
+    medirGrafo(&mapa);
+    free(ids);
+
+    m = iniciarMedicao("liberarArvore (mansao)");
+    liberarArvore(&mapa.mansao);
+    terminarMedicao(&m, p.numSalas);
+
+    m = iniciarMedicao("liberarTabelaHash");
+    liberarTabelaHash(&mapa.tabela);
+    terminarMedicao(&m, p.numPistas);
+    return 0;
+}
+
+/* lerNumero()
+   Converte um argumento numérico; retorna -1 se não for um número válido. */
+static int lerNumero(const char *texto, uint32_t *valor) {
+    char *fim;
+    unsigned long v = strtoul(texto, &fim, 10);
+    if (*texto == '\0' || *fim != '\0' || v > UINT32_MAX) return -1;
+    *valor = (uint32_t) v;
+    return 0;
+}
+
+int main(int argc, char *argv[]) {
+    ConfigBenchmark cfg;
+    cfg.gerador.forma = FORMA_BALANCEADA;
+    cfg.gerador.numSalas = 1000000;
+    cfg.gerador.numPistas = 4096;
+    cfg.gerador.numSuspeitos = 16;
+    cfg.gerador.numPassagens = 0;
+    cfg.gerador.suspeitosPorPista = 1;
+    cfg.gerador.semente = 42;
+    cfg.numBuscas = 1000000;
+    cfg.caminhoSalvar = NULL;
+    int todasAsFormas = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        const char *opcao = argv[i];
+        const char *valor = i + 1 < argc ? argv[i + 1] : NULL;
+        uint32_t semente;
+        int erro = valor == NULL;
+        if (!erro && strcmp(opcao, "--salas") == 0) erro = lerNumero(valor, &cfg.gerador.numSalas);
+        else if (!erro && strcmp(opcao, "--pistas") == 0) erro = lerNumero(valor, &cfg.gerador.numPistas);
+        else if (!erro && strcmp(opcao, "--suspeitos") == 0) erro = lerNumero(valor, &cfg.gerador.numSuspeitos);
+        else if (!erro && strcmp(opcao, "--buscas") == 0) erro = lerNumero(valor, &cfg.numBuscas);
+        else if (!erro && strcmp(opcao, "--passagens") == 0) erro = lerNumero(valor, &cfg.gerador.numPassagens);
+        else if (!erro && strcmp(opcao, "--suspeitos-por-pista") == 0)
+            erro = lerNumero(valor, &cfg.gerador.suspeitosPorPista);
+        else if (!erro && strcmp(opcao, "--semente") == 0) {
+            erro = lerNumero(valor, &semente);
+            cfg.gerador.semente = semente;
+        } else if (!erro && strcmp(opcao, "--salvar") == 0) cfg.caminhoSalvar = valor;
+        else if (!erro && strcmp(opcao, "--forma") == 0) {
+            todasAsFormas = strcmp(valor, "todas") == 0;
+            if (!todasAsFormas) erro = lerForma(valor, &cfg.gerador.forma);
+        } else erro = 1;
+        if (erro) {
+            printf("Uso: %s [--salas N] [--pistas N] [--suspeitos N] [--buscas N] [--passagens N]\n"
+                   "       [--suspeitos-por-pista N] [--forma balanceada|degenerada|aleatoria|todas]\n"
+                   "       [--semente S] [--salvar mapa.txt]\n",
+                   argv[0]);
+            return 1;
+        }
+        i++;
+    }
+    if (cfg.caminhoSalvar != NULL && todasAsFormas) {
+        printf("--salvar exige uma unica --forma.\n");
+        return 1;
+    }
+    if (cfg.gerador.numSalas == 0) {
+        printf("A mansao precisa de pelo menos uma sala.\n");
+        return 1;
+    }
+
+    printf("=== BENCHMARK DETECTIVE QUEST ===\n");
+    printf("Buscas: %u  Semente: %llu  Conjunto padrao: %s\n", cfg.numBuscas,
+           (unsigned long long) cfg.gerador.semente, nomeConjunto(CONJUNTO_PISTAS_PADRAO));
+    if (todasAsFormas) {
+        for (int f = FORMA_BALANCEADA; f <= FORMA_ALEATORIA; ++f)
+            if (executarCenario(&cfg, (FormaMansao) f) != 0) return 1;
+    } else if (executarCenario(&cfg, cfg.gerador.forma) != 0) {
+        return 1;
+    }
+    return 0;
+}
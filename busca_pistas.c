@@ -0,0 +1,186 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "busca_pistas.h"
+
+#if (defined(__x86_64__) || defined(__i386__)) && !defined(BUSCA_PISTAS_ESCALAR)
+#define BUSCA_PISTAS_X86 1
+#include <immintrin.h>
+#endif
+
+/* procurarEscalar()
+   Varredura byte a byte: a referência e o caminho sem SIMD. */
+static const char* procurarEscalar(const char *inicio, const char *fim, const char *trecho, size_t tam) {
+    if ((size_t) (fim - inicio) < tam) return NULL;
+    const char *ultimo = fim - tam;
+    for (const char *p = inicio; p <= ultimo; ++p) {
+        if (*p == trecho[0] && p[tam - 1] == trecho[tam - 1] && memcmp(p + 1, trecho + 1, tam - 1) == 0)
+            return p;
+    }
+    return NULL;
+}
+
+#ifdef BUSCA_PISTAS_X86
+/* procurarSse2() / procurarAvx2()
+   Para cada bloco de 16 (32) posições, compara o primeiro byte do trecho
+   com as posições e o último byte com as posições + tam - 1; só as
+   posições com os dois iguais vão para memcmp(). O final, menor que um
+   vetor, fica com a versão escalar. */
+static const char* procurarSse2(const char *inicio, const char *fim, const char *trecho, size_t tam) {
+    size_t n = (size_t) (fim - inicio);
+    if (n < tam) return NULL;
+    const __m128i primeiro = _mm_set1_epi8(trecho[0]);
+    const __m128i ultimo = _mm_set1_epi8(trecho[tam - 1]);
+    size_t i = 0;
+    for (; i + tam - 1 + 16 <= n; i += 16) {
+        __m128i a = _mm_loadu_si128((const __m128i*) (inicio + i));
+        __m128i b = _mm_loadu_si128((const __m128i*) (inicio + i + tam - 1));
+        unsigned mascara = (unsigned) _mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, primeiro),
+                                                                      _mm_cmpeq_epi8(b, ultimo)));
+        while (mascara != 0) {
+            unsigned bit = (unsigned) __builtin_ctz(mascara);
+            if (tam <= 2 || memcmp(inicio + i + bit + 1, trecho + 1, tam - 2) == 0) return inicio + i + bit;
+            mascara &= mascara - 1;
+        }
+    }
+    return procurarEscalar(inicio + i, fim, trecho, tam);
+}
+
+__attribute__((target("avx2")))
+static const char* procurarAvx2(const char *inicio, const char *fim, const char *trecho, size_t tam) {
+    size_t n = (size_t) (fim - inicio);
+    if (n < tam) return NULL;
+    const __m256i primeiro = _mm256_set1_epi8(trecho[0]);
+    const __m256i ultimo = _mm256_set1_epi8(trecho[tam - 1]);
+    size_t i = 0;
+    for (; i + tam - 1 + 32 <= n; i += 32) {
+        __m256i a = _mm256_loadu_si256((const __m256i*) (inicio + i));
+        __m256i b = _mm256_loadu_si256((const __m256i*) (inicio + i + tam - 1));
+        unsigned mascara = (unsigned) _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, primeiro),
+                                                                            _mm256_cmpeq_epi8(b, ultimo)));
+        while (mascara != 0) {
+            unsigned bit = (unsigned) __builtin_ctz(mascara);
+            if (tam <= 2 || memcmp(inicio + i + bit + 1, trecho + 1, tam - 2) == 0) return inicio + i + bit;
+            mascara &= mascara - 1;
+        }
+    }
+    return procurarSse2(inicio + i, fim, trecho, tam);
+}
+#endif
+
+/* escolherImplementacaoBusca()
+   Troca a varredura por "avx2", "sse2" ou "escalar" (para comparar no
+   benchmark). Retorna -1 se o nome não existir ou a CPU não suportar. */
+int escolherImplementacaoBusca(BuscaPistas *b, const char *nome) {
+    if (strcmp(nome, "escalar") == 0) {
+        b->procurar = procurarEscalar;
+        b->implementacao = "escalar";
+        return 0;
+    }
+#ifdef BUSCA_PISTAS_X86
+    if (strcmp(nome, "sse2") == 0 && __builtin_cpu_supports("sse2")) {
+        b->procurar = procurarSse2;
+        b->implementacao = "sse2";
+        return 0;
+    }
+    if (strcmp(nome, "avx2") == 0 && __builtin_cpu_supports("avx2")) {
+        b->procurar = procurarAvx2;
+        b->implementacao = "avx2";
+        return 0;
+    }
+#endif
+    return -1;
+}
+
+/* construirBusca()
+   Copia os textos do catálogo (já ordenado) para o bloco e escolhe a
+   melhor varredura para a CPU. O catálogo não pode mudar depois. */
+void construirBusca(BuscaPistas *b, const Internador *pistas) {
+    uint32_t n = pistas->numOrdenados;
+    b->pistas = pistas;
+    b->quantidade = n;
+    b->inicio = (uint32_t*) realocarOuSair(NULL, ((size_t) n + 1) * sizeof(uint32_t), "a busca de pistas");
+    size_t total = 0;
+    for (uint32_t i = 0; i < n; ++i) total += strlen(textoInternado(pistas, pistas->porOrdem[i])) + 1;
+    b->bloco = (char*) realocarOuSair(NULL, total ? total : 1, "a busca de pistas");
+    size_t pos = 0;
+    for (uint32_t i = 0; i < n; ++i) {
+        const char *texto = textoInternado(pistas, pistas->porOrdem[i]);
+        size_t tam = strlen(texto) + 1;
+        b->inicio[i] = (uint32_t) pos;
+        memcpy(b->bloco + pos, texto, tam);
+        pos += tam;
+    }
+    b->inicio[n] = (uint32_t) pos;
+    b->tamBloco = pos;
+
+    if (escolherImplementacaoBusca(b, "avx2") != 0 && escolherImplementacaoBusca(b, "sse2") != 0)
+        escolherImplementacaoBusca(b, "escalar");
+}
+
+/* ordemDoDeslocamento()
+   Posição alfabética do texto que contém o byte do bloco. */
+static uint32_t ordemDoDeslocamento(const BuscaPistas *b, uint32_t deslocamento) {
+    uint32_t l = 0, r = b->quantidade;
+    while (r - l > 1) {
+        uint32_t meio = l + (r - l) / 2;
+        if (b->inicio[meio] <= deslocamento) l = meio;
+        else r = meio;
+    }
+    return l;
+}
+
+/* buscarTrecho()
+   Chama visitar() com a posição alfabética de cada pista que contém o
+   trecho, em ordem alfabética, e retorna quantas foram. O trecho vazio
+   casa com todas. */
+uint32_t buscarTrecho(const BuscaPistas *b, const char *trecho,
+                      void (*visitar)(uint32_t ordem, void *contexto), void *contexto) {
+    size_t tam = strlen(trecho);
+    if (tam == 0) {
+        for (uint32_t i = 0; i < b->quantidade; ++i) visitar(i, contexto);
+        return b->quantidade;
+    }
+    uint32_t encontradas = 0;
+    const char *fim = b->bloco + b->tamBloco;
+    const char *p = b->bloco;
+    while ((p = b->procurar(p, fim, trecho, tam)) != NULL) {
+        uint32_t ordem = ordemDoDeslocamento(b, (uint32_t) (p - b->bloco));
+        visitar(ordem, contexto);
+        encontradas++;
+        p = b->bloco + b->inicio[ordem + 1];
+    }
+    return encontradas;
+}
+
+/* intervaloPrefixo()
+   Posições alfabéticas [*primeira, *fim) das pistas que começam com o
+   prefixo. O(tam do prefixo * log n). */
+void intervaloPrefixo(const BuscaPistas *b, const char *prefixo, uint32_t *primeira, uint32_t *fim) {
+    size_t tam = strlen(prefixo);
+    uint32_t l = 0, r = b->quantidade;
+    while (l < r) {
+        uint32_t meio = l + (r - l) / 2;
+        if (strcmp(textoNaBusca(b, meio), prefixo) < 0) l = meio + 1;
+        else r = meio;
+    }
+    *primeira = l;
+    r = b->quantidade;
+    while (l < r) {
+        uint32_t meio = l + (r - l) / 2;
+        if (strncmp(textoNaBusca(b, meio), prefixo, tam) <= 0) l = meio + 1;
+        else r = meio;
+    }
+    *fim = l;
+}
+
+/* liberarBusca()
+   Libera o bloco e os deslocamentos. */
+void liberarBusca(BuscaPistas *b) {
+    free(b->bloco);
+    free(b->inicio);
+    b->bloco = NULL;
+    b->inicio = NULL;
+}
@@ -0,0 +1,61 @@
+#ifndef BUSCA_PISTAS_H
+#define BUSCA_PISTAS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "internador.h"
+
+/* ===================== BUSCA DE TEXTO NAS PISTAS ===================== */
+
+/* Busca por trecho ("tudo que contém veneno") e por prefixo sobre o
+   catálogo de pistas, sem percorrer árvores nem comparar nó a nó.
+
+   Os textos do catálogo são copiados, em ordem alfabética, para um bloco
+   contíguo, cada um seguido de '\0'; inicio[posição] dá onde começa o
+   texto da posição alfabética. Assim:
+
+   - trecho: o bloco inteiro é varrido de uma vez. A versão vetorizada
+     compara 16 (SSE2) ou 32 (AVX2) posições por instrução com o primeiro
+     e o último byte do trecho e só confirma com memcmp() as posições em
+     que os dois batem. Ao achar uma ocorrência a varredura pula para o
+     texto seguinte, então cada pista aparece uma vez, em ordem alfabética.
+     O trecho nunca contém '\0', então não casa entre dois textos.
+   - prefixo: as pistas com o prefixo são um intervalo de posições
+     alfabéticas, achado com duas buscas binárias.
+
+   A comparação é byte a byte, diferenciando maiúsculas e acentos, como a
+   ordem alfabética do catálogo (strcmp()).
+
+   A implementação do trecho é escolhida em construirBusca() pela CPU
+   (AVX2, SSE2 ou escalar). Compilar com -DBUSCA_PISTAS_ESCALAR (opção
+   DQ_BUSCA_SIMD=OFF do CMake) deixa só a versão escalar. */
+
+/* Varredura do bloco: primeira ocorrência do trecho (tam bytes, tam > 0)
+   em [inicio, fim), ou NULL. */
+typedef const char* (*ProcurarTrecho)(const char *inicio, const char *fim, const char *trecho, size_t tam);
+
+typedef struct BuscaPistas {
+    const Internador *pistas;
+    char *bloco;            // textos em ordem alfabética, cada um seguido de '\0'
+    size_t tamBloco;
+    uint32_t *inicio;       // quantidade + 1 deslocamentos no bloco
+    uint32_t quantidade;
+    ProcurarTrecho procurar;
+    const char *implementacao;  // "avx2", "sse2" ou "escalar"
+} BuscaPistas;
+
+void construirBusca(BuscaPistas *b, const Internador *pistas);
+int escolherImplementacaoBusca(BuscaPistas *b, const char *nome);
+uint32_t buscarTrecho(const BuscaPistas *b, const char *trecho,
+                      void (*visitar)(uint32_t ordem, void *contexto), void *contexto);
+void intervaloPrefixo(const BuscaPistas *b, const char *prefixo, uint32_t *primeira, uint32_t *fim);
+void liberarBusca(BuscaPistas *b);
+
+/* textoNaBusca()
+   Texto da pista na posição alfabética, dentro do bloco. */
+static inline const char* textoNaBusca(const BuscaPistas *b, uint32_t ordem) {
+    return b->bloco + b->inicio[ordem];
+}
+
+#endif
@@ -0,0 +1,347 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "internador.h"
+
+/* Gerador de carga para o servidor de partidas (servidor.h). Abre N
+   conexões ao mesmo tempo num único epoll e, em cada uma, joga P partidas
+   seguidas de M movimentos: cada movimento é uma saída sorteada entre as
+   da linha "sala" recebida, e a partida termina com 's' e a acusação do
+   suspeito mais provável. Mede o tempo de cada movimento, do envio da
+   escolha até a chegada da sala seguinte, e informa a vazão e os
+   percentis 50, 99 e 99,9 da latência.
+
+   Uso: carga_servidor <socket> [--conexoes N] [--partidas P] [--movimentos M]
+                                [--semente S]
+
+   Retorna 1 se alguma partida não chegou ao fim. */
+
+#define EVENTOS_CARGA 512
+#define TAM_SUSPEITO 64
+
+typedef enum {
+    CLIENTE_ESPERANDO_SALA,
+    CLIENTE_ESPERANDO_FIM,  // depois do 's': pistas, suspeito, acusar, obrigado
+    CLIENTE_TERMINADO
+} EstadoCliente;
+
+/* Uma conexão do gerador e a partida que ela está jogando. */
+typedef struct Cliente {
+    int fd;
+    EstadoCliente estado;
+    uint32_t partidasRestantes;
+    uint32_t movimentosRestantes;
+    uint64_t enviadoEm;         // ns do envio do último movimento; 0 se nenhum esperando resposta
+    uint64_t aleatorio;
+    char *entrada;              // linha em montagem
+    size_t tamEntrada;
+    size_t capEntrada;
+    char suspeito[TAM_SUSPEITO];
+} Cliente;
+
+typedef struct Carga {
+    struct sockaddr_un endereco;
+    int epoll;
+    uint32_t movimentosPorPartida;
+    uint32_t ativos;            // clientes que ainda têm partidas
+    uint32_t *pendentes;        // clientes esperando vaga na fila do socket para conectar
+    uint32_t numPendentes;
+    uint64_t *latencias;        // ns de cada movimento
+    size_t numLatencias;
+    size_t capLatencias;
+    uint64_t partidas;
+    uint64_t falhas;
+} Carga;
+
+/* agoraNs()
+   Relógio monotônico em nanossegundos. */
+static uint64_t agoraNs(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000ull + (uint64_t) ts.tv_nsec;
+}
+
+/* sortear()
+   xorshift64 do cliente: número em [0, n). */
+static uint32_t sortear(Cliente *cl, uint32_t n) {
+    cl->aleatorio ^= cl->aleatorio << 13;
+    cl->aleatorio ^= cl->aleatorio >> 7;
+    cl->aleatorio ^= cl->aleatorio << 17;
+    return (uint32_t) (cl->aleatorio % n);
+}
+
+/* ===================== CONEXÕES ===================== */
+
+/* conectar()
+   Abre a conexão da próxima partida do cliente. Com a fila do socket
+   cheia, o cliente espera em pendentes e tenta de novo na próxima volta.
+   Retorna 1 se o servidor recusou a conexão. */
+static int conectar(Carga *carga, Cliente *cl, uint32_t id) {
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0) return 1;
+    if (connect(fd, (struct sockaddr*) &carga->endereco, sizeof(carga->endereco)) != 0) {
+        int erro = errno;
+        close(fd);
+        errno = erro;
+        if (erro != EAGAIN) return 1;
+        carga->pendentes[carga->numPendentes++] = id;
+        return 0;
+    }
+    cl->fd = fd;
+    cl->estado = CLIENTE_ESPERANDO_SALA;
+    cl->movimentosRestantes = carga->movimentosPorPartida;
+    cl->enviadoEm = 0;
+    cl->tamEntrada = 0;
+    cl->suspeito[0] = '\0';
+
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.u32 = id;
+    epoll_ctl(carga->epoll, EPOLL_CTL_ADD, fd, &ev);
+    return 0;
+}
+
+/* terminarPartida()
+   Fecha a conexão e, se ainda houver partidas, abre a da próxima. */
+static int terminarPartida(Carga *carga, Cliente *cl, uint32_t id, int completa) {
+    close(cl->fd);
+    cl->fd = -1;
+    if (completa) carga->partidas++;
+    else carga->falhas++;
+    if (--cl->partidasRestantes > 0) return conectar(carga, cl, id);
+    cl->estado = CLIENTE_TERMINADO;
+    carga->ativos--;
+    return 0;
+}
+
+/* enviarLinha()
+   Envia uma linha curta; com o cliente esperando cada resposta, o buffer
+   do socket nunca está cheio. */
+static int enviarLinha(Cliente *cl, const char *linha, size_t tam) {
+    return send(cl->fd, linha, tam, MSG_NOSIGNAL) == (ssize_t) tam ? 0 : 1;
+}
+
+/* ===================== PARTIDAS ===================== */
+
+/* escolherSaida()
+   Sorteia uma saída da linha "sala" (esquerda, direita ou passagem);
+   sem saídas, 'e', que o servidor responde como inválida. */
+static char escolherSaida(Cliente *cl, char *linha) {
+    char opcoes[2 + 9];
+    uint32_t n = 0;
+    uint32_t coluna = 0;
+    // campos separados um a um: uma pista vazia é um campo vazio, não some
+    for (char *campo = linha; campo != NULL; ++coluna) {
+        char *fim = strchr(campo, '\t');
+        if (fim != NULL) *fim = '\0';
+        if (coluna == 3 && strcmp(campo, "-") != 0) opcoes[n++] = 'e';
+        else if (coluna == 4 && strcmp(campo, "-") != 0) opcoes[n++] = 'd';
+        else if (coluna >= 5 && coluna < 5 + 9) opcoes[n++] = (char) ('1' + coluna - 5);
+        campo = fim != NULL ? fim + 1 : NULL;   // colunas 0 a 2: "sala", nome e pista
+    }
+    return n > 0 ? opcoes[sortear(cl, n)] : 'e';
+}
+
+/* registrarLatencia()
+   Guarda o tempo de um movimento. */
+static void registrarLatencia(Carga *carga, uint64_t ns) {
+    if (carga->numLatencias == carga->capLatencias) {
+        carga->capLatencias = carga->capLatencias ? carga->capLatencias * 2 : 1 << 16;
+        carga->latencias = (uint64_t*) realocarOuSair(carga->latencias, carga->capLatencias * sizeof(uint64_t),
+                                                      "as latencias");
+    }
+    carga->latencias[carga->numLatencias++] = ns;
+}
+
+/* tratarLinha()
+   Uma linha do servidor. Retorna 1 se a conexão deve ser encerrada como
+   falha, 2 se a partida terminou e 0 para continuar. */
+static int tratarLinha(Carga *carga, Cliente *cl, char *linha) {
+    if (cl->estado == CLIENTE_ESPERANDO_SALA) {
+        if (strncmp(linha, "sala\t", 5) != 0) return 0;   // "protocolo", "invalido"
+        if (cl->enviadoEm != 0) registrarLatencia(carga, agoraNs() - cl->enviadoEm);
+        if (cl->movimentosRestantes == 0) {
+            cl->enviadoEm = 0;
+            cl->estado = CLIENTE_ESPERANDO_FIM;
+            return enviarLinha(cl, "s\n", 2);
+        }
+        char escolha[2] = { escolherSaida(cl, linha), '\n' };
+        cl->movimentosRestantes--;
+        cl->enviadoEm = agoraNs();
+        return enviarLinha(cl, escolha, 2);
+    }
+
+    if (strncmp(linha, "suspeito\t", 9) == 0) {
+        size_t n = strcspn(linha + 9, "\t");
+        if (n >= TAM_SUSPEITO) n = TAM_SUSPEITO - 1;
+        memcpy(cl->suspeito, linha + 9, n);
+        cl->suspeito[n] = '\0';
+    } else if (strcmp(linha, "acusar") == 0) {
+        char acusacao[TAM_SUSPEITO + 1];
+        size_t n = strlen(cl->suspeito);
+        memcpy(acusacao, cl->suspeito, n);
+        acusacao[n] = '\n';
+        return enviarLinha(cl, acusacao, n + 1);
+    } else if (strcmp(linha, "obrigado") == 0) {
+        return 2;
+    }
+    return 0;
+}
+
+/* lerCliente()
+   Lê o que chegou na conexão e trata as linhas completas. */
+static int lerCliente(Carga *carga, Cliente *cl, uint32_t id) {
+    while (1) {
+        if (cl->capEntrada - cl->tamEntrada < 1024) {
+            cl->capEntrada = cl->capEntrada ? cl->capEntrada * 2 : 4096;
+            cl->entrada = (char*) realocarOuSair(cl->entrada, cl->capEntrada, "a entrada do cliente");
+        }
+        ssize_t n = recv(cl->fd, cl->entrada + cl->tamEntrada, cl->capEntrada - cl->tamEntrada, 0);
+        if (n == 0) return terminarPartida(carga, cl, id, 0);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) return 0;
+            return terminarPartida(carga, cl, id, 0);
+        }
+        cl->tamEntrada += (size_t) n;
+
+        size_t inicio = 0;
+        char *fimLinha;
+        while ((fimLinha = memchr(cl->entrada + inicio, '\n', cl->tamEntrada - inicio)) != NULL) {
+            *fimLinha = '\0';
+            int r = tratarLinha(carga, cl, cl->entrada + inicio);
+            if (r != 0) return terminarPartida(carga, cl, id, r == 2);
+            inicio = (size_t) (fimLinha - cl->entrada) + 1;
+        }
+        memmove(cl->entrada, cl->entrada + inicio, cl->tamEntrada - inicio);
+        cl->tamEntrada -= inicio;
+    }
+}
+
+/* ===================== RELATÓRIO ===================== */
+
+static int compararLatencias(const void *a, const void *b) {
+    uint64_t x = *(const uint64_t*) a, y = *(const uint64_t*) b;
+    return (x > y) - (x < y);
+}
+
+/* percentil()
+   Latência (em µs) do percentil q de um vetor ordenado. */
+static double percentil(const uint64_t *v, size_t n, double q) {
+    if (n == 0) return 0.0;
+    return v[(size_t) (q * (double) (n - 1))] / 1e3;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        printf("Uso: %s <socket> [--conexoes N] [--partidas P] [--movimentos M] [--semente S]\n", argv[0]);
+        return 1;
+    }
+    uint32_t numConexoes = 1000, partidas = 4, movimentos = 50;
+    uint64_t semente = 42;
+    for (int i = 2; i < argc; ++i) {
+        if (strcmp(argv[i], "--conexoes") == 0 && i + 1 < argc)
+            numConexoes = (uint32_t) strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--partidas") == 0 && i + 1 < argc)
+            partidas = (uint32_t) strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--movimentos") == 0 && i + 1 < argc)
+            movimentos = (uint32_t) strtoul(argv[++i], NULL, 10);
+        else if (strcmp(argv[i], "--semente") == 0 && i + 1 < argc)
+            semente = strtoull(argv[++i], NULL, 10);
+        else {
+            printf("Opcao desconhecida: %s\n", argv[i]);
+            return 1;
+        }
+    }
+    if (numConexoes == 0 || partidas == 0) {
+        printf("--conexoes e --partidas devem ser maiores que zero.\n");
+        return 1;
+    }
+
+    Carga carga;
+    memset(&carga, 0, sizeof(carga));
+    carga.endereco.sun_family = AF_UNIX;
+    if (strlen(argv[1]) >= sizeof(carga.endereco.sun_path)) {
+        printf("Caminho do socket longo demais: %s\n", argv[1]);
+        return 1;
+    }
+    strcpy(carga.endereco.sun_path, argv[1]);
+    carga.movimentosPorPartida = movimentos;
+    carga.ativos = numConexoes;
+    carga.epoll = epoll_create1(EPOLL_CLOEXEC);
+
+    // cada conexão é um descritor
+    struct rlimit lim;
+    if (getrlimit(RLIMIT_NOFILE, &lim) == 0 && lim.rlim_cur < lim.rlim_max) {
+        lim.rlim_cur = lim.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &lim);
+    }
+
+    Cliente *clientes = (Cliente*) calloc(numConexoes, sizeof(Cliente));
+    carga.pendentes = (uint32_t*) calloc(numConexoes, sizeof(uint32_t));
+    uint32_t *tentativas = (uint32_t*) calloc(numConexoes, sizeof(uint32_t));
+    if (clientes == NULL || carga.pendentes == NULL || tentativas == NULL) {
+        printf("Erro ao alocar memoria para os clientes.\n");
+        exit(1);
+    }
+
+    uint64_t inicio = agoraNs();
+    int erro = 0;
+    for (uint32_t i = 0; i < numConexoes && !erro; ++i) {
+        clientes[i].fd = -1;
+        clientes[i].partidasRestantes = partidas;
+        clientes[i].aleatorio = (semente + i) * 0x9E3779B97F4A7C15ull | 1;
+        erro = conectar(&carga, &clientes[i], i);
+    }
+
+    struct epoll_event eventos[EVENTOS_CARGA];
+    while (carga.ativos > 0 && !erro) {
+        int n = epoll_wait(carga.epoll, eventos, EVENTOS_CARGA, carga.numPendentes > 0 ? 1 : -1);
+        if (n < 0 && errno != EINTR) break;
+        for (int i = 0; i < n && !erro; ++i) {
+            uint32_t id = eventos[i].data.u32;
+            erro = lerCliente(&carga, &clientes[id], id);
+        }
+
+        // quem achou a fila do socket cheia tenta de novo
+        uint32_t numTentativas = carga.numPendentes;
+        memcpy(tentativas, carga.pendentes, numTentativas * sizeof(uint32_t));
+        carga.numPendentes = 0;
+        for (uint32_t i = 0; i < numTentativas && !erro; ++i)
+            erro = conectar(&carga, &clientes[tentativas[i]], tentativas[i]);
+    }
+    double segundos = (agoraNs() - inicio) / 1e9;
+    if (erro) printf("Erro ao conectar em %s: %s\n", argv[1], strerror(errno));
+
+    qsort(carga.latencias, carga.numLatencias, sizeof(uint64_t), compararLatencias);
+    size_t n = carga.numLatencias;
+    printf("=== CARGA NO SERVIDOR ===\n");
+    printf("Conexoes simultaneas: %u\n", numConexoes);
+    printf("Partidas: %llu completas, %llu interrompidas\n", (unsigned long long) carga.partidas,
+           (unsigned long long) carga.falhas);
+    printf("Movimentos: %zu em %.3f s (%.0f movimentos/s)\n", n, segundos, segundos > 0 ? n / segundos : 0.0);
+    printf("Latencia por movimento (us): p50 %.1f  p99 %.1f  p99.9 %.1f  max %.1f\n",
+           percentil(carga.latencias, n, 0.50), percentil(carga.latencias, n, 0.99),
+           percentil(carga.latencias, n, 0.999), percentil(carga.latencias, n, 1.0));
+
+    for (uint32_t i = 0; i < numConexoes; ++i) {
+        if (clientes[i].fd >= 0) close(clientes[i].fd);
+        free(clientes[i].entrada);
+    }
+    free(clientes);
+    free(tentativas);
+    free(carga.pendentes);
+    free(carga.latencias);
+    close(carga.epoll);
+    return erro || carga.falhas > 0 || carga.partidas < (uint64_t) numConexoes * partidas;
+}
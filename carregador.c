@@ -0,0 +1,588 @@
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "carregador.h"
+
+/* inicializarMapa()
+   Prepara um mapa vazio, montado em memória. */
+void inicializarMapa(MapaCarregado *mapa) {
+    inicializarMansao(&mapa->mansao);
+    inicializarTabelaHash(&mapa->tabela, &mapa->mansao.pistas);
+    mapa->conjunto = CONJUNTO_PISTAS_PADRAO;
+    mapa->mapeamento = NULL;
+    mapa->tamMapeamento = 0;
+    mapa->erro[0] = '\0';
+}
+
+/* liberarMapa()
+   Desfaz o mapeamento do arquivo binário ou libera a mansão e a tabela
+   montadas em memória. Tabelas estáticas do programa não têm o que liberar. */
+void liberarMapa(MapaCarregado *mapa) {
+    if (mapa->mapeamento != NULL) {
+        if (mapa->tamMapeamento > 0) munmap(mapa->mapeamento, mapa->tamMapeamento);
+        mapa->mapeamento = NULL;
+        return;
+    }
+    liberarArvore(&mapa->mansao);
+    liberarTabelaHash(&mapa->tabela);
+}
+
+/* finalizarMapa()
+   Congela com o hash perfeito (internador.h) os pools buscados por texto,
+   pistas e suspeitos, o que os renumera, e passa os ids novos para as
+   salas e a tabela. Depois calcula a ordem alfabética das pistas, usada
+   pelo conjunto de pistas coletadas, as máscaras de pistas dos suspeitos,
+   as listas (suspeito, peso) das pistas e o grafo de saídas das salas.
+   Deve ser chamada depois de montar o mapa em memória. */
+void finalizarMapa(MapaCarregado *mapa) {
+    Internador *pistas = &mapa->mansao.pistas;
+    Internador *suspeitos = &mapa->tabela.suspeitos;
+    uint32_t *novaPista = (uint32_t*) realocarOuSair(NULL, ((size_t) pistas->quantidade + 1) * sizeof(uint32_t),
+                                                     "o mapa");
+    uint32_t *novoSuspeito = (uint32_t*) realocarOuSair(NULL, ((size_t) suspeitos->quantidade + 1) * sizeof(uint32_t),
+                                                        "o mapa");
+    congelarInternador(pistas, novaPista);
+    congelarInternador(suspeitos, novoSuspeito);
+    renumerarPistasDasSalas(&mapa->mansao, novaPista);
+    renumerarTabelaHash(&mapa->tabela, novaPista, novoSuspeito);
+    free(novaPista);
+    free(novoSuspeito);
+
+    ordenarInternador(pistas);
+    prepararMascaras(&mapa->tabela);
+    montarPostagens(&mapa->tabela);
+    montarGrafo(&mapa->mansao);
+}
+
+/* registrarErro()
+   Guarda a mensagem de erro no mapa; quem chamou decide se e onde exibi-la. */
+static int registrarErro(MapaCarregado *mapa, const char *formato, ...) {
+    va_list args;
+    va_start(args, formato);
+    vsnprintf(mapa->erro, sizeof(mapa->erro), formato, args);
+    va_end(args);
+    return -1;
+}
+
+/* lerIndiceSala()
+   Converte o campo de filho do formato texto ("-" ou vazio = sem sala). */
+static int lerIndiceSala(const char *campo, uint32_t *indice) {
+    if (campo[0] == '\0' || strcmp(campo, "-") == 0) {
+        *indice = SEM_SALA;
+        return 0;
+    }
+    char *fim;
+    unsigned long v = strtoul(campo, &fim, 10);
+    if (*fim != '\0' || v >= SEM_SALA) return -1;
+    *indice = (uint32_t) v;
+    return 0;
+}
+
+/* separarPeso()
+   Separa o peso no fim do campo de suspeito ("nome:peso"), terminando o
+   nome no ':'. Sem um peso numérico depois do último ':', o campo todo é
+   o nome e o peso é 1. Retorna -1 para peso fora de 1 .. HASH_PESO_MAXIMO. */
+static int separarPeso(char *campo, uint32_t *peso) {
+    *peso = 1;
+    char *sep = strrchr(campo, ':');
+    if (sep == NULL || sep[1] == '\0' || strspn(sep + 1, "0123456789") != strlen(sep + 1)) return 0;
+    unsigned long v = strtoul(sep + 1, NULL, 10);
+    if (v == 0 || v > HASH_PESO_MAXIMO) return -1;
+    *sep = '\0';
+    *peso = (uint32_t) v;
+    return 0;
+}
+
+/* carregarMapaTexto()
+   Lê o formato texto. Retorna 0 em caso de sucesso ou -1 com a mensagem em mapa->erro. */
+static int carregarMapaTexto(FILE *arq, const char *caminho, MapaCarregado *mapa) {
+    char linha[MAPA_TAM_LINHA];
+    char *campos[MAPA_MAX_CAMPOS];
+    unsigned long numLinha = 0;
+
+    while (fgets(linha, sizeof(linha), arq) != NULL) {
+        numLinha++;
+        linha[strcspn(linha, "\r\n")] = '\0';
+        if (linha[0] == '\0' || linha[0] == '#') continue;
+        if (strchr(linha, '\t') != NULL) {
+            return registrarErro(mapa, "%s:%lu: tabulacao nos nomes nao e permitida.", caminho, numLinha);
+        }
+
+        int n = 0;
+        char *p = linha;
+        campos[n++] = p;
+        while (n < MAPA_MAX_CAMPOS && (p = strchr(p, '|')) != NULL) {
+            *p++ = '\0';
+            campos[n++] = p;
+        }
+        if (p != NULL && strchr(p, '|') != NULL) {
+            return registrarErro(mapa, "%s:%lu: mais de %d campos na linha.", caminho, numLinha, MAPA_MAX_CAMPOS);
+        }
+
+        if (strcmp(campos[0], "sala") == 0 && n == 5) {
+            uint32_t esq, dir;
+            if (lerIndiceSala(campos[3], &esq) != 0 || lerIndiceSala(campos[4], &dir) != 0) {
+                return registrarErro(mapa, "%s:%lu: indice de sala invalido.", caminho, numLinha);
+            }
+            uint32_t sala = criarSala(&mapa->mansao, campos[1], campos[2]);
+            conectarSalas(&mapa->mansao, sala, esq, dir);
+        } else if (strcmp(campos[0], "passagem") == 0 && n == 3) {
+            uint32_t origem, destino;
+            if (lerIndiceSala(campos[1], &origem) != 0 || lerIndiceSala(campos[2], &destino) != 0 ||
+                origem == SEM_SALA || destino == SEM_SALA) {
+                return registrarErro(mapa, "%s:%lu: indice de sala invalido.", caminho, numLinha);
+            }
+            criarPassagem(&mapa->mansao, origem, destino);
+        } else if (strcmp(campos[0], "pista") == 0 && n >= 3) {
+            uint32_t pesos[MAPA_MAX_CAMPOS];
+            for (int i = 2; i < n; ++i)
+                if (separarPeso(campos[i], &pesos[i]) != 0)
+                    return registrarErro(mapa, "%s:%lu: peso de suspeito invalido.", caminho, numLinha);
+            if (n == 3 && pesos[2] == 1) {
+                inserirNaHash(&mapa->tabela, campos[1], campos[2]);
+            } else {
+                for (int i = 2; i < n; ++i) inserirPesoNaHash(&mapa->tabela, campos[1], campos[i], pesos[i]);
+            }
+        } else {
+            return registrarErro(mapa, "%s:%lu: linha nao reconhecida.", caminho, numLinha);
+        }
+    }
+
+    if (mapa->mansao.numSalas == 0) {
+        return registrarErro(mapa, "%s: o mapa nao possui salas.", caminho);
+    }
+    for (uint32_t i = 0; i < mapa->mansao.numSalas; ++i) {
+        const Sala *s = &mapa->mansao.salas[i];
+        if ((s->esquerda != SEM_SALA && s->esquerda >= mapa->mansao.numSalas) ||
+            (s->direita != SEM_SALA && s->direita >= mapa->mansao.numSalas)) {
+            return registrarErro(mapa, "%s: a sala %u aponta para uma sala inexistente.", caminho, i);
+        }
+    }
+    const Mansao *m = &mapa->mansao;
+    for (uint32_t p = 0; p < m->numCriadas; ++p) {
+        if (m->passagens[2 * p] >= m->numSalas || m->passagens[2 * p + 1] >= m->numSalas) {
+            return registrarErro(mapa, "%s: a passagem %u liga uma sala inexistente.", caminho, p + 1);
+        }
+    }
+    finalizarMapa(mapa);
+    return 0;
+}
+
+/* secaoValida()
+   Confere se a seção cabe no arquivo, está alinhada e tem o tamanho esperado. */
+static int secaoValida(const SecaoMapa *s, size_t tamArquivo, uint64_t tamEsperado) {
+    return s->deslocamento % 8 == 0 && s->tamanho == tamEsperado &&
+           s->deslocamento <= tamArquivo && s->tamanho <= tamArquivo - s->deslocamento;
+}
+
+/* poolValido()
+   Confere as seções de um pool de strings. */
+static int poolValido(const SecaoMapa *s, const CabecalhoPool *p, size_t tamArquivo) {
+    // congelado, o pool não tem índice; senão o índice precisa de posições vazias
+    int indiceValido = p->numBaldes > 0 ? p->capIndice == 0
+                                        : (p->capIndice & (p->capIndice - 1)) == 0 && p->capIndice > p->quantidade;
+    return indiceValido &&
+           (p->numOrdenados == 0 || p->numOrdenados == p->quantidade) &&
+           secaoValida(&s[POOL_TEXTOS], tamArquivo, s[POOL_TEXTOS].tamanho) &&
+           secaoValida(&s[POOL_DESLOCAMENTOS], tamArquivo, (uint64_t) p->quantidade * sizeof(uint32_t)) &&
+           secaoValida(&s[POOL_HASHES], tamArquivo, (uint64_t) p->quantidade * sizeof(uint32_t)) &&
+           secaoValida(&s[POOL_INDICE], tamArquivo, (uint64_t) p->capIndice * sizeof(uint32_t)) &&
+           secaoValida(&s[POOL_ORDEM], tamArquivo, (uint64_t) p->numOrdenados * sizeof(uint32_t)) &&
+           secaoValida(&s[POOL_POR_ORDEM], tamArquivo, (uint64_t) p->numOrdenados * sizeof(uint32_t)) &&
+           (p->numBaldes == 0 || p->quantidade > 0) &&
+           p->numBaldes <= p->quantidade &&
+           secaoValida(&s[POOL_SEMENTES_BALDE], tamArquivo, (uint64_t) p->numBaldes * sizeof(uint32_t));
+}
+
+/* apontarPool()
+   Faz o pool de strings usar os arrays mapeados do arquivo. */
+static void apontarPool(Internador *in, char *base, const SecaoMapa *s, const CabecalhoPool *p) {
+    in->textos = base + s[POOL_TEXTOS].deslocamento;
+    in->tamTextos = in->capTextos = s[POOL_TEXTOS].tamanho;
+    in->deslocamentos = (uint32_t*) (base + s[POOL_DESLOCAMENTOS].deslocamento);
+    in->hashes = (uint32_t*) (base + s[POOL_HASHES].deslocamento);
+    in->quantidade = in->capIds = p->quantidade;
+    in->indice = p->capIndice ? (uint32_t*) (base + s[POOL_INDICE].deslocamento) : NULL;
+    in->capIndice = p->capIndice;
+    in->numOrdenados = p->numOrdenados;
+    in->ordem = p->numOrdenados ? (uint32_t*) (base + s[POOL_ORDEM].deslocamento) : NULL;
+    in->porOrdem = p->numOrdenados ? (uint32_t*) (base + s[POOL_POR_ORDEM].deslocamento) : NULL;
+    in->numBaldes = p->numBaldes;
+    in->sementePerfeita = p->sementePerfeita;
+    in->sementesBalde = p->numBaldes ? (uint32_t*) (base + s[POOL_SEMENTES_BALDE].deslocamento) : NULL;
+}
+
+/* esvaziarMapa()
+   Deixa o mapa sem mansão, tabela nem mapeamento, sem alocar nada: é o
+   estado de um carregamento que falhou, em que liberarMapa() não tem o
+   que fazer. */
+static void esvaziarMapa(MapaCarregado *mapa) {
+    memset(&mapa->mansao, 0, sizeof(mapa->mansao));
+    memset(&mapa->tabela, 0, sizeof(mapa->tabela));
+    mapa->mapeamento = NULL;
+    mapa->tamMapeamento = 0;
+}
+
+/* poolConsistente()
+   Confere os valores de um pool mapeado: cada string começa dentro do
+   buffer de textos, que termina em '\0', o índice tem posições vazias
+   (senão a sondagem não termina) e todo id guardado nele e na ordem
+   alfabética existe. O hash perfeito não guarda ids: qualquer semente
+   leva a uma posição menor que a quantidade. */
+static int poolConsistente(const Internador *in) {
+    if (in->quantidade > 0 && (in->tamTextos == 0 || in->textos[in->tamTextos - 1] != '\0')) return 0;
+    for (uint32_t id = 0; id < in->quantidade; ++id)
+        if (in->deslocamentos[id] >= in->tamTextos) return 0;
+    uint32_t ocupadas = 0;   // com alguma posição vazia, a sondagem sempre termina
+    for (uint32_t pos = 0; pos < in->capIndice; ++pos) {
+        if (in->indice[pos] > in->quantidade) return 0;
+        ocupadas += in->indice[pos] != 0;
+    }
+    if (ocupadas > in->quantidade) return 0;
+    for (uint32_t id = 0; id < in->numOrdenados; ++id)
+        if (in->ordem[id] >= in->numOrdenados || in->porOrdem[in->ordem[id]] != id) return 0;
+    return 1;
+}
+
+/* textosSemSeparadores()
+   1 se nenhuma string do pool tem tabulação ou quebra de linha, que
+   desmontariam as linhas do protocolo (renderizador.h). */
+static int textosSemSeparadores(const Internador *in) {
+    return memchr(in->textos, '\t', in->tamTextos) == NULL && memchr(in->textos, '\n', in->tamTextos) == NULL;
+}
+
+/* mapaConsistente()
+   Confere, numa passada por cada array mapeado, que todo índice guardado
+   no arquivo aponta para dentro do array a que se refere: filhos e saídas
+   das salas, nomes e pistas das salas, suspeitos das pistas e das listas
+   ponderadas e as faixas das saídas (com lugar para os corredores de cada
+   sala) e das listas de suspeitos. secaoValida() só garante os tamanhos;
+   sem isto um .dqm corrompido viraria leitura fora dos limites no jogo,
+   no resolvedor ou no servidor. */
+static int mapaConsistente(const Mansao *m, const TabelaHash *t) {
+    if (!poolConsistente(&m->nomes) || !poolConsistente(&m->pistas) || !poolConsistente(&t->suspeitos)) return 0;
+    for (uint32_t i = 0; i < m->numSalas; ++i) {
+        const Sala *s = &m->salas[i];
+        if (s->nome >= m->nomes.quantidade || (s->pista != SEM_PISTA && s->pista >= m->pistas.quantidade) ||
+            (s->esquerda != SEM_SALA && s->esquerda >= m->numSalas) ||
+            (s->direita != SEM_SALA && s->direita >= m->numSalas) ||
+            m->inicioSaidas[i] > m->inicioSaidas[i + 1] ||
+            m->inicioSaidas[i + 1] - m->inicioSaidas[i] < numCorredores(s))
+            return 0;
+    }
+    for (uint32_t k = 0; k < m->numSaidas; ++k)
+        if (m->saidas[k] >= m->numSalas) return 0;
+    for (uint32_t p = 0; p < t->capacidade; ++p)
+        if (t->suspeitoPorPista[p] != INTERNADOR_AUSENTE && t->suspeitoPorPista[p] >= t->suspeitos.quantidade)
+            return 0;
+    for (uint32_t p = 0; p < m->pistas.quantidade; ++p)
+        if (t->inicioPostagens[p] > t->inicioPostagens[p + 1]) return 0;
+    for (uint32_t k = 0; k < t->numPostagens; ++k)
+        if (t->postagens[k].suspeito >= t->suspeitos.quantidade) return 0;
+    return 1;
+}
+
+/* apontarMapaBinario()
+   Valida a imagem de um .dqm na memória (tamArquivo bytes, alinhada em 8)
+   e aponta a mansão e a tabela para dentro dela, sem copiar nada. Além
+   dos tamanhos das seções, confere os índices guardados nelas
+   (mapaConsistente()), então uma imagem aceita nunca leva a leituras fora
+   dos arrays. A mansão e a tabela são montadas em variáveis locais e só
+   passam para o mapa depois de aceitas: uma imagem recusada deixa o mapa
+   vazio, sem ponteiros para dentro dela, que quem chama pode desmapear.
+   Retorna 0 em caso de sucesso ou -1 com a mensagem em mapa->erro. */
+static int apontarMapaBinario(void *base, size_t tamArquivo, const char *caminho, MapaCarregado *mapa) {
+    esvaziarMapa(mapa);
+    if (tamArquivo < sizeof(CabecalhoMapa) || memcmp(base, MAPA_MAGICA, 8) != 0)
+        return registrarErro(mapa, "%s: arquivo de mapa binario truncado.", caminho);
+    const CabecalhoMapa *c = (const CabecalhoMapa*) base;
+    const SecaoMapa *s = c->secoes;
+    int valido = c->versao == MAPA_VERSAO && c->numSalas > 0 &&
+        c->poolPistas.numOrdenados == c->poolPistas.quantidade &&
+        secaoValida(&s[SECAO_SALAS], tamArquivo, (uint64_t) c->numSalas * sizeof(Sala)) &&
+        poolValido(&s[SECAO_POOL_NOMES], &c->poolNomes, tamArquivo) &&
+        poolValido(&s[SECAO_POOL_PISTAS], &c->poolPistas, tamArquivo) &&
+        secaoValida(&s[SECAO_SUSPEITO_POR_PISTA], tamArquivo, (uint64_t) c->capacidadeHash * sizeof(uint32_t)) &&
+        poolValido(&s[SECAO_POOL_SUSPEITOS], &c->poolSuspeitos, tamArquivo) &&
+        (c->palavrasMascara == 0 || c->palavrasMascara == palavrasConjunto(c->poolPistas.quantidade)) &&
+        secaoValida(&s[SECAO_MASCARAS], tamArquivo,
+                    (uint64_t) c->poolSuspeitos.quantidade * c->palavrasMascara * sizeof(uint64_t)) &&
+        secaoValida(&s[SECAO_INICIO_SAIDAS], tamArquivo, ((uint64_t) c->numSalas + 1) * sizeof(uint32_t)) &&
+        secaoValida(&s[SECAO_SAIDAS], tamArquivo, (uint64_t) c->numSaidas * sizeof(uint32_t)) &&
+        ((const uint32_t*) ((const char*) base + s[SECAO_INICIO_SAIDAS].deslocamento))[c->numSalas] == c->numSaidas &&
+        secaoValida(&s[SECAO_INICIO_POSTAGENS], tamArquivo,
+                    ((uint64_t) c->poolPistas.quantidade + 1) * sizeof(uint32_t)) &&
+        secaoValida(&s[SECAO_POSTAGENS], tamArquivo, (uint64_t) c->numPostagens * sizeof(PostagemSuspeito)) &&
+        ((const uint32_t*) ((const char*) base + s[SECAO_INICIO_POSTAGENS].deslocamento))[c->poolPistas.quantidade] ==
+            c->numPostagens;
+    if (!valido) return registrarErro(mapa, "%s: arquivo de mapa binario corrompido ou de outra versao.", caminho);
+
+    char *b = (char*) base;
+    Mansao mansao;
+    TabelaHash tabela;
+    Mansao *m = &mansao;
+    m->salas = (Sala*) (b + s[SECAO_SALAS].deslocamento);
+    m->numSalas = m->capSalas = c->numSalas;
+    apontarPool(&m->nomes, b, &s[SECAO_POOL_NOMES], &c->poolNomes);
+    apontarPool(&m->pistas, b, &s[SECAO_POOL_PISTAS], &c->poolPistas);
+    m->inicioSaidas = (uint32_t*) (b + s[SECAO_INICIO_SAIDAS].deslocamento);
+    m->saidas = (uint32_t*) (b + s[SECAO_SAIDAS].deslocamento);
+    m->numSaidas = c->numSaidas;
+    m->numPassagens = c->numPassagens;
+    m->passagens = NULL;
+    m->numCriadas = m->capPassagens = 0;
+
+    TabelaHash *t = &tabela;
+    t->pistas = &m->pistas;
+    t->suspeitoPorPista = (uint32_t*) (b + s[SECAO_SUSPEITO_POR_PISTA].deslocamento);
+    t->capacidade = c->capacidadeHash;
+    t->quantidade = c->quantidadeHash;
+    apontarPool(&t->suspeitos, b, &s[SECAO_POOL_SUSPEITOS], &c->poolSuspeitos);
+    t->palavrasMascara = c->palavrasMascara;
+    t->mascaras = c->palavrasMascara ? (uint64_t*) (b + s[SECAO_MASCARAS].deslocamento) : NULL;
+    t->inicioPostagens = (uint32_t*) (b + s[SECAO_INICIO_POSTAGENS].deslocamento);
+    t->postagens = (PostagemSuspeito*) (b + s[SECAO_POSTAGENS].deslocamento);
+    t->numPostagens = c->numPostagens;
+    t->ponderada = c->ponderada;
+    t->pesos = NULL;
+    t->numPesos = t->capPesos = 0;
+    if (m->inicioSaidas[0] != 0 || t->inicioPostagens[0] != 0 || !mapaConsistente(m, t))
+        return registrarErro(mapa, "%s: arquivo de mapa binario com indices fora dos limites.", caminho);
+    if (!textosSemSeparadores(&m->nomes) || !textosSemSeparadores(&m->pistas) || !textosSemSeparadores(&t->suspeitos))
+        return registrarErro(mapa, "%s: nomes com tabulacao ou quebra de linha no mapa binario.", caminho);
+
+    mapa->mansao = mansao;
+    mapa->tabela = tabela;
+    mapa->tabela.pistas = &mapa->mansao.pistas;
+    mapa->conjunto = CONJUNTO_PISTAS_PADRAO;
+    mapa->mapeamento = base;
+    mapa->tamMapeamento = 0;
+    return 0;
+}
+
+/* mapearMapaBinario()
+   Mapeia o arquivo .dqm e aponta a mansão e a tabela para dentro dele.
+   Retorna 0 em caso de sucesso ou -1 com a mensagem em mapa->erro. */
+static int mapearMapaBinario(int fd, size_t tamArquivo, const char *caminho, MapaCarregado *mapa) {
+    void *base = mmap(NULL, tamArquivo, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (base == MAP_FAILED) return registrarErro(mapa, "%s: erro ao mapear o arquivo.", caminho);
+    if (apontarMapaBinario(base, tamArquivo, caminho, mapa) != 0) {
+        munmap(base, tamArquivo);
+        return -1;
+    }
+    mapa->tamMapeamento = tamArquivo;
+    return 0;
+}
+
+/* apontarMapaEstatico()
+   Usa como mapa uma imagem .dqm embutida no programa (compilar_mapa --c):
+   nenhuma alocação, leitura ou cópia. A imagem precisa ter sido gerada
+   numa máquina com a mesma ordem de bytes. nome aparece nas mensagens.
+   Retorna 0 em caso de sucesso ou -1 com a mensagem em mapa->erro. */
+int apontarMapaEstatico(MapaCarregado *mapa, const void *dados, size_t tam, const char *nome) {
+    // a imagem é só lida, como o mapeamento PROT_READ dos arquivos
+    mapa->erro[0] = '\0';
+    return apontarMapaBinario((void*) dados, tam, nome, mapa);
+}
+
+/* carregarMapa()
+   Carrega um mapa do arquivo, reconhecendo pelo cabeçalho se ele é binário
+   (mapeado no lugar) ou texto (lido linha a linha).
+   Retorna 0 em caso de sucesso ou -1 com a mensagem em mapa->erro (e o
+   mapa vazio); nada é escrito na tela. */
+int carregarMapa(const char *caminho, MapaCarregado *mapa) {
+    mapa->erro[0] = '\0';
+    esvaziarMapa(mapa);
+    FILE *arq = fopen(caminho, "rb");
+    if (arq == NULL) return registrarErro(mapa, "Erro ao abrir o mapa %s.", caminho);
+
+    char magica[8];
+    struct stat info;
+    int binario = fread(magica, 1, sizeof(magica), arq) == sizeof(magica) &&
+                  memcmp(magica, MAPA_MAGICA, sizeof(magica)) == 0;
+    int resultado;
+    if (binario) {
+        if (fstat(fileno(arq), &info) != 0 || (size_t) info.st_size < sizeof(CabecalhoMapa)) {
+            resultado = registrarErro(mapa, "%s: arquivo de mapa binario truncado.", caminho);
+        } else {
+            resultado = mapearMapaBinario(fileno(arq), (size_t) info.st_size, caminho, mapa);
+        }
+    } else {
+        rewind(arq);
+        inicializarMapa(mapa);
+        resultado = carregarMapaTexto(arq, caminho, mapa);
+        if (resultado != 0) {
+            liberarMapa(mapa);
+            esvaziarMapa(mapa);
+        }
+    }
+    fclose(arq);
+    return resultado;
+}
+
+/* escreverIndiceSala()
+   Escreve o campo de filho do formato texto ("-" para sem sala). */
+static void escreverIndiceSala(FILE *arq, uint32_t indice) {
+    if (indice == SEM_SALA) fputc('-', arq);
+    else fprintf(arq, "%u", indice);
+}
+
+/* salvarMapaTexto()
+   Grava a mansão e a tabela de suspeitos no formato texto.
+   Retorna 0 em caso de sucesso ou -1 se o arquivo não pôde ser gravado. */
+int salvarMapaTexto(const char *caminho, const Mansao *m, const TabelaHash *t) {
+    FILE *arq = fopen(caminho, "w");
+    if (arq == NULL) return -1;
+    fprintf(arq, "# sala|<nome>|<pista ou vazio>|<indice esquerda ou ->|<indice direita ou ->\n");
+    if (m->numPassagens > 0) fprintf(arq, "# passagem|<indice origem>|<indice destino>\n");
+    fprintf(arq, t->ponderada ? "# pista|<texto da pista>|<suspeito>[:<peso>][|<suspeito>[:<peso>] ...]\n\n"
+                              : "# pista|<texto da pista>|<suspeito>\n\n");
+    for (uint32_t i = 0; i < m->numSalas; ++i) {
+        const char *pista = pistaSala(m, i);
+        fprintf(arq, "sala|%s|%s|", nomeSala(m, i), pista != NULL ? pista : "");
+        escreverIndiceSala(arq, m->salas[i].esquerda);
+        fputc('|', arq);
+        escreverIndiceSala(arq, m->salas[i].direita);
+        fputc('\n', arq);
+    }
+    if (m->numPassagens > 0) fputc('\n', arq);
+    for (uint32_t i = 0; i < m->numSalas; ++i)
+        for (uint32_t k = 0; k < numPassagensSala(m, i); ++k)
+            fprintf(arq, "passagem|%u|%u\n", i, passagemSala(m, i, k));
+    fputc('\n', arq);
+    for (uint32_t p = 0; p < t->pistas->quantidade; ++p) {
+        uint32_t suspeito = suspeitoDaPista(t, p);
+        if (suspeito == INTERNADOR_AUSENTE) continue;
+        fprintf(arq, "pista|%s", textoInternado(t->pistas, p));
+        if (!t->ponderada || numPostagensPista(t, p) == 0) {
+            fprintf(arq, "|%s\n", nomeSuspeito(t, suspeito));
+            continue;
+        }
+        const PostagemSuspeito *lista = postagensDaPista(t, p);
+        for (uint32_t k = 0; k < numPostagensPista(t, p); ++k)
+            fprintf(arq, "|%s:%u", nomeSuspeito(t, lista[k].suspeito), lista[k].peso);
+        fputc('\n', arq);
+    }
+    return ferror(arq) | (fclose(arq) != 0) ? -1 : 0;
+}
+
+/* escreverSecao()
+   Grava os bytes da seção, completando com zeros até múltiplo de 8,
+   e registra o deslocamento e tamanho no cabeçalho. */
+static int escreverSecao(FILE *arq, SecaoMapa *secao, const void *dados, size_t tamanho) {
+    static const char zeros[8] = { 0 };
+    long pos = ftell(arq);
+    if (pos < 0) return -1;
+    secao->deslocamento = (uint64_t) pos;
+    secao->tamanho = tamanho;
+    if (tamanho > 0 && fwrite(dados, 1, tamanho, arq) != tamanho) return -1;
+    size_t resto = (8 - tamanho % 8) % 8;
+    if (resto > 0 && fwrite(zeros, 1, resto, arq) != resto) return -1;
+    return 0;
+}
+
+/* escreverPool()
+   Grava as seções de um pool de strings e preenche o seu cabeçalho. */
+static int escreverPool(FILE *arq, SecaoMapa *s, CabecalhoPool *p, const Internador *in) {
+    p->quantidade = in->quantidade;
+    p->capIndice = in->capIndice;
+    p->numOrdenados = in->numOrdenados == in->quantidade ? in->numOrdenados : 0;
+    p->numBaldes = in->numBaldes;
+    p->sementePerfeita = in->sementePerfeita;
+    size_t tamOrdem = (size_t) p->numOrdenados * sizeof(uint32_t);
+    return escreverSecao(arq, &s[POOL_TEXTOS], in->textos, in->tamTextos) ||
+           escreverSecao(arq, &s[POOL_DESLOCAMENTOS], in->deslocamentos, (size_t) in->quantidade * sizeof(uint32_t)) ||
+           escreverSecao(arq, &s[POOL_HASHES], in->hashes, (size_t) in->quantidade * sizeof(uint32_t)) ||
+           escreverSecao(arq, &s[POOL_INDICE], in->indice, (size_t) in->capIndice * sizeof(uint32_t)) ||
+           escreverSecao(arq, &s[POOL_ORDEM], in->ordem, tamOrdem) ||
+           escreverSecao(arq, &s[POOL_POR_ORDEM], in->porOrdem, tamOrdem) ||
+           escreverSecao(arq, &s[POOL_SEMENTES_BALDE], in->sementesBalde, (size_t) in->numBaldes * sizeof(uint32_t));
+}
+
+/* escreverMapaBinario()
+   Grava a mansão e a tabela de suspeitos no formato binário, a partir do
+   início do arquivo (que precisa aceitar fseek()). Retorna 0 ou -1. */
+static int escreverMapaBinario(FILE *arq, const Mansao *m, const TabelaHash *t) {
+    CabecalhoMapa c;
+    memset(&c, 0, sizeof(c));
+    memcpy(c.magica, MAPA_MAGICA, sizeof(c.magica));
+    c.versao = MAPA_VERSAO;
+    c.numSalas = m->numSalas;
+    c.capacidadeHash = t->capacidade;
+    c.quantidadeHash = t->quantidade;
+    c.palavrasMascara = t->palavrasMascara;
+    c.numSaidas = m->numSaidas;
+    c.numPassagens = m->numPassagens;
+    c.numPostagens = t->numPostagens;
+    c.ponderada = t->ponderada;
+
+    int erro = fwrite(&c, sizeof(c), 1, arq) != 1 ||
+        escreverSecao(arq, &c.secoes[SECAO_SALAS], m->salas, (size_t) m->numSalas * sizeof(Sala)) ||
+        escreverPool(arq, &c.secoes[SECAO_POOL_NOMES], &c.poolNomes, &m->nomes) ||
+        escreverPool(arq, &c.secoes[SECAO_POOL_PISTAS], &c.poolPistas, &m->pistas) ||
+        escreverSecao(arq, &c.secoes[SECAO_SUSPEITO_POR_PISTA], t->suspeitoPorPista, (size_t) t->capacidade * sizeof(uint32_t)) ||
+        escreverPool(arq, &c.secoes[SECAO_POOL_SUSPEITOS], &c.poolSuspeitos, &t->suspeitos) ||
+        escreverSecao(arq, &c.secoes[SECAO_MASCARAS], t->mascaras,
+                      (size_t) numSuspeitos(t) * t->palavrasMascara * sizeof(uint64_t)) ||
+        escreverSecao(arq, &c.secoes[SECAO_INICIO_SAIDAS], m->inicioSaidas, ((size_t) m->numSalas + 1) * sizeof(uint32_t)) ||
+        escreverSecao(arq, &c.secoes[SECAO_SAIDAS], m->saidas, (size_t) m->numSaidas * sizeof(uint32_t)) ||
+        escreverSecao(arq, &c.secoes[SECAO_INICIO_POSTAGENS], t->inicioPostagens,
+                      ((size_t) t->pistas->quantidade + 1) * sizeof(uint32_t)) ||
+        escreverSecao(arq, &c.secoes[SECAO_POSTAGENS], t->postagens, (size_t) t->numPostagens * sizeof(PostagemSuspeito));
+
+    // reescreve o cabeçalho, agora com as seções preenchidas
+    if (!erro) erro = fseek(arq, 0, SEEK_SET) != 0 || fwrite(&c, sizeof(c), 1, arq) != 1;
+    return erro ? -1 : 0;
+}
+
+/* salvarMapaBinario()
+   Grava a mansão e a tabela de suspeitos no formato binário.
+   Retorna 0 em caso de sucesso ou -1 se o arquivo não pôde ser gravado. */
+int salvarMapaBinario(const char *caminho, const Mansao *m, const TabelaHash *t) {
+    FILE *arq = fopen(caminho, "wb");
+    if (arq == NULL) return -1;
+    int erro = escreverMapaBinario(arq, m, t) != 0;
+    if (fclose(arq) != 0) erro = 1;
+    return erro ? -1 : 0;
+}
+
+/* salvarMapaFonteC()
+   Grava um arquivo C que define a imagem .dqm do mapa como um vetor
+   constante (simbolo, alinhado em 8) e o seu tamanho (simbolo + "Tam"),
+   para ser compilado junto com o programa e aberto com
+   apontarMapaEstatico(). origem só entra no comentário do arquivo.
+   Retorna 0 em caso de sucesso ou -1 se o arquivo não pôde ser gravado. */
+int salvarMapaFonteC(const char *caminho, const char *simbolo, const char *origem,
+                     const Mansao *m, const TabelaHash *t) {
+    FILE *imagem = tmpfile();
+    if (imagem == NULL) return -1;
+    FILE *arq = escreverMapaBinario(imagem, m, t) == 0 ? fopen(caminho, "w") : NULL;
+    if (arq == NULL) {
+        fclose(imagem);
+        return -1;
+    }
+
+    fprintf(arq, "/* Gerado por compilar_mapa a partir de %s. Não edite. */\n\n", origem);
+    fprintf(arq, "#include <stddef.h>\n\n");
+    fprintf(arq, "_Alignas(8) const unsigned char %s[] = {", simbolo);
+    rewind(imagem);
+    size_t tam = 0;
+    int c;
+    while ((c = getc(imagem)) != EOF) {
+        fprintf(arq, tam % 16 == 0 ? "\n    0x%02x," : " 0x%02x,", c);
+        tam++;
+    }
+    fprintf(arq, "\n};\n\nconst size_t %sTam = %zu;\n", simbolo, tam);
+    int erro = ferror(imagem) || tam == 0;
+    fclose(imagem);
+    if (ferror(arq)) erro = 1;
+    if (fclose(arq) != 0) erro = 1;
+    return erro ? -1 : 0;
+}
@@ -0,0 +1,138 @@
+#ifndef CARREGADOR_H
+#define CARREGADOR_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "mansao.h"
+#include "tabela_hash.h"
+
+/* ===================== CARREGAMENTO DE MAPAS ===================== */
+
+/* Formato texto (uma definição por linha, campos separados por '|'):
+
+     # comentário
+     sala|<nome>|<pista ou vazio>|<índice esquerda ou ->|<índice direita ou ->
+     passagem|<índice origem>|<índice destino>
+     pista|<texto da pista>|<suspeito>[:<peso>][|<suspeito>[:<peso>] ...]
+
+   As salas são numeradas na ordem em que aparecem e a sala 0 é a entrada.
+   Passagens são saídas extras (mansao.h) e podem citar salas definidas
+   mais adiante; as de uma mesma sala são numeradas na ordem do arquivo.
+   Uma pista pode implicar vários suspeitos, com pesos inteiros (1 se
+   omitido); o primeiro é o principal (tabela_hash.h).
+   Nomes de salas, pistas e suspeitos não podem ter tabulações nem quebras
+   de linha, que separam os campos e as linhas do protocolo
+   (renderizador.h); mapas com elas são recusados, no texto e no .dqm.
+
+   Formato binário (.dqm): cabeçalho seguido das seções abaixo, cada uma
+   alinhada em 8 bytes. As seções são cópias exatas dos arrays em memória,
+   então o arquivo é mapeado com mmap() e usado no lugar, sem conversão;
+   isso inclui o hash perfeito dos pools, montado por finalizarMapa().
+   O formato usa a ordem de bytes da máquina que o gerou.
+
+   A mesma imagem pode ser embutida no programa como um vetor constante
+   (salvarMapaFonteC(), compilar_mapa --c) e usada no lugar com
+   apontarMapaEstatico(). É assim que a mansão padrão entra na biblioteca:
+   o build gera as tabelas de mapas/mansao_padrao.txt e
+   montarMansaoPadrao() não aloca nem lê nada. */
+
+#define MAPA_MAGICA "DQMAPA\0\0"
+#define MAPA_VERSAO 7
+#define MAPA_TAM_LINHA 4096
+#define MAPA_TAM_ERRO 256
+#define MAPA_MAX_CAMPOS 64
+
+/* Seções de um pool de strings (Internador), a partir da primeira. */
+enum {
+    POOL_TEXTOS,
+    POOL_DESLOCAMENTOS,
+    POOL_HASHES,
+    POOL_INDICE,       // vazia se o pool foi congelado
+    POOL_ORDEM,        // vazias se o pool não foi ordenado
+    POOL_POR_ORDEM,
+    POOL_SEMENTES_BALDE,   // vazias se o pool não foi congelado
+    POOL_NUM_SECOES
+};
+
+enum {
+    SECAO_SALAS,
+    SECAO_POOL_NOMES,
+    SECAO_POOL_PISTAS = SECAO_POOL_NOMES + POOL_NUM_SECOES,
+    SECAO_SUSPEITO_POR_PISTA = SECAO_POOL_PISTAS + POOL_NUM_SECOES,
+    SECAO_POOL_SUSPEITOS,
+    SECAO_MASCARAS = SECAO_POOL_SUSPEITOS + POOL_NUM_SECOES,
+    SECAO_INICIO_SAIDAS,
+    SECAO_SAIDAS,
+    SECAO_INICIO_POSTAGENS,
+    SECAO_POSTAGENS,
+    MAPA_NUM_SECOES
+};
+
+typedef struct SecaoMapa {
+    uint64_t deslocamento;
+    uint64_t tamanho;
+} SecaoMapa;
+
+typedef struct CabecalhoPool {
+    uint32_t quantidade;
+    uint32_t capIndice;
+    uint32_t numOrdenados;
+    uint32_t numBaldes;        // 0: sem hash perfeito
+    uint64_t sementePerfeita;
+} CabecalhoPool;
+
+typedef struct CabecalhoMapa {
+    char magica[8];
+    uint32_t versao;
+    uint32_t numSalas;
+    uint32_t capacidadeHash;
+    uint32_t quantidadeHash;
+    uint32_t palavrasMascara;
+    uint32_t numSaidas;
+    uint32_t numPassagens;
+    uint32_t numPostagens;
+    uint32_t ponderada;
+    uint32_t reservado;
+    CabecalhoPool poolNomes;
+    CabecalhoPool poolPistas;
+    CabecalhoPool poolSuspeitos;
+    SecaoMapa secoes[MAPA_NUM_SECOES];
+} CabecalhoMapa;
+
+/* Mansão e tabela de suspeitos prontas para o jogo. Se vieram de um arquivo
+   binário, apontam para dentro do mapeamento e são somente leitura; o
+   mesmo vale para um mapa estático, com mapeamento apontando para a
+   imagem embutida e tamMapeamento 0 (nada a desfazer).
+   A tabela usa o pool de pistas da mansão, então o mapa não deve ser
+   copiado para outro endereço depois de inicializado.
+   conjunto é a representação das pistas coletadas usada pelas sessões
+   sobre este mapa (CONJUNTO_PISTAS_PADRAO, a menos que o programa troque).
+   erro guarda a mensagem da última falha de carregarMapa(). */
+typedef struct MapaCarregado {
+    Mansao mansao;
+    TabelaHash tabela;
+    TipoConjunto conjunto;
+    void *mapeamento;
+    size_t tamMapeamento;
+    char erro[MAPA_TAM_ERRO];
+} MapaCarregado;
+
+void inicializarMapa(MapaCarregado *mapa);
+void liberarMapa(MapaCarregado *mapa);
+void finalizarMapa(MapaCarregado *mapa);
+void montarMansaoPadrao(MapaCarregado *mapa);
+int carregarMapa(const char *caminho, MapaCarregado *mapa);
+int apontarMapaEstatico(MapaCarregado *mapa, const void *dados, size_t tam, const char *nome);
+int salvarMapaTexto(const char *caminho, const Mansao *m, const TabelaHash *t);
+int salvarMapaBinario(const char *caminho, const Mansao *m, const TabelaHash *t);
+int salvarMapaFonteC(const char *caminho, const char *simbolo, const char *origem,
+                     const Mansao *m, const TabelaHash *t);
+
+#endif
@@ -0,0 +1,66 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "carregador.h"
+
+/* Compila um mapa em formato texto para o formato binário (.dqm), que os
+   jogos carregam com mmap() sem nenhuma etapa de leitura.
+
+   Com --c, gera em vez disso um arquivo C com a imagem .dqm num vetor
+   constante chamado <simbolo>, para ser compilado junto com o programa
+   (carregador.h). Como em todo mapa finalizado, os pools de pistas e de
+   suspeitos vão congelados com o hash perfeito (internador.h): cada busca
+   de pista ou suspeito pelo texto é um hash, uma leitura e uma comparação.
+
+   Uso: compilar_mapa <mapa.txt> <mapa.dqm>
+        compilar_mapa --c <simbolo> <mapa.txt> <saida.c> */
+
+/* emHeapImplicito()
+   1 se os filhos da sala i são sempre 2i+1 e 2i+2 (ou não existem), como
+   num heap implícito: a árvore de corredores pode ser percorrida só com
+   aritmética de índices. */
+static int emHeapImplicito(const Mansao *m) {
+    for (uint32_t i = 0; i < m->numSalas; ++i) {
+        uint64_t e = 2 * (uint64_t) i + 1, d = e + 1;
+        if ((m->salas[i].esquerda != SEM_SALA && m->salas[i].esquerda != e) ||
+            (m->salas[i].direita != SEM_SALA && m->salas[i].direita != d))
+            return 0;
+    }
+    return 1;
+}
+
+int main(int argc, char *argv[]) {
+    int fonteC = argc == 5 && strcmp(argv[1], "--c") == 0;
+    if (argc != 3 && !fonteC) {
+        printf("Uso: %s <mapa.txt> <mapa.dqm>\n"
+               "       %s --c <simbolo> <mapa.txt> <saida.c>\n", argv[0], argv[0]);
+        return 1;
+    }
+    const char *entrada = argv[fonteC ? 3 : 1];
+    const char *saida = argv[fonteC ? 4 : 2];
+
+    MapaCarregado mapa;
+    if (carregarMapa(entrada, &mapa) != 0) {
+        printf("%s\n", mapa.erro);
+        return 1;
+    }
+    int erro = fonteC ? salvarMapaFonteC(saida, argv[2], entrada, &mapa.mansao, &mapa.tabela)
+                      : salvarMapaBinario(saida, &mapa.mansao, &mapa.tabela);
+    if (erro != 0) {
+        printf("Erro ao gravar o mapa %s.\n", saida);
+        liberarMapa(&mapa);
+        return 1;
+    }
+
+    printf("Mapa compilado: %u salas, %u nomes, %u pistas (%u com suspeito), %u suspeitos.\n",
+           mapa.mansao.numSalas, mapa.mansao.nomes.quantidade, mapa.mansao.pistas.quantidade,
+           mapa.tabela.quantidade, numSuspeitos(&mapa.tabela));
+    if (fonteC)
+        printf("Tabelas estaticas: pistas e suspeitos %s, salas %sem heap implicito.\n",
+               mapa.mansao.pistas.numBaldes > 0 && mapa.tabela.suspeitos.numBaldes > 0 ? "com hash perfeito"
+                                                                                      : "sem hash perfeito",
+               emHeapImplicito(&mapa.mansao) ? "" : "fora de ");
+    liberarMapa(&mapa);
+    return 0;
+}
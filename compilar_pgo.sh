@@ -0,0 +1,35 @@
+#!/bin/sh
+# Build com profile-guided optimization.
+#
+# 1. compila os programas instrumentados (DQ_PGO=GERAR);
+# 2. treina com partidas roteirizadas: o modo lote do Mestres sobre o mapa
+#    padrão (texto e .dqm, com os dois conjuntos de pistas e com threads) e
+#    o benchmark sobre mansões sintéticas;
+# 3. recompila usando os perfis gravados (DQ_PGO=USAR).
+#
+# Uso: ./compilar_pgo.sh [diretorio de build]   (padrão: build-pgo)
+
+set -e
+
+RAIZ=$(cd "$(dirname "$0")" && pwd)
+BUILD=${1:-build-pgo}
+mkdir -p "$BUILD"
+BUILD=$(cd "$BUILD" && pwd)
+PERFIS="$BUILD/pgo-perfis"
+TREINO="$RAIZ/mapas/partidas_treino.txt"
+
+rm -rf "$PERFIS"
+cmake -S "$RAIZ" -B "$BUILD" -DCMAKE_BUILD_TYPE=Release -DDQ_PGO=GERAR -DDQ_PGO_DIR="$PERFIS"
+cmake --build "$BUILD" --clean-first -j
+
+MESTRES="$BUILD/algoritmo_avacadosMestres"
+"$BUILD/compilar_mapa" "$RAIZ/mapas/mansao_padrao.txt" "$BUILD/treino.dqm" > /dev/null
+for conjunto in bits arvore; do
+    "$MESTRES" "$RAIZ/mapas/mansao_padrao.txt" --lote "$TREINO" --conjunto $conjunto > /dev/null
+    "$MESTRES" "$BUILD/treino.dqm" --lote "$TREINO" --conjunto $conjunto --threads 4 > /dev/null
+done
+"$BUILD/benchmark" --salas 50000 --pistas 5000 --buscas 50000 --forma todas > /dev/null
+
+cmake -S "$RAIZ" -B "$BUILD" -DDQ_PGO=USAR
+cmake --build "$BUILD" --clean-first -j
+echo "Programas otimizados com PGO em $BUILD/"
@@ -0,0 +1,112 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "conjunto_pistas.h"
+
+/* Adaptador de percorrerConjunto() para os nós da árvore. */
+typedef struct VisitaConjunto {
+    const Internador *pistas;
+    void (*visitar)(uint32_t idPista, void *contexto);
+    void *contexto;
+} VisitaConjunto;
+
+/* nomeConjunto() / lerTipoConjunto()
+   Conversão entre o tipo e o nome usado na linha de comando
+   ("arvore" ou "bits"). lerTipoConjunto() retorna -1 para nome inválido. */
+const char* nomeConjunto(TipoConjunto tipo) {
+    return tipo == CONJUNTO_BITS ? "bits" : "arvore";
+}
+
+int lerTipoConjunto(const char *nome, TipoConjunto *tipo) {
+    if (strcmp(nome, "arvore") == 0) *tipo = CONJUNTO_ARVORE;
+    else if (strcmp(nome, "bits") == 0) *tipo = CONJUNTO_BITS;
+    else return -1;
+    return 0;
+}
+
+/* iniciarConjunto()
+   Prepara um conjunto vazio para um catálogo de numPistas pistas. A arena
+   só é usada pela árvore (NULL: malloc()). */
+void iniciarConjunto(ConjuntoPistas *c, TipoConjunto tipo, uint32_t numPistas, ArenaPistas *arena) {
+    c->tipo = escolherConjunto(tipo, numPistas);
+    c->raiz = NULL;
+    c->arena = arena;
+    c->bits = NULL;
+    c->numPalavras = 0;
+    if (c->tipo == CONJUNTO_BITS) {
+        c->numPalavras = palavrasConjunto(numPistas);
+        c->bits = (uint64_t*) calloc(c->numPalavras ? c->numPalavras : 1, sizeof(uint64_t));
+        if (c->bits == NULL) {
+            printf("Erro ao alocar memoria para o conjunto de pistas.\n");
+            exit(1);
+        }
+    }
+}
+
+/* contarNaMascara()
+   Quantas pistas do conjunto de bits também estão na máscara (mesmo
+   layout do conjunto). */
+int contarNaMascara(const ConjuntoPistas *c, const uint64_t *mascara) {
+    int total = 0;
+    for (uint32_t w = 0; w < c->numPalavras; ++w)
+        total += __builtin_popcountll(c->bits[w] & mascara[w]);
+    return total;
+}
+
+static void visitarNoConjunto(const PistaNode *no, void *contexto) {
+    VisitaConjunto *v = (VisitaConjunto*) contexto;
+    v->visitar(idPistaNo(no, v->pistas), v->contexto);
+}
+
+/* percorrerConjunto()
+   Visita as pistas do conjunto em ordem alfabética, passando o id de
+   cada uma no pool de pistas. */
+void percorrerConjunto(const ConjuntoPistas *c, const Internador *pistas,
+                       void (*visitar)(uint32_t idPista, void *contexto), void *contexto) {
+    if (c->tipo == CONJUNTO_ARVORE) {
+        VisitaConjunto v = { pistas, visitar, contexto };
+        percorrerPistas(c->raiz, visitarNoConjunto, &v);
+        return;
+    }
+    for (uint32_t w = 0; w < c->numPalavras; ++w) {
+        uint64_t x = c->bits[w];
+        while (x != 0) {
+            uint32_t ordem = w * 64 + (uint32_t) __builtin_ctzll(x);
+            visitar(pistas->porOrdem[ordem], contexto);
+            x &= x - 1;
+        }
+    }
+}
+
+/* reiniciarConjunto()
+   Esvazia o conjunto para reuso, sem devolver memória: a arena da árvore é
+   reiniciada em O(1) e o conjunto de bits é zerado. */
+void reiniciarConjunto(ConjuntoPistas *c) {
+    if (c->tipo == CONJUNTO_ARVORE) {
+        if (c->arena != NULL)
+            reiniciarArena(c->arena);
+        else
+            liberarBST(c->raiz);
+        c->raiz = NULL;
+    } else {
+        memset(c->bits, 0, (size_t) c->numPalavras * sizeof(uint64_t));
+    }
+}
+
+/* encerrarConjunto()
+   Libera as pistas do conjunto. Os nós alocados na arena são descartados
+   reiniciando a arena. */
+void encerrarConjunto(ConjuntoPistas *c) {
+    if (c->tipo == CONJUNTO_ARVORE) {
+        if (c->arena != NULL)
+            reiniciarArena(c->arena);
+        else
+            liberarBST(c->raiz);
+        c->raiz = NULL;
+    } else {
+        free(c->bits);
+        c->bits = NULL;
+    }
+}
@@ -0,0 +1,91 @@
+#ifndef CONJUNTO_PISTAS_H
+#define CONJUNTO_PISTAS_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arvore_pistas.h"
+#include "internador.h"
+
+/* ===================== CONJUNTO DE PISTAS COLETADAS ===================== */
+
+/* As pistas coletadas numa sessão podem ficar em duas representações:
+
+   - CONJUNTO_ARVORE: a AVL de PistaNode (arvore_pistas.h), que só ocupa
+     memória para as pistas coletadas e serve para qualquer catálogo.
+   - CONJUNTO_BITS: um bit por pista do catálogo, indexado pela posição
+     alfabética da pista (Internador.ordem). Inserir é ligar um bit, listar
+     em ordem alfabética é varrer os bits ligados e contar as pistas de um
+     suspeito é popcount(bits & máscara do suspeito).
+
+   O conjunto de bits só é usado quando o catálogo tem até
+   CONJUNTO_BITS_MAX_PISTAS pistas; acima disso cai para a árvore.
+   O padrão é escolhido na compilação com
+   -DCONJUNTO_PISTAS_PADRAO=CONJUNTO_ARVORE (ou CONJUNTO_BITS) e pode ser
+   trocado na execução. */
+
+typedef enum {
+    CONJUNTO_ARVORE,
+    CONJUNTO_BITS
+} TipoConjunto;
+
+#ifndef CONJUNTO_PISTAS_PADRAO
+#define CONJUNTO_PISTAS_PADRAO CONJUNTO_BITS
+#endif
+
+/* 65536 pistas = 8 KiB de bits por sessão. */
+#define CONJUNTO_BITS_MAX_PISTAS (1u << 16)
+
+typedef struct ConjuntoPistas {
+    TipoConjunto tipo;
+    PistaNode *raiz;      // CONJUNTO_ARVORE
+    ArenaPistas *arena;   // NULL: nós alocados com malloc()
+    uint64_t *bits;       // CONJUNTO_BITS
+    uint32_t numPalavras;
+} ConjuntoPistas;
+
+/* palavrasConjunto()
+   Número de palavras de 64 bits para um catálogo de numPistas pistas. */
+static inline uint32_t palavrasConjunto(uint32_t numPistas) {
+    return (numPistas + 63) / 64;
+}
+
+/* escolherConjunto()
+   Representação efetivamente usada para o catálogo: a preferida, a não ser
+   que o catálogo seja grande demais para o conjunto de bits. */
+static inline TipoConjunto escolherConjunto(TipoConjunto preferido, uint32_t numPistas) {
+    return preferido == CONJUNTO_BITS && numPistas <= CONJUNTO_BITS_MAX_PISTAS ? CONJUNTO_BITS : CONJUNTO_ARVORE;
+}
+
+const char* nomeConjunto(TipoConjunto tipo);
+int lerTipoConjunto(const char *nome, TipoConjunto *tipo);
+void iniciarConjunto(ConjuntoPistas *c, TipoConjunto tipo, uint32_t numPistas, ArenaPistas *arena);
+
+/* inserirNoConjunto()
+   Acrescenta a pista pela sua posição alfabética.
+   Retorna 1 se a pista foi inserida ou 0 se já estava no conjunto. */
+static inline int inserirNoConjunto(ConjuntoPistas *c, uint32_t ordem) {
+    if (c->tipo == CONJUNTO_ARVORE) return inserirPistaNova(&c->raiz, ordem, c->arena);
+    uint64_t *palavra = &c->bits[ordem >> 6];
+    uint64_t bit = 1ull << (ordem & 63);
+    if (*palavra & bit) return 0;
+    *palavra |= bit;
+    return 1;
+}
+
+/* contemNoConjunto()
+   Retorna 1 se a pista (posição alfabética) está no conjunto. */
+static inline int contemNoConjunto(const ConjuntoPistas *c, uint32_t ordem) {
+    if (c->tipo == CONJUNTO_ARVORE) return contemPista(c->raiz, ordem);
+    return (c->bits[ordem >> 6] >> (ordem & 63)) & 1;
+}
+
+int contarNaMascara(const ConjuntoPistas *c, const uint64_t *mascara);
+void percorrerConjunto(const ConjuntoPistas *c, const Internador *pistas,
+                       void (*visitar)(uint32_t idPista, void *contexto), void *contexto);
+void reiniciarConjunto(ConjuntoPistas *c);
+void encerrarConjunto(ConjuntoPistas *c);
+
+#endif
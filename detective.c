@@ -0,0 +1,527 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "detective.h"
+#include "busca_pistas.h"
+#include "carregador.h"
+#include "conjunto_pistas.h"
+#include "estatisticas.h"
+#include "indice_mansao.h"
+#include "resolvedor.h"
+#include "retrato_sessao.h"
+#include "sessao.h"
+
+_Static_assert(DQ_PASSAGENS_POR_DIGITO == PASSAGENS_POR_DIGITO, "passagens por digito diferentes na API");
+
+/* Sessão da API: a sessão do motor mais a mansão em que ela joga. */
+struct DqSessao {
+    Sessao sessao;
+    const MapaCarregado *mapa;
+};
+
+/* Busca da API: o bloco de textos das pistas da mansão. */
+struct DqBusca {
+    BuscaPistas busca;
+    const MapaCarregado *mapa;
+};
+
+/* Contexto usado por dqBuscarTrecho() para filtrar pela sessão e entregar
+   textos em vez de posições alfabéticas. */
+typedef struct VisitaBusca {
+    const DqBusca *busca;
+    const ConjuntoPistas *filtro;   // NULL: todas as pistas
+    void (*visitar)(const char *pista, void *contexto);
+    void *contexto;
+    size_t encontradas;
+} VisitaBusca;
+
+/* Contexto usado por dqPercorrerPistas() para entregar textos em vez de ids. */
+typedef struct VisitaTextos {
+    const Internador *pistas;
+    void (*visitar)(const char *pista, void *contexto);
+    void *contexto;
+} VisitaTextos;
+
+/* Contexto usado por dqRanking() para entregar nomes em vez de ids. */
+typedef struct VisitaRanking {
+    const TabelaHash *tabela;
+    void (*visitar)(const char *suspeito, uint64_t pontos, void *contexto);
+    void *contexto;
+} VisitaRanking;
+
+/* dqVersaoApi()
+   Versão da API com que a biblioteca foi compilada (DQ_VERSAO_API). */
+int dqVersaoApi(void) {
+    return DQ_VERSAO_API;
+}
+
+/* dqAbrirMansao()
+   Carrega uma mansão de um arquivo texto ou binário (.dqm). Em caso de
+   falha retorna NULL e, se erro não for NULL, copia a mensagem para ele. */
+DqMansao* dqAbrirMansao(const char *caminho, char *erro, size_t tamErro) {
+    MapaCarregado *mapa = (MapaCarregado*) malloc(sizeof(MapaCarregado));
+    if (mapa == NULL) {
+        if (erro != NULL && tamErro > 0) snprintf(erro, tamErro, "Memoria insuficiente para a mansao %s.", caminho);
+        return NULL;
+    }
+    if (carregarMapa(caminho, mapa) != 0) {
+        if (erro != NULL && tamErro > 0) snprintf(erro, tamErro, "%s", mapa->erro);
+        free(mapa);
+        return NULL;
+    }
+    return mapa;
+}
+
+/* dqMansaoPadrao()
+   Monta a mansão padrão do jogo (NULL se faltar memória). */
+DqMansao* dqMansaoPadrao(void) {
+    MapaCarregado *mapa = (MapaCarregado*) malloc(sizeof(MapaCarregado));
+    if (mapa == NULL) return NULL;
+    montarMansaoPadrao(mapa);
+    return mapa;
+}
+
+/* dqDefinirConjunto()
+   Escolhe a representação das pistas coletadas ("arvore" ou "bits") para as
+   sessões iniciadas daqui em diante. Retorna -1 se o nome não for conhecido. */
+int dqDefinirConjunto(DqMansao *m, const char *nome) {
+    return lerTipoConjunto(nome, &m->conjunto);
+}
+
+/* dqNumSalas()
+   Número de salas da mansão. */
+uint32_t dqNumSalas(const DqMansao *m) {
+    return m->mansao.numSalas;
+}
+
+/* dqNomeSala() / dqPistaSala()
+   Nome e pista (NULL se não houver) da sala de número informado
+   (0 .. dqNumSalas() - 1; a entrada é a sala 0). NULL fora da mansão. */
+const char* dqNomeSala(const DqMansao *m, uint32_t sala) {
+    return sala < m->mansao.numSalas ? nomeSala(&m->mansao, sala) : NULL;
+}
+
+const char* dqPistaSala(const DqMansao *m, uint32_t sala) {
+    return sala < m->mansao.numSalas ? pistaSala(&m->mansao, sala) : NULL;
+}
+
+/* dqNumPistas()
+   Número de pistas do catálogo da mansão. */
+uint32_t dqNumPistas(const DqMansao *m) {
+    return m->mansao.pistas.quantidade;
+}
+
+/* dqIdPistaSala() / dqTextoPista()
+   Número da pista da sala no catálogo (0 .. dqNumPistas() - 1), ou
+   DQ_SEM_PISTA (também para uma sala fora da mansão), e o texto da pista
+   de número informado (NULL fora do catálogo). Os números valem para a
+   mansão aberta; logs que os guardam só servem para a mesma mansão. */
+uint32_t dqIdPistaSala(const DqMansao *m, uint32_t sala) {
+    return sala < m->mansao.numSalas ? m->mansao.salas[sala].pista : DQ_SEM_PISTA;
+}
+
+const char* dqTextoPista(const DqMansao *m, uint32_t pista) {
+    return pista < m->mansao.pistas.quantidade ? textoInternado(&m->mansao.pistas, pista) : NULL;
+}
+
+/* dqSuspeitoPista()
+   Suspeito principal da pista de texto informado, ou NULL se a pista não
+   estiver no catálogo ou não apontar para ninguém. */
+const char* dqSuspeitoPista(const DqMansao *m, const char *pista) {
+    return encontrarSuspeito(&m->tabela, pista);
+}
+
+/* vizinhaNaDirecao()
+   Sala na direção 'e', 'd' ou '1'..'9' (passagem), ou SEM_SALA. */
+static uint32_t vizinhaNaDirecao(const Mansao *m, uint32_t sala, char direcao) {
+    const Sala *s = &m->salas[sala];
+    if (direcao >= '1' && direcao < '1' + PASSAGENS_POR_DIGITO) return passagemSala(m, sala, (uint32_t) (direcao - '1'));
+    return direcao == 'e' ? s->esquerda : direcao == 'd' ? s->direita : SEM_SALA;
+}
+
+/* dqSalaVizinha()
+   Sala à esquerda ('e'), à direita ('d') ou na passagem '1'..'9' da sala
+   informada, ou DQ_SEM_SALA se não houver caminho nessa direção ou a sala
+   não for da mansão. */
+uint32_t dqSalaVizinha(const DqMansao *m, uint32_t sala, char direcao) {
+    return sala < m->mansao.numSalas ? vizinhaNaDirecao(&m->mansao, sala, direcao) : DQ_SEM_SALA;
+}
+
+/* dqNumPassagens()
+   Quantidade de passagens da sala (0 fora da mansão). */
+uint32_t dqNumPassagens(const DqMansao *m, uint32_t sala) {
+    return sala < m->mansao.numSalas ? numPassagensSala(&m->mansao, sala) : 0;
+}
+
+/* dqPassagem()
+   Destino da passagem de número informado (a partir de 0), ou DQ_SEM_SALA. */
+uint32_t dqPassagem(const DqMansao *m, uint32_t sala, uint32_t passagem) {
+    return sala < m->mansao.numSalas ? passagemSala(&m->mansao, sala, passagem) : DQ_SEM_SALA;
+}
+
+/* dqPistasPonderadas()
+   1 se alguma pista da mansão tem mais de um suspeito ou peso diferente
+   de 1; nesse caso o ranking pode diferir da contagem de evidências. */
+int dqPistasPonderadas(const DqMansao *m) {
+    return m->tabela.ponderada != 0;
+}
+
+/* dqFecharMansao()
+   Libera a mansão. Todas as sessões sobre ela devem ter sido encerradas. */
+void dqFecharMansao(DqMansao *m) {
+    if (m == NULL) return;
+    liberarMapa(m);
+    free(m);
+}
+
+/* dqIniciarSessao()
+   Começa uma sessão na entrada da mansão, sem pistas (NULL se faltar
+   memória). */
+DqSessao* dqIniciarSessao(const DqMansao *m) {
+    DqSessao *s = (DqSessao*) malloc(sizeof(DqSessao));
+    if (s == NULL) return NULL;
+    s->mapa = m;
+    iniciarSessao(&s->sessao, SALA_ENTRADA, &m->tabela, NULL, m->conjunto);
+    return s;
+}
+
+/* dqReiniciarSessao()
+   Volta a sessão para a entrada, sem pistas, reaproveitando a sua memória.
+   Jogar muitas partidas curtas reiniciando a mesma sessão não aloca nada. */
+void dqReiniciarSessao(DqSessao *s) {
+    reiniciarSessao(&s->sessao, SALA_ENTRADA);
+}
+
+/* dqEncerrarSessao()
+   Libera a sessão e as pistas coletadas por ela. */
+void dqEncerrarSessao(DqSessao *s) {
+    if (s == NULL) return;
+    encerrarSessao(&s->sessao);
+    free(s);
+}
+
+/* dqSalaAtual()
+   Nome da sala em que o jogador está. */
+const char* dqSalaAtual(const DqSessao *s) {
+    return nomeSala(&s->mapa->mansao, s->sessao.salaAtual);
+}
+
+/* dqIdSalaAtual()
+   Número da sala em que o jogador está, para uso com dqNomeSala() e afins. */
+uint32_t dqIdSalaAtual(const DqSessao *s) {
+    return s->sessao.salaAtual;
+}
+
+/* dqCaminho()
+   Nome da sala à esquerda ('e'), à direita ('d') ou na passagem '1'..'9'
+   da sala atual, ou NULL se não houver caminho nessa direção. */
+const char* dqCaminho(const DqSessao *s, char direcao) {
+    uint32_t destino = vizinhaNaDirecao(&s->mapa->mansao, s->sessao.salaAtual, direcao);
+    return destino != SEM_SALA ? nomeSala(&s->mapa->mansao, destino) : NULL;
+}
+
+/* converterMovimento()
+   Resultado de moverSessao() no enum da API. */
+static DqMovimento converterMovimento(ResultadoMovimento r) {
+    switch (r) {
+        case MOVIMENTO_OK: return DQ_MOVIMENTO_OK;
+        case MOVIMENTO_SAIR: return DQ_MOVIMENTO_SAIR;
+        default: return DQ_MOVIMENTO_INVALIDO;
+    }
+}
+
+/* dqMover()
+   Aplica uma escolha do jogador: 'e' (esquerda), 'd' (direita), '1'..'9'
+   (passagem) ou 's' (sair). */
+DqMovimento dqMover(DqSessao *s, char escolha) {
+    return converterMovimento(moverSessao(&s->sessao, &s->mapa->mansao, escolha));
+}
+
+/* dqSeguirPassagem()
+   Segue a passagem de número informado (a partir de 0) da sala atual. */
+DqMovimento dqSeguirPassagem(DqSessao *s, uint32_t passagem) {
+    return converterMovimento(moverPorPassagem(&s->sessao, &s->mapa->mansao, passagem));
+}
+
+/* dqColetar()
+   Coleta a pista da sala atual. Retorna o texto da pista (mesmo que já
+   tivesse sido coletada) ou NULL se a sala não tem pista. */
+const char* dqColetar(DqSessao *s) {
+    return coletarPistaDaSala(&s->sessao, &s->mapa->mansao);
+}
+
+/* dqAcusar()
+   Acusa um suspeito pelo nome. Retorna 1 se há pelo menos ACUSACAO_MINIMA
+   pistas coletadas contra ele e 0 caso contrário; se evidencias não for
+   NULL, recebe quantas pistas apontam para o suspeito. */
+int dqAcusar(const DqSessao *s, const char *suspeito, uint32_t *evidencias) {
+    int n = evidenciasContra(&s->sessao, suspeito);
+    if (evidencias != NULL) *evidencias = (uint32_t) n;
+    return n >= ACUSACAO_MINIMA;
+}
+
+/* dqPontuacao()
+   Soma dos pesos das pistas coletadas que implicam o suspeito (0 se o
+   nome não for de um suspeito). */
+uint64_t dqPontuacao(const DqSessao *s, const char *suspeito) {
+    return pontuacaoContra(&s->sessao, suspeito);
+}
+
+/* visitarSuspeito()
+   Adaptador: converte o id do suspeito no nome antes de chamar o visitante. */
+static void visitarSuspeito(uint32_t suspeito, uint64_t pontos, void *contexto) {
+    VisitaRanking *v = (VisitaRanking*) contexto;
+    v->visitar(nomeSuspeito(v->tabela, suspeito), pontos, v->contexto);
+}
+
+/* dqRanking()
+   Chama visitar() para os até n suspeitos de maior pontuação, do primeiro
+   para baixo (empates em ordem de cadastro), pulando os sem pontos.
+   Retorna quantos foram visitados. */
+uint32_t dqRanking(const DqSessao *s, uint32_t n, void (*visitar)(const char *suspeito, uint64_t pontos, void *contexto),
+                   void *contexto) {
+    VisitaRanking v = { &s->mapa->tabela, visitar, contexto };
+    return percorrerRanking(&s->sessao, n, visitarSuspeito, &v);
+}
+
+/* dqEstatisticas()
+   Copia o estado atual da sessão. */
+void dqEstatisticas(const DqSessao *s, DqEstatisticas *e) {
+    const Sessao *sessao = &s->sessao;
+    e->sala = dqSalaAtual(s);
+    e->movimentos = sessao->movimentos;
+    e->invalidos = sessao->invalidos;
+    e->pistas = sessao->numPistas;
+    e->maisProvavel = sessao->suspeitoMaisProvavel != INTERNADOR_AUSENTE
+                    ? nomeSuspeito(&s->mapa->tabela, sessao->suspeitoMaisProvavel) : NULL;
+    e->maxEvidencias = sessao->maxEvidencias;
+}
+
+/* visitarTexto()
+   Adaptador: converte o id da pista no texto antes de chamar o visitante. */
+static void visitarTexto(uint32_t idPista, void *contexto) {
+    VisitaTextos *v = (VisitaTextos*) contexto;
+    v->visitar(textoInternado(v->pistas, idPista), v->contexto);
+}
+
+/* dqPercorrerPistas()
+   Chama visitar() para cada pista coletada, em ordem alfabética. */
+void dqPercorrerPistas(const DqSessao *s, void (*visitar)(const char *pista, void *contexto),
+                       void *contexto) {
+    VisitaTextos v = { &s->mapa->mansao.pistas, visitar, contexto };
+    percorrerConjunto(&s->sessao.pistas, v.pistas, visitarTexto, &v);
+}
+
+/* dqContadoresPool()
+   Contadores da arena de nós de pista da sessão. */
+void dqContadoresPool(const DqSessao *s, DqContadoresPool *c) {
+    ContadoresPool p = contadoresPool(&s->sessao.arena);
+    c->alocacoes = p.alocacoes;
+    c->blocos = p.blocos;
+    c->reinicios = p.reinicios;
+    c->emUso = p.emUso;
+    c->pico = p.pico;
+}
+
+/* dqResolver()
+   Resolve todos os suspeitos (resolvedor.h): pelo índice de alcance se a
+   mansão é uma árvore, pelo grafo de saídas se não é. Entrega a solução de
+   cada um, com o caminho em texto, a visitar() (que pode ser NULL).
+   contadores pode ser NULL. */
+uint32_t dqResolver(const DqMansao *m, int numThreads, void (*visitar)(const DqSolucao *solucao, void *contexto),
+                    void *contexto, DqContadoresResolver *contadores) {
+    const TabelaHash *tabela = &m->tabela;
+    uint32_t suspeitos = numSuspeitos(tabela);
+    SolucaoSuspeito *solucoes = (SolucaoSuspeito*) malloc((suspeitos ? suspeitos : 1) * sizeof(SolucaoSuspeito));
+    if (solucoes == NULL) return DQ_RESOLVER_FALHOU;
+    ContadoresResolvedor c;
+    IndiceMansao indice;
+    if (construirIndice(&indice, &m->mansao, tabela) == 0) {
+        resolverMansao(&m->mansao, tabela, &indice, numThreads, solucoes, &c);
+        liberarIndice(&indice);
+    } else {
+        resolverGrafo(&m->mansao, tabela, numThreads, solucoes, &c);
+    }
+    if (contadores != NULL) {
+        contadores->salas = c.salas;
+        contadores->tarefas = c.tarefas;
+        contadores->roubos = c.roubos;
+    }
+
+    uint32_t resolvidos = 0;
+    for (uint32_t s = 0; s < suspeitos; ++s) {
+        const SolucaoSuspeito *sol = &solucoes[s];
+        DqSolucao d = { nomeSuspeito(tabela, s), NULL, NULL, 0 };
+        if (sol->salaFinal != SEM_SALA) {
+            resolvidos++;
+            d.salaFinal = nomeSala(&m->mansao, sol->salaFinal);
+            d.movimentos = sol->caminho;
+            d.numMovimentos = sol->movimentos;
+        }
+        if (visitar != NULL) visitar(&d, contexto);
+    }
+    liberarSolucoes(solucoes, suspeitos);
+    free(solucoes);
+    return resolvidos;
+}
+
+/* dqTamanhoMaximoRetrato()
+   Espaço suficiente para dqRetratarSessao() no estado atual da sessão. */
+size_t dqTamanhoMaximoRetrato(const DqSessao *s) {
+    return limiteRetrato(&s->sessao, &s->mapa->mansao);
+}
+
+/* dqRetratarSessao()
+   Escreve o retrato da sessão em destino (com pelo menos
+   dqTamanhoMaximoRetrato() bytes) e retorna o tamanho usado. */
+size_t dqRetratarSessao(const DqSessao *s, void *destino) {
+    return codificarSessao(&s->sessao, &s->mapa->mansao, (uint8_t*) destino);
+}
+
+/* dqRestaurarSessao()
+   Volta a sessão ao estado do retrato. Retorna 0, ou -1 se o retrato for
+   inválido para a mansão (a sessão fica na entrada, sem pistas). */
+int dqRestaurarSessao(DqSessao *s, const void *dados, size_t tam) {
+    size_t usados;
+    return decodificarSessao(&s->sessao, &s->mapa->mansao, (const uint8_t*) dados, tam, &usados);
+}
+
+/* dqSalvarSessoes()
+   Grava os retratos de n sessões da mansão num arquivo, com uma única
+   escrita. Retorna -1 se alguma sessão for de outra mansão ou se o arquivo
+   não puder ser gravado. */
+int dqSalvarSessoes(const DqMansao *m, const char *caminho, DqSessao *const *sessoes, size_t n) {
+    for (size_t i = 0; i < n; ++i)
+        if (sessoes[i]->mapa != m) return -1;
+    GravadorRetratos g;
+    iniciarGravadorRetratos(&g, m);
+    for (size_t i = 0; i < n; ++i) acrescentarRetrato(&g, &sessoes[i]->sessao);
+    int resultado = gravarRetratos(&g, caminho);
+    liberarGravadorRetratos(&g);
+    return resultado;
+}
+
+/* dqCarregarSessoes()
+   Recria as sessões de um arquivo gravado por dqSalvarSessoes() para a
+   mesma mansão. Retorna um vetor com *numSessoes sessões, que devem ser
+   encerradas com dqEncerrarSessao(); o vetor é liberado com free().
+   Em caso de falha retorna NULL e, se erro não for NULL, a mensagem. */
+DqSessao** dqCarregarSessoes(const DqMansao *m, const char *caminho, size_t *numSessoes,
+                             char *erro, size_t tamErro) {
+    LeitorRetratos l;
+    *numSessoes = 0;
+    if (abrirRetratos(&l, m, caminho) != 0) {
+        if (erro != NULL && tamErro > 0) snprintf(erro, tamErro, "%s", l.erro);
+        return NULL;
+    }
+    size_t n = (size_t) l.numSessoes;
+    DqSessao **sessoes = (DqSessao**) malloc((n ? n : 1) * sizeof(DqSessao*));
+    if (sessoes == NULL) {
+        if (erro != NULL && tamErro > 0) snprintf(erro, tamErro, "%s: memoria insuficiente para as sessoes.", caminho);
+        fecharRetratos(&l);
+        return NULL;
+    }
+    for (size_t i = 0; i < n; ++i) {
+        sessoes[i] = dqIniciarSessao(m);
+        if (sessoes[i] == NULL || lerRetrato(&l, &sessoes[i]->sessao) != 1) {
+            if (erro != NULL && tamErro > 0)
+                snprintf(erro, tamErro, "%s: %s", caminho, sessoes[i] != NULL ? l.erro : "memoria insuficiente para as sessoes.");
+            for (size_t j = 0; j <= i; ++j) dqEncerrarSessao(sessoes[j]);
+            free(sessoes);
+            fecharRetratos(&l);
+            return NULL;
+        }
+    }
+    fecharRetratos(&l);
+    *numSessoes = n;
+    return sessoes;
+}
+
+/* dqCriarBusca()
+   Prepara a busca de texto sobre o catálogo de pistas da mansão (NULL se
+   faltar memória). */
+DqBusca* dqCriarBusca(const DqMansao *m) {
+    DqBusca *b = (DqBusca*) malloc(sizeof(DqBusca));
+    if (b == NULL) return NULL;
+    b->mapa = m;
+    construirBusca(&b->busca, &m->mansao.pistas);
+    return b;
+}
+
+/* visitarBusca()
+   Entrega uma pista encontrada a quem chamou, se ela passar pelo filtro. */
+static void visitarBusca(uint32_t ordem, void *contexto) {
+    VisitaBusca *v = (VisitaBusca*) contexto;
+    if (v->filtro != NULL && !contemNoConjunto(v->filtro, ordem)) return;
+    const Internador *pistas = &v->busca->mapa->mansao.pistas;
+    v->encontradas++;
+    if (v->visitar != NULL) v->visitar(textoInternado(pistas, pistas->porOrdem[ordem]), v->contexto);
+}
+
+/* dqBuscarTrecho()
+   Chama visitar() (que pode ser NULL) para cada pista que contém o trecho,
+   em ordem alfabética, e retorna quantas foram. O filtro, se não for NULL,
+   deve ser uma sessão sobre a mesma mansão. */
+size_t dqBuscarTrecho(const DqBusca *b, const DqSessao *filtro, const char *trecho,
+                      void (*visitar)(const char *pista, void *contexto), void *contexto) {
+    VisitaBusca v = { b, filtro != NULL ? &filtro->sessao.pistas : NULL, visitar, contexto, 0 };
+    buscarTrecho(&b->busca, trecho, visitarBusca, &v);
+    return v.encontradas;
+}
+
+/* dqBuscarPrefixo()
+   Como dqBuscarTrecho(), para as pistas que começam com o prefixo. */
+size_t dqBuscarPrefixo(const DqBusca *b, const DqSessao *filtro, const char *prefixo,
+                       void (*visitar)(const char *pista, void *contexto), void *contexto) {
+    VisitaBusca v = { b, filtro != NULL ? &filtro->sessao.pistas : NULL, visitar, contexto, 0 };
+    uint32_t primeira, fim;
+    intervaloPrefixo(&b->busca, prefixo, &primeira, &fim);
+    for (uint32_t ordem = primeira; ordem < fim; ++ordem) visitarBusca(ordem, &v);
+    return v.encontradas;
+}
+
+/* dqImplementacaoBusca()
+   Implementação usada pela busca por trecho: "avx2", "sse2" ou "escalar". */
+const char* dqImplementacaoBusca(const DqBusca *b) {
+    return b->busca.implementacao;
+}
+
+/* dqLiberarBusca()
+   Libera a busca. */
+void dqLiberarBusca(DqBusca *b) {
+    if (b == NULL) return;
+    liberarBusca(&b->busca);
+    free(b);
+}
+
+/* dqEstatisticasAtivas()
+   1 se a biblioteca foi compilada com DQ_ESTATISTICAS. */
+int dqEstatisticasAtivas(void) {
+    return estatisticasAtivas();
+}
+
+/* dqTextoEstatisticas()
+   Relatório das estatísticas no formato pedido, num texto alocado com
+   malloc(), ou NULL se o formato for desconhecido ou faltar memória. */
+char* dqTextoEstatisticas(const char *formato) {
+    FormatoEstatisticas f;
+    if (lerFormatoEstatisticas(formato, &f) != 0) return NULL;
+    char *texto = NULL;
+    size_t tam = 0;
+    FILE *saida = open_memstream(&texto, &tam);
+    if (saida == NULL) return NULL;
+    escreverEstatisticas(saida, f);
+    if (fclose(saida) != 0) {
+        free(texto);
+        return NULL;
+    }
+    return texto;
+}
+
+/* dqZerarEstatisticas()
+   Zera as estatísticas de todas as threads. */
+void dqZerarEstatisticas(void) {
+    zerarEstatisticas();
+}
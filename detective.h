@@ -0,0 +1,164 @@
+#ifndef DETECTIVE_H
+#define DETECTIVE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* ===================== API DO MOTOR (LIBDETECTIVE) ===================== */
+
+/* Interface estável para embutir o jogo em outros programas (servidores,
+   ferramentas, testes). Mansões e sessões são acessadas apenas por ponteiros
+   opacos e nenhuma função faz entrada ou saída no terminal: erros voltam
+   como códigos ou mensagens e a apresentação fica com quem chama. As
+   funções que criam mansões, sessões e buscas retornam NULL se faltar
+   memória, e um número de sala fora da mansão dá NULL, DQ_SEM_SALA ou
+   DQ_SEM_PISTA em vez de uma leitura fora dela.
+
+   Uma mansão é somente leitura depois de aberta, então qualquer número de
+   sessões pode jogar sobre ela ao mesmo tempo, inclusive em threads
+   diferentes; cada sessão deve ser usada por uma thread de cada vez.
+   Os textos devolvidos (salas, pistas, suspeitos) pertencem à mansão e
+   valem até dqFecharMansao(). */
+
+#define DQ_VERSAO_API 7
+#define DQ_TAM_ERRO 256     // tamanho suficiente para as mensagens de dqAbrirMansao()
+#define DQ_SEM_SALA UINT32_MAX  // dqSalaVizinha() sem caminho na direção pedida
+#define DQ_SEM_PISTA UINT32_MAX // dqIdPistaSala() de uma sala sem pista
+#define DQ_RESOLVER_FALHOU UINT32_MAX // dqResolver() sem memória
+
+/* Além de esquerda ('e') e direita ('d'), uma sala pode ter passagens para
+   qualquer outra sala (com voltas e ciclos). As nove primeiras são as
+   direções '1'..'9' de dqSalaVizinha(), dqCaminho() e dqMover(); todas
+   são alcançáveis por dqPassagem() e dqSeguirPassagem(), numeradas a
+   partir de 0. */
+#define DQ_PASSAGENS_POR_DIGITO 9
+
+/* Uma pista pode implicar vários suspeitos, cada um com um peso. A
+   acusação (dqAcusar()) e o mais provável de dqEstatisticas() contam só o
+   suspeito principal de cada pista (o primeiro da sua linha no mapa);
+   dqPontuacao() e dqRanking() somam os pesos de todos. Numa mansão sem
+   pesos (dqPistasPonderadas() igual a 0) as duas contagens coincidem. */
+
+typedef struct MapaCarregado DqMansao;
+typedef struct DqSessao DqSessao;
+typedef struct DqBusca DqBusca;
+
+/* Resultado de dqMover(). */
+typedef enum {
+    DQ_MOVIMENTO_OK,
+    DQ_MOVIMENTO_INVALIDO,
+    DQ_MOVIMENTO_SAIR
+} DqMovimento;
+
+/* Contadores da arena de nós de pista da sessão, lidos por dqContadoresPool(). */
+typedef struct DqContadoresPool {
+    uint64_t alocacoes;   // nós entregues pela arena
+    uint64_t blocos;      // blocos pedidos ao malloc()
+    uint64_t reinicios;
+    uint32_t emUso;
+    uint32_t pico;
+} DqContadoresPool;
+
+/* Melhor partida contra um suspeito, entregue por dqResolver(). */
+typedef struct DqSolucao {
+    const char *suspeito;
+    const char *salaFinal;      // NULL se nenhum caminho reúne pistas suficientes
+    const char *movimentos;     // 'e', 'd' e '1'..'9' da entrada até salaFinal
+    uint32_t numMovimentos;
+} DqSolucao;
+
+/* Totais de dqResolver(). */
+typedef struct DqContadoresResolver {
+    uint64_t salas;       // salas visitadas
+    uint64_t tarefas;     // subárvores repartidas entre as threads (suspeitos, fora das árvores)
+    uint64_t roubos;      // tarefas executadas por outra thread (0 fora das árvores)
+} DqContadoresResolver;
+
+/* Estado de uma sessão, preenchido por dqEstatisticas(). */
+typedef struct DqEstatisticas {
+    const char *sala;           // sala atual
+    uint32_t movimentos;
+    uint32_t invalidos;
+    uint32_t pistas;            // pistas distintas coletadas
+    const char *maisProvavel;   // NULL se nenhuma pista aponta para alguém
+    uint32_t maxEvidencias;
+} DqEstatisticas;
+
+int dqVersaoApi(void);
+
+DqMansao* dqAbrirMansao(const char *caminho, char *erro, size_t tamErro);
+DqMansao* dqMansaoPadrao(void);
+int dqDefinirConjunto(DqMansao *m, const char *nome);
+uint32_t dqNumSalas(const DqMansao *m);
+const char* dqNomeSala(const DqMansao *m, uint32_t sala);
+const char* dqPistaSala(const DqMansao *m, uint32_t sala);
+uint32_t dqNumPistas(const DqMansao *m);
+uint32_t dqIdPistaSala(const DqMansao *m, uint32_t sala);
+const char* dqTextoPista(const DqMansao *m, uint32_t pista);
+const char* dqSuspeitoPista(const DqMansao *m, const char *pista);
+uint32_t dqSalaVizinha(const DqMansao *m, uint32_t sala, char direcao);
+uint32_t dqNumPassagens(const DqMansao *m, uint32_t sala);
+uint32_t dqPassagem(const DqMansao *m, uint32_t sala, uint32_t passagem);
+int dqPistasPonderadas(const DqMansao *m);
+void dqFecharMansao(DqMansao *m);
+
+DqSessao* dqIniciarSessao(const DqMansao *m);
+void dqReiniciarSessao(DqSessao *s);
+void dqEncerrarSessao(DqSessao *s);
+const char* dqSalaAtual(const DqSessao *s);
+uint32_t dqIdSalaAtual(const DqSessao *s);
+const char* dqCaminho(const DqSessao *s, char direcao);
+DqMovimento dqMover(DqSessao *s, char escolha);
+DqMovimento dqSeguirPassagem(DqSessao *s, uint32_t passagem);
+const char* dqColetar(DqSessao *s);
+int dqAcusar(const DqSessao *s, const char *suspeito, uint32_t *evidencias);
+uint64_t dqPontuacao(const DqSessao *s, const char *suspeito);
+uint32_t dqRanking(const DqSessao *s, uint32_t n, void (*visitar)(const char *suspeito, uint64_t pontos, void *contexto),
+                   void *contexto);
+void dqEstatisticas(const DqSessao *s, DqEstatisticas *e);
+void dqPercorrerPistas(const DqSessao *s, void (*visitar)(const char *pista, void *contexto),
+                       void *contexto);
+void dqContadoresPool(const DqSessao *s, DqContadoresPool *c);
+
+/* Resolvedor: para cada suspeito, a menor sequência de movimentos a partir
+   da entrada que reúne pistas suficientes para acusá-lo, calculada por
+   numThreads threads (o resultado não depende delas). Vale para qualquer
+   mansão: corredores, salas compartilhadas, ciclos e as passagens que as
+   partidas escolhem por dígito ('1'..'9'). visitar() recebe os suspeitos
+   na ordem do catálogo; os textos da solução valem só durante a chamada.
+   Retorna quantos suspeitos têm solução, ou DQ_RESOLVER_FALHOU. */
+uint32_t dqResolver(const DqMansao *m, int numThreads, void (*visitar)(const DqSolucao *solucao, void *contexto),
+                    void *contexto, DqContadoresResolver *contadores);
+
+/* Retratos: o estado de uma sessão em poucos bytes, para estacionar
+   sessões ociosas e retomá-las depois. Um retrato só pode ser restaurado
+   numa sessão sobre a mesma mansão. */
+size_t dqTamanhoMaximoRetrato(const DqSessao *s);
+size_t dqRetratarSessao(const DqSessao *s, void *destino);
+int dqRestaurarSessao(DqSessao *s, const void *dados, size_t tam);
+int dqSalvarSessoes(const DqMansao *m, const char *caminho, DqSessao *const *sessoes, size_t n);
+DqSessao** dqCarregarSessoes(const DqMansao *m, const char *caminho, size_t *numSessoes,
+                             char *erro, size_t tamErro);
+
+/* Busca de texto no catálogo de pistas da mansão: por trecho contido na
+   pista ou por prefixo, com resultados em ordem alfabética. Com uma sessão
+   em filtro, só entram as pistas que ela já coletou. A busca vale até
+   dqLiberarBusca() e pode ser usada por várias threads ao mesmo tempo. */
+DqBusca* dqCriarBusca(const DqMansao *m);
+size_t dqBuscarTrecho(const DqBusca *b, const DqSessao *filtro, const char *trecho,
+                      void (*visitar)(const char *pista, void *contexto), void *contexto);
+size_t dqBuscarPrefixo(const DqBusca *b, const DqSessao *filtro, const char *prefixo,
+                       void (*visitar)(const char *pista, void *contexto), void *contexto);
+const char* dqImplementacaoBusca(const DqBusca *b);
+void dqLiberarBusca(DqBusca *b);
+
+/* Estatísticas do motor (contadores e histogramas somados de todas as
+   threads), existentes só se a biblioteca foi compilada com
+   DQ_ESTATISTICAS. O relatório é devolvido como texto, que deve ser
+   liberado com free(); NULL se o formato não for "json" nem "prometheus"
+   ou se faltar memória. */
+int dqEstatisticasAtivas(void);
+char* dqTextoEstatisticas(const char *formato);
+void dqZerarEstatisticas(void);
+
+#endif
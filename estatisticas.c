@@ -0,0 +1,241 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "estatisticas.h"
+
+/* Nomes usados nos relatórios (JSON e métricas dq_* do Prometheus). */
+static const char *const nomesContadores[EST_NUM_CONTADORES] = {
+    "buscas_internador", "pistas_inseridas", "movimentos",
+    "movimentos_invalidos", "sessoes", "contagens_suspeito"
+};
+
+static const char *const ajudaContadores[EST_NUM_CONTADORES] = {
+    "Consultas ao indice dos pools de strings",
+    "Nos novos na arvore de pistas",
+    "Movimentos validos",
+    "Movimentos invalidos",
+    "Sessoes encerradas ou reiniciadas depois de jogar",
+    "Chamadas de contarPistasParaSuspeito"
+};
+
+static const char *const nomesHistogramas[EST_NUM_HISTOGRAMAS] = {
+    "sondagens_internador", "profundidade_pista", "movimentos_sessao", "ns_contar_pistas"
+};
+
+static const char *const ajudaHistogramas[EST_NUM_HISTOGRAMAS] = {
+    "Posicoes visitadas por consulta ao indice dos pools de strings",
+    "Profundidade do no inserido na arvore de pistas",
+    "Movimentos por sessao encerrada",
+    "Nanossegundos por contarPistasParaSuspeito"
+};
+
+#ifdef DQ_ESTATISTICAS
+
+_Thread_local BlocoEstatisticas *estatisticasDaThread = NULL;
+
+/* Lista de blocos de todas as threads; só cresce, então pode ser
+   percorrida sem trava. */
+static BlocoEstatisticas *blocosRegistrados = NULL;
+
+/* registrarBlocoEstatisticas()
+   Cria o bloco da thread atual e o acrescenta à lista global. */
+BlocoEstatisticas* registrarBlocoEstatisticas(void) {
+    BlocoEstatisticas *b = (BlocoEstatisticas*) calloc(1, sizeof(BlocoEstatisticas));
+    if (b == NULL) {
+        printf("Erro ao alocar memoria para as estatisticas.\n");
+        exit(1);
+    }
+    b->proximo = __atomic_load_n(&blocosRegistrados, __ATOMIC_RELAXED);
+    while (!__atomic_compare_exchange_n(&blocosRegistrados, &b->proximo, b, 1,
+                                        __ATOMIC_RELEASE, __ATOMIC_RELAXED)) { }
+    estatisticasDaThread = b;
+    return b;
+}
+
+/* relogioEstatisticas()
+   Relógio monotônico em nanossegundos, para os histogramas de tempo. */
+uint64_t relogioEstatisticas(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+}
+
+#endif
+
+/* estatisticasAtivas()
+   1 se o motor foi compilado com DQ_ESTATISTICAS. */
+int estatisticasAtivas(void) {
+#ifdef DQ_ESTATISTICAS
+    return 1;
+#else
+    return 0;
+#endif
+}
+
+/* somarEstatisticas()
+   Soma os blocos de todas as threads em total. As threads podem continuar
+   contando enquanto isso; cada número lido é um valor recente, mas o
+   total não é um retrato instantâneo de todos ao mesmo tempo. */
+void somarEstatisticas(BlocoEstatisticas *total) {
+    memset(total, 0, sizeof(*total));
+#ifdef DQ_ESTATISTICAS
+    for (BlocoEstatisticas *b = __atomic_load_n(&blocosRegistrados, __ATOMIC_ACQUIRE); b != NULL; b = b->proximo) {
+        for (int c = 0; c < EST_NUM_CONTADORES; ++c)
+            total->contadores[c] += __atomic_load_n(&b->contadores[c], __ATOMIC_RELAXED);
+        for (int h = 0; h < EST_NUM_HISTOGRAMAS; ++h) {
+            const HistogramaValores *origem = &b->histogramas[h];
+            HistogramaValores *destino = &total->histogramas[h];
+            destino->quantidade += __atomic_load_n(&origem->quantidade, __ATOMIC_RELAXED);
+            destino->soma += __atomic_load_n(&origem->soma, __ATOMIC_RELAXED);
+            for (int i = 0; i < EST_BALDES; ++i)
+                destino->baldes[i] += __atomic_load_n(&origem->baldes[i], __ATOMIC_RELAXED);
+        }
+    }
+#endif
+}
+
+/* zerarEstatisticas()
+   Zera os blocos de todas as threads. Um incremento simultâneo de outra
+   thread pode sobreviver ou se perder; para medir um trecho isolado,
+   chame com as demais threads paradas. */
+void zerarEstatisticas(void) {
+#ifdef DQ_ESTATISTICAS
+    for (BlocoEstatisticas *b = __atomic_load_n(&blocosRegistrados, __ATOMIC_ACQUIRE); b != NULL; b = b->proximo) {
+        for (int c = 0; c < EST_NUM_CONTADORES; ++c) __atomic_store_n(&b->contadores[c], 0, __ATOMIC_RELAXED);
+        for (int h = 0; h < EST_NUM_HISTOGRAMAS; ++h) {
+            HistogramaValores *hist = &b->histogramas[h];
+            __atomic_store_n(&hist->quantidade, 0, __ATOMIC_RELAXED);
+            __atomic_store_n(&hist->soma, 0, __ATOMIC_RELAXED);
+            for (int i = 0; i < EST_BALDES; ++i) __atomic_store_n(&hist->baldes[i], 0, __ATOMIC_RELAXED);
+        }
+    }
+#endif
+}
+
+/* lerFormatoEstatisticas()
+   Converte "json" ou "prometheus"; retorna -1 para outros nomes. */
+int lerFormatoEstatisticas(const char *nome, FormatoEstatisticas *formato) {
+    if (strcmp(nome, "json") == 0) *formato = EST_FORMATO_JSON;
+    else if (strcmp(nome, "prometheus") == 0) *formato = EST_FORMATO_PROMETHEUS;
+    else return -1;
+    return 0;
+}
+
+/* limiteBalde()
+   Maior valor que cabe no balde b (b bits significativos). */
+static uint64_t limiteBalde(int b) {
+    return b == 0 ? 0 : (b >= 64 ? UINT64_MAX : (UINT64_C(1) << b) - 1);
+}
+
+/* escreverJson()
+   Relatório em JSON; cada histograma lista só os baldes não vazios, com o
+   maior valor de cada um ("ate"). */
+static void escreverJson(FILE *saida, const BlocoEstatisticas *total) {
+    fprintf(saida, "{\"ativadas\": %s", estatisticasAtivas() ? "true" : "false");
+    if (!estatisticasAtivas()) {
+        fprintf(saida, "}\n");
+        return;
+    }
+    fprintf(saida, ",\n \"contadores\": {");
+    for (int c = 0; c < EST_NUM_CONTADORES; ++c)
+        fprintf(saida, "%s\n  \"%s\": %llu", c ? "," : "", nomesContadores[c],
+                (unsigned long long) total->contadores[c]);
+    fprintf(saida, "\n },\n \"histogramas\": {");
+    for (int h = 0; h < EST_NUM_HISTOGRAMAS; ++h) {
+        const HistogramaValores *hist = &total->histogramas[h];
+        fprintf(saida, "%s\n  \"%s\": {\"quantidade\": %llu, \"soma\": %llu, \"baldes\": [", h ? "," : "",
+                nomesHistogramas[h], (unsigned long long) hist->quantidade, (unsigned long long) hist->soma);
+        int primeiro = 1;
+        for (int b = 0; b < EST_BALDES; ++b) {
+            if (hist->baldes[b] == 0) continue;
+            fprintf(saida, "%s{\"ate\": %llu, \"quantidade\": %llu}", primeiro ? "" : ", ",
+                    (unsigned long long) (b == EST_BALDES - 1 ? UINT64_MAX : limiteBalde(b)),
+                    (unsigned long long) hist->baldes[b]);
+            primeiro = 0;
+        }
+        fprintf(saida, "]}");
+    }
+    fprintf(saida, "\n }\n}\n");
+}
+
+/* escreverPrometheus()
+   Relatório no formato de texto do Prometheus: contadores dq_*_total e
+   histogramas com baldes cumulativos até o último não vazio. */
+static void escreverPrometheus(FILE *saida, const BlocoEstatisticas *total) {
+    if (!estatisticasAtivas()) {
+        fprintf(saida, "# estatisticas desligadas (compile com DQ_ESTATISTICAS)\n");
+        return;
+    }
+    for (int c = 0; c < EST_NUM_CONTADORES; ++c) {
+        fprintf(saida, "# HELP dq_%s_total %s\n# TYPE dq_%s_total counter\ndq_%s_total %llu\n",
+                nomesContadores[c], ajudaContadores[c], nomesContadores[c], nomesContadores[c],
+                (unsigned long long) total->contadores[c]);
+    }
+    for (int h = 0; h < EST_NUM_HISTOGRAMAS; ++h) {
+        const HistogramaValores *hist = &total->histogramas[h];
+        const char *nome = nomesHistogramas[h];
+        fprintf(saida, "# HELP dq_%s %s\n# TYPE dq_%s histogram\n", nome, ajudaHistogramas[h], nome);
+        int ultimo = -1;
+        for (int b = 0; b < EST_BALDES - 1; ++b)
+            if (hist->baldes[b] != 0) ultimo = b;
+        uint64_t acumulado = 0;
+        for (int b = 0; b <= ultimo; ++b) {
+            acumulado += hist->baldes[b];
+            fprintf(saida, "dq_%s_bucket{le=\"%llu\"} %llu\n", nome, (unsigned long long) limiteBalde(b),
+                    (unsigned long long) acumulado);
+        }
+        fprintf(saida, "dq_%s_bucket{le=\"+Inf\"} %llu\ndq_%s_sum %llu\ndq_%s_count %llu\n", nome,
+                (unsigned long long) hist->quantidade, nome, (unsigned long long) hist->soma, nome,
+                (unsigned long long) hist->quantidade);
+    }
+}
+
+/* escreverEstatisticas()
+   Soma as estatísticas de todas as threads e escreve o relatório. */
+void escreverEstatisticas(FILE *saida, FormatoEstatisticas formato) {
+    BlocoEstatisticas total;
+    somarEstatisticas(&total);
+    if (formato == EST_FORMATO_JSON) escreverJson(saida, &total);
+    else escreverPrometheus(saida, &total);
+    fflush(saida);
+}
+
+/* Relatório pedido por escreverEstatisticasAoSair(). */
+static FormatoEstatisticas formatoAoSair;
+static char caminhoAoSair[1024];
+
+/* relatarAoSair()
+   Tratador do atexit(): escreve o relatório no arquivo ou na saída de erro. */
+static void relatarAoSair(void) {
+    FILE *saida = caminhoAoSair[0] != '\0' ? fopen(caminhoAoSair, "w") : stderr;
+    if (saida == NULL) {
+        fprintf(stderr, "Erro ao gravar as estatisticas em %s.\n", caminhoAoSair);
+        return;
+    }
+    escreverEstatisticas(saida, formatoAoSair);
+    if (saida != stderr) fclose(saida);
+}
+
+/* escreverEstatisticasAoSair()
+   Pede o relatório no fim do programa. destino é "FORMATO" (na saída de
+   erro) ou "FORMATO:arquivo", com FORMATO json ou prometheus.
+   Retorna -1 se o formato não for conhecido. */
+int escreverEstatisticasAoSair(const char *destino) {
+    static int registrado = 0;
+    char nome[16];
+    const char *separador = strchr(destino, ':');
+    size_t tam = separador != NULL ? (size_t) (separador - destino) : strlen(destino);
+    if (tam >= sizeof(nome)) return -1;
+    memcpy(nome, destino, tam);
+    nome[tam] = '\0';
+    if (lerFormatoEstatisticas(nome, &formatoAoSair) != 0) return -1;
+    snprintf(caminhoAoSair, sizeof(caminhoAoSair), "%s", separador != NULL ? separador + 1 : "");
+    if (!registrado) {
+        atexit(relatarAoSair);
+        registrado = 1;
+    }
+    return 0;
+}
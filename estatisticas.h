@@ -0,0 +1,121 @@
+#ifndef ESTATISTICAS_H
+#define ESTATISTICAS_H
+
+#include <stdint.h>
+#include <stdio.h>
+
+/* ===================== ESTATÍSTICAS DE EXECUÇÃO ===================== */
+
+/* Contadores e histogramas dos caminhos quentes do motor: sondagens no
+   índice dos pools de strings, profundidade das inserções na árvore de
+   pistas, movimentos por sessão e tempo de contarPistasParaSuspeito().
+
+   Só existem quando o projeto é compilado com -DDQ_ESTATISTICAS (opção
+   DQ_ESTATISTICAS do CMake). Sem ela as macros EST_* não geram código e
+   os relatórios apenas dizem que as estatísticas estão desligadas.
+
+   Cada thread escreve no seu próprio bloco, sem travas nem operações
+   atômicas de leitura-modificação-escrita; o bloco é criado no primeiro
+   uso e entra numa lista global que nunca encolhe (os números de threads
+   já encerradas continuam contando). somarEstatisticas() soma todos os
+   blocos quando alguém pede um relatório.
+
+   Histogramas usam baldes de potência de 2: o balde b guarda os valores
+   com b bits significativos (0; 1; 2-3; 4-7; ...); o último também
+   guarda tudo o que for maior. */
+
+typedef enum {
+    EST_BUSCAS_INTERNADOR,      // consultas ao índice dos pools de strings
+    EST_PISTAS_INSERIDAS,       // nós novos na árvore de pistas
+    EST_MOVIMENTOS,
+    EST_MOVIMENTOS_INVALIDOS,
+    EST_SESSOES,                // sessões encerradas ou reiniciadas depois de jogar
+    EST_CONTAGENS_SUSPEITO,     // chamadas de contarPistasParaSuspeito()
+    EST_NUM_CONTADORES
+} ContadorEstatistica;
+
+typedef enum {
+    EST_SONDAGENS_INTERNADOR,   // posições visitadas por consulta ao índice
+    EST_PROFUNDIDADE_PISTA,     // profundidade do nó inserido na árvore de pistas
+    EST_MOVIMENTOS_SESSAO,      // movimentos de cada sessão encerrada
+    EST_NS_CONTAR_PISTAS,       // nanossegundos por contarPistasParaSuspeito()
+    EST_NUM_HISTOGRAMAS
+} HistogramaEstatistica;
+
+#define EST_BALDES 33
+
+typedef struct HistogramaValores {
+    uint64_t quantidade;
+    uint64_t soma;
+    uint64_t baldes[EST_BALDES];
+} HistogramaValores;
+
+/* Estatísticas de uma thread, ou a soma de todas. */
+typedef struct BlocoEstatisticas {
+    uint64_t contadores[EST_NUM_CONTADORES];
+    HistogramaValores histogramas[EST_NUM_HISTOGRAMAS];
+    struct BlocoEstatisticas *proximo;
+} BlocoEstatisticas;
+
+typedef enum {
+    EST_FORMATO_JSON,
+    EST_FORMATO_PROMETHEUS
+} FormatoEstatisticas;
+
+int estatisticasAtivas(void);
+void somarEstatisticas(BlocoEstatisticas *total);
+void zerarEstatisticas(void);
+int lerFormatoEstatisticas(const char *nome, FormatoEstatisticas *formato);
+void escreverEstatisticas(FILE *saida, FormatoEstatisticas formato);
+int escreverEstatisticasAoSair(const char *destino);
+
+#ifdef DQ_ESTATISTICAS
+
+extern _Thread_local BlocoEstatisticas *estatisticasDaThread;
+BlocoEstatisticas* registrarBlocoEstatisticas(void);
+uint64_t relogioEstatisticas(void);
+
+/* blocoEstatisticas()
+   Bloco da thread atual, criado no primeiro uso. */
+static inline BlocoEstatisticas* blocoEstatisticas(void) {
+    BlocoEstatisticas *b = estatisticasDaThread;
+    return b != NULL ? b : registrarBlocoEstatisticas();
+}
+
+/* somarValor()
+   Soma ao valor de um bloco. Só a thread dona escreve nele; as escritas e
+   leituras atômicas relaxadas (movs simples no x86) deixam os relatórios
+   lerem de outras threads sem condição de corrida. */
+static inline void somarValor(uint64_t *valor, uint64_t v) {
+    __atomic_store_n(valor, __atomic_load_n(valor, __ATOMIC_RELAXED) + v, __ATOMIC_RELAXED);
+}
+
+static inline void somarContador(ContadorEstatistica c, uint64_t v) {
+    somarValor(&blocoEstatisticas()->contadores[c], v);
+}
+
+/* registrarValor()
+   Acrescenta um valor ao histograma. */
+static inline void registrarValor(HistogramaEstatistica h, uint64_t v) {
+    HistogramaValores *hist = &blocoEstatisticas()->histogramas[h];
+    unsigned balde = v != 0 ? 64 - (unsigned) __builtin_clzll(v) : 0;
+    somarValor(&hist->quantidade, 1);
+    somarValor(&hist->soma, v);
+    somarValor(&hist->baldes[balde < EST_BALDES ? balde : EST_BALDES - 1], 1);
+}
+
+#define EST_CONTAR(contador, v) somarContador((contador), (v))
+#define EST_REGISTRAR(histograma, v) registrarValor((histograma), (v))
+#define EST_MARCAR_TEMPO(marca) uint64_t marca = relogioEstatisticas()
+#define EST_REGISTRAR_TEMPO(histograma, marca) registrarValor((histograma), relogioEstatisticas() - (marca))
+
+#else
+
+#define EST_CONTAR(contador, v) ((void) 0)
+#define EST_REGISTRAR(histograma, v) ((void) 0)
+#define EST_MARCAR_TEMPO(marca) ((void) 0)
+#define EST_REGISTRAR_TEMPO(histograma, marca) ((void) 0)
+
+#endif
+
+#endif
@@ -0,0 +1,123 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "gerador_mansao.h"
+
+/* Vaga livre para uma sala nova na forma aleatória. */
+typedef struct VagaSala {
+    uint32_t sala;
+    uint32_t direita;
+} VagaSala;
+
+/* nomeForma() / lerForma()
+   Conversão entre a forma e o nome usado na linha de comando.
+   lerForma() retorna -1 para nome inválido. */
+const char* nomeForma(FormaMansao forma) {
+    switch (forma) {
+    case FORMA_BALANCEADA: return "balanceada";
+    case FORMA_DEGENERADA: return "degenerada";
+    default: return "aleatoria";
+    }
+}
+
+int lerForma(const char *nome, FormaMansao *forma) {
+    if (strcmp(nome, "balanceada") == 0) *forma = FORMA_BALANCEADA;
+    else if (strcmp(nome, "degenerada") == 0) *forma = FORMA_DEGENERADA;
+    else if (strcmp(nome, "aleatoria") == 0) *forma = FORMA_ALEATORIA;
+    else return -1;
+    return 0;
+}
+
+/* gerarCatalogo()
+   Insere no mapa as associações pista -> suspeito do catálogo sintético.
+   Os textos têm tamanhos variados, como pistas escritas à mão. */
+void gerarCatalogo(MapaCarregado *mapa, const ParametrosGerador *p, uint64_t *estado) {
+    static const char *objetos[] = {
+        "Pegadas", "Um copo quebrado", "Uma colher suja", "Um livro rasgado",
+        "Uma luva", "Perfume forte", "Uma carta queimada", "Um relogio parado"
+    };
+    static const char *lugares[] = {
+        "no tapete", "perto da lareira", "sob a escada", "atras da cortina",
+        "no jardim de inverno", "dentro do cofre"
+    };
+    char pista[128], suspeito[32];
+    uint32_t numSuspeitos = p->numSuspeitos ? p->numSuspeitos : 1;
+    for (uint32_t i = 0; i < p->numPistas; ++i) {
+        snprintf(pista, sizeof(pista), "%s %s #%u", objetos[proximoAleatorio(estado) % 8],
+                 lugares[proximoAleatorio(estado) % 6], i);
+        uint32_t primeiro = proximoAleatorio(estado) % numSuspeitos;
+        snprintf(suspeito, sizeof(suspeito), "Suspeito %u", primeiro);
+        if (p->suspeitosPorPista <= 1) {
+            inserirNaHash(&mapa->tabela, pista, suspeito);
+            continue;
+        }
+        // suspeitos seguidos a partir do sorteado, sem repetir, com pesos de 1 a 9
+        for (uint32_t k = 0; k < p->suspeitosPorPista && k < numSuspeitos; ++k) {
+            snprintf(suspeito, sizeof(suspeito), "Suspeito %u", (primeiro + k) % numSuspeitos);
+            inserirPesoNaHash(&mapa->tabela, pista, suspeito, 1 + proximoAleatorio(estado) % 9);
+        }
+    }
+}
+
+/* gerarSalas()
+   Cria as salas com criarSala(), liga os filhos conforme a forma e sorteia
+   as passagens. O catálogo já deve ter sido gerado. */
+void gerarSalas(MapaCarregado *mapa, const ParametrosGerador *p, uint64_t *estado) {
+    Mansao *m = &mapa->mansao;
+    uint32_t numPistas = m->pistas.quantidade;
+    char nome[32];
+    for (uint32_t i = 0; i < p->numSalas; ++i) {
+        const char *pista = NULL;
+        if (numPistas > 0 && proximoAleatorio(estado) % 4 != 0)
+            pista = textoInternado(&m->pistas, proximoAleatorio(estado) % numPistas);
+        snprintf(nome, sizeof(nome), "Sala %u", i);
+        criarSala(m, nome, pista);
+    }
+
+    uint32_t n = m->numSalas;
+    if (p->forma == FORMA_BALANCEADA) {
+        for (uint32_t i = 0; i < n; ++i) {
+            uint64_t e = 2 * (uint64_t) i + 1, d = e + 1;
+            conectarSalas(m, i, e < n ? (uint32_t) e : SEM_SALA, d < n ? (uint32_t) d : SEM_SALA);
+        }
+    } else if (p->forma == FORMA_DEGENERADA) {
+        for (uint32_t i = 0; i < n; ++i)
+            conectarSalas(m, i, i + 1 < n ? i + 1 : SEM_SALA, SEM_SALA);
+    } else {
+        // cada sala nova consome uma vaga e abre duas
+        VagaSala *vagas = (VagaSala*) realocarOuSair(NULL, ((size_t) n + 2) * sizeof(VagaSala), "o gerador");
+        uint32_t numVagas = 0;
+        if (n > 0) {
+            vagas[numVagas++] = (VagaSala) { 0, 0 };
+            vagas[numVagas++] = (VagaSala) { 0, 1 };
+        }
+        for (uint32_t i = 1; i < n; ++i) {
+            uint32_t v = proximoAleatorio(estado) % numVagas;
+            VagaSala vaga = vagas[v];
+            vagas[v] = vagas[--numVagas];
+            if (vaga.direita) m->salas[vaga.sala].direita = i;
+            else m->salas[vaga.sala].esquerda = i;
+            vagas[numVagas++] = (VagaSala) { i, 0 };
+            vagas[numVagas++] = (VagaSala) { i, 1 };
+        }
+        free(vagas);
+    }
+
+    // sem passagens, a sequência sorteada é a mesma de antes delas existirem
+    for (uint32_t i = 0; n > 0 && i < p->numPassagens; ++i) {
+        uint32_t origem = proximoAleatorio(estado) % n;
+        criarPassagem(m, origem, proximoAleatorio(estado) % n);
+    }
+}
+
+/* gerarMansao()
+   Monta no mapa (não inicializado) uma mansão sintética completa. */
+void gerarMansao(MapaCarregado *mapa, const ParametrosGerador *p) {
+    uint64_t estado = iniciarAleatorio(p->semente);
+    inicializarMapa(mapa);
+    gerarCatalogo(mapa, p, &estado);
+    gerarSalas(mapa, p, &estado);
+    finalizarMapa(mapa);
+}
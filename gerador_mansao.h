@@ -0,0 +1,70 @@
+#ifndef GERADOR_MANSAO_H
+#define GERADOR_MANSAO_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "carregador.h"
+
+/* ===================== GERADOR DE MANSÕES SINTÉTICAS ===================== */
+
+/* Gera mansões de tamanho arbitrário para benchmarks, sempre iguais para a
+   mesma semente:
+
+   - FORMA_BALANCEADA: árvore completa (filhos de i em 2i+1 e 2i+2).
+   - FORMA_DEGENERADA: uma única corrente de salas pela esquerda, o pior
+     caso para percursos e para quem usa recursão.
+   - FORMA_ALEATORIA: cada sala nova ocupa uma vaga livre (esquerda ou
+     direita de uma sala já criada) sorteada entre todas as vagas.
+
+   O catálogo tem numPistas pistas, cada uma associada a um de numSuspeitos
+   suspeitos; três de cada quatro salas recebem uma pista sorteada. Com
+   suspeitosPorPista acima de 1, cada pista implica também os suspeitos
+   seguintes ao sorteado, todos com pesos sorteados (tabela_hash.h).
+   Depois da árvore, numPassagens passagens (mansao.h) ligam pares de salas
+   sorteados, criando voltas e ciclos. */
+
+typedef enum {
+    FORMA_BALANCEADA,
+    FORMA_DEGENERADA,
+    FORMA_ALEATORIA
+} FormaMansao;
+
+typedef struct ParametrosGerador {
+    FormaMansao forma;
+    uint32_t numSalas;
+    uint32_t numPistas;
+    uint32_t numSuspeitos;
+    uint32_t numPassagens;
+    uint32_t suspeitosPorPista;   // 0 ou 1: só o suspeito principal, peso 1
+    uint64_t semente;
+} ParametrosGerador;
+
+/* proximoAleatorio()
+   Gerador xorshift64*: rápido e reprodutível em qualquer plataforma
+   (rand() muda de uma libc para outra). */
+static inline uint32_t proximoAleatorio(uint64_t *estado) {
+    uint64_t x = *estado;
+    x ^= x >> 12;
+    x ^= x << 25;
+    x ^= x >> 27;
+    *estado = x;
+    return (uint32_t) ((x * 0x2545F4914F6CDD1Dull) >> 32);
+}
+
+/* iniciarAleatorio()
+   Estado inicial do gerador a partir da semente (nunca zero). */
+static inline uint64_t iniciarAleatorio(uint64_t semente) {
+    uint64_t estado = semente * 0x9E3779B97F4A7C15ull + 1;
+    return estado != 0 ? estado : 1;
+}
+
+const char* nomeForma(FormaMansao forma);
+int lerForma(const char *nome, FormaMansao *forma);
+void gerarCatalogo(MapaCarregado *mapa, const ParametrosGerador *p, uint64_t *estado);
+void gerarSalas(MapaCarregado *mapa, const ParametrosGerador *p, uint64_t *estado);
+void gerarMansao(MapaCarregado *mapa, const ParametrosGerador *p);
+
+#endif
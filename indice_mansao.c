@@ -0,0 +1,283 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "indice_mansao.h"
+
+/* compararUint32()
+   Comparação para qsort() de uint32_t. */
+static int compararUint32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t*) a, y = *(const uint32_t*) b;
+    return (x > y) - (x < y);
+}
+
+/* alocarVetor()
+   Vetor de n uint32_t (pelo menos um, para nunca pedir 0 bytes). */
+static uint32_t* alocarVetor(size_t n) {
+    return (uint32_t*) realocarOuSair(NULL, (n ? n : 1) * sizeof(uint32_t), "o indice da mansao");
+}
+
+/* suspeitoDaSala()
+   Suspeito para o qual aponta a pista da sala, ou INTERNADOR_AUSENTE. */
+static uint32_t suspeitoDaSala(const Mansao *m, const TabelaHash *tabela, uint32_t sala) {
+    uint32_t pista = m->salas[sala].pista;
+    return pista != SEM_PISTA ? suspeitoDaPista(tabela, pista) : INTERNADOR_AUSENTE;
+}
+
+/* percorrerEuler()
+   Percurso em pré-ordem iterativo a partir da entrada, preenchendo entrada,
+   saida, profundidade e salaNaPosicao. caminho[posição] recebe, para salas
+   com suspeito, quantas salas do mesmo suspeito há no caminho desde a
+   entrada (ela inclusive). profundidade marca as salas já descobertas:
+   achar uma delas de novo por outro corredor (sala com dois pais, ou ciclo)
+   significa que a mansão não é uma árvore, e o percurso retorna -1. */
+static int percorrerEuler(IndiceMansao *indice, const Mansao *m, const TabelaHash *tabela,
+                          uint32_t *caminho) {
+    uint32_t *noCaminho = alocarVetor(numSuspeitos(tabela));
+    memset(noCaminho, 0, (size_t) numSuspeitos(tabela) * sizeof(uint32_t));
+    // cada item é sala * 2, mais 1 quando marca a saída da sala; cada sala
+    // entra uma vez, e a sua saída também
+    uint64_t *pilha = (uint64_t*) realocarOuSair(NULL, ((size_t) m->numSalas * 2 + 1) * sizeof(uint64_t),
+                                                 "o indice da mansao");
+    size_t topo = 0;
+    uint32_t pos = 0;
+
+    pilha[topo++] = (uint64_t) SALA_ENTRADA << 1;
+    indice->profundidade[SALA_ENTRADA] = 0;
+    while (topo > 0) {
+        uint64_t item = pilha[--topo];
+        uint32_t sala = (uint32_t) (item >> 1);
+        uint32_t suspeito = suspeitoDaSala(m, tabela, sala);
+        if (item & 1) {
+            indice->saida[sala] = pos;
+            if (suspeito != INTERNADOR_AUSENTE) noCaminho[suspeito]--;
+            continue;
+        }
+
+        indice->entrada[sala] = pos;
+        indice->salaNaPosicao[pos] = sala;
+        if (suspeito != INTERNADOR_AUSENTE) caminho[pos] = ++noCaminho[suspeito];
+        pos++;
+
+        pilha[topo++] = item | 1;
+        const Sala *s = &m->salas[sala];
+        uint32_t filhos[2] = { s->direita, s->esquerda };  // esquerda sai primeiro da pilha
+        for (int f = 0; f < 2; ++f) {
+            uint32_t filho = filhos[f];
+            if (filho == SEM_SALA) continue;
+            if (indice->profundidade[filho] != SEM_SALA) {
+                free(pilha);
+                free(noCaminho);
+                return -1;
+            }
+            indice->profundidade[filho] = indice->profundidade[sala] + 1;
+            pilha[topo++] = (uint64_t) filho << 1;
+        }
+    }
+    indice->numAlcancaveis = pos;
+    free(pilha);
+    free(noCaminho);
+    return 0;
+}
+
+/* montarArvoreSegmentos()
+   Completa a árvore de segmentos de n folhas já escritas em arvore[n..2n),
+   com o menor (maior = 0) ou o maior (maior = 1) valor de cada par. */
+static void montarArvoreSegmentos(uint32_t *arvore, uint32_t n, int maior) {
+    for (uint32_t i = n - 1; i >= 1; --i) {
+        uint32_t a = arvore[2 * i], b = arvore[2 * i + 1];
+        if (maior) arvore[i] = a > b ? a : b;
+        else arvore[i] = a < b ? a : b;
+    }
+}
+
+/* consultarArvoreSegmentos()
+   Menor (ou maior) valor das folhas [l, r) de uma árvore com n folhas. */
+static uint32_t consultarArvoreSegmentos(const uint32_t *arvore, uint32_t n, uint32_t l, uint32_t r, int maior) {
+    uint32_t resultado = maior ? 0 : UINT32_MAX;
+    for (l += n, r += n; l < r; l >>= 1, r >>= 1) {
+        if (l & 1) {
+            uint32_t v = arvore[l++];
+            if (maior ? v > resultado : v < resultado) resultado = v;
+        }
+        if (r & 1) {
+            uint32_t v = arvore[--r];
+            if (maior ? v > resultado : v < resultado) resultado = v;
+        }
+    }
+    return resultado;
+}
+
+/* construirIndice()
+   Monta o índice da mansão em O(n + k log k), com n salas e k salas com
+   pista de algum suspeito. A mansão e a tabela não podem mudar depois.
+   Retorna 0, ou -1 (com o índice vazio) se a mansão tem passagens ou se
+   alguma sala alcançável é chegada por mais de um corredor. */
+int construirIndice(IndiceMansao *indice, const Mansao *m, const TabelaHash *tabela) {
+    uint32_t n = m->numSalas;
+    uint32_t suspeitos = numSuspeitos(tabela);
+    memset(indice, 0, sizeof(*indice));
+    if (m->numPassagens > 0 || m->numCriadas > 0) return -1;
+    indice->numSalas = n;
+    indice->numSuspeitos = suspeitos;
+    indice->entrada = alocarVetor(n);
+    indice->saida = alocarVetor(n);
+    indice->profundidade = alocarVetor(n);
+    indice->salaNaPosicao = alocarVetor(n);
+    for (uint32_t i = 0; i < n; ++i) indice->entrada[i] = indice->saida[i] = indice->profundidade[i] = SEM_SALA;
+
+    uint32_t *caminho = alocarVetor(n);
+    indice->numAlcancaveis = 0;
+    if (n > 0 && percorrerEuler(indice, m, tabela, caminho) != 0) {
+        free(caminho);
+        liberarIndice(indice);
+        return -1;
+    }
+    uint32_t alcancaveis = indice->numAlcancaveis;
+
+    // salas com pista, em ordem de percurso, e quantas de cada suspeito
+    indice->pistasAte = alocarVetor((size_t) alcancaveis + 1);
+    indice->inicio = alocarVetor((size_t) suspeitos + 1);
+    memset(indice->inicio, 0, ((size_t) suspeitos + 1) * sizeof(uint32_t));
+    uint32_t comPista = 0;
+    for (uint32_t pos = 0; pos < alcancaveis; ++pos) {
+        uint32_t sala = indice->salaNaPosicao[pos];
+        indice->pistasAte[pos] = comPista;
+        if (m->salas[sala].pista == SEM_PISTA) continue;
+        comPista++;
+        uint32_t suspeito = suspeitoDaSala(m, tabela, sala);
+        if (suspeito != INTERNADOR_AUSENTE) indice->inicio[suspeito + 1]++;
+    }
+    indice->pistasAte[alcancaveis] = comPista;
+    indice->salasComPista = alocarVetor(comPista);
+    for (uint32_t pos = 0, k = 0; pos < alcancaveis; ++pos) {
+        uint32_t sala = indice->salaNaPosicao[pos];
+        if (m->salas[sala].pista != SEM_PISTA) indice->salasComPista[k++] = sala;
+    }
+
+    // ocorrências de cada suspeito, já em ordem de percurso
+    for (uint32_t s = 0; s < suspeitos; ++s) indice->inicio[s + 1] += indice->inicio[s];
+    uint32_t ocorrencias = indice->inicio[suspeitos];
+    indice->posicoes = alocarVetor(ocorrencias);
+    indice->fins = alocarVetor(ocorrencias);
+    indice->menorProfundidade = alocarVetor((size_t) ocorrencias * 2);
+    indice->maiorCaminho = alocarVetor((size_t) ocorrencias * 2);
+    uint32_t *proxima = alocarVetor(suspeitos);
+    memcpy(proxima, indice->inicio, (size_t) suspeitos * sizeof(uint32_t));
+    for (uint32_t pos = 0; pos < alcancaveis; ++pos) {
+        uint32_t sala = indice->salaNaPosicao[pos];
+        uint32_t suspeito = suspeitoDaSala(m, tabela, sala);
+        if (suspeito == INTERNADOR_AUSENTE) continue;
+        uint32_t k = proxima[suspeito]++;
+        uint32_t o = indice->inicio[suspeito];
+        uint32_t qtd = indice->inicio[suspeito + 1] - o;
+        indice->posicoes[k] = pos;
+        indice->fins[k] = indice->saida[sala];
+        // folhas das árvores de segmentos do suspeito (região [2o, 2o + 2qtd))
+        indice->menorProfundidade[2 * o + qtd + (k - o)] = indice->profundidade[sala];
+        indice->maiorCaminho[2 * o + qtd + (k - o)] = caminho[pos];
+    }
+    free(proxima);
+    free(caminho);
+
+    for (uint32_t s = 0; s < suspeitos; ++s) {
+        uint32_t o = indice->inicio[s];
+        uint32_t qtd = indice->inicio[s + 1] - o;
+        if (qtd == 0) continue;
+        qsort(indice->fins + o, qtd, sizeof(uint32_t), compararUint32);
+        montarArvoreSegmentos(indice->menorProfundidade + 2 * o, qtd, 0);
+        montarArvoreSegmentos(indice->maiorCaminho + 2 * o, qtd, 1);
+    }
+    return 0;
+}
+
+/* limiteInferior() / limiteSuperior()
+   Primeira posição do vetor crescente com valor >= v (ou > v). */
+static uint32_t limiteInferior(const uint32_t *v, uint32_t n, uint32_t valor) {
+    uint32_t l = 0, r = n;
+    while (l < r) {
+        uint32_t meio = l + (r - l) / 2;
+        if (v[meio] < valor) l = meio + 1;
+        else r = meio;
+    }
+    return l;
+}
+
+static uint32_t limiteSuperior(const uint32_t *v, uint32_t n, uint32_t valor) {
+    return limiteInferior(v, n, valor + 1);
+}
+
+/* ocorrenciasAbaixo()
+   Intervalo [*l, *r) (relativo ao suspeito) das salas do suspeito que estão
+   na subárvore da sala. */
+static void ocorrenciasAbaixo(const IndiceMansao *indice, uint32_t sala, uint32_t suspeito,
+                              uint32_t *l, uint32_t *r) {
+    const uint32_t *pos = indice->posicoes + indice->inicio[suspeito];
+    uint32_t qtd = indice->inicio[suspeito + 1] - indice->inicio[suspeito];
+    *l = limiteInferior(pos, qtd, indice->entrada[sala]);
+    *r = limiteInferior(pos, qtd, indice->saida[sala]);
+}
+
+/* evidenciasAbaixo()
+   Quantas salas da subárvore (a própria inclusive) têm pista contra o
+   suspeito. O(log n). */
+uint32_t evidenciasAbaixo(const IndiceMansao *indice, uint32_t sala, uint32_t suspeito) {
+    if (suspeito >= indice->numSuspeitos) return 0;
+    uint32_t l, r;
+    ocorrenciasAbaixo(indice, sala, suspeito, &l, &r);
+    return r - l;
+}
+
+/* distanciaPistaSuspeito()
+   Quantas salas separam a sala da pista mais próxima contra o suspeito na
+   sua subárvore (0 se a própria sala tem uma), ou INDICE_INALCANCAVEL.
+   O(log n). */
+uint32_t distanciaPistaSuspeito(const IndiceMansao *indice, uint32_t sala, uint32_t suspeito) {
+    if (suspeito >= indice->numSuspeitos) return INDICE_INALCANCAVEL;
+    uint32_t l, r;
+    ocorrenciasAbaixo(indice, sala, suspeito, &l, &r);
+    if (l == r) return INDICE_INALCANCAVEL;
+    uint32_t o = indice->inicio[suspeito];
+    uint32_t qtd = indice->inicio[suspeito + 1] - o;
+    return consultarArvoreSegmentos(indice->menorProfundidade + 2 * o, qtd, l, r, 0) - indice->profundidade[sala];
+}
+
+/* melhorCaminhoSuspeito()
+   Maior número de salas com pista contra o suspeito que um único caminho
+   descendo a partir da sala (ela inclusive) consegue visitar. O(log n).
+
+   caminho[v] conta as salas do suspeito da entrada até v; o melhor caminho
+   é o maior caminho[v] da subárvore menos as salas do suspeito acima da
+   sala. Essas são os intervalos [entrada, saida) de salas do suspeito que
+   contêm entrada[sala]: como os intervalos são aninhados, são os que
+   começam até ela menos os que já terminaram. */
+uint32_t melhorCaminhoSuspeito(const IndiceMansao *indice, uint32_t sala, uint32_t suspeito) {
+    if (suspeito >= indice->numSuspeitos) return 0;
+    uint32_t l, r;
+    ocorrenciasAbaixo(indice, sala, suspeito, &l, &r);
+    if (l == r) return 0;
+    uint32_t o = indice->inicio[suspeito];
+    uint32_t qtd = indice->inicio[suspeito + 1] - o;
+    uint32_t p = indice->entrada[sala];
+    uint32_t contem = limiteSuperior(indice->posicoes + o, qtd, p) - limiteSuperior(indice->fins + o, qtd, p);
+    uint32_t acima = contem - (indice->posicoes[o + l] == p);
+    return consultarArvoreSegmentos(indice->maiorCaminho + 2 * o, qtd, l, r, 1) - acima;
+}
+
+/* liberarIndice()
+   Libera todos os vetores do índice. */
+void liberarIndice(IndiceMansao *indice) {
+    free(indice->entrada);
+    free(indice->saida);
+    free(indice->profundidade);
+    free(indice->salaNaPosicao);
+    free(indice->pistasAte);
+    free(indice->salasComPista);
+    free(indice->inicio);
+    free(indice->posicoes);
+    free(indice->fins);
+    free(indice->menorProfundidade);
+    free(indice->maiorCaminho);
+    memset(indice, 0, sizeof(*indice));
+}
@@ -0,0 +1,98 @@
+#ifndef INDICE_MANSAO_H
+#define INDICE_MANSAO_H
+
+#include <stdint.h>
+
+#include "mansao.h"
+#include "tabela_hash.h"
+
+/* ===================== ÍNDICE DE ALCANCE DA MANSÃO ===================== */
+
+/* Pré-processamento único da árvore de salas para responder, sem percorrer
+   a mansão de novo, perguntas sobre o que ainda pode ser alcançado a partir
+   de uma sala (o jogador só desce, então "alcançável" é a subárvore).
+
+   Percurso de Euler: um percurso em pré-ordem a partir da entrada dá a cada
+   sala a posição entrada[sala]; a subárvore ocupa o intervalo contíguo
+   [entrada[sala], saida[sala]). Assim "y está abaixo de x" e "quantas pistas
+   há abaixo de x" são O(1), e as salas com pista abaixo de x são um trecho
+   contíguo de salasComPista.
+
+   Por suspeito, as salas cuja pista aponta para ele ficam (em ordem de
+   percurso) numa lista compacta, com uma árvore de segmentos para a menor
+   profundidade e outra para o maior número de salas do suspeito num caminho
+   da entrada até a sala. Com buscas binárias nessa lista, as contagens por
+   subárvore, a distância até a pista mais próxima e o melhor caminho para
+   baixo custam O(log n).
+
+   As contagens são de salas: se o mesmo texto de pista aparece em várias
+   salas, cada sala conta. Salas que não são alcançáveis a partir da entrada
+   ficam fora do índice (entrada[sala] == SEM_SALA) e não podem ser
+   consultadas. As evidências contam só o suspeito principal de cada
+   pista, sem os pesos (tabela_hash.h).
+
+   Subárvore só é "o que o jogador alcança" numa árvore: o índice é montado
+   apenas para mansões sem passagens em que cada sala alcançável tem um só
+   corredor chegando nela (a entrada, nenhum). construirIndice() recusa as
+   outras, com salas compartilhadas ou ciclos, em vez de responder errado. */
+
+/* Retorno das consultas de distância quando não há pista alcançável. */
+#define INDICE_INALCANCAVEL UINT32_MAX
+
+typedef struct IndiceMansao {
+    uint32_t numSalas;
+    uint32_t numAlcancaveis;
+    uint32_t *entrada;           // entrada[sala] -> posição no percurso
+    uint32_t *saida;             // fim (exclusivo) do intervalo da subárvore
+    uint32_t *profundidade;      // profundidade[sala] (entrada = 0)
+    uint32_t *salaNaPosicao;     // salaNaPosicao[posição] -> sala
+    uint32_t *pistasAte;         // salas com pista antes da posição (numAlcancaveis + 1)
+    uint32_t *salasComPista;     // salas com pista, em ordem de percurso
+
+    // por suspeito, em formato compacto: ocorrências de inicio[s] a inicio[s + 1]
+    uint32_t numSuspeitos;
+    uint32_t *inicio;            // numSuspeitos + 1
+    uint32_t *posicoes;          // entrada das salas do suspeito, crescente
+    uint32_t *fins;              // saida das mesmas salas, em ordem crescente
+    uint32_t *menorProfundidade; // árvore de segmentos (2 por ocorrência)
+    uint32_t *maiorCaminho;      // árvore de segmentos (2 por ocorrência)
+} IndiceMansao;
+
+int construirIndice(IndiceMansao *indice, const Mansao *m, const TabelaHash *tabela);
+void liberarIndice(IndiceMansao *indice);
+
+/* salaAlcancavel()
+   Indica se a sala é alcançável a partir da entrada. */
+static inline int salaAlcancavel(const IndiceMansao *indice, uint32_t sala) {
+    return indice->entrada[sala] != SEM_SALA;
+}
+
+/* salaAbaixoDe()
+   Indica se a sala y está na subárvore de x (x inclusive). O(1). */
+static inline int salaAbaixoDe(const IndiceMansao *indice, uint32_t x, uint32_t y) {
+    uint32_t e = indice->entrada[y];
+    return e != SEM_SALA && indice->entrada[x] <= e && e < indice->saida[x];
+}
+
+/* salasAbaixo()
+   Número de salas na subárvore (a própria sala inclusive). O(1). */
+static inline uint32_t salasAbaixo(const IndiceMansao *indice, uint32_t sala) {
+    return indice->saida[sala] - indice->entrada[sala];
+}
+
+/* pistasAbaixo()
+   Número de salas com pista na subárvore. O(1). As salas são
+   salasComPista[primeiraPistaAbaixo(...)] em diante. */
+static inline uint32_t pistasAbaixo(const IndiceMansao *indice, uint32_t sala) {
+    return indice->pistasAte[indice->saida[sala]] - indice->pistasAte[indice->entrada[sala]];
+}
+
+static inline uint32_t primeiraPistaAbaixo(const IndiceMansao *indice, uint32_t sala) {
+    return indice->pistasAte[indice->entrada[sala]];
+}
+
+uint32_t evidenciasAbaixo(const IndiceMansao *indice, uint32_t sala, uint32_t suspeito);
+uint32_t distanciaPistaSuspeito(const IndiceMansao *indice, uint32_t sala, uint32_t suspeito);
+uint32_t melhorCaminhoSuspeito(const IndiceMansao *indice, uint32_t sala, uint32_t suspeito);
+
+#endif
@@ -0,0 +1,197 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "interface.h"
+#include "registro_eventos.h"
+
+/* lerEscolha()
+   Lê a opção do menu e descarta o resto da linha, para que leituras
+   seguintes com fgets() comecem numa linha nova. O fim da entrada conta
+   como 's' (sair). */
+char lerEscolha(void) {
+    char escolha;
+    if (scanf(" %c", &escolha) != 1) return 's';
+    int c;
+    while ((c = getchar()) != '\n' && c != EOF) { /* limpa buffer */ }
+    return escolha;
+}
+
+/* exibirAbertura()
+   Boas-vindas do jogo (no protocolo, a linha de versão). objetivo é a
+   última linha do texto, que muda com o nível. */
+void exibirAbertura(const Renderizador *r, const char *objetivo) {
+    if (r->formato == SAIDA_PROTOCOLO) {
+        printf("protocolo\t%d\n", PROTOCOLO_VERSAO);
+        return;
+    }
+    printf("=== DETECTIVE QUEST ===\n");
+    printf("Bem-vindo à mansão misteriosa!\n");
+    printf("%s\n", objetivo);
+}
+
+/* explorarSalas()
+   Permite que o jogador navegue pela mansão interativamente.
+   O jogador escolhe 'e' para esquerda, 'd' para direita, '1'..'9' para as
+   passagens da sala ou 's' para sair.
+   Cada jogada sai do renderizador numa única escrita. */
+void explorarSalas(DqSessao *sessao, Renderizador *r) {
+    while (1) {
+        renderizarSala(r, dqIdSalaAtual(sessao));
+
+        // Caso o cômodo não tenha saídas, fim da exploração (o quadro já avisa)
+        if (dqCaminho(sessao, 'e') == NULL && dqCaminho(sessao, 'd') == NULL && dqCaminho(sessao, '1') == NULL) {
+            descarregarRenderizador(r);
+            break;
+        }
+
+        descarregarRenderizador(r);
+        DqMovimento mv = dqMover(sessao, lerEscolha());
+        if (mv == DQ_MOVIMENTO_SAIR) {
+            renderizarEvento(r, EVENTO_SAIR);
+            descarregarRenderizador(r);
+            break;
+        }
+        if (mv == DQ_MOVIMENTO_INVALIDO) renderizarEvento(r, EVENTO_INVALIDO);
+    }
+}
+
+/* explorarSalasComPistas()
+   Como explorarSalas(), mas cada sala visitada adiciona sua pista (se
+   existir) às pistas da sessão. O quadro da sala já traz a pista.
+   Com um registro de eventos aberto, movimentos e pistas entram nele. */
+void explorarSalasComPistas(DqSessao *sessao, Renderizador *r) {
+    int registrar = registroEventosAtivo();
+    if (registrar) registrarInicio(REGISTRO_SESSAO_INTERATIVA, dqIdSalaAtual(sessao));
+    while (1) {
+        // coleta automática da pista da sala
+        if (dqColetar(sessao) != NULL && registrar) registrarPista(REGISTRO_SESSAO_INTERATIVA, dqIdSalaAtual(sessao));
+        renderizarSala(r, dqIdSalaAtual(sessao));
+
+        descarregarRenderizador(r);
+        char escolha = lerEscolha();
+        DqMovimento mv = dqMover(sessao, escolha);
+        if (mv == DQ_MOVIMENTO_SAIR) {
+            renderizarEvento(r, EVENTO_SAIR);
+            descarregarRenderizador(r);
+            break;
+        }
+        if (registrar) registrarMovimento(REGISTRO_SESSAO_INTERATIVA, dqIdSalaAtual(sessao), escolha, mv == DQ_MOVIMENTO_OK);
+        if (mv == DQ_MOVIMENTO_INVALIDO) renderizarEvento(r, EVENTO_INVALIDO);
+    }
+    if (registrar) registrarFim(REGISTRO_SESSAO_INTERATIVA, dqIdSalaAtual(sessao));
+}
+
+/* imprimirPista()
+   Visitante usado por exibirPistas(); o contexto é o formato de saída. */
+static void imprimirPista(const char *pista, void *contexto) {
+    const Renderizador *r = (const Renderizador*) contexto;
+    printf(r->formato == SAIDA_PROTOCOLO ? "pista\t%s\n" : " - %s\n", pista);
+}
+
+/* exibirPistas()
+   Exibe as pistas coletadas em ordem alfabética. */
+void exibirPistas(const DqSessao *sessao, const Renderizador *r) {
+    DqEstatisticas e;
+    dqEstatisticas(sessao, &e);
+    if (r->formato == SAIDA_PROTOCOLO) {
+        printf("pistas\t%u\n", e.pistas);
+        dqPercorrerPistas(sessao, imprimirPista, (void*) r);
+        return;
+    }
+    printf("\n=== PISTAS COLETADAS ===\n");
+    if (e.pistas == 0)
+        printf("Nenhuma pista coletada.\n");
+    else
+        dqPercorrerPistas(sessao, imprimirPista, (void*) r);
+}
+
+/* exibirSuspeitoMaisProvavel()
+   Suspeito mais citado pelas pistas coletadas, se houver. */
+void exibirSuspeitoMaisProvavel(const DqSessao *sessao, const Renderizador *r) {
+    DqEstatisticas e;
+    dqEstatisticas(sessao, &e);
+    if (e.maisProvavel != NULL && r->formato == SAIDA_PROTOCOLO)
+        printf("suspeito\t%s\t%u\n", e.maisProvavel, e.maxEvidencias);
+    else if (e.maisProvavel != NULL)
+        printf("\nSuspeito mais provável: %s (%u pista(s))\n", e.maisProvavel, e.maxEvidencias);
+}
+
+/* Contexto de imprimirSuspeito(): formato de saída e posição no ranking. */
+typedef struct VisitaRanking {
+    const Renderizador *r;
+    uint32_t posicao;
+} VisitaRanking;
+
+/* imprimirSuspeito()
+   Visitante usado por exibirRanking(). */
+static void imprimirSuspeito(const char *suspeito, uint64_t pontos, void *contexto) {
+    VisitaRanking *v = (VisitaRanking*) contexto;
+    if (v->r->formato == SAIDA_PROTOCOLO)
+        printf("ranking\t%s\t%llu\n", suspeito, (unsigned long long) pontos);
+    else
+        printf(" %u. %s (%llu ponto(s))\n", ++v->posicao, suspeito, (unsigned long long) pontos);
+}
+
+/* exibirRanking()
+   Suspeitos com mais pontos pelas pistas coletadas, somando os pesos de
+   todos os suspeitos de cada pista. Só aparece em mansões com pistas
+   ponderadas; nas outras repetiria o suspeito mais provável. */
+void exibirRanking(const DqMansao *mansao, const DqSessao *sessao, const Renderizador *r) {
+    if (!dqPistasPonderadas(mansao)) return;
+    VisitaRanking v = { r, 0 };
+    if (r->formato == SAIDA_TEXTO) printf("\n=== RANKING DE SUSPEITOS ===\n");
+    if (dqRanking(sessao, RANKING_EXIBIDO, imprimirSuspeito, &v) == 0 && r->formato == SAIDA_TEXTO)
+        printf("Nenhuma pista coletada.\n");
+}
+
+/* verificarSuspeitoFinal()
+   Solicita ao jogador o nome do suspeito acusado e verifica se há pelo menos
+   duas pistas coletadas que apontam para esse suspeito. */
+void verificarSuspeitoFinal(const DqSessao *sessao, const Renderizador *r) {
+    int protocolo = r->formato == SAIDA_PROTOCOLO;
+    DqEstatisticas e;
+    dqEstatisticas(sessao, &e);
+    if (e.pistas == 0) {
+        printf(protocolo ? "acusacao\t-\t0\tsem_pistas\n"
+                         : "\nNenhuma pista coletada - não é possível acusar ninguém.\n");
+        return;
+    }
+
+    char acusado[50];
+    printf(protocolo ? "acusar\n" : "\nQuem você acusa? (digite o nome exato do suspeito): ");
+    fflush(stdout);
+    // lê uma linha segura
+    if (fgets(acusado, sizeof(acusado), stdin) == NULL) {
+        printf(protocolo ? "acusacao\t-\t0\terro\n" : "Erro na leitura.\n");
+        return;
+    }
+    // remove '\n' final
+    acusado[strcspn(acusado, "\r\n")] = '\0';
+
+    if (strlen(acusado) == 0) {
+        printf(protocolo ? "acusacao\t-\t0\tcancelada\n" : "Nenhum nome fornecido. Acusação cancelada.\n");
+        return;
+    }
+
+    uint32_t correspondencias;
+    int valida = dqAcusar(sessao, acusado, &correspondencias);
+    if (protocolo) {
+        printf("acusacao\t%s\t%u\t%s\n", acusado, correspondencias, valida ? "valida" : "insuficiente");
+        return;
+    }
+
+    printf("\nPistas que apontam para %s: %u\n", acusado, correspondencias);
+    if (valida) {
+        printf("Acusação válida! Há evidências suficientes para prender %s.\n", acusado);
+    } else {
+        printf("Acusação insuficiente. São necessárias pelo menos 2 pistas para uma acusação válida.\n");
+    }
+}
+
+/* exibirEncerramento()
+   Despedida do jogo. */
+void exibirEncerramento(const Renderizador *r) {
+    printf(r->formato == SAIDA_PROTOCOLO ? "obrigado\n" : "\nObrigado por jogar!\n");
+    fflush(stdout);
+}
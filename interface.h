@@ -0,0 +1,26 @@
+#ifndef INTERFACE_H
+#define INTERFACE_H
+
+#include "detective.h"
+#include "renderizador.h"
+
+/* ===================== INTERFACE NO TERMINAL ===================== */
+
+/* Menus e mensagens do jogo interativo, comuns aos três níveis. Toda a
+   entrada e saída fica aqui; o motor é usado apenas pela API de
+   detective.h. A exploração escreve pelo renderizador (renderizador.h),
+   que também decide entre o texto do jogo e o protocolo compacto. */
+
+#define RANKING_EXIBIDO 5   // suspeitos listados por exibirRanking() (e pelo servidor)
+
+char lerEscolha(void);
+void exibirAbertura(const Renderizador *r, const char *objetivo);
+void explorarSalas(DqSessao *sessao, Renderizador *r);
+void explorarSalasComPistas(DqSessao *sessao, Renderizador *r);
+void exibirPistas(const DqSessao *sessao, const Renderizador *r);
+void exibirSuspeitoMaisProvavel(const DqSessao *sessao, const Renderizador *r);
+void exibirRanking(const DqMansao *mansao, const DqSessao *sessao, const Renderizador *r);
+void verificarSuspeitoFinal(const DqSessao *sessao, const Renderizador *r);
+void exibirEncerramento(const Renderizador *r);
+
+#endif
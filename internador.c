@@ -0,0 +1,331 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "internador.h"
+
+/* Par (texto, id) usado para ordenar o pool com qsort(). */
+typedef struct TextoComId {
+    const char *texto;
+    uint32_t id;
+} TextoComId;
+
+/* realocarOuSair()
+   realloc() que encerra o programa com mensagem em caso de falha. */
+void* realocarOuSair(void *ptr, size_t tamanho, const char *oque) {
+    void *novo = realloc(ptr, tamanho);
+    if (novo == NULL && tamanho != 0) {
+        printf("Erro ao alocar memoria para %s.\n", oque);
+        exit(1);
+    }
+    return novo;
+}
+
+/* inicializarInternador()
+   Prepara um pool vazio. */
+void inicializarInternador(Internador *in) {
+    memset(in, 0, sizeof(*in));
+    in->capIndice = 16;
+    in->indice = (uint32_t*) calloc(in->capIndice, sizeof(uint32_t));
+    if (in->indice == NULL) {
+        printf("Erro ao alocar memoria para o pool de strings.\n");
+        exit(1);
+    }
+}
+
+/* refazerIndice()
+   Monta o índice com a capacidade dada a partir dos hashes guardados. */
+static void refazerIndice(Internador *in, uint32_t novaCap) {
+    uint32_t mascara = novaCap - 1;
+    uint32_t *novo = (uint32_t*) calloc(novaCap, sizeof(uint32_t));
+    if (novo == NULL) {
+        printf("Erro ao alocar memoria para o pool de strings.\n");
+        exit(1);
+    }
+    for (uint32_t id = 0; id < in->quantidade; ++id) {
+        uint32_t pos = in->hashes[id] & mascara;
+        while (novo[pos] != 0) pos = (pos + 1) & mascara;
+        novo[pos] = id + 1;
+    }
+    free(in->indice);
+    in->indice = novo;
+    in->capIndice = novaCap;
+}
+
+/* crescerIndice()
+   Dobra o índice quando a ocupação passa de 70%. */
+static void crescerIndice(Internador *in) {
+    refazerIndice(in, in->capIndice * 2);
+}
+
+/* internarString()
+   Retorna o id da string, copiando-a para o pool se for nova. */
+uint32_t internarString(Internador *in, const char *s) {
+    if (in->numBaldes > 0) {
+        uint32_t id = buscarCongelado(in, s);
+        if (id != INTERNADOR_AUSENTE) return id;
+        descongelarInternador(in);
+    }
+    uint32_t h = calculaHash(s);
+    uint32_t pos = posicaoNoIndice(in, s, h);
+    if (in->indice[pos] != 0) return in->indice[pos] - 1;
+
+    size_t tam = strlen(s) + 1;
+    if (in->tamTextos + tam > in->capTextos) {
+        size_t novaCap = in->capTextos ? in->capTextos * 2 : 1024;
+        while (novaCap < in->tamTextos + tam) novaCap *= 2;
+        in->textos = (char*) realocarOuSair(in->textos, novaCap, "o pool de strings");
+        in->capTextos = novaCap;
+    }
+    if (in->quantidade == in->capIds) {
+        in->capIds = in->capIds ? in->capIds * 2 : 64;
+        in->deslocamentos = (uint32_t*) realocarOuSair(in->deslocamentos, in->capIds * sizeof(uint32_t), "o pool de strings");
+        in->hashes = (uint32_t*) realocarOuSair(in->hashes, in->capIds * sizeof(uint32_t), "o pool de strings");
+    }
+
+    uint32_t id = in->quantidade++;
+    in->deslocamentos[id] = (uint32_t) in->tamTextos;
+    in->hashes[id] = h;
+    memcpy(in->textos + in->tamTextos, s, tam);
+    in->tamTextos += tam;
+    in->indice[pos] = id + 1;
+
+    if ((double) in->quantidade > in->capIndice * 0.70) crescerIndice(in);
+    return id;
+}
+
+/* compararTextoComId()
+   Comparação alfabética (strcmp) para qsort(). */
+static int compararTextoComId(const void *a, const void *b) {
+    return strcmp(((const TextoComId*) a)->texto, ((const TextoComId*) b)->texto);
+}
+
+/* ordenarInternador()
+   Calcula a ordem alfabética de todas as strings do pool. Deve ser chamada
+   de novo se mais strings forem internadas depois. */
+void ordenarInternador(Internador *in) {
+    uint32_t n = in->quantidade;
+    TextoComId *pares = (TextoComId*) realocarOuSair(NULL, (n ? n : 1) * sizeof(TextoComId), "o pool de strings");
+    for (uint32_t id = 0; id < n; ++id) {
+        pares[id].texto = textoInternado(in, id);
+        pares[id].id = id;
+    }
+    qsort(pares, n, sizeof(TextoComId), compararTextoComId);
+
+    in->ordem = (uint32_t*) realocarOuSair(in->ordem, (n ? n : 1) * sizeof(uint32_t), "o pool de strings");
+    in->porOrdem = (uint32_t*) realocarOuSair(in->porOrdem, (n ? n : 1) * sizeof(uint32_t), "o pool de strings");
+    for (uint32_t pos = 0; pos < n; ++pos) {
+        in->porOrdem[pos] = pares[pos].id;
+        in->ordem[pares[pos].id] = pos;
+    }
+    in->numOrdenados = n;
+    free(pares);
+}
+
+/* ===================== HASH PERFEITO (CHD) ===================== */
+
+#define CONGELAR_TENTATIVAS 8   // sementes globais tentadas antes de desistir
+
+/* Construção do hash perfeito: os hashes das strings, os baldes em CSR e
+   a string que ficou em cada posição. */
+typedef struct ConstrucaoPerfeita {
+    uint64_t *hashes;     // hashes[id] com a semente global da tentativa
+    uint32_t *idDaPosicao;
+    uint32_t *inicio;     // strings do balde b em membros[inicio[b] .. inicio[b + 1])
+    uint32_t *membros;
+    uint32_t *ordem;      // baldes do maior para o menor
+    uint32_t *posicoes;   // posições candidatas do balde em teste
+} ConstrucaoPerfeita;
+
+/* acomodarBalde()
+   Procura a primeira semente que leva as strings do balde a posições
+   livres e distintas, e as ocupa. Retorna -1 se passar do limite de
+   tentativas (duas strings do balde com o mesmo hash baixo nunca se
+   separam; a construção recomeça com outra semente global). */
+static int acomodarBalde(Internador *in, ConstrucaoPerfeita *c, uint32_t balde, uint64_t limite) {
+    uint32_t ini = c->inicio[balde], fim = c->inicio[balde + 1];
+    for (uint64_t semente = 0; semente <= limite; ++semente) {
+        uint32_t k = ini;
+        for (; k < fim; ++k) {
+            uint32_t pos = posicaoPerfeita(c->hashes[c->membros[k]], (uint32_t) semente, in->quantidade);
+            if (c->idDaPosicao[pos] != INTERNADOR_AUSENTE) break;
+            uint32_t j = ini;
+            while (j < k && c->posicoes[j - ini] != pos) j++;
+            if (j < k) break;
+            c->posicoes[k - ini] = pos;
+        }
+        if (k < fim) continue;
+        for (k = ini; k < fim; ++k) c->idDaPosicao[c->posicoes[k - ini]] = c->membros[k];
+        in->sementesBalde[balde] = (uint32_t) semente;
+        return 0;
+    }
+    return -1;
+}
+
+/* construirPerfeito()
+   Uma tentativa de montar o hash perfeito com a semente global dada:
+   distribui as strings nos baldes e acomoda os baldes do maior para o
+   menor, quando ainda há mais posições livres. Retorna 0 ou -1. */
+static int construirPerfeito(Internador *in, ConstrucaoPerfeita *c, uint64_t semente) {
+    uint32_t n = in->quantidade, numBaldes = in->numBaldes;
+    memset(c->inicio, 0, ((size_t) numBaldes + 2) * sizeof(uint32_t));
+    for (uint32_t id = 0; id < n; ++id) {
+        c->hashes[id] = calculaHash64(textoInternado(in, id), semente);
+        c->inicio[reduzirFaixa((uint32_t) (c->hashes[id] >> 32), numBaldes) + 2]++;
+    }
+
+    // baldes ordenados por tamanho (contagem), do maior para o menor
+    uint32_t maior = 0;
+    for (uint32_t b = 0; b < numBaldes; ++b)
+        if (c->inicio[b + 2] > maior) maior = c->inicio[b + 2];
+    uint32_t *porTamanho = (uint32_t*) calloc((size_t) maior + 2, sizeof(uint32_t));
+    if (porTamanho == NULL) {
+        printf("Erro ao alocar memoria para o pool de strings.\n");
+        exit(1);
+    }
+    for (uint32_t b = 0; b < numBaldes; ++b) porTamanho[maior - c->inicio[b + 2] + 1]++;
+    for (uint32_t t = 1; t <= maior + 1; ++t) porTamanho[t] += porTamanho[t - 1];
+    for (uint32_t b = 0; b < numBaldes; ++b) c->ordem[porTamanho[maior - c->inicio[b + 2]]++] = b;
+    free(porTamanho);
+
+    // CSR: inicio[b + 2] conta, vira o início de b + 1 e, preenchido, o fim de b
+    for (uint32_t b = 0; b < numBaldes; ++b) c->inicio[b + 2] += c->inicio[b + 1];
+    for (uint32_t id = 0; id < n; ++id)
+        c->membros[c->inicio[reduzirFaixa((uint32_t) (c->hashes[id] >> 32), numBaldes) + 1]++] = id;
+
+    for (uint32_t p = 0; p < n; ++p) c->idDaPosicao[p] = INTERNADOR_AUSENTE;
+    uint64_t limite = 64 * (uint64_t) n + 1024;
+    if (limite > UINT32_MAX) limite = UINT32_MAX;
+    for (uint32_t i = 0; i < numBaldes; ++i) {
+        uint32_t b = c->ordem[i];
+        if (c->inicio[b] == c->inicio[b + 1]) {
+            in->sementesBalde[b] = 0;
+        } else if (acomodarBalde(in, c, b, limite) != 0) {
+            return -1;
+        }
+    }
+    return 0;
+}
+
+/* renumerarPerfeito()
+   Dá a cada string o id igual à sua posição no hash perfeito: permuta os
+   deslocamentos, os hashes e a ordem alfabética e descarta o índice, que
+   o hash perfeito substitui. */
+static void renumerarPerfeito(Internador *in, const uint32_t *idDaPosicao, uint32_t *novoId) {
+    uint32_t n = in->quantidade;
+    uint32_t *deslocamentos = (uint32_t*) realocarOuSair(NULL, (size_t) in->capIds * sizeof(uint32_t), "o pool de strings");
+    uint32_t *hashes = (uint32_t*) realocarOuSair(NULL, (size_t) in->capIds * sizeof(uint32_t), "o pool de strings");
+    for (uint32_t pos = 0; pos < n; ++pos) {
+        uint32_t id = idDaPosicao[pos];
+        deslocamentos[pos] = in->deslocamentos[id];
+        hashes[pos] = in->hashes[id];
+        novoId[id] = pos;
+    }
+    free(in->deslocamentos);
+    free(in->hashes);
+    in->deslocamentos = deslocamentos;
+    in->hashes = hashes;
+
+    if (in->numOrdenados == n) {
+        uint32_t *ordem = (uint32_t*) realocarOuSair(NULL, (size_t) n * sizeof(uint32_t), "o pool de strings");
+        for (uint32_t id = 0; id < n; ++id) ordem[novoId[id]] = in->ordem[id];
+        for (uint32_t k = 0; k < n; ++k) in->porOrdem[k] = novoId[in->porOrdem[k]];
+        free(in->ordem);
+        in->ordem = ordem;
+    } else {
+        in->numOrdenados = 0;   // ordem desatualizada: refeita por ordenarInternador()
+    }
+
+    free(in->indice);
+    in->indice = NULL;
+    in->capIndice = 0;
+}
+
+/* congelarInternador()
+   Monta o hash perfeito do pool e renumera as strings (ver internador.h).
+   novoId, se não for NULL e tiver uma posição por string, recebe o id
+   novo de cada id antigo, para quem guarda ids do pool atualizá-los; se
+   nenhuma das sementes der certo, o pool fica sem hash perfeito, os ids
+   não mudam (novoId recebe a identidade) e buscarString() continua no
+   índice. Retorna 0 se o pool ficou congelado. */
+int congelarInternador(Internador *in, uint32_t *novoId) {
+    descongelarInternador(in);
+    uint32_t n = in->quantidade;
+    for (uint32_t id = 0; novoId != NULL && id < n; ++id) novoId[id] = id;
+    if (n == 0) return -1;
+
+    in->numBaldes = (n + INTERNADOR_CHAVES_POR_BALDE - 1) / INTERNADOR_CHAVES_POR_BALDE;
+    in->sementesBalde = (uint32_t*) realocarOuSair(NULL, (size_t) in->numBaldes * sizeof(uint32_t), "o pool de strings");
+    ConstrucaoPerfeita c;
+    c.hashes = (uint64_t*) realocarOuSair(NULL, (size_t) n * sizeof(uint64_t), "o pool de strings");
+    c.idDaPosicao = (uint32_t*) realocarOuSair(NULL, (size_t) n * sizeof(uint32_t), "o pool de strings");
+    c.inicio = (uint32_t*) realocarOuSair(NULL, ((size_t) in->numBaldes + 2) * sizeof(uint32_t), "o pool de strings");
+    c.membros = (uint32_t*) realocarOuSair(NULL, (size_t) n * sizeof(uint32_t), "o pool de strings");
+    c.ordem = (uint32_t*) realocarOuSair(NULL, (size_t) in->numBaldes * sizeof(uint32_t), "o pool de strings");
+    c.posicoes = (uint32_t*) realocarOuSair(NULL, (size_t) n * sizeof(uint32_t), "o pool de strings");
+
+    int resultado = -1;
+    for (uint32_t t = 0; t < CONGELAR_TENTATIVAS && resultado != 0; ++t) {
+        in->sementePerfeita = (uint64_t) t * 0x9E3779B97F4A7C15ull;
+        resultado = construirPerfeito(in, &c, in->sementePerfeita);
+    }
+    if (resultado == 0) {
+        // c.membros já foi usado; serve de destino do mapeamento se ninguém pediu
+        renumerarPerfeito(in, c.idDaPosicao, novoId != NULL ? novoId : c.membros);
+    }
+    free(c.hashes);
+    free(c.idDaPosicao);
+    free(c.inicio);
+    free(c.membros);
+    free(c.ordem);
+    free(c.posicoes);
+    if (resultado != 0) descongelarInternador(in);
+    return resultado;
+}
+
+/* descongelarInternador()
+   Descarta o hash perfeito e refaz o índice, para onde as buscas voltam.
+   Os ids continuam os mesmos. */
+void descongelarInternador(Internador *in) {
+    free(in->sementesBalde);
+    in->sementesBalde = NULL;
+    in->numBaldes = 0;
+    in->sementePerfeita = 0;
+    if (in->indice == NULL) {
+        uint32_t cap = 16;
+        while ((double) in->quantidade > cap * 0.70) cap *= 2;
+        refazerIndice(in, cap);
+    }
+}
+
+/* estatisticasSondagem()
+   Calcula o comprimento médio e máximo de sondagem do índice (posições
+   visitadas numa busca bem-sucedida). */
+void estatisticasSondagem(const Internador *in, double *media, uint32_t *maximo) {
+    uint32_t mascara = in->capIndice - 1;
+    uint64_t soma = 0;
+    uint32_t maior = 0;
+    for (uint32_t pos = 0; pos < in->capIndice; ++pos) {
+        if (in->indice[pos] == 0) continue;
+        uint32_t id = in->indice[pos] - 1;
+        uint32_t sondagem = ((pos - (in->hashes[id] & mascara)) & mascara) + 1;
+        soma += sondagem;
+        if (sondagem > maior) maior = sondagem;
+    }
+    if (media != NULL) *media = in->quantidade ? (double) soma / in->quantidade : 0.0;
+    if (maximo != NULL) *maximo = maior;
+}
+
+/* liberarInternador()
+   Libera os buffers do pool. */
+void liberarInternador(Internador *in) {
+    free(in->textos);
+    free(in->deslocamentos);
+    free(in->hashes);
+    free(in->indice);
+    free(in->ordem);
+    free(in->porOrdem);
+    free(in->sementesBalde);
+    memset(in, 0, sizeof(*in));
+}
@@ -0,0 +1,170 @@
+#ifndef INTERNADOR_H
+#define INTERNADOR_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "estatisticas.h"
+
+/* ===================== POOL DE STRINGS (INTERNADOR) ===================== */
+
+/* Identificador retornado quando a string não está no pool. */
+#define INTERNADOR_AUSENTE UINT32_MAX
+
+/* Pool de strings sem repetição. Cada string distinta recebe um id denso
+   (0, 1, 2, ...) e é guardada uma única vez num buffer contíguo, então
+   igualdade de strings vira comparação de inteiros.
+   O índice é uma tabela de endereçamento aberto que guarda id + 1
+   (0 indica posição vazia).
+   Depois de ordenarInternador(), ordem[id] é a posição alfabética da string
+   e porOrdem[posição] o id correspondente.
+
+   Um pool que não vai mais crescer pode ser congelado
+   (congelarInternador()): ganha um hash perfeito mínimo no esquema CHD
+   (hash, deslocamento e compressão), que leva cada string a uma posição
+   exclusiva de 0 a quantidade - 1, e os ids são renumerados para que o
+   id de cada string seja a sua posição. As strings são distribuídas em
+   baldes de INTERNADOR_CHAVES_POR_BALDE em média; cada balde guarda a
+   semente que espalha as suas strings por posições livres. Essas
+   sementes (32 bits por balde, 8 bits por string) são toda a estrutura
+   de busca do pool congelado: o índice de endereçamento aberto é
+   descartado, e buscarString() faz um hash, uma leitura da semente e uma
+   comparação com a string do id calculado. Continuam no pool, como em
+   qualquer pool, o deslocamento e o hash de 32 bits de cada string (este
+   refaz o índice se o pool for descongelado e entra na impressão do
+   catálogo dos retratos).
+   Internar uma string nova descongela o pool, refazendo o índice; os ids
+   já dados não mudam. */
+#define INTERNADOR_CHAVES_POR_BALDE 4
+typedef struct Internador {
+    char *textos;
+    size_t tamTextos;
+    size_t capTextos;
+    uint32_t *deslocamentos; // deslocamentos[id] -> início da string em textos
+    uint32_t *hashes;        // hashes[id] -> hash da string
+    uint32_t quantidade;
+    uint32_t capIds;
+    uint32_t *indice;        // NULL no pool congelado
+    uint32_t capIndice;      // sempre potência de 2 (0 no pool congelado)
+    uint32_t *ordem;
+    uint32_t *porOrdem;
+    uint32_t numOrdenados;   // ids com ordem calculada (0 .. numOrdenados - 1)
+    uint32_t *sementesBalde; // hash perfeito: semente de cada balde
+    uint32_t numBaldes;      // 0: pool não congelado
+    uint64_t sementePerfeita;
+} Internador;
+
+/* calculaHash()
+   FNV-1a de 32 bits sobre os bytes da string, seguido de uma mistura final
+   (fmix32) para espalhar bem os bits baixos usados como índice.
+   O valor 0 é reservado para posições vazias, por isso é trocado por 1. */
+static inline uint32_t calculaHash(const char *s) {
+    uint32_t h = 2166136261u;
+    for (; *s != '\0'; ++s) {
+        h ^= (unsigned char)*s;
+        h *= 16777619u;
+    }
+    h ^= h >> 16;
+    h *= 0x85ebca6bu;
+    h ^= h >> 13;
+    h *= 0xc2b2ae35u;
+    h ^= h >> 16;
+    return h != 0 ? h : 1;
+}
+
+/* calculaHash64()
+   FNV-1a de 64 bits, partindo da semente, com a mistura final do
+   MurmurHash3 (fmix64). É o hash do hash perfeito; a semente muda quando
+   uma construção não dá certo. */
+static inline uint64_t calculaHash64(const char *s, uint64_t semente) {
+    uint64_t h = 14695981039346656037ull ^ semente;
+    for (; *s != '\0'; ++s) {
+        h ^= (unsigned char)*s;
+        h *= 1099511628211ull;
+    }
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+/* misturar32() / reduzirFaixa()
+   Mistura bijetora de 32 bits (fmix32) e a redução de x para 0 .. n - 1
+   por multiplicação, sem divisão. */
+static inline uint32_t misturar32(uint32_t x) {
+    x ^= x >> 16;
+    x *= 0x85ebca6bu;
+    x ^= x >> 13;
+    x *= 0xc2b2ae35u;
+    x ^= x >> 16;
+    return x;
+}
+
+static inline uint32_t reduzirFaixa(uint32_t x, uint32_t n) {
+    return (uint32_t) (((uint64_t) x * n) >> 32);
+}
+
+/* posicaoPerfeita()
+   Posição do hash perfeito para uma string de hash h: o balde vem dos 32
+   bits altos e a posição dos baixos, misturados com a semente do balde. */
+static inline uint32_t posicaoPerfeita(uint64_t h, uint32_t sementeBalde, uint32_t quantidade) {
+    return reduzirFaixa(misturar32((uint32_t) h ^ sementeBalde), quantidade);
+}
+
+void* realocarOuSair(void *ptr, size_t tamanho, const char *oque);
+void inicializarInternador(Internador *in);
+
+/* textoInternado()
+   Retorna a string do id informado. */
+static inline const char* textoInternado(const Internador *in, uint32_t id) {
+    return in->textos + in->deslocamentos[id];
+}
+
+/* posicaoNoIndice()
+   Posição do índice onde a string está ou, se ausente, a posição vazia
+   onde ela deveria entrar. */
+static inline uint32_t posicaoNoIndice(const Internador *in, const char *s, uint32_t h) {
+    uint32_t mascara = in->capIndice - 1;
+    uint32_t pos = h & mascara;
+    while (in->indice[pos] != 0) {
+        uint32_t id = in->indice[pos] - 1;
+        if (in->hashes[id] == h && strcmp(textoInternado(in, id), s) == 0) break;
+        pos = (pos + 1) & mascara;
+    }
+    EST_CONTAR(EST_BUSCAS_INTERNADOR, 1);
+    EST_REGISTRAR(EST_SONDAGENS_INTERNADOR, ((pos - (h & mascara)) & mascara) + 1);
+    return pos;
+}
+
+/* buscarCongelado()
+   Busca pelo hash perfeito de um pool congelado: a posição é o id da
+   única candidata, e basta uma comparação para confirmar. */
+static inline uint32_t buscarCongelado(const Internador *in, const char *s) {
+    uint64_t h = calculaHash64(s, in->sementePerfeita);
+    uint32_t balde = reduzirFaixa((uint32_t) (h >> 32), in->numBaldes);
+    uint32_t id = posicaoPerfeita(h, in->sementesBalde[balde], in->quantidade);
+    EST_CONTAR(EST_BUSCAS_INTERNADOR, 1);
+    EST_REGISTRAR(EST_SONDAGENS_INTERNADOR, 1);
+    return strcmp(textoInternado(in, id), s) == 0 ? id : INTERNADOR_AUSENTE;
+}
+
+/* buscarString()
+   Retorna o id da string ou INTERNADOR_AUSENTE se ela nunca foi internada. */
+static inline uint32_t buscarString(const Internador *in, const char *s) {
+    if (in->numBaldes > 0) return buscarCongelado(in, s);
+    uint32_t v = in->indice[posicaoNoIndice(in, s, calculaHash(s))];
+    return v != 0 ? v - 1 : INTERNADOR_AUSENTE;
+}
+
+uint32_t internarString(Internador *in, const char *s);
+void ordenarInternador(Internador *in);
+int congelarInternador(Internador *in, uint32_t *novoId);
+void descongelarInternador(Internador *in);
+void estatisticasSondagem(const Internador *in, double *media, uint32_t *maximo);
+void liberarInternador(Internador *in);
+
+#endif
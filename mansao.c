@@ -0,0 +1,150 @@
+#include <stdint.h>
+#include <stdlib.h>
+
+#include "mansao.h"
+
+/* inicializarMansao()
+   Prepara uma mansão vazia. */
+void inicializarMansao(Mansao *m) {
+    m->salas = NULL;
+    m->numSalas = 0;
+    m->capSalas = 0;
+    m->inicioSaidas = NULL;
+    m->saidas = NULL;
+    m->numSaidas = 0;
+    m->numPassagens = 0;
+    m->passagens = NULL;
+    m->numCriadas = 0;
+    m->capPassagens = 0;
+    inicializarInternador(&m->nomes);
+    inicializarInternador(&m->pistas);
+}
+
+/* criarSala()
+   Acrescenta uma nova sala com o nome e a pista (opcional) e retorna o seu índice.
+   Pista NULL ou vazia significa sala sem pista. */
+uint32_t criarSala(Mansao *m, const char *nome, const char *pista) {
+    if (m->numSalas == m->capSalas) {
+        m->capSalas = m->capSalas ? m->capSalas * 2 : 16;
+        m->salas = (Sala*) realocarOuSair(m->salas, m->capSalas * sizeof(Sala), "a sala");
+    }
+    uint32_t idx = m->numSalas++;
+    Sala *s = &m->salas[idx];
+    s->nome = internarString(&m->nomes, nome);
+    s->pista = (pista != NULL && pista[0] != '\0') ? internarString(&m->pistas, pista) : SEM_PISTA;
+    s->esquerda = SEM_SALA;
+    s->direita = SEM_SALA;
+    return idx;
+}
+
+/* criarPassagem()
+   Acrescenta uma passagem (saída extra) da sala origem para a sala
+   destino. Ela entra no grafo no próximo montarGrafo(). */
+void criarPassagem(Mansao *m, uint32_t origem, uint32_t destino) {
+    if (m->numCriadas == m->capPassagens) {
+        m->capPassagens = m->capPassagens ? m->capPassagens * 2 : 16;
+        m->passagens = (uint32_t*) realocarOuSair(m->passagens, (size_t) m->capPassagens * 2 * sizeof(uint32_t),
+                                                  "a passagem");
+    }
+    m->passagens[2 * m->numCriadas] = origem;
+    m->passagens[2 * m->numCriadas + 1] = destino;
+    m->numCriadas++;
+}
+
+/* montarGrafo()
+   Monta o CSR de saídas a partir dos corredores atuais e de todas as
+   passagens criadas, em O(salas + saídas): conta as saídas de cada sala,
+   acumula os inícios e preenche. Um grafo já montado é descartado e
+   refeito do zero. */
+void montarGrafo(Mansao *m) {
+    uint32_t n = m->numSalas;
+    const uint32_t *passagens = m->passagens;
+    uint32_t total = m->numCriadas;
+    free(m->inicioSaidas);
+    free(m->saidas);
+
+    // inicio[s + 1] conta as saídas de s e depois vira o cursor de preenchimento
+    uint32_t *inicio = (uint32_t*) realocarOuSair(NULL, ((size_t) n + 1) * sizeof(uint32_t), "o grafo da mansao");
+    inicio[0] = 0;
+    for (uint32_t s = 0; s < n; ++s) inicio[s + 1] = numCorredores(&m->salas[s]);
+    for (uint32_t p = 0; p < total; ++p) inicio[passagens[2 * p] + 1]++;
+    uint64_t soma = 0;
+    for (uint32_t s = 0; s < n; ++s) {
+        uint32_t c = inicio[s + 1];
+        inicio[s + 1] = (uint32_t) soma;
+        soma += c;
+    }
+    if (soma >= UINT32_MAX) {
+        printf("Erro: a mansao tem saidas demais.\n");
+        exit(1);
+    }
+
+    uint32_t *saidas = (uint32_t*) realocarOuSair(NULL, (soma ? soma : 1) * sizeof(uint32_t), "o grafo da mansao");
+    for (uint32_t s = 0; s < n; ++s) {
+        if (m->salas[s].esquerda != SEM_SALA) saidas[inicio[s + 1]++] = m->salas[s].esquerda;
+        if (m->salas[s].direita != SEM_SALA) saidas[inicio[s + 1]++] = m->salas[s].direita;
+    }
+    for (uint32_t p = 0; p < total; ++p) saidas[inicio[passagens[2 * p] + 1]++] = passagens[2 * p + 1];
+
+    m->inicioSaidas = inicio;
+    m->saidas = saidas;
+    m->numSaidas = (uint32_t) soma;
+    m->numPassagens = total;
+}
+
+/* percorrerGrafo()
+   Busca em largura pelo grafo de saídas a partir da sala origem. Se ordem
+   não for NULL (com espaço para numSalas), recebe as salas alcançadas na
+   ordem da busca. Retorna quantas salas são alcançáveis. As visitadas
+   ficam num bitmap (1 bit por sala) e a fila é o próprio vetor de saída,
+   então a busca só lê memória contígua além do bitmap. */
+uint32_t percorrerGrafo(const Mansao *m, uint32_t origem, uint32_t *ordem) {
+    uint32_t n = m->numSalas;
+    if (m->inicioSaidas == NULL || origem >= n) return 0;
+    uint64_t *visitadas = (uint64_t*) calloc(((size_t) n + 63) / 64, sizeof(uint64_t));
+    uint32_t *fila = ordem != NULL ? ordem : (uint32_t*) malloc((size_t) n * sizeof(uint32_t));
+    if (visitadas == NULL || fila == NULL) {
+        printf("Erro ao alocar memoria para o percurso da mansao.\n");
+        exit(1);
+    }
+    uint32_t inicioFila = 0, fimFila = 0;
+    visitadas[origem >> 6] |= 1ull << (origem & 63);
+    fila[fimFila++] = origem;
+    while (inicioFila < fimFila) {
+        uint32_t s = fila[inicioFila++];
+        for (uint32_t i = m->inicioSaidas[s]; i < m->inicioSaidas[s + 1]; ++i) {
+            uint32_t d = m->saidas[i];
+            uint64_t bit = 1ull << (d & 63);
+            if (visitadas[d >> 6] & bit) continue;
+            visitadas[d >> 6] |= bit;
+            fila[fimFila++] = d;
+        }
+    }
+    free(visitadas);
+    if (fila != ordem) free(fila);
+    return fimFila;
+}
+
+/* renumerarPistasDasSalas()
+   Troca a pista de cada sala pelo id novo (novaPista[idAntigo]), depois
+   que o pool de pistas foi renumerado por congelarInternador(). */
+void renumerarPistasDasSalas(Mansao *m, const uint32_t *novaPista) {
+    for (uint32_t i = 0; i < m->numSalas; ++i)
+        if (m->salas[i].pista != SEM_PISTA) m->salas[i].pista = novaPista[m->salas[i].pista];
+}
+
+/* liberarArvore()
+   Libera a mansão inteira: o vetor de salas, o grafo de saídas e os pools
+   de textos, sem percorrer a árvore sala por sala. */
+void liberarArvore(Mansao *m) {
+    free(m->salas);
+    free(m->inicioSaidas);
+    free(m->saidas);
+    free(m->passagens);
+    m->salas = NULL;
+    m->inicioSaidas = m->saidas = m->passagens = NULL;
+    m->numSalas = m->capSalas = 0;
+    m->numSaidas = m->numPassagens = m->numCriadas = m->capPassagens = 0;
+    liberarInternador(&m->nomes);
+    liberarInternador(&m->pistas);
+}
@@ -0,0 +1,122 @@
+#ifndef MANSAO_H
+#define MANSAO_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "internador.h"
+
+/* ===================== MANSÃO (ÁRVORE EM ARRAY + GRAFO DE SAÍDAS) ===================== */
+
+/* Índice usado para "sem sala" (filho inexistente) e "sem pista". */
+#define SEM_SALA UINT32_MAX
+#define SEM_PISTA UINT32_MAX
+
+/* A primeira sala criada (índice 0) é a entrada da mansão. */
+#define SALA_ENTRADA 0
+
+/* Passagens que podem ser escolhidas por um único dígito ('1'..'9') nos
+   menus e nas partidas em lote; as demais só por moverPorPassagem(). */
+#define PASSAGENS_POR_DIGITO 9
+
+/* Estrutura que representa uma sala (nó da árvore binária).
+   Nome e pista são ids nos pools de nomes e de pistas da mansão; os filhos
+   são índices no array de salas. São 16 bytes por sala. */
+typedef struct Sala {
+    uint32_t nome;
+    uint32_t pista;
+    uint32_t esquerda;
+    uint32_t direita;
+} Sala;
+
+/* Mansão inteira: salas num vetor contíguo e textos em pools separados,
+   onde nomes e pistas repetidos são guardados uma única vez.
+   O pool de pistas é o catálogo de pistas do mapa: a tabela de suspeitos,
+   a árvore de pistas coletadas e os contadores usam os mesmos ids.
+
+   Além dos corredores da árvore (esquerda e direita), uma sala pode ter
+   passagens: saídas para qualquer sala, inclusive de volta, para ela mesma
+   ou formando ciclos. montarGrafo() junta todas as saídas num grafo
+   dirigido em CSR (compressed sparse row): as saídas da sala s ficam em
+   saidas[inicioSaidas[s] .. inicioSaidas[s + 1]), primeiro os corredores
+   existentes (esquerda, direita) e depois as passagens, na ordem em que
+   foram criadas. Percorrer o grafo é ler dois vetores contíguos.
+   As passagens criadas ficam também na sua própria lista, da qual
+   montarGrafo() refaz o CSR a cada chamada, então salas, corredores e
+   passagens podem mudar entre uma montagem e outra. Um mapa mapeado de
+   arquivo só tem o CSR e não é remontado.
+   O índice de alcance (indice_mansao.h) só é montado para mansões que são
+   árvores; o resolvedor percorre o grafo inteiro. */
+typedef struct Mansao {
+    Sala *salas;
+    uint32_t numSalas;
+    uint32_t capSalas;
+    Internador nomes;
+    Internador pistas;
+    uint32_t *inicioSaidas;   // numSalas + 1 posições; NULL antes de montarGrafo()
+    uint32_t *saidas;
+    uint32_t numSaidas;
+    uint32_t numPassagens;    // passagens no CSR
+    uint32_t *passagens;      // pares (origem, destino) na ordem de criação
+    uint32_t numCriadas;
+    uint32_t capPassagens;
+} Mansao;
+
+void inicializarMansao(Mansao *m);
+uint32_t criarSala(Mansao *m, const char *nome, const char *pista);
+void criarPassagem(Mansao *m, uint32_t origem, uint32_t destino);
+void montarGrafo(Mansao *m);
+uint32_t percorrerGrafo(const Mansao *m, uint32_t origem, uint32_t *ordem);
+void renumerarPistasDasSalas(Mansao *m, const uint32_t *novaPista);
+
+/* conectarSalas()
+   Define os filhos da sala (SEM_SALA para nenhum). */
+static inline void conectarSalas(Mansao *m, uint32_t sala, uint32_t esquerda, uint32_t direita) {
+    m->salas[sala].esquerda = esquerda;
+    m->salas[sala].direita = direita;
+}
+
+/* numCorredores()
+   Quantos dos filhos da árvore (esquerda, direita) a sala tem. */
+static inline uint32_t numCorredores(const Sala *s) {
+    return (s->esquerda != SEM_SALA) + (s->direita != SEM_SALA);
+}
+
+/* numPassagensSala()
+   Quantidade de passagens da sala (0 antes de montarGrafo()). */
+static inline uint32_t numPassagensSala(const Mansao *m, uint32_t sala) {
+    if (m->inicioSaidas == NULL) return 0;
+    return m->inicioSaidas[sala + 1] - m->inicioSaidas[sala] - numCorredores(&m->salas[sala]);
+}
+
+/* passagemSala()
+   Destino da k-ésima passagem da sala (a partir de 0), ou SEM_SALA. */
+static inline uint32_t passagemSala(const Mansao *m, uint32_t sala, uint32_t k) {
+    if (k >= numPassagensSala(m, sala)) return SEM_SALA;
+    return m->saidas[m->inicioSaidas[sala] + numCorredores(&m->salas[sala]) + k];
+}
+
+/* nomeSala()
+   Nome da sala de índice informado. */
+static inline const char* nomeSala(const Mansao *m, uint32_t sala) {
+    return textoInternado(&m->nomes, m->salas[sala].nome);
+}
+
+/* pistaSala()
+   Pista da sala, ou NULL se a sala não tiver pista. */
+static inline const char* pistaSala(const Mansao *m, uint32_t sala) {
+    uint32_t p = m->salas[sala].pista;
+    return p != SEM_PISTA ? textoInternado(&m->pistas, p) : NULL;
+}
+
+/* textoPista()
+   Texto da pista de id informado. */
+static inline const char* textoPista(const Mansao *m, uint32_t pista) {
+    return textoInternado(&m->pistas, pista);
+}
+
+void liberarArvore(Mansao *m);
+
+#endif
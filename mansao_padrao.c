@@ -0,0 +1,20 @@
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "carregador.h"
+
+/* Imagem .dqm de mapas/mansao_padrao.txt, gerada no build por
+   compilar_mapa --c (mansao_padrao_tabelas.c, na pasta do build). */
+extern const unsigned char mansaoPadraoDqm[];
+extern const size_t mansaoPadraoDqmTam;
+
+/* montarMansaoPadrao()
+   Usa no lugar as tabelas da mansão padrão (a de mapas/mansao_padrao.txt),
+   embutidas no programa, para os jogos quando nenhum mapa é informado.
+   Não aloca nem lê nada; liberarMapa() também não tem o que fazer. */
+void montarMansaoPadrao(MapaCarregado *mapa) {
+    if (apontarMapaEstatico(mapa, mansaoPadraoDqm, mansaoPadraoDqmTam, "mansao padrao") != 0) {
+        printf("%s\n", mapa->erro);
+        exit(1);
+    }
+}
@@ -0,0 +1,120 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+
+#include "modo_lote.h"
+#include "registro_eventos.h"
+
+/* jogarPartida()
+   Joga uma linha de movimentos sobre a mansão. acusado pode ser NULL.
+   A linha não é modificada e não precisa terminar em '\0' (usa tam).
+   A sessão, iniciada uma vez sobre o mapa, é reiniciada no começo de cada
+   partida, então jogar não aloca memória depois da primeira partida.
+   Com um registro de eventos aberto, a partida entra nele com o id numero. */
+ResultadoPartida jogarPartida(Sessao *sessao, const MapaCarregado *mapa, unsigned long numero,
+                              const char *movimentos, size_t tam, const char *acusado) {
+    int registrar = registroEventosAtivo();
+    reiniciarSessao(sessao, SALA_ENTRADA);
+    if (registrar) registrarInicio(numero, sessao->salaAtual);
+    if (coletarPistaDaSala(sessao, &mapa->mansao) != NULL && registrar) registrarPista(numero, sessao->salaAtual);
+    for (size_t i = 0; i < tam; ++i) {
+        char c = movimentos[i];
+        if (c == ' ' || c == '\t') continue;
+        ResultadoMovimento r = moverSessao(sessao, &mapa->mansao, c);
+        if (r == MOVIMENTO_SAIR) break;
+        if (registrar) registrarMovimento(numero, sessao->salaAtual, c, r == MOVIMENTO_OK);
+        if (r == MOVIMENTO_OK && coletarPistaDaSala(sessao, &mapa->mansao) != NULL && registrar)
+            registrarPista(numero, sessao->salaAtual);
+    }
+    if (registrar) registrarFim(numero, sessao->salaAtual);
+
+    ResultadoPartida res;
+    res.salaFinal = sessao->salaAtual;
+    res.movimentos = sessao->movimentos;
+    res.invalidos = sessao->invalidos;
+    res.pistas = sessao->numPistas;
+    res.maisProvavel = sessao->suspeitoMaisProvavel;
+    res.evidencias = -1;
+    res.acusacaoValida = 0;
+    if (acusado != NULL && acusado[0] != '\0') {
+        res.evidencias = evidenciasContra(sessao, acusado);
+        res.acusacaoValida = res.evidencias >= ACUSACAO_MINIMA;
+    }
+    return res;
+}
+
+/* separarPartida()
+   Divide a linha (já sem '\n') em movimentos e acusado, no ';'.
+   Retorna o tamanho do trecho de movimentos e aponta *acusado para o nome
+   (sem espaços nas pontas) ou NULL. */
+size_t separarPartida(char *linha, const char **acusado) {
+    char *sep = strchr(linha, ';');
+    *acusado = NULL;
+    if (sep == NULL) return strlen(linha);
+    *sep = '\0';
+    char *nome = sep + 1;
+    while (*nome == ' ' || *nome == '\t') nome++;
+    size_t n = strlen(nome);
+    while (n > 0 && (nome[n - 1] == ' ' || nome[n - 1] == '\t')) nome[--n] = '\0';
+    *acusado = nome;
+    return (size_t) (sep - linha);
+}
+
+/* partidaValida()
+   Indica se a linha da entrada é uma partida (não vazia nem comentário). */
+int partidaValida(const char *linha) {
+    return linha[0] != '\0' && linha[0] != '#';
+}
+
+/* escreverCabecalhoLote()
+   Escreve a linha com os nomes das colunas do resumo. */
+void escreverCabecalhoLote(FILE *saida) {
+    fputs("#sessao\tsala_final\tmovimentos\tinvalidos\tpistas\tmais_provavel\tacusado\tevidencias\tresultado\n", saida);
+}
+
+/* escreverResultado()
+   Escreve a linha de resumo de uma partida. */
+void escreverResultado(FILE *saida, unsigned long numero, const MapaCarregado *mapa,
+                       const ResultadoPartida *r, const char *acusado) {
+    fprintf(saida, "%lu\t%s\t%u\t%u\t%u\t", numero, nomeSala(&mapa->mansao, r->salaFinal),
+            r->movimentos, r->invalidos, r->pistas);
+    fputs(r->maisProvavel != INTERNADOR_AUSENTE ? nomeSuspeito(&mapa->tabela, r->maisProvavel) : "-", saida);
+    fputc('\t', saida);
+    if (r->evidencias < 0)
+        fputs("-\t-\t-\n", saida);
+    else
+        fprintf(saida, "%s\t%d\t%s\n", acusado, r->evidencias, r->acusacaoValida ? "valida" : "insuficiente");
+}
+
+/* executarLote()
+   Joga todas as partidas da entrada e escreve um resumo por partida. */
+ResumoLote executarLote(FILE *entrada, FILE *saida, const MapaCarregado *mapa) {
+    ResumoLote resumo;
+    memset(&resumo, 0, sizeof(resumo));
+    char *linha = NULL;
+    size_t cap = 0;
+    ssize_t lidos;
+    Sessao sessao;
+    iniciarSessao(&sessao, SALA_ENTRADA, &mapa->tabela, NULL, mapa->conjunto);
+
+    setvbuf(saida, NULL, _IOFBF, LOTE_TAM_BUFFER_SAIDA);
+    escreverCabecalhoLote(saida);
+    while ((lidos = getline(&linha, &cap, entrada)) != -1) {
+        linha[strcspn(linha, "\r\n")] = '\0';
+        if (!partidaValida(linha)) continue;
+
+        const char *acusado;
+        size_t tam = separarPartida(linha, &acusado);
+        ResultadoPartida r = jogarPartida(&sessao, mapa, ++resumo.sessoes, linha, tam, acusado);
+        escreverResultado(saida, resumo.sessoes, mapa, &r, acusado);
+        resumo.movimentos += r.movimentos;
+        if (r.acusacaoValida) resumo.acusacoesValidas++;
+    }
+    free(linha);
+    resumo.nos = contadoresPool(&sessao.arena);
+    encerrarSessao(&sessao);
+    fflush(saida);
+    return resumo;
+}
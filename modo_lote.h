@@ -0,0 +1,56 @@
+#ifndef MODO_LOTE_H
+#define MODO_LOTE_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "carregador.h"
+#include "sessao.h"
+
+/* ===================== MODO EM LOTE (SEM INTERAÇÃO) ===================== */
+
+/* Cada linha da entrada é uma partida completa:
+
+     <movimentos>[;<suspeito acusado>]
+
+   Os movimentos são 'e', 'd', '1'..'9' (passagens) e 's' (sair; o restante
+   da linha é ignorado),
+   por exemplo "dd;Herdeiro". Espaços são ignorados, qualquer outro caractere
+   conta como movimento inválido e linhas vazias ou iniciadas por '#' são
+   puladas. Para cada partida é escrita uma linha de resumo separada por
+   tabulações, sem o texto do jogo interativo. */
+
+#define LOTE_TAM_BUFFER_SAIDA (1 << 16)
+
+/* Totais de uma execução em lote. nos soma os contadores das arenas de
+   nós de pista usadas (uma por thread). */
+typedef struct ResumoLote {
+    unsigned long sessoes;
+    unsigned long movimentos;
+    unsigned long acusacoesValidas;
+    ContadoresPool nos;
+} ResumoLote;
+
+/* ResultadoPartida: resumo de uma partida jogada por jogarPartida(). */
+typedef struct ResultadoPartida {
+    uint32_t salaFinal;
+    uint32_t movimentos;
+    uint32_t invalidos;
+    uint32_t pistas;
+    uint32_t maisProvavel; // id do suspeito com mais evidências
+    int evidencias;       // -1 quando não houve acusação
+    int acusacaoValida;
+} ResultadoPartida;
+
+ResultadoPartida jogarPartida(Sessao *sessao, const MapaCarregado *mapa, unsigned long numero,
+                              const char *movimentos, size_t tam, const char *acusado);
+size_t separarPartida(char *linha, const char **acusado);
+int partidaValida(const char *linha);
+void escreverCabecalhoLote(FILE *saida);
+void escreverResultado(FILE *saida, unsigned long numero, const MapaCarregado *mapa,
+                       const ResultadoPartida *r, const char *acusado);
+ResumoLote executarLote(FILE *entrada, FILE *saida, const MapaCarregado *mapa);
+
+#endif
@@ -0,0 +1,97 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "pool.h"
+
+/* inicializarPool()
+   Prepara um pool vazio (o primeiro bloco é alocado no primeiro uso).
+   O tamanho do objeto é arredondado para múltiplo de 8 bytes, o que
+   alinha inteiros de 64 bits e ponteiros. */
+void inicializarPool(PoolNos *p, const char *nome, size_t tamObjeto, uint32_t objetosPorBloco) {
+    p->nome = nome;
+    p->tamObjeto = (tamObjeto + 7) & ~(size_t) 7;
+    p->objetosPorBloco = objetosPorBloco;
+    p->usados = objetosPorBloco;
+    p->primeiro = p->atual = NULL;
+    p->alocacoes = p->alocacoesNoReinicio = 0;
+    p->blocos = p->reinicios = 0;
+    p->pico = 0;
+}
+
+/* alocarEmNovoBloco()
+   Caminho lento de alocarDoPool(): passa para o próximo bloco já alocado
+   (depois de um reinício) ou pede um novo ao malloc(). */
+void* alocarEmNovoBloco(PoolNos *p) {
+    BlocoPool *prox = p->atual != NULL ? p->atual->proximo : p->primeiro;
+    if (prox == NULL) {
+        prox = (BlocoPool*) malloc(sizeof(BlocoPool) + p->tamObjeto * p->objetosPorBloco);
+        if (prox == NULL) {
+            printf("Erro ao alocar memoria para %s.\n", p->nome);
+            exit(1);
+        }
+        prox->proximo = NULL;
+        if (p->atual != NULL) p->atual->proximo = prox;
+        else p->primeiro = prox;
+        p->blocos++;
+    }
+    p->atual = prox;
+    p->usados = 0;
+    return alocarDoPool(p);
+}
+
+/* emUsoPool()
+   Objetos entregues desde o último reinício. */
+static uint32_t emUsoPool(const PoolNos *p) {
+    return (uint32_t) (p->alocacoes - p->alocacoesNoReinicio);
+}
+
+/* reiniciarPool()
+   Descarta todos os objetos de uma vez, mantendo os blocos para reuso. */
+void reiniciarPool(PoolNos *p) {
+    uint32_t emUso = emUsoPool(p);
+    if (emUso > p->pico) p->pico = emUso;
+    p->alocacoesNoReinicio = p->alocacoes;
+    p->reinicios++;
+    p->atual = NULL;
+    p->usados = p->objetosPorBloco;
+}
+
+/* liberarPool()
+   Devolve todos os blocos ao sistema. Os contadores são preservados. */
+void liberarPool(PoolNos *p) {
+    uint32_t emUso = emUsoPool(p);
+    if (emUso > p->pico) p->pico = emUso;
+    p->alocacoesNoReinicio = p->alocacoes;
+    p->atual = NULL;
+    p->usados = p->objetosPorBloco;
+    BlocoPool *b = p->primeiro;
+    while (b != NULL) {
+        BlocoPool *prox = b->proximo;
+        free(b);
+        b = prox;
+    }
+    p->primeiro = NULL;
+}
+
+/* contadoresPool()
+   Retrato dos contadores do pool. */
+ContadoresPool contadoresPool(const PoolNos *p) {
+    ContadoresPool c;
+    c.alocacoes = p->alocacoes;
+    c.blocos = p->blocos;
+    c.reinicios = p->reinicios;
+    c.emUso = emUsoPool(p);
+    c.pico = c.emUso > p->pico ? c.emUso : p->pico;
+    return c;
+}
+
+/* somarContadoresPool()
+   Acumula os contadores de um pool (por exemplo, o de cada thread) num total. */
+void somarContadoresPool(ContadoresPool *total, const ContadoresPool *c) {
+    total->alocacoes += c->alocacoes;
+    total->blocos += c->blocos;
+    total->reinicios += c->reinicios;
+    total->emUso += c->emUso;
+    if (c->pico > total->pico) total->pico = c->pico;
+}
@@ -0,0 +1,63 @@
+#ifndef POOL_H
+#define POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* ===================== POOL DE NÓS (SLABS) ===================== */
+
+/* Pool de objetos de tamanho fixo, alocados em blocos (slabs) de
+   objetosPorBloco objetos. Alocar é avançar um contador no bloco atual;
+   os objetos não são devolvidos um a um, e sim todos juntos:
+   reiniciarPool() é O(1) e mantém os blocos para a próxima rodada, e
+   liberarPool() devolve os blocos ao sistema.
+
+   Cada pool conta as alocações que atendeu, quantos blocos pediu ao
+   malloc() e o pico de objetos em uso entre dois reinícios. */
+
+typedef struct ContadoresPool {
+    uint64_t alocacoes;   // objetos entregues pelo pool
+    uint64_t blocos;      // blocos pedidos ao malloc()
+    uint64_t reinicios;
+    uint32_t emUso;       // objetos entregues desde o último reinício
+    uint32_t pico;        // maior emUso já visto
+} ContadoresPool;
+
+/* Bloco de objetos (lista encadeada de blocos). */
+typedef struct BlocoPool {
+    struct BlocoPool *proximo;
+    max_align_t dados[];
+} BlocoPool;
+
+typedef struct PoolNos {
+    const char *nome;
+    size_t tamObjeto;
+    uint32_t objetosPorBloco;
+    uint32_t usados;          // objetos usados no bloco atual
+    BlocoPool *primeiro;
+    BlocoPool *atual;
+    uint64_t alocacoes;
+    uint64_t alocacoesNoReinicio;
+    uint64_t blocos;
+    uint64_t reinicios;
+    uint32_t pico;
+} PoolNos;
+
+void inicializarPool(PoolNos *p, const char *nome, size_t tamObjeto, uint32_t objetosPorBloco);
+void* alocarEmNovoBloco(PoolNos *p);
+
+/* alocarDoPool()
+   Retorna um objeto livre (não zerado). Só sai da função inline quando o
+   bloco atual se esgota. */
+static inline void* alocarDoPool(PoolNos *p) {
+    if (p->usados == p->objetosPorBloco) return alocarEmNovoBloco(p);
+    p->alocacoes++;
+    return (char*) p->atual->dados + (size_t) p->usados++ * p->tamObjeto;
+}
+
+void reiniciarPool(PoolNos *p);
+void liberarPool(PoolNos *p);
+ContadoresPool contadoresPool(const PoolNos *p);
+void somarContadoresPool(ContadoresPool *total, const ContadoresPool *c);
+
+#endif
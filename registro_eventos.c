@@ -0,0 +1,305 @@
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "internador.h"
+#include "registro_eventos.h"
+
+#define MASCARA_ANEL (REGISTRO_TAM_ANEL - 1)
+
+_Static_assert((REGISTRO_TAM_ANEL & MASCARA_ANEL) == 0, "REGISTRO_TAM_ANEL deve ser potencia de 2");
+_Static_assert(sizeof(EventoJogo) == 32, "EventoJogo deve ter 32 bytes");
+
+/* Anel de uma thread. cabeca só é escrita pela thread que joga e cauda só
+   pela escritora; ficam em linhas de cache diferentes para que uma não
+   invalide a outra a cada evento. caudaVista é a última cauda lida pelo
+   produtor, que só volta a ler a cauda de verdade quando o anel parece
+   cheio. */
+typedef struct AnelEventos {
+    EventoJogo eventos[REGISTRO_TAM_ANEL];
+    _Alignas(64) atomic_uint_fast64_t cabeca;
+    uint64_t caudaVista;
+    uint64_t esperas;
+    _Alignas(64) atomic_uint_fast64_t cauda;
+    uint32_t numero;
+    struct AnelEventos *proximo;
+} AnelEventos;
+
+/* Estado do registro aberto. A lista de anéis só cresce enquanto ele está
+   aberto, então a escritora a percorre sem trava. */
+typedef struct RegistroEventos {
+    FILE *arquivo;
+    char *buffer;
+    const DqMansao *mansao;
+    pthread_t escritora;
+    atomic_int encerrar;
+    _Atomic(AnelEventos*) aneis;
+    atomic_uint numAneis;
+    uint64_t eventos;   // gravados pela escritora
+    int erro;
+} RegistroEventos;
+
+static RegistroEventos registro;
+atomic_int registroLigado = 0;
+
+/* Cada abertura muda a geração; o anel guardado por uma thread só vale
+   para a geração em que foi criado. */
+static atomic_uint geracaoRegistro = 0;
+static _Thread_local AnelEventos *anelDaThread = NULL;
+static _Thread_local unsigned geracaoDaThread = 0;
+
+/* criarAnel()
+   Cria o anel da thread atual e o acrescenta à lista do registro. Os
+   anéis de um registro aberto são numerados abaixo de REGISTRO_MAX_ANEIS,
+   o limite gravado no cabeçalho. */
+static AnelEventos* criarAnel(void) {
+    uint32_t numero = atomic_fetch_add_explicit(&registro.numAneis, 1, memory_order_relaxed);
+    if (numero >= REGISTRO_MAX_ANEIS) {
+        printf("Erro: mais de %u threads no registro de eventos.\n", REGISTRO_MAX_ANEIS);
+        exit(1);
+    }
+    void *memoria;
+    if (posix_memalign(&memoria, 64, sizeof(AnelEventos)) != 0) {
+        printf("Erro ao alocar memoria para o registro de eventos.\n");
+        exit(1);
+    }
+    AnelEventos *a = (AnelEventos*) memoria;
+    memset(a, 0, sizeof(*a));
+    atomic_init(&a->cabeca, 0);
+    atomic_init(&a->cauda, 0);
+    a->numero = numero;
+    a->proximo = atomic_load_explicit(&registro.aneis, memory_order_relaxed);
+    while (!atomic_compare_exchange_weak_explicit(&registro.aneis, &a->proximo, a,
+                                                  memory_order_release, memory_order_relaxed)) { }
+    return a;
+}
+
+/* registrarEvento()
+   Põe um evento no anel da thread, esperando se ele estiver cheio. */
+static void registrarEvento(uint8_t tipo, uint64_t sessao, uint32_t sala, uint32_t pista, char escolha) {
+    if (!registroEventosAtivo()) return;
+    unsigned geracao = atomic_load_explicit(&geracaoRegistro, memory_order_relaxed);
+    AnelEventos *a = anelDaThread;
+    if (a == NULL || geracaoDaThread != geracao) {
+        a = anelDaThread = criarAnel();
+        geracaoDaThread = geracao;
+    }
+
+    uint64_t cabeca = atomic_load_explicit(&a->cabeca, memory_order_relaxed);
+    if (cabeca - a->caudaVista == REGISTRO_TAM_ANEL) {
+        a->caudaVista = atomic_load_explicit(&a->cauda, memory_order_acquire);
+        if (cabeca - a->caudaVista == REGISTRO_TAM_ANEL) a->esperas++;
+        while (cabeca - a->caudaVista == REGISTRO_TAM_ANEL) {
+            sched_yield();
+            a->caudaVista = atomic_load_explicit(&a->cauda, memory_order_acquire);
+        }
+    }
+
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    EventoJogo *e = &a->eventos[cabeca & MASCARA_ANEL];
+    e->sessao = sessao;
+    e->instante = (uint64_t) ts.tv_sec * 1000000000u + (uint64_t) ts.tv_nsec;
+    e->sala = sala;
+    e->pista = pista;
+    e->anel = a->numero;
+    e->tipo = tipo;
+    e->escolha = escolha;
+    e->reservado = 0;
+    atomic_store_explicit(&a->cabeca, cabeca + 1, memory_order_release);
+}
+
+/* esvaziarAneis()
+   Grava no arquivo tudo o que há nos anéis, direto da memória do anel
+   (no máximo dois trechos por anel, por causa da volta), e devolve o
+   espaço aos produtores. Retorna quantos eventos foram gravados. */
+static uint64_t esvaziarAneis(void) {
+    uint64_t gravados = 0;
+    for (AnelEventos *a = atomic_load_explicit(&registro.aneis, memory_order_acquire); a != NULL; a = a->proximo) {
+        uint64_t cauda = atomic_load_explicit(&a->cauda, memory_order_relaxed);
+        uint64_t cabeca = atomic_load_explicit(&a->cabeca, memory_order_acquire);
+        while (cauda != cabeca) {
+            size_t inicio = (size_t) (cauda & MASCARA_ANEL);
+            size_t n = (size_t) (cabeca - cauda);
+            if (n > REGISTRO_TAM_ANEL - inicio) n = REGISTRO_TAM_ANEL - inicio;
+            if (fwrite(&a->eventos[inicio], sizeof(EventoJogo), n, registro.arquivo) != n) registro.erro = 1;
+            cauda += n;
+            gravados += n;
+        }
+        atomic_store_explicit(&a->cauda, cauda, memory_order_release);
+    }
+    return gravados;
+}
+
+/* escreverRegistro()
+   Laço da thread escritora: esvazia os anéis enquanto houver eventos e
+   dorme REGISTRO_PAUSA_NS quando estão vazios. Ao encerrar, só sai depois
+   de uma rodada sem nenhum evento. */
+static void* escreverRegistro(void *arg) {
+    (void) arg;
+    struct timespec pausa = { 0, REGISTRO_PAUSA_NS };
+    while (1) {
+        int encerrar = atomic_load_explicit(&registro.encerrar, memory_order_acquire);
+        uint64_t gravados = esvaziarAneis();
+        registro.eventos += gravados;
+        if (gravados > 0) {
+            if (fflush(registro.arquivo) != 0) registro.erro = 1;
+        } else if (encerrar) {
+            break;
+        } else {
+            nanosleep(&pausa, NULL);
+        }
+    }
+    return NULL;
+}
+
+/* abrirRegistroEventos()
+   Abre o log para acréscimo (criando-o com o cabeçalho se estiver vazio)
+   e inicia a thread escritora. Um log existente precisa ser da mesma
+   mansão. Retorna -1 se não conseguir, com a mensagem já escrita. */
+int abrirRegistroEventos(const char *caminho, const DqMansao *mansao) {
+    if (registroEventosAtivo()) {
+        printf("Erro: ja existe um registro de eventos aberto.\n");
+        return -1;
+    }
+    FILE *arquivo = fopen(caminho, "ab+");
+    if (arquivo == NULL) {
+        printf("Erro ao abrir o registro de eventos %s.\n", caminho);
+        return -1;
+    }
+    fseek(arquivo, 0, SEEK_END);
+    if (ftell(arquivo) > 0) {
+        char erro[DQ_TAM_ERRO];
+        rewind(arquivo);
+        if (lerCabecalhoRegistro(arquivo, mansao, NULL, erro, sizeof(erro)) != 0) {
+            printf("%s: %s\n", caminho, erro);
+            fclose(arquivo);
+            return -1;
+        }
+    } else {
+        CabecalhoRegistro c;
+        memset(&c, 0, sizeof(c));
+        memcpy(c.magica, REGISTRO_MAGICA, sizeof(c.magica));
+        c.versao = REGISTRO_VERSAO;
+        c.tamEvento = sizeof(EventoJogo);
+        c.numSalas = dqNumSalas(mansao);
+        c.numPistas = dqNumPistas(mansao);
+        c.maxAneis = REGISTRO_MAX_ANEIS;
+        if (fwrite(&c, sizeof(c), 1, arquivo) != 1 || fflush(arquivo) != 0) {
+            printf("Erro ao gravar o registro de eventos %s.\n", caminho);
+            fclose(arquivo);
+            return -1;
+        }
+    }
+
+    registro.buffer = (char*) realocarOuSair(NULL, REGISTRO_TAM_BUFFER, "o registro de eventos");
+    setvbuf(arquivo, registro.buffer, _IOFBF, REGISTRO_TAM_BUFFER);
+    registro.arquivo = arquivo;
+    registro.mansao = mansao;
+    registro.eventos = 0;
+    registro.erro = 0;
+    atomic_store(&registro.encerrar, 0);
+    atomic_store(&registro.aneis, NULL);
+    atomic_store(&registro.numAneis, 0);
+    atomic_fetch_add(&geracaoRegistro, 1);
+    if (pthread_create(&registro.escritora, NULL, escreverRegistro, NULL) != 0) {
+        printf("Erro ao iniciar a thread do registro de eventos.\n");
+        fclose(arquivo);
+        free(registro.buffer);
+        return -1;
+    }
+    atomic_store(&registroLigado, 1);
+    return 0;
+}
+
+/* fecharRegistroEventos()
+   Para de aceitar eventos, espera a escritora gravar o que restou nos
+   anéis e fecha o arquivo. As threads que jogaram já devem ter parado. */
+ResumoRegistro fecharRegistroEventos(void) {
+    ResumoRegistro r;
+    memset(&r, 0, sizeof(r));
+    if (!registroEventosAtivo()) return r;
+    atomic_store(&registroLigado, 0);
+    atomic_store_explicit(&registro.encerrar, 1, memory_order_release);
+    pthread_join(registro.escritora, NULL);
+    if (fclose(registro.arquivo) != 0) registro.erro = 1;
+    free(registro.buffer);
+
+    r.eventos = registro.eventos;
+    r.erro = registro.erro;
+    AnelEventos *a = atomic_load(&registro.aneis);
+    while (a != NULL) {
+        AnelEventos *proximo = a->proximo;
+        r.esperas += a->esperas;
+        r.aneis++;
+        free(a);
+        a = proximo;
+    }
+    atomic_store(&registro.aneis, NULL);
+    return r;
+}
+
+/* registrarInicio()
+   A sessão começou (ou recomeçou) na sala. */
+void registrarInicio(uint64_t sessao, uint32_t sala) {
+    registrarEvento(REG_INICIO, sessao, sala, REGISTRO_SEM_PISTA, 0);
+}
+
+/* registrarMovimento()
+   Escolha processada pela sessão: válida (sala é o destino) ou não (sala
+   é a atual). */
+void registrarMovimento(uint64_t sessao, uint32_t sala, char escolha, int valido) {
+    registrarEvento(valido ? REG_MOVIMENTO : REG_INVALIDO, sessao, sala, REGISTRO_SEM_PISTA, escolha);
+}
+
+/* registrarPista()
+   A pista da sala foi coletada; o id vem da mansão do registro. */
+void registrarPista(uint64_t sessao, uint32_t sala) {
+    if (!registroEventosAtivo()) return;
+    registrarEvento(REG_PISTA, sessao, sala, dqIdPistaSala(registro.mansao, sala), 0);
+}
+
+/* registrarFim()
+   A sessão terminou na sala. */
+void registrarFim(uint64_t sessao, uint32_t sala) {
+    registrarEvento(REG_FIM, sessao, sala, REGISTRO_SEM_PISTA, 0);
+}
+
+/* lerCabecalhoRegistro()
+   Lê e confere o cabeçalho de um log, deixando o arquivo no primeiro
+   evento. Com mansao, confere também se o log é dessa mansão; com
+   maxAneis, devolve o limite dos anéis, acima do qual um evento só pode
+   estar corrompido. Retorna -1 com a mensagem em erro se o log não servir. */
+int lerCabecalhoRegistro(FILE *arquivo, const DqMansao *mansao, uint32_t *maxAneis, char *erro, size_t tamErro) {
+    CabecalhoRegistro c;
+    if (fread(&c, sizeof(c), 1, arquivo) != 1 || memcmp(c.magica, REGISTRO_MAGICA, sizeof(c.magica)) != 0) {
+        snprintf(erro, tamErro, "Arquivo nao e um registro de eventos.");
+        return -1;
+    }
+    if (c.versao != REGISTRO_VERSAO || c.tamEvento != sizeof(EventoJogo)) {
+        snprintf(erro, tamErro, "Registro de eventos na versao %u (esperada %u).", c.versao, REGISTRO_VERSAO);
+        return -1;
+    }
+    if (c.maxAneis == 0 || c.maxAneis > REGISTRO_MAX_ANEIS) {
+        snprintf(erro, tamErro, "Registro de eventos com limite de aneis invalido (%u).", c.maxAneis);
+        return -1;
+    }
+    if (mansao != NULL && (c.numSalas != dqNumSalas(mansao) || c.numPistas != dqNumPistas(mansao))) {
+        snprintf(erro, tamErro, "Registro de outra mansao (%u salas e %u pistas).", c.numSalas, c.numPistas);
+        return -1;
+    }
+    if (maxAneis != NULL) *maxAneis = c.maxAneis;
+    return 0;
+}
+
+/* nomeTipoEvento()
+   Nome do tipo de evento, para listagens. */
+const char* nomeTipoEvento(uint8_t tipo) {
+    static const char *const nomes[] = { "inicio", "movimento", "invalido", "pista", "fim" };
+    return tipo <= REG_FIM ? nomes[tipo] : "?";
+}
@@ -0,0 +1,100 @@
+#ifndef REGISTRO_EVENTOS_H
+#define REGISTRO_EVENTOS_H
+
+#include <stdatomic.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+
+#include "detective.h"
+
+/* ===================== REGISTRO DE EVENTOS ===================== */
+
+/* Log binário, só de acréscimo, com cada movimento e cada pista coletada
+   das partidas, para auditoria e para reproduzir as partidas depois
+   (reproduzir_registro).
+
+   Quem joga não faz entrada e saída: cada thread escreve os eventos num
+   anel próprio (um produtor e um consumidor, sem travas), criado no
+   primeiro evento da thread. Uma thread escritora esvazia os anéis em
+   lotes, gravando os trechos ocupados direto do anel no arquivo. Se o
+   anel de uma thread enche, ela espera a escritora abrir espaço (nenhum
+   evento se perde) e a espera é contada no resumo.
+
+   O arquivo é um CabecalhoRegistro seguido de EventoJogo de tamanho fixo,
+   na ordem de bytes da máquina. Os eventos de uma thread saem na ordem em
+   que aconteceram, mas os de threads diferentes se intercalam. Como cada
+   thread joga uma sessão de cada vez, os eventos de uma sessão são os do
+   seu anel entre o REG_INICIO e o REG_FIM.
+
+   Só um registro fica aberto por vez. Abrir e fechar devem acontecer sem
+   threads jogando. */
+
+#define REGISTRO_MAGICA "DQEVENT\0"
+#define REGISTRO_VERSAO 2
+#define REGISTRO_TAM_ANEL 8192          // eventos por thread (potência de 2)
+#define REGISTRO_TAM_BUFFER (1 << 20)   // buffer de escrita do arquivo
+#define REGISTRO_PAUSA_NS 1000000       // espera da escritora com os anéis vazios
+#define REGISTRO_MAX_ANEIS 4096        // threads que escrevem num mesmo registro aberto
+#define REGISTRO_SEM_PISTA UINT32_MAX
+#define REGISTRO_SESSAO_INTERATIVA 1    // id da sessão do jogo no terminal
+
+typedef enum {
+    REG_INICIO,      // sessão (re)começou na sala
+    REG_MOVIMENTO,   // movimento válido; sala é o destino
+    REG_INVALIDO,    // escolha não reconhecida; sala é a atual
+    REG_PISTA,       // pista da sala coletada
+    REG_FIM          // sessão terminou na sala
+} TipoEvento;
+
+typedef struct CabecalhoRegistro {
+    char magica[8];
+    uint32_t versao;
+    uint32_t tamEvento;
+    uint32_t numSalas;   // da mansão em que as partidas foram jogadas
+    uint32_t numPistas;
+    uint32_t maxAneis;   // todo evento do log tem anel menor que isto
+    uint32_t reservado;
+} CabecalhoRegistro;
+
+/* Um evento, com 32 bytes. instante é em ns desde a época (CLOCK_REALTIME);
+   anel identifica a thread que o produziu; escolha é a tecla do
+   movimento ('e', 'd', '1'..'9') ou 0. */
+typedef struct EventoJogo {
+    uint64_t sessao;
+    uint64_t instante;
+    uint32_t sala;
+    uint32_t pista;      // id no pool de pistas, ou REGISTRO_SEM_PISTA
+    uint32_t anel;
+    uint8_t tipo;
+    char escolha;
+    uint16_t reservado;
+} EventoJogo;
+
+/* Totais de um registro, devolvidos por fecharRegistroEventos(). */
+typedef struct ResumoRegistro {
+    uint64_t eventos;
+    uint64_t esperas;    // eventos que encontraram o anel cheio
+    uint32_t aneis;
+    int erro;            // falha de escrita no arquivo
+} ResumoRegistro;
+
+extern atomic_int registroLigado;
+
+/* registroEventosAtivo()
+   1 se há um registro aberto; quem joga testa isto antes de montar os
+   eventos, então o registro desligado custa uma leitura por movimento. */
+static inline int registroEventosAtivo(void) {
+    return atomic_load_explicit(&registroLigado, memory_order_relaxed);
+}
+
+int abrirRegistroEventos(const char *caminho, const DqMansao *mansao);
+ResumoRegistro fecharRegistroEventos(void);
+void registrarInicio(uint64_t sessao, uint32_t sala);
+void registrarMovimento(uint64_t sessao, uint32_t sala, char escolha, int valido);
+void registrarPista(uint64_t sessao, uint32_t sala);
+void registrarFim(uint64_t sessao, uint32_t sala);
+int lerCabecalhoRegistro(FILE *arquivo, const DqMansao *mansao, uint32_t *maxAneis, char *erro, size_t tamErro);
+const char* nomeTipoEvento(uint8_t tipo);
+
+#endif
@@ -0,0 +1,178 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "renderizador.h"
+
+/* Folga do buffer da jogada além do maior quadro: cabe qualquer
+   combinação de mensagens de uma jogada. */
+#define FOLGA_BUFFER 256
+
+/* realocarTexto()
+   realloc() que encerra o programa se faltar memória. */
+static void* realocarTexto(void *ptr, size_t tamanho) {
+    void *novo = realloc(ptr, tamanho);
+    if (novo == NULL) {
+        printf("Erro ao alocar memoria para a saida do jogo.\n");
+        exit(1);
+    }
+    return novo;
+}
+
+/* anexarQuadro()
+   Acrescenta um texto aos quadros em montagem. */
+static void anexarQuadro(Renderizador *r, size_t *cap, const char *texto) {
+    size_t n = strlen(texto);
+    if (r->tam + n > *cap) {
+        while (r->tam + n > *cap) *cap *= 2;
+        r->quadros = (char*) realocarTexto(r->quadros, *cap);
+    }
+    memcpy(r->quadros + r->tam, texto, n);
+    r->tam += n;
+}
+
+/* montarQuadro()
+   Escreve o quadro fixo de uma sala no formato escolhido. */
+static void montarQuadro(Renderizador *r, size_t *cap, const DqMansao *m, uint32_t sala) {
+    const char *pista = r->comPistas ? dqPistaSala(m, sala) : NULL;
+    uint32_t esquerda = dqSalaVizinha(m, sala, 'e');
+    uint32_t direita = dqSalaVizinha(m, sala, 'd');
+    uint32_t passagens = dqNumPassagens(m, sala);
+    if (passagens > DQ_PASSAGENS_POR_DIGITO) passagens = DQ_PASSAGENS_POR_DIGITO;
+    int semSaidas = !r->comPistas && esquerda == DQ_SEM_SALA && direita == DQ_SEM_SALA && passagens == 0;
+
+    if (r->formato == SAIDA_PROTOCOLO) {
+        anexarQuadro(r, cap, "sala\t");
+        anexarQuadro(r, cap, dqNomeSala(m, sala));
+        anexarQuadro(r, cap, "\t");
+        anexarQuadro(r, cap, pista != NULL ? pista : "-");
+        anexarQuadro(r, cap, "\t");
+        anexarQuadro(r, cap, esquerda != DQ_SEM_SALA ? dqNomeSala(m, esquerda) : "-");
+        anexarQuadro(r, cap, "\t");
+        anexarQuadro(r, cap, direita != DQ_SEM_SALA ? dqNomeSala(m, direita) : "-");
+        // as passagens, se houver, vêm em colunas extras
+        for (uint32_t k = 0; k < passagens; ++k) {
+            anexarQuadro(r, cap, "\t");
+            anexarQuadro(r, cap, dqNomeSala(m, dqPassagem(m, sala, k)));
+        }
+        anexarQuadro(r, cap, "\n");
+        if (semSaidas) anexarQuadro(r, cap, "fim\n");
+        return;
+    }
+
+    anexarQuadro(r, cap, "\nVocê está em: ");
+    anexarQuadro(r, cap, dqNomeSala(m, sala));
+    anexarQuadro(r, cap, "\n");
+    if (pista != NULL) {
+        anexarQuadro(r, cap, "Você encontrou uma pista: \"");
+        anexarQuadro(r, cap, pista);
+        anexarQuadro(r, cap, "\"\n");
+    }
+    // no nível Novato a exploração termina numa sala sem saídas
+    if (semSaidas) {
+        anexarQuadro(r, cap, "Não há mais caminhos a seguir. Fim da exploração.\n");
+        return;
+    }
+    anexarQuadro(r, cap, "Escolha um caminho:\n");
+    if (esquerda != DQ_SEM_SALA) {
+        anexarQuadro(r, cap, " (e) Ir para ");
+        anexarQuadro(r, cap, dqNomeSala(m, esquerda));
+        anexarQuadro(r, cap, "\n");
+    }
+    if (direita != DQ_SEM_SALA) {
+        anexarQuadro(r, cap, " (d) Ir para ");
+        anexarQuadro(r, cap, dqNomeSala(m, direita));
+        anexarQuadro(r, cap, "\n");
+    }
+    for (uint32_t k = 0; k < passagens; ++k) {
+        char opcao[32];
+        snprintf(opcao, sizeof(opcao), " (%u) Passagem para ", k + 1);
+        anexarQuadro(r, cap, opcao);
+        anexarQuadro(r, cap, dqNomeSala(m, dqPassagem(m, sala, k)));
+        anexarQuadro(r, cap, "\n");
+    }
+    anexarQuadro(r, cap, " (s) Sair do jogo\n>> ");
+}
+
+/* prepararRenderizador()
+   Monta os quadros de todas as salas da mansão (com a pista da sala se
+   comPistas) e o buffer das jogadas. */
+void prepararRenderizador(Renderizador *r, const DqMansao *m, int comPistas, FormatoSaida formato) {
+    uint32_t n = dqNumSalas(m);
+    size_t cap = 4096;
+    size_t maiorQuadro = 0;
+    r->formato = formato;
+    r->comPistas = comPistas;
+    r->numSalas = n;
+    r->inicioQuadro = (size_t*) realocarTexto(NULL, ((size_t) n + 1) * sizeof(size_t));
+    r->quadros = (char*) realocarTexto(NULL, cap);
+    r->tam = 0;
+    for (uint32_t s = 0; s < n; ++s) {
+        r->inicioQuadro[s] = r->tam;
+        montarQuadro(r, &cap, m, s);
+        if (r->tam - r->inicioQuadro[s] > maiorQuadro) maiorQuadro = r->tam - r->inicioQuadro[s];
+    }
+    r->inicioQuadro[n] = r->tam;
+
+    r->cap = maiorQuadro + FOLGA_BUFFER;
+    r->buffer = (char*) realocarTexto(NULL, r->cap);
+    r->tam = 0;
+}
+
+/* anexarJogada()
+   Acrescenta bytes à jogada em montagem. */
+static void anexarJogada(Renderizador *r, const char *dados, size_t n) {
+    if (r->tam + n > r->cap) {
+        r->cap = (r->tam + n) * 2;
+        r->buffer = (char*) realocarTexto(r->buffer, r->cap);
+    }
+    memcpy(r->buffer + r->tam, dados, n);
+    r->tam += n;
+}
+
+/* renderizarSala()
+   Acrescenta o quadro pronto da sala à jogada. */
+void renderizarSala(Renderizador *r, uint32_t sala) {
+    size_t inicio = r->inicioQuadro[sala];
+    anexarJogada(r, r->quadros + inicio, r->inicioQuadro[sala + 1] - inicio);
+}
+
+/* renderizarEvento()
+   Acrescenta a mensagem de um evento da jogada. */
+void renderizarEvento(Renderizador *r, EventoJogada evento) {
+    static const char invalidoTexto[] = "Opção inválida. Tente novamente.\n";
+    static const char sairTexto[] = "\nVocê decidiu encerrar a exploração.\n";
+    static const char invalidoProtocolo[] = "invalido\n";
+    static const char sairProtocolo[] = "sair\n";
+
+    if (r->formato == SAIDA_PROTOCOLO) {
+        if (evento == EVENTO_INVALIDO) anexarJogada(r, invalidoProtocolo, sizeof(invalidoProtocolo) - 1);
+        else anexarJogada(r, sairProtocolo, sizeof(sairProtocolo) - 1);
+    } else if (evento == EVENTO_INVALIDO) {
+        anexarJogada(r, invalidoTexto, sizeof(invalidoTexto) - 1);
+    } else if (r->comPistas) {
+        anexarJogada(r, sairTexto, sizeof(sairTexto) - 1);
+    } else {
+        // o nível Novato não deixa linha em branco antes da despedida
+        anexarJogada(r, sairTexto + 1, sizeof(sairTexto) - 2);
+    }
+}
+
+/* descarregarRenderizador()
+   Envia a jogada montada para a saída padrão numa única escrita. */
+void descarregarRenderizador(Renderizador *r) {
+    if (r->tam > 0) fwrite(r->buffer, 1, r->tam, stdout);
+    fflush(stdout);
+    r->tam = 0;
+}
+
+/* liberarRenderizador()
+   Libera os quadros e o buffer. */
+void liberarRenderizador(Renderizador *r) {
+    free(r->inicioQuadro);
+    free(r->quadros);
+    free(r->buffer);
+    r->inicioQuadro = NULL;
+    r->quadros = NULL;
+    r->buffer = NULL;
+}
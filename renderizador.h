@@ -0,0 +1,72 @@
+#ifndef RENDERIZADOR_H
+#define RENDERIZADOR_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "detective.h"
+
+/* ===================== SAÍDA BUFERIZADA DO JOGO ===================== */
+
+/* Camada de saída da exploração interativa. O texto fixo de cada sala
+   (nome, pista e menu de caminhos) é montado uma vez, quando a mansão é
+   carregada; a cada jogada o quadro da sala é copiado para um buffer
+   reaproveitado junto com as mensagens da jogada, e o buffer vai para a
+   saída padrão numa única escrita, logo antes de ler a próxima escolha.
+   Durante a exploração não há alocações, printf() nem strlen().
+
+   Há dois formatos:
+   - SAIDA_TEXTO: o texto do jogo em português, como sempre foi;
+   - SAIDA_PROTOCOLO: linhas curtas separadas por tabulações, para
+     programas que conversam com o jogo por um pipe ou pelo servidor
+     (servidor.h):
+
+       protocolo  <versão>                     início da partida
+       sala       <nome> <pista|-> <esquerda|-> <direita|-> [<passagem 1> ... <passagem 9>]
+       invalido                                escolha não reconhecida
+       fim                                     sala sem saídas (Novato)
+       sair                                    o jogador saiu
+       pistas     <quantidade>                 seguido de uma linha por pista:
+       pista      <texto>
+       suspeito   <nome> <evidências>          o mais provável, se houver
+       ranking    <nome> <pontos>              os de mais pontos (mapas com pesos)
+       acusar                                  esperando o nome do acusado
+       acusacao   <nome|-> <evidências> valida|insuficiente|sem_pistas|cancelada|erro
+       obrigado                                fim do jogo
+
+     No nível Novato o campo da pista da linha "sala" é sempre "-". As
+     colunas de passagens só aparecem em salas que as têm, então mapas sem
+     passagens produzem as mesmas linhas de antes; o mesmo vale para as
+     linhas "ranking" em mapas sem pesos. */
+
+#define PROTOCOLO_VERSAO 1
+
+typedef enum {
+    SAIDA_TEXTO,
+    SAIDA_PROTOCOLO
+} FormatoSaida;
+
+/* Mensagens de uma jogada, acrescentadas depois (ou antes) do quadro. */
+typedef enum {
+    EVENTO_INVALIDO,
+    EVENTO_SAIR
+} EventoJogada;
+
+typedef struct Renderizador {
+    FormatoSaida formato;
+    int comPistas;          // quadros do nível Aventureiro/Mestre (com a pista da sala)
+    uint32_t numSalas;
+    size_t *inicioQuadro;   // quadro da sala s: quadros[inicioQuadro[s] .. inicioQuadro[s + 1])
+    char *quadros;
+    char *buffer;           // jogada em montagem
+    size_t tam;
+    size_t cap;
+} Renderizador;
+
+void prepararRenderizador(Renderizador *r, const DqMansao *m, int comPistas, FormatoSaida formato);
+void renderizarSala(Renderizador *r, uint32_t sala);
+void renderizarEvento(Renderizador *r, EventoJogada evento);
+void descarregarRenderizador(Renderizador *r);
+void liberarRenderizador(Renderizador *r);
+
+#endif
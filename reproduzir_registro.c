@@ -0,0 +1,188 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "detective.h"
+#include "internador.h"
+#include "registro_eventos.h"
+
+/* Reproduz um registro de eventos (registro_eventos.h) no motor, sem
+   terminal: cada sessão do log é jogada de novo numa sessão da API com as
+   mesmas escolhas, conferindo a cada evento se o resultado, a sala e a
+   pista batem com as do log. Para cada sessão terminada escreve uma linha
+   com as colunas do modo lote (sem as da acusação) e o número de
+   divergências, na ordem em que as sessões terminaram no log. Com
+   --listar, apenas escreve os eventos, um por linha.
+
+   Uso: reproduzir_registro <mapa> <eventos.dqe> [--listar]
+
+   Eventos com anel acima do limite gravado no cabeçalho só podem estar
+   corrompidos: são contados e ignorados.
+
+   Retorna 1 se alguma sessão divergiu do log ou havia eventos corrompidos. */
+
+#define TAM_LOTE_LEITURA 4096
+
+/* Sessão sendo reproduzida para um anel do log (uma thread joga uma
+   sessão de cada vez, então basta uma por anel). */
+typedef struct Reproducao {
+    DqSessao *sessao;
+    uint64_t id;
+    uint32_t divergencias;
+    int ativa;
+} Reproducao;
+
+typedef struct TotaisReproducao {
+    unsigned long long eventos;
+    unsigned long long sessoes;
+    unsigned long long divergencias;
+    unsigned long long incompletas;   // sem REG_FIM antes do próximo REG_INICIO do anel
+    unsigned long long avulsos;       // eventos fora de uma sessão
+    unsigned long long corrompidos;   // anel acima do limite do cabeçalho
+} TotaisReproducao;
+
+/* reproducaoDoAnel()
+   Estado do anel, aumentando o vetor se for um anel ainda não visto. O
+   anel precisa estar abaixo de maxAneis (lerCabecalhoRegistro()), que
+   limita o vetor. */
+static Reproducao* reproducaoDoAnel(Reproducao **vetor, uint32_t *cap, uint32_t anel, uint32_t maxAneis) {
+    if (anel >= *cap) {
+        uint32_t novo = *cap ? *cap : 16;
+        while (novo <= anel) novo *= 2;
+        if (novo > maxAneis) novo = maxAneis;
+        *vetor = (Reproducao*) realocarOuSair(*vetor, (size_t) novo * sizeof(Reproducao), "a reproducao");
+        memset(*vetor + *cap, 0, (size_t) (novo - *cap) * sizeof(Reproducao));
+        *cap = novo;
+    }
+    return &(*vetor)[anel];
+}
+
+/* escreverSessao()
+   Linha de resumo de uma sessão reproduzida. */
+static void escreverSessao(const Reproducao *rp) {
+    DqEstatisticas e;
+    dqEstatisticas(rp->sessao, &e);
+    printf("%llu\t%s\t%u\t%u\t%u\t%s\t%u\n", (unsigned long long) rp->id, e.sala, e.movimentos, e.invalidos,
+           e.pistas, e.maisProvavel != NULL ? e.maisProvavel : "-", rp->divergencias);
+}
+
+/* reproduzirEvento()
+   Aplica um evento à sessão do seu anel e confere o resultado. */
+static void reproduzirEvento(Reproducao *rp, const DqMansao *mansao, const EventoJogo *e, TotaisReproducao *t) {
+    if (e->tipo == REG_INICIO) {
+        if (rp->ativa) t->incompletas++;
+        if (rp->sessao == NULL) {
+            rp->sessao = dqIniciarSessao(mansao);
+            if (rp->sessao == NULL) {
+                printf("Erro ao alocar memoria para a sessao.\n");
+                exit(1);
+            }
+        } else {
+            dqReiniciarSessao(rp->sessao);
+        }
+        rp->id = e->sessao;
+        rp->divergencias = e->sala != dqIdSalaAtual(rp->sessao);
+        rp->ativa = 1;
+        return;
+    }
+    if (!rp->ativa) {
+        t->avulsos++;
+        return;
+    }
+
+    DqSessao *s = rp->sessao;
+    int diverge = e->sessao != rp->id;
+    if (e->tipo == REG_MOVIMENTO || e->tipo == REG_INVALIDO) {
+        DqMovimento esperado = e->tipo == REG_MOVIMENTO ? DQ_MOVIMENTO_OK : DQ_MOVIMENTO_INVALIDO;
+        diverge |= dqMover(s, e->escolha) != esperado || dqIdSalaAtual(s) != e->sala;
+    } else if (e->tipo == REG_PISTA) {
+        diverge |= dqIdSalaAtual(s) != e->sala || dqIdPistaSala(mansao, dqIdSalaAtual(s)) != e->pista;
+        dqColetar(s);
+    } else if (e->tipo == REG_FIM) {
+        diverge |= dqIdSalaAtual(s) != e->sala;
+    } else {
+        diverge = 1;
+    }
+    rp->divergencias += diverge;
+
+    if (e->tipo == REG_FIM) {
+        escreverSessao(rp);
+        t->sessoes++;
+        t->divergencias += rp->divergencias;
+        rp->ativa = 0;
+    }
+}
+
+/* listarEvento()
+   Escreve um evento com os nomes da sala e da pista. */
+static void listarEvento(const DqMansao *mansao, const EventoJogo *e) {
+    const char *pista = dqTextoPista(mansao, e->pista);
+    printf("%llu\t%u\t%llu\t%s\t%s\t%c\t%s\n", (unsigned long long) e->instante, e->anel,
+           (unsigned long long) e->sessao, nomeTipoEvento(e->tipo),
+           e->sala < dqNumSalas(mansao) ? dqNomeSala(mansao, e->sala) : "?",
+           e->escolha != 0 ? e->escolha : '-', pista != NULL ? pista : "-");
+}
+
+int main(int argc, char *argv[]) {
+    int listar = argc == 4 && strcmp(argv[3], "--listar") == 0;
+    if (argc != 3 && !listar) {
+        printf("Uso: %s <mapa> <eventos.dqe> [--listar]\n", argv[0]);
+        return 1;
+    }
+
+    char erro[DQ_TAM_ERRO];
+    DqMansao *mansao = dqAbrirMansao(argv[1], erro, sizeof(erro));
+    if (mansao == NULL) {
+        printf("%s\n", erro);
+        return 1;
+    }
+    FILE *arquivo = fopen(argv[2], "rb");
+    if (arquivo == NULL) {
+        printf("Erro ao abrir o registro de eventos %s.\n", argv[2]);
+        dqFecharMansao(mansao);
+        return 1;
+    }
+    uint32_t maxAneis;
+    if (lerCabecalhoRegistro(arquivo, mansao, &maxAneis, erro, sizeof(erro)) != 0) {
+        printf("%s: %s\n", argv[2], erro);
+        fclose(arquivo);
+        dqFecharMansao(mansao);
+        return 1;
+    }
+
+    setvbuf(stdout, NULL, _IOFBF, 1 << 16);
+    printf(listar ? "#instante\tanel\tsessao\tevento\tsala\tescolha\tpista\n"
+                  : "#sessao\tsala_final\tmovimentos\tinvalidos\tpistas\tmais_provavel\tdivergencias\n");
+    EventoJogo *lote = (EventoJogo*) realocarOuSair(NULL, TAM_LOTE_LEITURA * sizeof(EventoJogo), "a reproducao");
+    Reproducao *reproducoes = NULL;
+    uint32_t capReproducoes = 0;
+    TotaisReproducao t;
+    memset(&t, 0, sizeof(t));
+    size_t lidos;
+    while ((lidos = fread(lote, sizeof(EventoJogo), TAM_LOTE_LEITURA, arquivo)) > 0) {
+        for (size_t i = 0; i < lidos; ++i) {
+            if (lote[i].anel >= maxAneis) t.corrompidos++;
+            else if (listar) listarEvento(mansao, &lote[i]);
+            else reproduzirEvento(reproducaoDoAnel(&reproducoes, &capReproducoes, lote[i].anel, maxAneis),
+                                  mansao, &lote[i], &t);
+        }
+        t.eventos += lidos;
+    }
+    fflush(stdout);
+    fclose(arquivo);
+
+    for (uint32_t a = 0; a < capReproducoes; ++a) {
+        if (reproducoes[a].ativa) t.incompletas++;
+        dqEncerrarSessao(reproducoes[a].sessao);
+    }
+    if (!listar)
+        fprintf(stderr, "%llu eventos, %llu sessoes reproduzidas, %llu divergencias, %llu incompletas, %llu avulsos, "
+                "%llu corrompidos\n", t.eventos, t.sessoes, t.divergencias, t.incompletas, t.avulsos, t.corrompidos);
+    else if (t.corrompidos > 0)
+        fprintf(stderr, "%llu eventos corrompidos ignorados\n", t.corrompidos);
+    free(reproducoes);
+    free(lote);
+    dqFecharMansao(mansao);
+    return t.divergencias > 0 || t.corrompidos > 0;
+}
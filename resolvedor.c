@@ -0,0 +1,593 @@
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "resolvedor.h"
+
+/* Estado do caminho por suspeito: quantas pistas distintas contra ele já
+   foram coletadas (até ACUSACAO_MINIMA) seguidas dos ids dessas pistas. */
+#define LARGURA_ESTADO (ACUSACAO_MINIMA + 1)
+
+/* Marcas dos itens da pilha do percurso (sala << 2 | marcas). */
+#define ITEM_SAIDA 1u       // volta da sala: desfaz o que ela acrescentou
+#define ITEM_ADICIONOU 2u   // a sala acrescentou uma pista nova ao estado
+
+/* Subárvore a resolver, com o estado do caminho da entrada até o pai. */
+typedef struct Tarefa {
+    uint32_t sala;
+    uint32_t dono;      // thread que criou a tarefa
+    uint32_t *estado;
+} Tarefa;
+
+/* Deque de tarefas de uma thread: a dona empilha e desempilha no fim,
+   as outras roubam do início (as tarefas mais antigas, mais altas na
+   árvore e por isso maiores). */
+typedef struct DequeTarefas {
+    pthread_mutex_t trava;
+    Tarefa *itens;
+    size_t inicio;
+    size_t fim;
+    size_t cap;
+} DequeTarefas;
+
+/* Estado compartilhado entre as threads. */
+typedef struct Resolvedor {
+    const Mansao *mansao;
+    const TabelaHash *tabela;
+    const IndiceMansao *indice;
+    uint32_t numSuspeitos;
+    int numThreads;
+    DequeTarefas *deques;
+    atomic_size_t pendentes;    // tarefas criadas e ainda não terminadas
+} Resolvedor;
+
+/* Estado de cada thread. melhor[suspeito] guarda profundidade << 32 mais a
+   posição de percurso da melhor sala final, para o menor valor desempatar
+   pela ordem de percurso. */
+typedef struct TrabalhadorResolvedor {
+    Resolvedor *res;
+    uint32_t id;
+    pthread_t thread;
+    uint32_t *estado;
+    uint64_t *melhor;
+    uint64_t *pilha;
+    size_t capPilha;
+    ContadoresResolvedor contadores;
+} TrabalhadorResolvedor;
+
+/* filhoNaArvore()
+   O filho, se ele pertence à árvore do percurso do índice abaixo da sala
+   (em mapas que não são árvores uma sala pode ter mais de um pai); senão
+   SEM_SALA. */
+static uint32_t filhoNaArvore(const IndiceMansao *indice, uint32_t sala, uint32_t filho) {
+    if (filho == SEM_SALA || !salaAbaixoDe(indice, sala, filho)) return SEM_SALA;
+    return indice->profundidade[filho] == indice->profundidade[sala] + 1 ? filho : SEM_SALA;
+}
+
+/* empilharTarefa()
+   Coloca a tarefa no fim do deque. */
+static void empilharTarefa(DequeTarefas *d, const Tarefa *tarefa) {
+    pthread_mutex_lock(&d->trava);
+    if (d->fim == d->cap) {
+        if (d->inicio > 0) {
+            memmove(d->itens, d->itens + d->inicio, (d->fim - d->inicio) * sizeof(Tarefa));
+            d->fim -= d->inicio;
+            d->inicio = 0;
+        } else {
+            d->cap = d->cap ? d->cap * 2 : 16;
+            d->itens = (Tarefa*) realocarOuSair(d->itens, d->cap * sizeof(Tarefa), "as tarefas do resolvedor");
+        }
+    }
+    d->itens[d->fim++] = *tarefa;
+    pthread_mutex_unlock(&d->trava);
+}
+
+/* retirarTarefa()
+   Tira uma tarefa do fim (dona) ou do início (roubo) do deque.
+   Retorna 0 se o deque estiver vazio. */
+static int retirarTarefa(DequeTarefas *d, int roubo, Tarefa *tarefa) {
+    int achou = 0;
+    pthread_mutex_lock(&d->trava);
+    if (d->inicio < d->fim) {
+        *tarefa = roubo ? d->itens[d->inicio++] : d->itens[--d->fim];
+        if (d->inicio == d->fim) d->inicio = d->fim = 0;
+        achou = 1;
+    }
+    pthread_mutex_unlock(&d->trava);
+    return achou;
+}
+
+/* criarTarefa()
+   Entrega a subárvore do filho como tarefa, com uma cópia do estado atual
+   do caminho. */
+static void criarTarefa(TrabalhadorResolvedor *t, uint32_t filho) {
+    Resolvedor *res = t->res;
+    size_t tam = (size_t) res->numSuspeitos * LARGURA_ESTADO * sizeof(uint32_t);
+    Tarefa tarefa;
+    tarefa.sala = filho;
+    tarefa.dono = t->id;
+    tarefa.estado = (uint32_t*) realocarOuSair(NULL, tam ? tam : 1, "as tarefas do resolvedor");
+    memcpy(tarefa.estado, t->estado, tam);
+    atomic_fetch_add_explicit(&res->pendentes, 1, memory_order_relaxed);
+    empilharTarefa(&res->deques[t->id], &tarefa);
+    t->contadores.tarefas++;
+}
+
+/* empilharSala()
+   Empilha um item do percurso, aumentando a pilha se preciso. */
+static void empilharSala(TrabalhadorResolvedor *t, size_t *topo, uint64_t item) {
+    if (*topo == t->capPilha) {
+        t->capPilha *= 2;
+        t->pilha = (uint64_t*) realocarOuSair(t->pilha, t->capPilha * sizeof(uint64_t), "o resolvedor");
+    }
+    t->pilha[(*topo)++] = item;
+}
+
+/* executarTarefa()
+   Percorre a subárvore da tarefa em pré-ordem, mantendo o estado do
+   caminho e registrando as salas em que um suspeito atinge
+   ACUSACAO_MINIMA pistas distintas. */
+static void executarTarefa(TrabalhadorResolvedor *t, Tarefa *tarefa) {
+    Resolvedor *res = t->res;
+    const Mansao *m = res->mansao;
+    const IndiceMansao *indice = res->indice;
+    memcpy(t->estado, tarefa->estado, (size_t) res->numSuspeitos * LARGURA_ESTADO * sizeof(uint32_t));
+    free(tarefa->estado);
+
+    size_t topo = 0;
+    empilharSala(t, &topo, (uint64_t) tarefa->sala << 2);
+    while (topo > 0) {
+        uint64_t item = t->pilha[--topo];
+        uint32_t sala = (uint32_t) (item >> 2);
+        uint32_t pista = m->salas[sala].pista;
+        uint32_t suspeito = pista != SEM_PISTA ? suspeitoDaPista(res->tabela, pista) : INTERNADOR_AUSENTE;
+        if (item & ITEM_SAIDA) {
+            if (item & ITEM_ADICIONOU) t->estado[(size_t) suspeito * LARGURA_ESTADO]--;
+            continue;
+        }
+
+        t->contadores.salas++;
+        uint64_t saida = ((uint64_t) sala << 2) | ITEM_SAIDA;
+        if (suspeito != INTERNADOR_AUSENTE) {
+            uint32_t *e = t->estado + (size_t) suspeito * LARGURA_ESTADO;
+            uint32_t i = 0;
+            while (i < e[0] && e[1 + i] != pista) i++;
+            if (i == e[0] && e[0] < ACUSACAO_MINIMA) {
+                e[1 + e[0]++] = pista;
+                saida |= ITEM_ADICIONOU;
+            }
+            if (e[0] >= ACUSACAO_MINIMA) {
+                uint64_t v = ((uint64_t) indice->profundidade[sala] << 32) | indice->entrada[sala];
+                if (v < t->melhor[suspeito]) t->melhor[suspeito] = v;
+            }
+        }
+        empilharSala(t, &topo, saida);
+
+        uint32_t esquerda = filhoNaArvore(indice, sala, m->salas[sala].esquerda);
+        uint32_t direita = filhoNaArvore(indice, sala, m->salas[sala].direita);
+        if (esquerda != SEM_SALA && direita != SEM_SALA &&
+            salasAbaixo(indice, esquerda) >= RESOLVEDOR_LIMIAR_TAREFA &&
+            salasAbaixo(indice, direita) >= RESOLVEDOR_LIMIAR_TAREFA) {
+            criarTarefa(t, direita);
+            direita = SEM_SALA;
+        }
+        // esquerda sai primeiro da pilha
+        if (direita != SEM_SALA) empilharSala(t, &topo, (uint64_t) direita << 2);
+        if (esquerda != SEM_SALA) empilharSala(t, &topo, (uint64_t) esquerda << 2);
+    }
+}
+
+/* pegarTarefa()
+   Próxima tarefa da própria thread ou, se não houver, roubada de outra. */
+static int pegarTarefa(TrabalhadorResolvedor *t, Tarefa *tarefa) {
+    Resolvedor *res = t->res;
+    if (retirarTarefa(&res->deques[t->id], 0, tarefa)) return 1;
+    for (int i = 1; i < res->numThreads; ++i) {
+        uint32_t vitima = (t->id + (uint32_t) i) % (uint32_t) res->numThreads;
+        if (retirarTarefa(&res->deques[vitima], 1, tarefa)) {
+            t->contadores.roubos++;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+/* trabalharResolvedor()
+   Laço de cada thread: executa tarefas até não restar nenhuma pendente. */
+static void* trabalharResolvedor(void *arg) {
+    TrabalhadorResolvedor *t = (TrabalhadorResolvedor*) arg;
+    Resolvedor *res = t->res;
+    Tarefa tarefa;
+    while (1) {
+        if (pegarTarefa(t, &tarefa)) {
+            executarTarefa(t, &tarefa);
+            atomic_fetch_sub_explicit(&res->pendentes, 1, memory_order_release);
+        } else if (atomic_load_explicit(&res->pendentes, memory_order_acquire) == 0) {
+            break;
+        } else {
+            sched_yield();
+        }
+    }
+    return NULL;
+}
+
+/* resolverMansao()
+   Preenche solucoes[suspeito] para todos os suspeitos da tabela, usando
+   numThreads threads (a thread que chama é uma delas). O índice deve ter
+   sido construído sobre a mesma mansão e tabela. */
+void resolverMansao(const Mansao *m, const TabelaHash *tabela, const IndiceMansao *indice,
+                    int numThreads, SolucaoSuspeito *solucoes, ContadoresResolvedor *contadores) {
+    uint32_t suspeitos = numSuspeitos(tabela);
+    memset(contadores, 0, sizeof(ContadoresResolvedor));
+    for (uint32_t s = 0; s < suspeitos; ++s) {
+        solucoes[s].salaFinal = SEM_SALA;
+        solucoes[s].movimentos = 0;
+        solucoes[s].caminho = NULL;
+    }
+    if (indice->numAlcancaveis == 0 || suspeitos == 0) return;
+    if (numThreads < 1) numThreads = 1;
+    if (numThreads > RESOLVEDOR_MAX_THREADS) numThreads = RESOLVEDOR_MAX_THREADS;
+
+    Resolvedor res;
+    res.mansao = m;
+    res.tabela = tabela;
+    res.indice = indice;
+    res.numSuspeitos = suspeitos;
+    res.numThreads = numThreads;
+    res.deques = (DequeTarefas*) realocarOuSair(NULL, (size_t) numThreads * sizeof(DequeTarefas), "o resolvedor");
+    atomic_init(&res.pendentes, 0);
+
+    size_t tamEstado = (size_t) suspeitos * LARGURA_ESTADO * sizeof(uint32_t);
+    TrabalhadorResolvedor trabalhadores[RESOLVEDOR_MAX_THREADS];
+    for (int i = 0; i < numThreads; ++i) {
+        TrabalhadorResolvedor *t = &trabalhadores[i];
+        pthread_mutex_init(&res.deques[i].trava, NULL);
+        res.deques[i].itens = NULL;
+        res.deques[i].inicio = res.deques[i].fim = res.deques[i].cap = 0;
+        t->res = &res;
+        t->id = (uint32_t) i;
+        t->estado = (uint32_t*) realocarOuSair(NULL, tamEstado, "o resolvedor");
+        t->melhor = (uint64_t*) realocarOuSair(NULL, suspeitos * sizeof(uint64_t), "o resolvedor");
+        for (uint32_t s = 0; s < suspeitos; ++s) t->melhor[s] = UINT64_MAX;
+        t->capPilha = 1024;
+        t->pilha = (uint64_t*) realocarOuSair(NULL, t->capPilha * sizeof(uint64_t), "o resolvedor");
+        memset(&t->contadores, 0, sizeof(ContadoresResolvedor));
+    }
+
+    // a mansão inteira é a primeira tarefa, com o caminho ainda vazio
+    Tarefa raiz;
+    raiz.sala = SALA_ENTRADA;
+    raiz.dono = 0;
+    raiz.estado = (uint32_t*) realocarOuSair(NULL, tamEstado, "as tarefas do resolvedor");
+    memset(raiz.estado, 0, tamEstado);
+    atomic_store(&res.pendentes, 1);
+    empilharTarefa(&res.deques[0], &raiz);
+    trabalhadores[0].contadores.tarefas = 1;
+
+    // a própria thread que chama é o trabalhador 0
+    int iniciadas = 1;
+    for (int i = 1; i < numThreads; ++i) {
+        if (pthread_create(&trabalhadores[i].thread, NULL, trabalharResolvedor, &trabalhadores[i]) != 0) break;
+        iniciadas++;
+    }
+    trabalharResolvedor(&trabalhadores[0]);
+    for (int i = 1; i < iniciadas; ++i) pthread_join(trabalhadores[i].thread, NULL);
+
+    for (int i = 0; i < numThreads; ++i) {
+        TrabalhadorResolvedor *t = &trabalhadores[i];
+        for (uint32_t s = 0; s < suspeitos; ++s) {
+            if (t->melhor[s] == UINT64_MAX) continue;
+            uint32_t sala = indice->salaNaPosicao[(uint32_t) t->melhor[s]];
+            uint32_t movimentos = (uint32_t) (t->melhor[s] >> 32);
+            SolucaoSuspeito *sol = &solucoes[s];
+            if (sol->salaFinal == SEM_SALA || movimentos < sol->movimentos ||
+                (movimentos == sol->movimentos && indice->entrada[sala] < indice->entrada[sol->salaFinal])) {
+                sol->salaFinal = sala;
+                sol->movimentos = movimentos;
+            }
+        }
+        contadores->salas += t->contadores.salas;
+        contadores->tarefas += t->contadores.tarefas;
+        contadores->roubos += t->contadores.roubos;
+        free(t->estado);
+        free(t->melhor);
+        free(t->pilha);
+        pthread_mutex_destroy(&res.deques[i].trava);
+        free(res.deques[i].itens);
+    }
+    free(res.deques);
+
+    for (uint32_t s = 0; s < suspeitos; ++s) {
+        if (solucoes[s].salaFinal == SEM_SALA) continue;
+        solucoes[s].caminho = (char*) realocarOuSair(NULL, (size_t) solucoes[s].movimentos + 1, "as solucoes");
+        caminhoAteSala(m, indice, solucoes[s].salaFinal, solucoes[s].caminho);
+    }
+}
+
+/* caminhoAteSala()
+   Escreve em movimentos ('e'/'d', terminado em '\0') o caminho da entrada
+   até a sala e retorna o número de movimentos. O buffer precisa ter
+   indice->profundidade[sala] + 1 posições. */
+uint32_t caminhoAteSala(const Mansao *m, const IndiceMansao *indice, uint32_t sala, char *movimentos) {
+    uint32_t n = 0;
+    uint32_t atual = SALA_ENTRADA;
+    while (atual != sala) {
+        uint32_t esquerda = filhoNaArvore(indice, atual, m->salas[atual].esquerda);
+        if (esquerda != SEM_SALA && salaAbaixoDe(indice, esquerda, sala)) {
+            movimentos[n++] = 'e';
+            atual = esquerda;
+        } else {
+            movimentos[n++] = 'd';
+            atual = filhoNaArvore(indice, atual, m->salas[atual].direita);
+        }
+    }
+    movimentos[n] = '\0';
+    return n;
+}
+
+/* ===================== GRAFO ===================== */
+
+_Static_assert(ACUSACAO_MINIMA == 2, "resolverGrafo() procura pares de pistas");
+
+/* Estado ainda sem origem na segunda busca de resolverGrafo(). */
+#define SEM_ORIGEM UINT32_MAX
+
+/* Dados comuns às threads de resolverGrafo(): a busca a partir da entrada
+   e, por suspeito, as salas com pista contra ele em ordem de distância. */
+typedef struct ResolvedorGrafo {
+    const Mansao *mansao;
+    const TabelaHash *tabela;
+    uint32_t *distancia;        // da entrada até a sala (SEM_SALA: inalcançável)
+    uint32_t *anterior;         // sala de onde a busca chegou nela
+    char *movimento;            // escolha que leva da anterior até ela
+    uint32_t *inicioSuspeito;   // salas do suspeito s: salasSuspeito[inicioSuspeito[s] ..]
+    uint32_t *salasSuspeito;
+    SolucaoSuspeito *solucoes;
+    uint32_t numSuspeitos;
+    atomic_uint proximo;        // próximo suspeito a resolver
+} ResolvedorGrafo;
+
+/* Estado de cada thread de resolverGrafo(). Na segunda busca, o estado
+   2 * sala + k é a k-ésima origem (pista de uma sala A) a chegar à sala. */
+typedef struct TrabalhadorGrafo {
+    ResolvedorGrafo *res;
+    pthread_t thread;
+    uint32_t *origem;           // SEM_ORIGEM: estado vazio
+    uint32_t *distancia;
+    uint32_t *anterior;         // estado anterior, ou SEM_SALA no da própria A
+    char *movimento;
+    uint32_t *fila;             // estados na ordem em que foram criados
+    ContadoresResolvedor contadores;
+} TrabalhadorGrafo;
+
+/* movimentoDaSaida()
+   Escolha do jogador que segue a k-ésima saída da sala no CSR: os
+   corredores ('e', 'd') e depois as passagens ('1'..'9'). '\0' para as
+   passagens sem dígito, que as partidas não alcançam. */
+static char movimentoDaSaida(const Mansao *m, uint32_t sala, uint32_t k) {
+    uint32_t corredores = numCorredores(&m->salas[sala]);
+    if (k < corredores) return k == 0 && m->salas[sala].esquerda != SEM_SALA ? 'e' : 'd';
+    k -= corredores;
+    return k < PASSAGENS_POR_DIGITO ? (char) ('1' + k) : '\0';
+}
+
+/* chegarSala()
+   Leva uma origem à sala, à distância informada: ela vira um estado novo
+   da sala se a sala ainda não tem essa origem nem duas outras. Retorna o
+   estado se a sala fecha a partida (tem outra pista contra o suspeito),
+   ou SEM_SALA. */
+static uint32_t chegarSala(TrabalhadorGrafo *t, uint32_t suspeito, uint32_t sala, uint32_t origem,
+                           uint32_t distancia, uint32_t anterior, char movimento, uint32_t *fim) {
+    uint32_t estado = 2 * sala;
+    if (t->origem[estado] == origem) return SEM_SALA;
+    if (t->origem[estado] != SEM_ORIGEM && t->origem[++estado] != SEM_ORIGEM) return SEM_SALA;
+    t->origem[estado] = origem;
+    t->distancia[estado] = distancia;
+    t->anterior[estado] = anterior;
+    t->movimento[estado] = movimento;
+    t->fila[(*fim)++] = estado;
+
+    const ResolvedorGrafo *res = t->res;
+    uint32_t pista = res->mansao->salas[sala].pista;
+    if (pista == SEM_PISTA || pista == origem || suspeitoDaPista(res->tabela, pista) != suspeito) return SEM_SALA;
+    return estado;
+}
+
+/* escreverCaminhoGrafo()
+   Monta o caminho da solução: do estado final volta pela segunda busca até
+   a sala A e de lá pela primeira até a entrada. */
+static void escreverCaminhoGrafo(const TrabalhadorGrafo *t, uint32_t estado, SolucaoSuspeito *sol) {
+    const ResolvedorGrafo *res = t->res;
+    uint32_t pos = t->distancia[estado];
+    sol->salaFinal = estado >> 1;
+    sol->movimentos = pos;
+    sol->caminho = (char*) realocarOuSair(NULL, (size_t) pos + 1, "as solucoes");
+    sol->caminho[pos] = '\0';
+    while (t->anterior[estado] != SEM_SALA) {
+        sol->caminho[--pos] = t->movimento[estado];
+        estado = t->anterior[estado];
+    }
+    for (uint32_t sala = estado >> 1; sala != SALA_ENTRADA; sala = res->anterior[sala])
+        sol->caminho[--pos] = res->movimento[sala];
+}
+
+/* resolverSuspeitoGrafo()
+   Segunda busca em largura para um suspeito. As salas A entram na fila
+   quando ela chega à distância delas, então os estados são criados em
+   ordem de distância e a primeira sala que fecha a partida é a melhor. */
+static void resolverSuspeitoGrafo(TrabalhadorGrafo *t, uint32_t suspeito) {
+    const ResolvedorGrafo *res = t->res;
+    const Mansao *m = res->mansao;
+    const uint32_t *fontes = res->salasSuspeito + res->inicioSuspeito[suspeito];
+    uint32_t numFontes = res->inicioSuspeito[suspeito + 1] - res->inicioSuspeito[suspeito];
+    uint32_t inicio = 0, fim = 0, f = 0;
+    uint32_t achado = SEM_SALA;
+    while (achado == SEM_SALA && (inicio < fim || f < numFontes)) {
+        uint32_t nivel = inicio < fim ? t->distancia[t->fila[inicio]] : UINT32_MAX;
+        if (f < numFontes && res->distancia[fontes[f]] < nivel) nivel = res->distancia[fontes[f]];
+        for (; f < numFontes && res->distancia[fontes[f]] == nivel && achado == SEM_SALA; ++f)
+            achado = chegarSala(t, suspeito, fontes[f], m->salas[fontes[f]].pista, nivel, SEM_SALA, '\0', &fim);
+        for (; inicio < fim && t->distancia[t->fila[inicio]] == nivel && achado == SEM_SALA; ++inicio) {
+            uint32_t estado = t->fila[inicio];
+            uint32_t sala = estado >> 1;
+            uint32_t primeira = m->inicioSaidas[sala];
+            uint32_t grau = m->inicioSaidas[sala + 1] - primeira;
+            t->contadores.salas++;
+            for (uint32_t k = 0; k < grau && achado == SEM_SALA; ++k) {
+                char movimento = movimentoDaSaida(m, sala, k);
+                if (movimento == '\0') break;
+                achado = chegarSala(t, suspeito, m->saidas[primeira + k], t->origem[estado], nivel + 1,
+                                    estado, movimento, &fim);
+            }
+        }
+    }
+    if (achado != SEM_SALA) escreverCaminhoGrafo(t, achado, &res->solucoes[suspeito]);
+    for (uint32_t i = 0; i < fim; ++i) t->origem[t->fila[i]] = SEM_ORIGEM;
+}
+
+/* trabalharGrafo()
+   Laço de cada thread: resolve o próximo suspeito ainda não pego. */
+static void* trabalharGrafo(void *arg) {
+    TrabalhadorGrafo *t = (TrabalhadorGrafo*) arg;
+    ResolvedorGrafo *res = t->res;
+    uint32_t suspeito;
+    while ((suspeito = atomic_fetch_add_explicit(&res->proximo, 1, memory_order_relaxed)) < res->numSuspeitos) {
+        resolverSuspeitoGrafo(t, suspeito);
+        t->contadores.tarefas++;
+    }
+    return NULL;
+}
+
+/* buscarDaEntrada()
+   Primeira busca em largura, da entrada pelas saídas que o jogador pode
+   escolher. Preenche distancia, anterior e movimento e, por suspeito, as
+   salas com pista contra ele na ordem em que a busca as alcançou. */
+static void buscarDaEntrada(ResolvedorGrafo *res) {
+    const Mansao *m = res->mansao;
+    uint32_t n = m->numSalas;
+    uint32_t *ordem = (uint32_t*) realocarOuSair(NULL, (size_t) n * sizeof(uint32_t), "o resolvedor");
+    for (uint32_t i = 0; i < n; ++i) res->distancia[i] = SEM_SALA;
+    uint32_t inicio = 0, fim = 0;
+    res->distancia[SALA_ENTRADA] = 0;
+    res->anterior[SALA_ENTRADA] = SEM_SALA;
+    ordem[fim++] = SALA_ENTRADA;
+    while (inicio < fim) {
+        uint32_t sala = ordem[inicio++];
+        uint32_t primeira = m->inicioSaidas[sala];
+        uint32_t grau = m->inicioSaidas[sala + 1] - primeira;
+        for (uint32_t k = 0; k < grau; ++k) {
+            char movimento = movimentoDaSaida(m, sala, k);
+            if (movimento == '\0') break;
+            uint32_t destino = m->saidas[primeira + k];
+            if (res->distancia[destino] != SEM_SALA) continue;
+            res->distancia[destino] = res->distancia[sala] + 1;
+            res->anterior[destino] = sala;
+            res->movimento[destino] = movimento;
+            ordem[fim++] = destino;
+        }
+    }
+
+    uint32_t *inicioSuspeito = res->inicioSuspeito;
+    memset(inicioSuspeito, 0, ((size_t) res->numSuspeitos + 1) * sizeof(uint32_t));
+    for (uint32_t i = 0; i < fim; ++i) {
+        uint32_t pista = m->salas[ordem[i]].pista;
+        uint32_t suspeito = pista != SEM_PISTA ? suspeitoDaPista(res->tabela, pista) : INTERNADOR_AUSENTE;
+        if (suspeito != INTERNADOR_AUSENTE) inicioSuspeito[suspeito + 1]++;
+    }
+    for (uint32_t s = 0; s < res->numSuspeitos; ++s) inicioSuspeito[s + 1] += inicioSuspeito[s];
+    res->salasSuspeito = (uint32_t*) realocarOuSair(NULL, ((size_t) inicioSuspeito[res->numSuspeitos] + 1) *
+                                                    sizeof(uint32_t), "o resolvedor");
+    uint32_t *proxima = (uint32_t*) realocarOuSair(NULL, ((size_t) res->numSuspeitos + 1) * sizeof(uint32_t),
+                                                   "o resolvedor");
+    memcpy(proxima, inicioSuspeito, (size_t) res->numSuspeitos * sizeof(uint32_t));
+    for (uint32_t i = 0; i < fim; ++i) {
+        uint32_t pista = m->salas[ordem[i]].pista;
+        uint32_t suspeito = pista != SEM_PISTA ? suspeitoDaPista(res->tabela, pista) : INTERNADOR_AUSENTE;
+        if (suspeito != INTERNADOR_AUSENTE) res->salasSuspeito[proxima[suspeito]++] = ordem[i];
+    }
+    free(proxima);
+    free(ordem);
+}
+
+/* resolverGrafo()
+   Preenche solucoes[suspeito] para todos os suspeitos numa mansão que não
+   é árvore, usando até numThreads threads (a que chama é uma delas). O
+   grafo da mansão precisa estar montado (montarGrafo()). */
+void resolverGrafo(const Mansao *m, const TabelaHash *tabela, int numThreads, SolucaoSuspeito *solucoes,
+                   ContadoresResolvedor *contadores) {
+    uint32_t suspeitos = numSuspeitos(tabela);
+    uint32_t n = m->numSalas;
+    memset(contadores, 0, sizeof(ContadoresResolvedor));
+    for (uint32_t s = 0; s < suspeitos; ++s) {
+        solucoes[s].salaFinal = SEM_SALA;
+        solucoes[s].movimentos = 0;
+        solucoes[s].caminho = NULL;
+    }
+    if (n == 0 || suspeitos == 0) return;
+    if (numThreads < 1) numThreads = 1;
+    if (numThreads > RESOLVEDOR_MAX_THREADS) numThreads = RESOLVEDOR_MAX_THREADS;
+    if ((uint32_t) numThreads > suspeitos) numThreads = (int) suspeitos;
+
+    ResolvedorGrafo res;
+    res.mansao = m;
+    res.tabela = tabela;
+    res.numSuspeitos = suspeitos;
+    res.solucoes = solucoes;
+    res.distancia = (uint32_t*) realocarOuSair(NULL, (size_t) n * sizeof(uint32_t), "o resolvedor");
+    res.anterior = (uint32_t*) realocarOuSair(NULL, (size_t) n * sizeof(uint32_t), "o resolvedor");
+    res.movimento = (char*) realocarOuSair(NULL, n, "o resolvedor");
+    res.inicioSuspeito = (uint32_t*) realocarOuSair(NULL, ((size_t) suspeitos + 1) * sizeof(uint32_t), "o resolvedor");
+    buscarDaEntrada(&res);
+    atomic_init(&res.proximo, 0);
+
+    size_t estados = (size_t) n * 2;
+    TrabalhadorGrafo trabalhadores[RESOLVEDOR_MAX_THREADS];
+    for (int i = 0; i < numThreads; ++i) {
+        TrabalhadorGrafo *t = &trabalhadores[i];
+        t->res = &res;
+        t->origem = (uint32_t*) realocarOuSair(NULL, estados * sizeof(uint32_t), "o resolvedor");
+        t->distancia = (uint32_t*) realocarOuSair(NULL, estados * sizeof(uint32_t), "o resolvedor");
+        t->anterior = (uint32_t*) realocarOuSair(NULL, estados * sizeof(uint32_t), "o resolvedor");
+        t->movimento = (char*) realocarOuSair(NULL, estados, "o resolvedor");
+        t->fila = (uint32_t*) realocarOuSair(NULL, estados * sizeof(uint32_t), "o resolvedor");
+        for (size_t e = 0; e < estados; ++e) t->origem[e] = SEM_ORIGEM;
+        memset(&t->contadores, 0, sizeof(ContadoresResolvedor));
+    }
+
+    int iniciadas = 1;
+    for (int i = 1; i < numThreads; ++i) {
+        if (pthread_create(&trabalhadores[i].thread, NULL, trabalharGrafo, &trabalhadores[i]) != 0) break;
+        iniciadas++;
+    }
+    trabalharGrafo(&trabalhadores[0]);
+    for (int i = 1; i < iniciadas; ++i) pthread_join(trabalhadores[i].thread, NULL);
+
+    for (int i = 0; i < numThreads; ++i) {
+        TrabalhadorGrafo *t = &trabalhadores[i];
+        contadores->salas += t->contadores.salas;
+        contadores->tarefas += t->contadores.tarefas;
+        free(t->origem);
+        free(t->distancia);
+        free(t->anterior);
+        free(t->movimento);
+        free(t->fila);
+    }
+    free(res.distancia);
+    free(res.anterior);
+    free(res.movimento);
+    free(res.inicioSuspeito);
+    free(res.salasSuspeito);
+}
+
+/* liberarSolucoes()
+   Libera os caminhos das n soluções. */
+void liberarSolucoes(SolucaoSuspeito *solucoes, uint32_t n) {
+    for (uint32_t s = 0; s < n; ++s) {
+        free(solucoes[s].caminho);
+        solucoes[s].caminho = NULL;
+    }
+}
@@ -0,0 +1,71 @@
+#ifndef RESOLVEDOR_H
+#define RESOLVEDOR_H
+
+#include <stdint.h>
+
+#include "indice_mansao.h"
+#include "mansao.h"
+#include "sessao.h"
+#include "tabela_hash.h"
+
+/* ===================== RESOLVEDOR EXAUSTIVO ===================== */
+
+/* Para cada suspeito, a menor sequência de movimentos a partir da entrada
+   que coleta pistas distintas suficientes (ACUSACAO_MINIMA) para acusá-lo.
+
+   O jogador só desce e coleta a pista de cada sala em que entra, então as
+   pistas de uma partida são as do caminho da entrada até a última sala, e a
+   melhor sequência termina na sala mais rasa cujo caminho já tem pistas
+   suficientes. Um único percurso de cima para baixo leva, por suspeito, as
+   pistas distintas já vistas no caminho; cada sala é visitada uma vez só,
+   para todos os suspeitos ao mesmo tempo.
+
+   O percurso é dividido em tarefas por subárvore. Quando as duas
+   subárvores de uma sala têm pelo menos RESOLVEDOR_LIMIAR_TAREFA salas
+   (tamanhos vindos do índice), a da direita vira uma tarefa com uma cópia
+   do estado do caminho e vai para o deque da thread; threads sem trabalho
+   roubam as tarefas mais antigas (as maiores) dos deques das outras.
+   Empates são desfeitos pela ordem de percurso, então o resultado não
+   depende do número de threads. Como na acusação, cada pista conta para o
+   seu suspeito principal, sem os pesos.
+
+   resolverMansao() vale só para árvores (o índice recusa as outras). Numa
+   mansão com passagens, salas compartilhadas ou ciclos, resolverGrafo()
+   faz a busca em largura sobre o grafo de saídas (CSR da mansão), com as
+   passagens que o jogador escolhe por dígito. Com ACUSACAO_MINIMA == 2, a
+   melhor partida vai da entrada a uma sala A com pista a do suspeito e de
+   lá a uma sala B com outra pista b dele: uma busca a partir da entrada dá
+   as distâncias até cada A, e uma segunda busca, partindo de todas as A
+   com as suas distâncias, leva a cada sala as duas menores distâncias com
+   pistas de origem diferentes; B é a primeira sala alcançada com uma
+   origem diferente da sua própria pista. Cada sala entra no máximo duas
+   vezes por suspeito, e as threads dividem os suspeitos entre si. */
+
+#define RESOLVEDOR_LIMIAR_TAREFA 4096
+#define RESOLVEDOR_MAX_THREADS 256
+
+/* Melhor sequência contra um suspeito: termina em salaFinal, depois de
+   movimentos escolhas, que estão em caminho ('e', 'd' e '1'..'9', terminado
+   em '\0'; alocado, liberado por liberarSolucoes()). salaFinal == SEM_SALA
+   e caminho == NULL quando nenhuma partida reúne pistas suficientes. */
+typedef struct SolucaoSuspeito {
+    uint32_t salaFinal;
+    uint32_t movimentos;
+    char *caminho;
+} SolucaoSuspeito;
+
+/* Totais de uma execução de resolverMansao() ou resolverGrafo(). */
+typedef struct ContadoresResolvedor {
+    uint64_t salas;     // salas visitadas (no grafo, uma vez por origem)
+    uint64_t tarefas;   // subárvores entregues como tarefa, ou suspeitos no grafo
+    uint64_t roubos;    // tarefas executadas por uma thread que não as criou (0 no grafo)
+} ContadoresResolvedor;
+
+void resolverMansao(const Mansao *m, const TabelaHash *tabela, const IndiceMansao *indice,
+                    int numThreads, SolucaoSuspeito *solucoes, ContadoresResolvedor *contadores);
+void resolverGrafo(const Mansao *m, const TabelaHash *tabela, int numThreads, SolucaoSuspeito *solucoes,
+                   ContadoresResolvedor *contadores);
+uint32_t caminhoAteSala(const Mansao *m, const IndiceMansao *indice, uint32_t sala, char *movimentos);
+void liberarSolucoes(SolucaoSuspeito *solucoes, uint32_t n);
+
+#endif
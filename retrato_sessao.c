@@ -0,0 +1,382 @@
+#include <stdarg.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "retrato_sessao.h"
+
+/* Campos inteiros no início de um retrato, até 5 bytes cada em varint. */
+#define RETRATO_CAMPOS 5
+#define RETRATO_MAX_CABECALHO (RETRATO_CAMPOS * 5 + 1)
+
+/* Percorre as posições alfabéticas de um conjunto em ordem crescente,
+   sem callbacks, nas duas representações. */
+typedef struct IteradorOrdens {
+    const ConjuntoPistas *c;
+    const PistaNode *pilha[PISTA_ALTURA_MAXIMA];
+    int topo;
+    const PistaNode *no;
+    uint32_t palavra;
+    uint64_t x;
+} IteradorOrdens;
+
+static void iniciarIterador(IteradorOrdens *it, const ConjuntoPistas *c) {
+    it->c = c;
+    it->topo = 0;
+    it->no = c->raiz;
+    it->palavra = 0;
+    it->x = c->tipo == CONJUNTO_BITS && c->numPalavras > 0 ? c->bits[0] : 0;
+}
+
+/* proximaOrdem()
+   Próxima posição do conjunto; retorna 0 quando acabaram. */
+static int proximaOrdem(IteradorOrdens *it, uint32_t *ordem) {
+    const ConjuntoPistas *c = it->c;
+    if (c->tipo == CONJUNTO_ARVORE) {
+        while (it->no != NULL) {
+            it->pilha[it->topo++] = it->no;
+            it->no = it->no->esquerda;
+        }
+        if (it->topo == 0) return 0;
+        const PistaNode *no = it->pilha[--it->topo];
+        *ordem = no->ordem;
+        it->no = no->direita;
+        return 1;
+    }
+    while (it->x == 0) {
+        if (++it->palavra >= c->numPalavras) return 0;
+        it->x = c->bits[it->palavra];
+    }
+    *ordem = it->palavra * 64 + (uint32_t) __builtin_ctzll(it->x);
+    it->x &= it->x - 1;
+    return 1;
+}
+
+/* escreverVarint() / lerVarint()
+   Inteiro sem sinal em blocos de 7 bits, o menos significativo primeiro.
+   lerVarint() retorna 0 se os dados acabarem ou o valor não couber em 32 bits. */
+static inline uint8_t* escreverVarint(uint8_t *p, uint32_t v) {
+    while (v >= 0x80) {
+        *p++ = (uint8_t) (v | 0x80);
+        v >>= 7;
+    }
+    *p++ = (uint8_t) v;
+    return p;
+}
+
+static inline int lerVarint(const uint8_t **p, const uint8_t *fim, uint32_t *v) {
+    uint64_t valor = 0;
+    for (int deslocamento = 0; deslocamento < 35; deslocamento += 7) {
+        if (*p == fim) return 0;
+        uint8_t b = *(*p)++;
+        valor |= (uint64_t) (b & 0x7f) << deslocamento;
+        if ((b & 0x80) == 0) {
+            *v = (uint32_t) valor;
+            return valor <= UINT32_MAX;
+        }
+    }
+    return 0;
+}
+
+/* bytesBits()
+   Tamanho do formato RETRATO_BITS para o catálogo. */
+static inline size_t bytesBits(const Mansao *m) {
+    return ((size_t) m->pistas.quantidade + 7) / 8;
+}
+
+/* impressaoMansao()
+   Impressão do catálogo de pistas (FNV-1a sobre os hashes das pistas em
+   ordem alfabética e o número de salas), para recusar retratos de outra
+   mansão. */
+uint32_t impressaoMansao(const Mansao *m) {
+    uint32_t h = 2166136261u;
+    const Internador *pistas = &m->pistas;
+    for (uint32_t i = 0; i < pistas->numOrdenados; ++i) {
+        h = (h ^ pistas->hashes[pistas->porOrdem[i]]) * 16777619u;
+    }
+    return (h ^ m->numSalas) * 16777619u;
+}
+
+/* limiteRetrato()
+   Espaço suficiente para o retrato da sessão. */
+size_t limiteRetrato(const Sessao *s, const Mansao *m) {
+    size_t lista = (size_t) s->numPistas * 5;
+    size_t bits = bytesBits(m) + 5;
+    return RETRATO_MAX_CABECALHO + (lista < bits ? lista : bits);
+}
+
+/* escreverBits()
+   Pistas no formato RETRATO_BITS. */
+static uint8_t* escreverBits(const Sessao *s, const Mansao *m, uint8_t *p) {
+    size_t n = bytesBits(m);
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    if (s->pistas.tipo == CONJUNTO_BITS) {
+        memcpy(p, s->pistas.bits, n);
+        return p + n;
+    }
+#endif
+    memset(p, 0, n);
+    IteradorOrdens it;
+    uint32_t ordem;
+    iniciarIterador(&it, &s->pistas);
+    while (proximaOrdem(&it, &ordem)) p[ordem >> 3] |= (uint8_t) (1u << (ordem & 7));
+    return p + n;
+}
+
+/* codificarSessao()
+   Escreve o retrato da sessão em destino, que precisa ter
+   limiteRetrato() bytes. Retorna o tamanho do retrato. */
+size_t codificarSessao(const Sessao *s, const Mansao *m, uint8_t *destino) {
+    uint8_t *p = destino;
+    p = escreverVarint(p, s->salaAtual);
+    p = escreverVarint(p, s->movimentos);
+    p = escreverVarint(p, s->invalidos);
+    p = escreverVarint(p, s->suspeitoMaisProvavel != INTERNADOR_AUSENTE ? s->suspeitoMaisProvavel + 1 : 0);
+    p = escreverVarint(p, s->numPistas);
+
+    // tenta a lista; se ela passar do tamanho do conjunto de bits, usa os bits
+    uint8_t *formato = p++;
+    uint8_t *limite = p + bytesBits(m);
+    IteradorOrdens it;
+    uint32_t ordem, anterior = 0;
+    iniciarIterador(&it, &s->pistas);
+    *formato = RETRATO_LISTA;
+    while (proximaOrdem(&it, &ordem)) {
+        if (p >= limite) {
+            *formato = RETRATO_BITS;
+            return (size_t) (escreverBits(s, m, formato + 1) - destino);
+        }
+        p = escreverVarint(p, ordem - anterior);
+        anterior = ordem;
+    }
+    return (size_t) (p - destino);
+}
+
+/* registrarOrdem()
+   Acrescenta uma pista restaurada ao conjunto, às evidências e ao ranking.
+   Retorna 0 se a pista já estava no conjunto. */
+static int registrarOrdem(Sessao *s, const Mansao *m, uint32_t ordem) {
+    if (!inserirNoConjunto(&s->pistas, ordem)) return 0;
+    somarEvidencia(s, m->pistas.porOrdem[ordem]);
+    return 1;
+}
+
+/* lerBits()
+   Restaura as pistas do formato RETRATO_BITS. Retorna quantas eram ou -1
+   se houver bits fora do catálogo. */
+static long lerBits(Sessao *s, const Mansao *m, const uint8_t *p) {
+    uint32_t numPistas = m->pistas.quantidade;
+    size_t n = bytesBits(m);
+    if ((numPistas & 7) != 0 && (p[n - 1] >> (numPistas & 7)) != 0) return -1;
+    long total = 0;
+#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    if (s->pistas.tipo == CONJUNTO_BITS) {
+        memcpy(s->pistas.bits, p, n);
+        IteradorOrdens it;
+        uint32_t ordem;
+        iniciarIterador(&it, &s->pistas);
+        while (proximaOrdem(&it, &ordem)) {
+            somarEvidencia(s, m->pistas.porOrdem[ordem]);
+            total++;
+        }
+        return total;
+    }
+#endif
+    for (size_t i = 0; i < n; ++i) {
+        for (uint32_t b = p[i]; b != 0; b &= b - 1) {
+            registrarOrdem(s, m, (uint32_t) (i * 8) + (uint32_t) __builtin_ctz(b));
+            total++;
+        }
+    }
+    return total;
+}
+
+/* restaurarRetrato()
+   Corpo de decodificarSessao(); retorna -1 no primeiro problema. */
+static int restaurarRetrato(Sessao *s, const Mansao *m, const uint8_t *dados, size_t tam, size_t *usados) {
+    const uint8_t *p = dados, *fim = dados + tam;
+    uint32_t campos[RETRATO_CAMPOS];
+    for (int i = 0; i < RETRATO_CAMPOS; ++i)
+        if (!lerVarint(&p, fim, &campos[i])) return -1;
+    if (p == fim) return -1;
+    uint32_t sala = campos[0], maisProvavel = campos[3], numPistas = campos[4];
+    uint32_t suspeitos = s->evidencias != NULL ? numSuspeitos(s->tabela) : 0;
+    if (sala >= m->numSalas || maisProvavel > suspeitos || numPistas > m->pistas.quantidade) return -1;
+
+    reiniciarSessao(s, sala);
+    s->movimentos = campos[1];
+    s->invalidos = campos[2];
+    uint8_t formato = *p++;
+    if (formato == RETRATO_LISTA) {
+        uint32_t ordem = 0;
+        for (uint32_t i = 0; i < numPistas; ++i) {
+            uint32_t diferenca;
+            if (!lerVarint(&p, fim, &diferenca)) return -1;
+            if ((i > 0 && diferenca == 0) || diferenca >= m->pistas.quantidade - ordem) return -1;
+            ordem += diferenca;
+            registrarOrdem(s, m, ordem);
+        }
+    } else if (formato == RETRATO_BITS) {
+        if ((size_t) (fim - p) < bytesBits(m) || lerBits(s, m, p) != (long) numPistas) return -1;
+        p += bytesBits(m);
+    } else {
+        return -1;
+    }
+    s->numPistas = numPistas;
+
+    // o mais provável precisa ter o maior número de evidências
+    if (maisProvavel > 0) {
+        s->suspeitoMaisProvavel = maisProvavel - 1;
+        s->maxEvidencias = s->evidencias[maisProvavel - 1];
+        if (s->maxEvidencias == 0) return -1;
+    }
+    for (uint32_t i = 0; i < suspeitos; ++i)
+        if (s->evidencias[i] > s->maxEvidencias) return -1;
+
+    *usados = (size_t) (p - dados);
+    return 0;
+}
+
+/* decodificarSessao()
+   Restaura na sessão (já iniciada sobre a mesma mansão) o retrato que
+   começa em dados. Em *usados fica o tamanho do retrato. Retorna 0, ou -1
+   se o retrato for inválido para a mansão; nesse caso a sessão volta à
+   entrada, sem pistas. */
+int decodificarSessao(Sessao *s, const Mansao *m, const uint8_t *dados, size_t tam, size_t *usados) {
+    if (restaurarRetrato(s, m, dados, tam, usados) == 0) return 0;
+    // as evidências podem ter sido contadas sem maxEvidencias, que é o que
+    // reiniciarSessao() usa para saber se precisa zerá-las
+    if (s->evidencias != NULL) memset(s->evidencias, 0, numSuspeitos(s->tabela) * sizeof(uint32_t));
+    reiniciarSessao(s, SALA_ENTRADA);
+    return -1;
+}
+
+/* ===================== ARQUIVOS DE RETRATOS ===================== */
+
+/* reservarGravador()
+   Garante espaço para mais n bytes no gravador. */
+static void reservarGravador(GravadorRetratos *g, size_t n) {
+    if (g->tam + n <= g->cap) return;
+    while (g->tam + n > g->cap) g->cap *= 2;
+    g->dados = (uint8_t*) realocarOuSair(g->dados, g->cap, "os retratos");
+}
+
+/* iniciarGravadorRetratos()
+   Começa um arquivo de retratos vazio para sessões sobre o mapa. */
+void iniciarGravadorRetratos(GravadorRetratos *g, const MapaCarregado *mapa) {
+    g->mapa = mapa;
+    g->cap = 1 << 16;
+    g->dados = (uint8_t*) realocarOuSair(NULL, g->cap, "os retratos");
+    g->tam = sizeof(CabecalhoRetratos);
+    g->numSessoes = 0;
+}
+
+/* acrescentarRetrato()
+   Acrescenta o retrato da sessão ao arquivo em montagem. */
+void acrescentarRetrato(GravadorRetratos *g, const Sessao *s) {
+    reservarGravador(g, limiteRetrato(s, &g->mapa->mansao));
+    g->tam += codificarSessao(s, &g->mapa->mansao, g->dados + g->tam);
+    g->numSessoes++;
+}
+
+/* gravarRetratos()
+   Preenche o cabeçalho e grava o arquivo numa única escrita.
+   Retorna 0 ou -1 se o arquivo não puder ser gravado. */
+int gravarRetratos(GravadorRetratos *g, const char *caminho) {
+    const Mansao *m = &g->mapa->mansao;
+    CabecalhoRetratos c;
+    memset(&c, 0, sizeof(c));
+    memcpy(c.magica, RETRATO_MAGICA, sizeof(c.magica));
+    c.versao = RETRATO_VERSAO;
+    c.numSalas = m->numSalas;
+    c.numPistas = m->pistas.quantidade;
+    c.numSuspeitos = numSuspeitos(&g->mapa->tabela);
+    c.impressao = impressaoMansao(m);
+    c.numSessoes = g->numSessoes;
+    c.tamDados = g->tam - sizeof(CabecalhoRetratos);
+    memcpy(g->dados, &c, sizeof(c));
+
+    FILE *arq = fopen(caminho, "wb");
+    if (arq == NULL) return -1;
+    int ok = fwrite(g->dados, 1, g->tam, arq) == g->tam;
+    if (fclose(arq) != 0) ok = 0;
+    return ok ? 0 : -1;
+}
+
+/* liberarGravadorRetratos()
+   Libera o buffer do gravador. */
+void liberarGravadorRetratos(GravadorRetratos *g) {
+    free(g->dados);
+    g->dados = NULL;
+    g->tam = g->cap = 0;
+}
+
+/* registrarErroLeitor()
+   Formata a mensagem de erro do leitor e retorna -1. */
+static int registrarErroLeitor(LeitorRetratos *l, const char *formato, ...) {
+    va_list args;
+    va_start(args, formato);
+    vsnprintf(l->erro, sizeof(l->erro), formato, args);
+    va_end(args);
+    return -1;
+}
+
+/* abrirRetratos()
+   Mapeia um arquivo de retratos gravado para a mesma mansão.
+   Retorna 0 ou -1 com a mensagem em l->erro. */
+int abrirRetratos(LeitorRetratos *l, const MapaCarregado *mapa, const char *caminho) {
+    memset(l, 0, sizeof(LeitorRetratos));
+    l->mapa = mapa;
+    int fd = open(caminho, O_RDONLY);
+    if (fd < 0) return registrarErroLeitor(l, "Erro ao abrir o arquivo de sessoes %s.", caminho);
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t) info.st_size < sizeof(CabecalhoRetratos)) {
+        close(fd);
+        return registrarErroLeitor(l, "%s: arquivo de sessoes truncado.", caminho);
+    }
+    size_t tamArquivo = (size_t) info.st_size;
+    void *base = mmap(NULL, tamArquivo, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED) return registrarErroLeitor(l, "%s: erro ao mapear o arquivo.", caminho);
+    l->mapeamento = base;
+    l->tamMapeamento = tamArquivo;
+
+    const CabecalhoRetratos *c = (const CabecalhoRetratos*) base;
+    const Mansao *m = &mapa->mansao;
+    if (memcmp(c->magica, RETRATO_MAGICA, sizeof(c->magica)) != 0 || c->versao != RETRATO_VERSAO ||
+        c->tamDados != tamArquivo - sizeof(CabecalhoRetratos)) {
+        fecharRetratos(l);
+        return registrarErroLeitor(l, "%s: arquivo de sessoes corrompido ou de outra versao.", caminho);
+    }
+    if (c->numSalas != m->numSalas || c->numPistas != m->pistas.quantidade ||
+        c->numSuspeitos != numSuspeitos(&mapa->tabela) || c->impressao != impressaoMansao(m)) {
+        fecharRetratos(l);
+        return registrarErroLeitor(l, "%s: as sessoes foram salvas em outra mansao.", caminho);
+    }
+    l->dados = (const uint8_t*) base + sizeof(CabecalhoRetratos);
+    l->tam = (size_t) c->tamDados;
+    l->numSessoes = c->numSessoes;
+    return 0;
+}
+
+/* lerRetrato()
+   Restaura o próximo retrato do arquivo na sessão. Retorna 1 se restaurou,
+   0 no fim do arquivo ou -1 se o retrato estiver corrompido. */
+int lerRetrato(LeitorRetratos *l, Sessao *s) {
+    if (l->lidas == l->numSessoes) return 0;
+    size_t usados;
+    if (decodificarSessao(s, &l->mapa->mansao, l->dados + l->pos, l->tam - l->pos, &usados) != 0)
+        return registrarErroLeitor(l, "Retrato %llu corrompido.", (unsigned long long) l->lidas + 1);
+    l->pos += usados;
+    l->lidas++;
+    return 1;
+}
+
+/* fecharRetratos()
+   Desfaz o mapeamento do arquivo. */
+void fecharRetratos(LeitorRetratos *l) {
+    if (l->mapeamento != NULL) munmap(l->mapeamento, l->tamMapeamento);
+    l->mapeamento = NULL;
+    l->dados = NULL;
+}
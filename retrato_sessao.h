@@ -0,0 +1,90 @@
+#ifndef RETRATO_SESSAO_H
+#define RETRATO_SESSAO_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "carregador.h"
+#include "sessao.h"
+
+/* ===================== RETRATOS DE SESSÃO ===================== */
+
+/* Estado de uma sessão serializado de forma compacta, para estacionar
+   sessões ociosas e retomá-las depois (no mesmo processo ou em outro).
+
+   Retrato de uma sessão (inteiros em varint, 7 bits por byte):
+
+     sala atual, movimentos, inválidos, suspeito mais provável + 1 (0 se
+     nenhum), número de pistas, formato das pistas (1 byte) e as pistas:
+     - RETRATO_LISTA: posições alfabéticas crescentes, como diferenças;
+     - RETRATO_BITS: um bit por pista do catálogo, o bit i no byte i / 8
+       (o mesmo layout do conjunto de bits numa máquina little-endian).
+     É usado o formato menor para aquela sessão.
+
+   As contagens de evidências são recalculadas a partir das pistas; o
+   suspeito mais provável é guardado porque, em empates, depende da ordem
+   em que as pistas foram coletadas.
+
+   Arquivo de retratos: CabecalhoRetratos seguido dos retratos, um após o
+   outro. O cabeçalho identifica a mansão (salas, pistas, suspeitos e uma
+   impressão do catálogo de pistas), e um arquivo só é aceito pela mesma
+   mansão. O arquivo inteiro é montado na memória e gravado numa única
+   escrita sequencial; a leitura mapeia o arquivo com mmap(). */
+
+#define RETRATO_MAGICA "DQSESSAO"
+#define RETRATO_VERSAO 1
+
+enum {
+    RETRATO_LISTA,
+    RETRATO_BITS
+};
+
+typedef struct CabecalhoRetratos {
+    char magica[8];
+    uint32_t versao;
+    uint32_t numSalas;
+    uint32_t numPistas;
+    uint32_t numSuspeitos;
+    uint32_t impressao;     // impressão do catálogo (impressaoMansao())
+    uint32_t reservado;
+    uint64_t numSessoes;
+    uint64_t tamDados;      // bytes de retratos depois do cabeçalho
+} CabecalhoRetratos;
+
+/* Retratos acumulados na memória até gravarRetratos(). */
+typedef struct GravadorRetratos {
+    const MapaCarregado *mapa;
+    uint8_t *dados;         // cabeçalho + retratos
+    size_t tam;
+    size_t cap;
+    uint64_t numSessoes;
+} GravadorRetratos;
+
+/* Arquivo de retratos aberto para leitura, percorrido por lerRetrato(). */
+typedef struct LeitorRetratos {
+    const MapaCarregado *mapa;
+    void *mapeamento;
+    size_t tamMapeamento;
+    const uint8_t *dados;
+    size_t tam;
+    size_t pos;
+    uint64_t numSessoes;
+    uint64_t lidas;
+    char erro[MAPA_TAM_ERRO];
+} LeitorRetratos;
+
+uint32_t impressaoMansao(const Mansao *m);
+size_t limiteRetrato(const Sessao *s, const Mansao *m);
+size_t codificarSessao(const Sessao *s, const Mansao *m, uint8_t *destino);
+int decodificarSessao(Sessao *s, const Mansao *m, const uint8_t *dados, size_t tam, size_t *usados);
+
+void iniciarGravadorRetratos(GravadorRetratos *g, const MapaCarregado *mapa);
+void acrescentarRetrato(GravadorRetratos *g, const Sessao *s);
+int gravarRetratos(GravadorRetratos *g, const char *caminho);
+void liberarGravadorRetratos(GravadorRetratos *g);
+
+int abrirRetratos(LeitorRetratos *l, const MapaCarregado *mapa, const char *caminho);
+int lerRetrato(LeitorRetratos *l, Sessao *s);
+void fecharRetratos(LeitorRetratos *l);
+
+#endif
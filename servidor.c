@@ -0,0 +1,494 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <signal.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "interface.h"
+#include "internador.h"
+#include "renderizador.h"
+#include "servidor.h"
+
+#define TAM_ACUSADO 50  // como o buffer de verificarSuspeitoFinal(): nomes maiores são cortados
+
+typedef enum {
+    FASE_EXPLORANDO,
+    FASE_ACUSANDO,
+    FASE_ENCERRADA      // só falta enviar o que está pendente
+} FaseConexao;
+
+/* Uma conexão e a sua partida. As conexões fechadas vão para a lista de
+   livres com a sessão e os buffers, que a próxima conexão reaproveita. */
+typedef struct Conexao {
+    int fd;
+    FaseConexao fase;
+    uint32_t eventos;           // interesse registrado no epoll (EPOLLIN, EPOLLOUT)
+    DqSessao *sessao;
+    size_t tamEntrada;          // bytes recebidos ainda sem '\n'
+    char entrada[SERVIDOR_TAM_LINHA];
+    char *saida;                // saida[enviados .. tamSaida) ainda não foi enviado
+    size_t tamSaida;
+    size_t enviados;
+    size_t capSaida;
+    struct Conexao *proximaLivre;
+} Conexao;
+
+typedef struct Servidor {
+    const DqMansao *mansao;
+    Renderizador renderizador;  // só os quadros são usados, nunca o buffer
+    int epoll;
+    int escuta;
+    int sinais;
+    int aceitando;              // 0 enquanto faltam descritores para novas conexões
+    uint32_t abertas;
+    Conexao *livres;
+    Conexao **todas;            // todas as conexões já criadas, para liberar no fim
+    size_t numTodas;
+    size_t capTodas;
+    ResumoServidor *resumo;
+} Servidor;
+
+/* ===================== SAÍDA DAS CONEXÕES ===================== */
+
+/* reservarSaida()
+   Garante espaço para mais n bytes na saída da conexão. */
+static void reservarSaida(Conexao *c, size_t n) {
+    if (c->tamSaida + n <= c->capSaida) return;
+    size_t cap = c->capSaida ? c->capSaida : 512;
+    while (c->tamSaida + n > cap) cap *= 2;
+    c->saida = (char*) realocarOuSair(c->saida, cap, "a saida do servidor");
+    c->capSaida = cap;
+}
+
+/* anexarSaida()
+   Acrescenta bytes à saída pendente da conexão. */
+static void anexarSaida(Conexao *c, const char *texto, size_t n) {
+    reservarSaida(c, n);
+    memcpy(c->saida + c->tamSaida, texto, n);
+    c->tamSaida += n;
+}
+
+/* anexarTexto()
+   anexarSaida() de uma string. */
+static void anexarTexto(Conexao *c, const char *texto) {
+    anexarSaida(c, texto, strlen(texto));
+}
+
+/* anexarFormatado()
+   Como anexarSaida(), com formatação de printf(). Só é usada no fim da
+   partida; as jogadas usam os quadros prontos. */
+static void anexarFormatado(Conexao *c, const char *formato, ...) {
+    va_list args;
+    va_start(args, formato);
+    int n = vsnprintf(NULL, 0, formato, args);
+    va_end(args);
+    reservarSaida(c, (size_t) n + 1);
+    va_start(args, formato);
+    vsnprintf(c->saida + c->tamSaida, (size_t) n + 1, formato, args);
+    va_end(args);
+    c->tamSaida += (size_t) n;
+}
+
+/* vigiarConexao()
+   Acerta no epoll o interesse da conexão: leitura enquanto a partida
+   continua e escrita enquanto há saída pendente. Uma partida encerrada
+   deixa de ser lida, senão o fim da entrada ou o que o cliente ainda
+   mandar seria entregue de novo a cada volta do epoll (por nível) sem
+   que ninguém o leia. Retorna 1 se o epoll recusou a mudança. */
+static int vigiarConexao(Servidor *srv, Conexao *c) {
+    uint32_t eventos = (c->fase != FASE_ENCERRADA ? EPOLLIN : 0) | (c->enviados < c->tamSaida ? EPOLLOUT : 0);
+    if (eventos == c->eventos) return 0;
+    struct epoll_event ev;
+    ev.events = eventos;
+    ev.data.ptr = c;
+    if (epoll_ctl(srv->epoll, EPOLL_CTL_MOD, c->fd, &ev) != 0) return 1;
+    c->eventos = eventos;
+    return 0;
+}
+
+/* enviarPendente()
+   Envia o que der da saída pendente sem bloquear. Retorna 1 se a conexão
+   deve ser fechada (erro, cliente que não lê ou partida encerrada e
+   entregue). */
+static int enviarPendente(Servidor *srv, Conexao *c) {
+    while (c->enviados < c->tamSaida) {
+        ssize_t n = send(c->fd, c->saida + c->enviados, c->tamSaida - c->enviados, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno != EAGAIN && errno != EWOULDBLOCK) return 1;
+            if (c->tamSaida - c->enviados > SERVIDOR_MAX_PENDENTE) return 1;
+            return vigiarConexao(srv, c);
+        }
+        c->enviados += (size_t) n;
+    }
+    c->tamSaida = c->enviados = 0;
+    if (c->fase == FASE_ENCERRADA) return 1;
+    return vigiarConexao(srv, c);
+}
+
+/* ===================== PARTIDAS ===================== */
+
+/* enviarSala()
+   Coleta a pista da sala atual e acrescenta o quadro dela, como no começo
+   de cada volta de explorarSalasComPistas(). */
+static void enviarSala(Servidor *srv, Conexao *c) {
+    const Renderizador *r = &srv->renderizador;
+    uint32_t sala = dqIdSalaAtual(c->sessao);
+    dqColetar(c->sessao);
+    anexarSaida(c, r->quadros + r->inicioQuadro[sala], r->inicioQuadro[sala + 1] - r->inicioQuadro[sala]);
+}
+
+/* anexarPista()
+   Visitante de dqPercorrerPistas() para a lista de pistas. */
+static void anexarPista(const char *pista, void *contexto) {
+    anexarFormatado((Conexao*) contexto, "pista\t%s\n", pista);
+}
+
+/* anexarSuspeito()
+   Visitante de dqRanking() para as linhas "ranking". */
+static void anexarSuspeito(const char *suspeito, uint64_t pontos, void *contexto) {
+    anexarFormatado((Conexao*) contexto, "ranking\t%s\t%llu\n", suspeito, (unsigned long long) pontos);
+}
+
+/* encerrarPartida()
+   Despedida: a partida termina e a conexão fecha depois de entregue.
+   Quem trata a entrada chama enviarPendente() em seguida, que tira a
+   leitura do epoll se a despedida não couber no socket. */
+static void encerrarPartida(Servidor *srv, Conexao *c) {
+    anexarTexto(c, "obrigado\n");
+    c->fase = FASE_ENCERRADA;
+    srv->resumo->partidas++;
+}
+
+/* encerrarExploracao()
+   O jogador saiu: pistas, suspeito mais provável, ranking e o pedido da
+   acusação, nas mesmas linhas que interface.c escreve no protocolo. */
+static void encerrarExploracao(Servidor *srv, Conexao *c) {
+    DqEstatisticas e;
+    dqEstatisticas(c->sessao, &e);
+    anexarFormatado(c, "sair\npistas\t%u\n", e.pistas);
+    dqPercorrerPistas(c->sessao, anexarPista, c);
+    if (e.maisProvavel != NULL) anexarFormatado(c, "suspeito\t%s\t%u\n", e.maisProvavel, e.maxEvidencias);
+    if (dqPistasPonderadas(srv->mansao)) dqRanking(c->sessao, RANKING_EXIBIDO, anexarSuspeito, c);
+
+    if (e.pistas == 0) {
+        anexarTexto(c, "acusacao\t-\t0\tsem_pistas\n");
+        encerrarPartida(srv, c);
+        return;
+    }
+    anexarTexto(c, "acusar\n");
+    c->fase = FASE_ACUSANDO;
+}
+
+/* acusar()
+   Linha com o nome do acusado (vazia cancela a acusação). */
+static void acusar(Servidor *srv, Conexao *c, char *linha, size_t tam) {
+    linha[strcspn(linha, "\r")] = '\0';
+    if (tam >= TAM_ACUSADO) linha[TAM_ACUSADO - 1] = '\0';
+    if (linha[0] == '\0') {
+        anexarTexto(c, "acusacao\t-\t0\tcancelada\n");
+    } else {
+        uint32_t correspondencias;
+        int valida = dqAcusar(c->sessao, linha, &correspondencias);
+        anexarFormatado(c, "acusacao\t%s\t%u\t%s\n", linha, correspondencias, valida ? "valida" : "insuficiente");
+        srv->resumo->acusacoesValidas += valida;
+    }
+    encerrarPartida(srv, c);
+}
+
+/* tratarLinha()
+   Uma linha completa do cliente (sem o '\n'). Como lerEscolha(), vale o
+   primeiro caractere que não é espaço e linhas em branco são ignoradas. */
+static void tratarLinha(Servidor *srv, Conexao *c, char *linha, size_t tam) {
+    if (c->fase == FASE_ACUSANDO) {
+        acusar(srv, c, linha, tam);
+        return;
+    }
+    if (c->fase != FASE_EXPLORANDO) return;
+
+    size_t i = 0;
+    while (i < tam && (linha[i] == ' ' || (linha[i] >= '\t' && linha[i] <= '\r'))) i++;
+    if (i == tam) return;
+    DqMovimento mv = dqMover(c->sessao, linha[i]);
+    if (mv == DQ_MOVIMENTO_SAIR) {
+        encerrarExploracao(srv, c);
+        return;
+    }
+    srv->resumo->movimentos++;
+    if (mv == DQ_MOVIMENTO_INVALIDO) anexarTexto(c, "invalido\n");
+    enviarSala(srv, c);
+}
+
+/* fimDaEntrada()
+   O cliente fechou a escrita. Como no jogo com a entrada padrão, uma
+   última linha sem '\n' ainda vale, o fim da entrada conta como 's' e
+   a acusação termina em erro; a resposta ainda é entregue se o cliente
+   continuar lendo. */
+static void fimDaEntrada(Servidor *srv, Conexao *c) {
+    if (c->tamEntrada > 0) {
+        c->entrada[c->tamEntrada] = '\0';   // nunca cheio: linhas longas demais fecham a conexão
+        tratarLinha(srv, c, c->entrada, c->tamEntrada);
+        c->tamEntrada = 0;
+    }
+    if (c->fase == FASE_EXPLORANDO) encerrarExploracao(srv, c);
+    if (c->fase == FASE_ACUSANDO) {
+        anexarTexto(c, "acusacao\t-\t0\terro\n");
+        encerrarPartida(srv, c);
+    }
+}
+
+/* lerConexao()
+   Lê o que chegou, trata as linhas completas e envia as respostas.
+   Retorna 1 se a conexão deve ser fechada. */
+static int lerConexao(Servidor *srv, Conexao *c) {
+    while (c->fase != FASE_ENCERRADA) {
+        size_t livre = sizeof(c->entrada) - c->tamEntrada;
+        ssize_t n = recv(c->fd, c->entrada + c->tamEntrada, livre, 0);
+        if (n == 0) {
+            fimDaEntrada(srv, c);
+            break;
+        }
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+            return 1;
+        }
+        c->tamEntrada += (size_t) n;
+
+        size_t inicio = 0;
+        char *fimLinha;
+        while (c->fase != FASE_ENCERRADA &&
+               (fimLinha = memchr(c->entrada + inicio, '\n', c->tamEntrada - inicio)) != NULL) {
+            *fimLinha = '\0';
+            tratarLinha(srv, c, c->entrada + inicio, (size_t) (fimLinha - c->entrada) - inicio);
+            inicio = (size_t) (fimLinha - c->entrada) + 1;
+        }
+        if (inicio == 0 && c->tamEntrada == sizeof(c->entrada)) return 1;  // linha longa demais
+        memmove(c->entrada, c->entrada + inicio, c->tamEntrada - inicio);
+        c->tamEntrada -= inicio;
+        if ((size_t) n < livre) break;
+    }
+    return enviarPendente(srv, c);
+}
+
+/* ===================== CONEXÕES ===================== */
+
+/* fecharConexao()
+   Fecha o socket e devolve a conexão à lista de livres. */
+static void fecharConexao(Servidor *srv, Conexao *c) {
+    close(c->fd);
+    c->fd = -1;
+    c->proximaLivre = srv->livres;
+    srv->livres = c;
+    srv->abertas--;
+    if (!srv->aceitando) {
+        // voltou a haver descritor livre para aceitar conexões
+        struct epoll_event ev;
+        ev.events = EPOLLIN;
+        ev.data.ptr = &srv->escuta;
+        if (epoll_ctl(srv->epoll, EPOLL_CTL_ADD, srv->escuta, &ev) == 0) srv->aceitando = 1;
+        else fprintf(stderr, "servidor: erro ao voltar a aceitar conexoes: %s\n", strerror(errno));
+    }
+}
+
+/* abrirConexao()
+   Começa a partida de uma conexão aceita: abertura e primeira sala. */
+static void abrirConexao(Servidor *srv, int fd) {
+    Conexao *c = srv->livres;
+    if (c != NULL) {
+        srv->livres = c->proximaLivre;
+        dqReiniciarSessao(c->sessao);
+    } else {
+        c = (Conexao*) calloc(1, sizeof(Conexao));
+        if (c == NULL || (c->sessao = dqIniciarSessao(srv->mansao)) == NULL) {
+            printf("Erro ao alocar memoria para a conexao.\n");
+            exit(1);
+        }
+        if (srv->numTodas == srv->capTodas) {
+            srv->capTodas = srv->capTodas ? srv->capTodas * 2 : 64;
+            srv->todas = (Conexao**) realocarOuSair(srv->todas, srv->capTodas * sizeof(Conexao*), "as conexoes");
+        }
+        srv->todas[srv->numTodas++] = c;
+    }
+    c->fd = fd;
+    c->fase = FASE_EXPLORANDO;
+    c->eventos = EPOLLIN;
+    c->tamEntrada = c->tamSaida = c->enviados = 0;
+
+    struct epoll_event ev;
+    ev.events = c->eventos;
+    ev.data.ptr = c;
+    if (epoll_ctl(srv->epoll, EPOLL_CTL_ADD, fd, &ev) != 0) {
+        fprintf(stderr, "servidor: erro ao vigiar a conexao: %s\n", strerror(errno));
+        close(fd);
+        c->fd = -1;
+        c->proximaLivre = srv->livres;
+        srv->livres = c;
+        return;
+    }
+    if (++srv->abertas > srv->resumo->picoConexoes) srv->resumo->picoConexoes = srv->abertas;
+    srv->resumo->conexoes++;
+
+    anexarFormatado(c, "protocolo\t%d\n", PROTOCOLO_VERSAO);
+    enviarSala(srv, c);
+    if (enviarPendente(srv, c)) fecharConexao(srv, c);
+}
+
+/* aceitarConexoes()
+   Aceita todas as conexões na fila. Sem descritores livres, o socket de
+   escuta sai do epoll até alguma conexão fechar (senão o epoll por nível
+   o entregaria de novo a cada volta). */
+static void aceitarConexoes(Servidor *srv) {
+    while (1) {
+        int fd = accept4(srv->escuta, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd >= 0) {
+            abrirConexao(srv, fd);
+            continue;
+        }
+        if (errno == EINTR || errno == ECONNABORTED) continue;
+        if ((errno == EMFILE || errno == ENFILE) && srv->abertas > 0) {
+            if (epoll_ctl(srv->epoll, EPOLL_CTL_DEL, srv->escuta, NULL) == 0) srv->aceitando = 0;
+            else fprintf(stderr, "servidor: erro ao pausar as conexoes: %s\n", strerror(errno));
+        }
+        return;
+    }
+}
+
+/* liberarConexoes()
+   Fecha as conexões ainda abertas e libera todas, abertas ou livres. */
+static void liberarConexoes(Servidor *srv) {
+    for (size_t i = 0; i < srv->numTodas; ++i) {
+        Conexao *c = srv->todas[i];
+        if (c->fd >= 0) close(c->fd);
+        dqEncerrarSessao(c->sessao);
+        free(c->saida);
+        free(c);
+    }
+    free(srv->todas);
+    srv->todas = NULL;
+    srv->numTodas = srv->capTodas = 0;
+    srv->livres = NULL;
+    srv->abertas = 0;
+}
+
+/* ===================== SERVIDOR ===================== */
+
+/* abrirEscuta()
+   Cria o socket Unix não bloqueante em caminho. Um socket velho no mesmo
+   caminho (de um servidor que não terminou direito) é removido; qualquer
+   outro tipo de arquivo é mantido e vira erro. */
+static int abrirEscuta(const char *caminho) {
+    struct sockaddr_un endereco;
+    memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    if (strlen(caminho) >= sizeof(endereco.sun_path)) {
+        printf("Caminho do socket longo demais: %s\n", caminho);
+        return -1;
+    }
+    strcpy(endereco.sun_path, caminho);
+
+    struct stat st;
+    if (lstat(caminho, &st) == 0 && S_ISSOCK(st.st_mode)) unlink(caminho);
+    int fd = socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (fd < 0 || bind(fd, (struct sockaddr*) &endereco, sizeof(endereco)) != 0 || listen(fd, SOMAXCONN) != 0) {
+        printf("Erro ao abrir o socket %s: %s\n", caminho, strerror(errno));
+        if (fd >= 0) close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/* aumentarLimiteDescritores()
+   Sobe o limite de arquivos abertos do processo até o máximo permitido:
+   cada conexão é um descritor. */
+static void aumentarLimiteDescritores(void) {
+    struct rlimit lim;
+    if (getrlimit(RLIMIT_NOFILE, &lim) == 0 && lim.rlim_cur < lim.rlim_max) {
+        lim.rlim_cur = lim.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &lim);
+    }
+}
+
+/* executarServidor()
+   Atende partidas em caminho até receber SIGINT ou SIGTERM e preenche os
+   totais em resumo. Retorna 1 se o servidor não pôde começar. */
+int executarServidor(const DqMansao *mansao, const char *caminho, ResumoServidor *resumo) {
+    memset(resumo, 0, sizeof(*resumo));
+    aumentarLimiteDescritores();
+
+    Servidor srv;
+    memset(&srv, 0, sizeof(srv));
+    srv.mansao = mansao;
+    srv.resumo = resumo;
+    srv.aceitando = 1;
+    srv.escuta = abrirEscuta(caminho);
+    if (srv.escuta < 0) return 1;
+
+    // os sinais de término chegam pelo epoll, como mais um descritor
+    sigset_t sinais, anteriores;
+    sigemptyset(&sinais);
+    sigaddset(&sinais, SIGINT);
+    sigaddset(&sinais, SIGTERM);
+    sigprocmask(SIG_BLOCK, &sinais, &anteriores);
+    srv.sinais = signalfd(-1, &sinais, SFD_NONBLOCK | SFD_CLOEXEC);
+    srv.epoll = epoll_create1(EPOLL_CLOEXEC);
+    struct epoll_event evEscuta, evSinais;
+    evEscuta.events = evSinais.events = EPOLLIN;
+    evEscuta.data.ptr = &srv.escuta;
+    evSinais.data.ptr = &srv.sinais;
+    if (srv.sinais < 0 || srv.epoll < 0 || epoll_ctl(srv.epoll, EPOLL_CTL_ADD, srv.escuta, &evEscuta) != 0 ||
+        epoll_ctl(srv.epoll, EPOLL_CTL_ADD, srv.sinais, &evSinais) != 0) {
+        printf("Erro ao preparar o servidor: %s\n", strerror(errno));
+        if (srv.epoll >= 0) close(srv.epoll);
+        if (srv.sinais >= 0) close(srv.sinais);
+        close(srv.escuta);
+        unlink(caminho);
+        sigprocmask(SIG_SETMASK, &anteriores, NULL);
+        return 1;
+    }
+
+    prepararRenderizador(&srv.renderizador, mansao, 1, SAIDA_PROTOCOLO);
+    fprintf(stderr, "servidor: atendendo em %s\n", caminho);
+
+    struct epoll_event eventos[SERVIDOR_EVENTOS];
+    int rodando = 1;
+    while (rodando) {
+        int n = epoll_wait(srv.epoll, eventos, SERVIDOR_EVENTOS, -1);
+        if (n < 0 && errno != EINTR) break;
+        for (int i = 0; i < n; ++i) {
+            void *alvo = eventos[i].data.ptr;
+            if (alvo == &srv.escuta) {
+                aceitarConexoes(&srv);
+            } else if (alvo == &srv.sinais) {
+                // consome o sinal, que senão seria entregue ao desbloquear
+                struct signalfd_siginfo info;
+                while (read(srv.sinais, &info, sizeof(info)) == (ssize_t) sizeof(info)) { /* esvazia */ }
+                rodando = 0;
+            } else {
+                Conexao *c = (Conexao*) alvo;
+                int fechar = (eventos[i].events & (EPOLLERR | EPOLLHUP)) != 0 && !(eventos[i].events & EPOLLIN);
+                if (!fechar && (eventos[i].events & EPOLLOUT)) fechar = enviarPendente(&srv, c);
+                if (!fechar && (eventos[i].events & EPOLLIN)) fechar = lerConexao(&srv, c);
+                if (fechar) fecharConexao(&srv, c);
+            }
+        }
+    }
+
+    liberarConexoes(&srv);
+    close(srv.epoll);
+    close(srv.sinais);
+    close(srv.escuta);
+    unlink(caminho);
+    sigprocmask(SIG_SETMASK, &anteriores, NULL);
+    liberarRenderizador(&srv.renderizador);
+    return 0;
+}
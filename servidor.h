@@ -0,0 +1,45 @@
+#ifndef SERVIDOR_H
+#define SERVIDOR_H
+
+#include <stdint.h>
+
+#include "detective.h"
+
+/* ===================== SERVIDOR DE PARTIDAS ===================== */
+
+/* Um processo e uma thread atendendo muitas partidas do nível Mestre ao
+   mesmo tempo, por um socket Unix (SOCK_STREAM). Cada conexão é uma
+   sessão própria (sala atual e pistas) sobre a mansão compartilhada e
+   conversa no protocolo de renderizador.h, byte a byte igual ao de
+   `algoritmo_avacadosMestres --protocolo` com a mesma entrada:
+
+     servidor  protocolo, sala            ao conectar (pista da sala já coletada)
+     cliente   e | d | 1..9               uma escolha por linha
+     servidor  [invalido] sala
+     cliente   s
+     servidor  sair, pistas, pista..., [suspeito], [ranking...], acusar
+     cliente   <nome do acusado>
+     servidor  acusacao, obrigado         e fecha a conexão
+
+   Os sockets são não bloqueantes e atendidos por um único epoll. O que
+   cada conexão recebeu pela metade ou ainda não conseguiu enviar fica nos
+   buffers dela, então um cliente lento não atrasa os outros; conexões e
+   sessões encerradas são reaproveitadas pelas próximas. SIGINT ou SIGTERM
+   terminam o servidor, que remove o socket. */
+
+#define SERVIDOR_TAM_LINHA 256          // maior linha aceita do cliente
+#define SERVIDOR_MAX_PENDENTE (1 << 20) // saída acumulada para um cliente que não lê
+#define SERVIDOR_EVENTOS 512            // eventos por chamada a epoll_wait()
+
+/* Totais de executarServidor(). */
+typedef struct ResumoServidor {
+    uint64_t conexoes;
+    uint64_t partidas;          // conexões que chegaram ao "obrigado"
+    uint64_t movimentos;        // escolhas recebidas, inválidas inclusive
+    uint64_t acusacoesValidas;
+    uint32_t picoConexoes;      // conexões abertas ao mesmo tempo
+} ResumoServidor;
+
+int executarServidor(const DqMansao *mansao, const char *caminho, ResumoServidor *resumo);
+
+#endif
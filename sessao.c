@@ -0,0 +1,348 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "sessao.h"
+
+/* Contexto usado por contarPistasParaSuspeito() durante o percurso. */
+typedef struct ContagemSuspeito {
+    const TabelaHash *tabela;
+    uint32_t suspeito;
+    int contador;
+} ContagemSuspeito;
+
+/* zerarRanking()
+   Todas as pontuações em zero: com os suspeitos em ordem de id, o vetor já
+   é um heap válido (empates ficam com o menor id). */
+static void zerarRanking(Sessao *s) {
+    uint32_t k = numSuspeitos(s->tabela);
+    memset(s->pontuacao, 0, (size_t) k * sizeof(uint64_t));
+    for (uint32_t i = 0; i < k; ++i) s->ranking[i] = s->posicaoRanking[i] = i;
+}
+
+/* iniciarSessao()
+   Começa uma sessão vazia na sala indicada, guardando as pistas coletadas
+   na representação pedida (conjunto_pistas.h). A tabela dá o catálogo de
+   pistas e os suspeitos; sem ela (NULL) as pistas ficam sempre na árvore.
+   Se arena não for NULL os nós da árvore são alocados nela; a arena é
+   reiniciada por encerrarSessao(), então só atende uma sessão por vez.
+   Sem arena externa, a sessão usa a sua própria. */
+void iniciarSessao(Sessao *s, uint32_t salaInicial, const TabelaHash *tabela,
+                   ArenaPistas *arena, TipoConjunto tipo) {
+    inicializarArena(&s->arena);
+    if (arena == NULL) arena = &s->arena;
+    s->salaAtual = salaInicial;
+    if (tabela != NULL)
+        iniciarConjunto(&s->pistas, tipo, tabela->pistas->quantidade, arena);
+    else
+        iniciarConjunto(&s->pistas, CONJUNTO_ARVORE, 0, arena);
+    s->numPistas = 0;
+    s->movimentos = 0;
+    s->invalidos = 0;
+    s->tabela = tabela;
+    s->evidencias = NULL;
+    s->suspeitoMaisProvavel = INTERNADOR_AUSENTE;
+    s->maxEvidencias = 0;
+    s->pontuacao = NULL;
+    s->ranking = NULL;
+    s->posicaoRanking = NULL;
+    s->visitadas = NULL;
+    s->salasVisitadas = NULL;
+    s->numVisitadas = 0;
+    s->capVisitadas = 0;
+    if (tabela != NULL && numSuspeitos(tabela) > 0) {
+        uint32_t k = numSuspeitos(tabela);
+        s->evidencias = (uint32_t*) calloc(k, sizeof(uint32_t));
+        s->pontuacao = (uint64_t*) calloc(k, sizeof(uint64_t));
+        s->ranking = (uint32_t*) malloc((size_t) k * 2 * sizeof(uint32_t));
+        if (s->evidencias == NULL || s->pontuacao == NULL || s->ranking == NULL) {
+            printf("Erro ao alocar memoria para a sessao.\n");
+            exit(1);
+        }
+        s->posicaoRanking = s->ranking + k;
+        zerarRanking(s);
+    }
+}
+
+/* contarFimDeSessao()
+   Estatísticas de uma sessão que termina ou recomeça depois de jogar. */
+static inline void contarFimDeSessao(const Sessao *s) {
+    if (s->movimentos + s->invalidos == 0 && s->numPistas == 0) return;
+    EST_CONTAR(EST_SESSOES, 1);
+    EST_REGISTRAR(EST_MOVIMENTOS_SESSAO, s->movimentos);
+}
+
+/* reiniciarSessao()
+   Volta a sessão ao estado inicial na sala indicada, reaproveitando toda a
+   memória: os nós da árvore são descartados reiniciando a arena (O(1)) e
+   os contadores de evidências são zerados. Para jogar muitas sessões
+   curtas em sequência sem alocar nada. */
+void reiniciarSessao(Sessao *s, uint32_t salaInicial) {
+    contarFimDeSessao(s);
+    reiniciarConjunto(&s->pistas);
+    s->salaAtual = salaInicial;
+    s->numPistas = 0;
+    s->movimentos = 0;
+    s->invalidos = 0;
+    if (s->evidencias != NULL && s->maxEvidencias > 0)
+        memset(s->evidencias, 0, numSuspeitos(s->tabela) * sizeof(uint32_t));
+    if (s->ranking != NULL && s->pontuacao[s->ranking[0]] > 0) zerarRanking(s);
+    s->suspeitoMaisProvavel = INTERNADOR_AUSENTE;
+    s->maxEvidencias = 0;
+    for (uint32_t i = 0; i < s->numVisitadas; ++i) {
+        uint32_t sala = s->salasVisitadas[i];
+        s->visitadas[sala >> 6] &= ~(1ull << (sala & 63));
+    }
+    s->numVisitadas = 0;
+}
+
+/* precedeNoRanking()
+   1 se o suspeito a vem antes de b: mais pontos ou, no empate, menor id. */
+static inline int precedeNoRanking(const uint64_t *pontuacao, uint32_t a, uint32_t b) {
+    return pontuacao[a] > pontuacao[b] || (pontuacao[a] == pontuacao[b] && a < b);
+}
+
+/* subirNoRanking()
+   Sobe no heap o suspeito cuja pontuação acabou de crescer. */
+static void subirNoRanking(Sessao *s, uint32_t suspeito) {
+    uint32_t i = s->posicaoRanking[suspeito];
+    while (i > 0) {
+        uint32_t pai = (i - 1) / 2;
+        uint32_t outro = s->ranking[pai];
+        if (!precedeNoRanking(s->pontuacao, suspeito, outro)) break;
+        s->ranking[i] = outro;
+        s->posicaoRanking[outro] = i;
+        i = pai;
+    }
+    s->ranking[i] = suspeito;
+    s->posicaoRanking[suspeito] = i;
+}
+
+/* somarEvidencia()
+   Soma a pista recém-coletada às evidências do seu suspeito principal e
+   às pontuações de todos os suspeitos da sua lista, subindo cada um no
+   ranking. Retorna a nova contagem do suspeito principal (0 se a pista
+   não tem suspeito). Não mexe no suspeito mais provável. */
+uint32_t somarEvidencia(Sessao *s, uint32_t idPista) {
+    if (s->evidencias == NULL) return 0;
+    uint32_t n = numPostagensPista(s->tabela, idPista);
+    if (n > 0) {
+        const PostagemSuspeito *lista = postagensDaPista(s->tabela, idPista);
+        for (uint32_t k = 0; k < n; ++k) {
+            s->pontuacao[lista[k].suspeito] += lista[k].peso;
+            subirNoRanking(s, lista[k].suspeito);
+        }
+    }
+    uint32_t id = suspeitoDaPista(s->tabela, idPista);
+    return id != INTERNADOR_AUSENTE ? ++s->evidencias[id] : 0;
+}
+
+/* registrarEvidencia()
+   Soma uma evidência contra o suspeito da pista recém-coletada e atualiza
+   o suspeito mais provável. Como as contagens só crescem, basta comparar
+   com o máximo atual: O(1) por pista, mais O(log k) por suspeito da lista
+   da pista no ranking. */
+static void registrarEvidencia(Sessao *s, uint32_t idPista) {
+    uint32_t n = somarEvidencia(s, idPista);
+    if (n == 0) return;
+    uint32_t id = suspeitoDaPista(s->tabela, idPista);
+    if (n > s->maxEvidencias) {
+        s->maxEvidencias = n;
+        s->suspeitoMaisProvavel = id;
+    }
+}
+
+/* marcarVisitada()
+   Marca a sala como visitada. Retorna 0 se ela já estava marcada. */
+static int marcarVisitada(Sessao *s, const Mansao *m, uint32_t sala) {
+    if (s->visitadas == NULL) {
+        s->visitadas = (uint64_t*) calloc(((size_t) m->numSalas + 63) / 64, sizeof(uint64_t));
+        if (s->visitadas == NULL) {
+            printf("Erro ao alocar memoria para a sessao.\n");
+            exit(1);
+        }
+    }
+    uint64_t bit = 1ull << (sala & 63);
+    if (s->visitadas[sala >> 6] & bit) return 0;
+    s->visitadas[sala >> 6] |= bit;
+    if (s->numVisitadas == s->capVisitadas) {
+        s->capVisitadas = s->capVisitadas ? s->capVisitadas * 2 : 64;
+        s->salasVisitadas = (uint32_t*) realocarOuSair(s->salasVisitadas, (size_t) s->capVisitadas * sizeof(uint32_t),
+                                                       "a sessao");
+    }
+    s->salasVisitadas[s->numVisitadas++] = sala;
+    return 1;
+}
+
+/* coletarPistaDaSala()
+   Coleta a pista da sala atual, se houver. Retorna o texto da pista
+   (mesmo que já tivesse sido coletada antes) ou NULL.
+   O pool de pistas da mansão precisa estar ordenado (finalizarMapa()). */
+const char* coletarPistaDaSala(Sessao *s, const Mansao *m) {
+    uint32_t pista = m->salas[s->salaAtual].pista;
+    if (pista == SEM_PISTA) return NULL;
+    // sem passagens não há como voltar a uma sala; com elas, a volta não reinsere a pista
+    if (m->numPassagens > 0 && !marcarVisitada(s, m, s->salaAtual)) return textoPista(m, pista);
+    if (inserirNoConjunto(&s->pistas, m->pistas.ordem[pista])) {
+        s->numPistas++;
+        registrarEvidencia(s, pista);
+    }
+    return textoPista(m, pista);
+}
+
+/* moverSessao()
+   Aplica uma escolha do jogador: 'e' (esquerda), 'd' (direita), '1'..'9'
+   (passagem) ou 's' (sair). */
+ResultadoMovimento moverSessao(Sessao *s, const Mansao *m, char escolha) {
+    const Sala *sala = &m->salas[s->salaAtual];
+    if (escolha >= '1' && escolha < '1' + PASSAGENS_POR_DIGITO) {
+        return moverPorPassagem(s, m, (uint32_t) (escolha - '1'));
+    } else if (escolha == 'e' && sala->esquerda != SEM_SALA) {
+        s->salaAtual = sala->esquerda;
+    } else if (escolha == 'd' && sala->direita != SEM_SALA) {
+        s->salaAtual = sala->direita;
+    } else if (escolha == 's') {
+        return MOVIMENTO_SAIR;
+    } else {
+        s->invalidos++;
+        EST_CONTAR(EST_MOVIMENTOS_INVALIDOS, 1);
+        return MOVIMENTO_INVALIDO;
+    }
+    s->movimentos++;
+    EST_CONTAR(EST_MOVIMENTOS, 1);
+    return MOVIMENTO_OK;
+}
+
+/* moverPorPassagem()
+   Segue a passagem de número informado (a partir de 0) da sala atual. */
+ResultadoMovimento moverPorPassagem(Sessao *s, const Mansao *m, uint32_t passagem) {
+    uint32_t destino = passagemSala(m, s->salaAtual, passagem);
+    if (destino == SEM_SALA) {
+        s->invalidos++;
+        EST_CONTAR(EST_MOVIMENTOS_INVALIDOS, 1);
+        return MOVIMENTO_INVALIDO;
+    }
+    s->salaAtual = destino;
+    s->movimentos++;
+    EST_CONTAR(EST_MOVIMENTOS, 1);
+    return MOVIMENTO_OK;
+}
+
+/* evidenciasContra()
+   Quantas pistas coletadas apontam para o suspeito, lidas do contador
+   mantido pela sessão. */
+int evidenciasContra(const Sessao *s, const char *suspeito) {
+    if (s->evidencias == NULL) return 0;
+    uint32_t id = buscarSuspeito(s->tabela, suspeito);
+    return id != INTERNADOR_AUSENTE ? (int) s->evidencias[id] : 0;
+}
+
+/* pontuacaoContra()
+   Soma dos pesos das pistas coletadas que implicam o suspeito. */
+uint64_t pontuacaoContra(const Sessao *s, const char *suspeito) {
+    if (s->pontuacao == NULL) return 0;
+    uint32_t id = buscarSuspeito(s->tabela, suspeito);
+    return id != INTERNADOR_AUSENTE ? s->pontuacao[id] : 0;
+}
+
+/* percorrerRanking()
+   Visita, do primeiro para baixo, os até n suspeitos com pontuação acima
+   de zero. Uma busca pelo melhor primeiro no heap (um heap auxiliar de
+   posições candidatas, começando pela raiz) custa O(n log n), sem olhar
+   os demais suspeitos. Retorna quantos foram visitados. */
+uint32_t percorrerRanking(const Sessao *s, uint32_t n, void (*visitar)(uint32_t suspeito, uint64_t pontos, void *contexto),
+                          void *contexto) {
+    if (s->ranking == NULL || n == 0) return 0;
+    uint32_t k = numSuspeitos(s->tabela);
+    if (n > k) n = k;
+    uint32_t locais[RANKING_CANDIDATOS_LOCAIS + 1];
+    uint32_t *candidatos = locais;
+    if (n + 1 > RANKING_CANDIDATOS_LOCAIS + 1)
+        candidatos = (uint32_t*) realocarOuSair(NULL, ((size_t) n + 1) * sizeof(uint32_t), "o ranking");
+
+    const uint64_t *pontos = s->pontuacao;
+    const uint32_t *heap = s->ranking;
+    uint32_t numCandidatos = 1, visitados = 0;
+    candidatos[0] = 0;
+    while (numCandidatos > 0 && visitados < n) {
+        uint32_t pos = candidatos[0];
+        uint32_t suspeito = heap[pos];
+        if (pontos[suspeito] == 0) break;
+        visitar(suspeito, pontos[suspeito], contexto);
+        visitados++;
+
+        // troca o candidato visitado pelo último e desce, depois sobe os filhos
+        candidatos[0] = candidatos[--numCandidatos];
+        for (uint32_t i = 0;;) {
+            uint32_t maior = i, e = 2 * i + 1, d = e + 1;
+            if (e < numCandidatos && precedeNoRanking(pontos, heap[candidatos[e]], heap[candidatos[maior]])) maior = e;
+            if (d < numCandidatos && precedeNoRanking(pontos, heap[candidatos[d]], heap[candidatos[maior]])) maior = d;
+            if (maior == i) break;
+            uint32_t t = candidatos[i];
+            candidatos[i] = candidatos[maior];
+            candidatos[maior] = t;
+            i = maior;
+        }
+        for (uint32_t filho = 2 * pos + 1; filho <= 2 * pos + 2 && filho < k; ++filho) {
+            uint32_t i = numCandidatos++;
+            while (i > 0 && precedeNoRanking(pontos, heap[filho], heap[candidatos[(i - 1) / 2]])) {
+                candidatos[i] = candidatos[(i - 1) / 2];
+                i = (i - 1) / 2;
+            }
+            candidatos[i] = filho;
+        }
+    }
+    if (candidatos != locais) free(candidatos);
+    return visitados;
+}
+
+/* contarPistaDoSuspeito()
+   Visitante: soma 1 se a pista aponta para o suspeito procurado. */
+static void contarPistaDoSuspeito(uint32_t idPista, void *contexto) {
+    ContagemSuspeito *c = (ContagemSuspeito*) contexto;
+    if (suspeitoDaPista(c->tabela, idPista) == c->suspeito) c->contador++;
+}
+
+/* contarNoConjunto()
+   Conta quantas pistas do conjunto apontam para o suspeito indicado. Com o
+   conjunto de bits é um popcount contra a máscara do suspeito; com a árvore,
+   um percurso consultando a tabela (pista -> suspeito). */
+static int contarNoConjunto(const ConjuntoPistas *pistas, const TabelaHash *tabela, const char *suspeito) {
+    ContagemSuspeito c = { tabela, buscarSuspeito(tabela, suspeito), 0 };
+    if (c.suspeito == INTERNADOR_AUSENTE) return 0;
+    const uint64_t *mascara = mascaraSuspeito(tabela, c.suspeito);
+    if (pistas->tipo == CONJUNTO_BITS && mascara != NULL) return contarNaMascara(pistas, mascara);
+    percorrerConjunto(pistas, tabela->pistas, contarPistaDoSuspeito, &c);
+    return c.contador;
+}
+
+/* contarPistasParaSuspeito()
+   contarNoConjunto() medida pelas estatísticas. Dá o mesmo resultado que
+   evidenciasContra(), que lê os contadores da sessão. */
+int contarPistasParaSuspeito(const ConjuntoPistas *pistas, const TabelaHash *tabela, const char *suspeito) {
+    EST_MARCAR_TEMPO(inicio);
+    int n = contarNoConjunto(pistas, tabela, suspeito);
+    EST_CONTAR(EST_CONTAGENS_SUSPEITO, 1);
+    EST_REGISTRAR_TEMPO(EST_NS_CONTAR_PISTAS, inicio);
+    return n;
+}
+
+/* encerrarSessao()
+   Libera as pistas coletadas pela sessão e a sua arena. */
+void encerrarSessao(Sessao *s) {
+    contarFimDeSessao(s);
+    encerrarConjunto(&s->pistas);
+    liberarArena(&s->arena);
+    free(s->evidencias);
+    free(s->pontuacao);
+    free(s->ranking);
+    free(s->visitadas);
+    free(s->salasVisitadas);
+    s->evidencias = NULL;
+    s->pontuacao = NULL;
+    s->ranking = s->posicaoRanking = NULL;
+    s->visitadas = NULL;
+    s->salasVisitadas = NULL;
+    s->numVisitadas = s->capVisitadas = 0;
+}
@@ -0,0 +1,82 @@
+#ifndef SESSAO_H
+#define SESSAO_H
+
+#include <stdint.h>
+#include <string.h>
+
+#include "arvore_pistas.h"
+#include "conjunto_pistas.h"
+#include "mansao.h"
+#include "tabela_hash.h"
+
+/* ===================== SESSÃO DE JOGO ===================== */
+
+/* Número mínimo de pistas contra o suspeito para a acusação ser válida. */
+#define ACUSACAO_MINIMA 2
+
+/* Até quantos suspeitos percorrerRanking() visita sem alocar memória. */
+#define RANKING_CANDIDATOS_LOCAIS 64
+
+/* Estado de um jogador: sala atual e pistas coletadas até agora.
+   Não faz nenhuma entrada ou saída; a interface (interativa ou em lote)
+   decide o que mostrar. Pistas e suspeitos são tratados pelos seus ids,
+   sem copiar nem comparar textos.
+   Com uma tabela de suspeitos, a sessão mantém quantas pistas coletadas
+   apontam para cada suspeito (evidencias[id]), atualizadas a cada pista
+   nova, e o suspeito com mais evidências até agora.
+   Mantém também a pontuação de cada suspeito, a soma dos pesos das pistas
+   coletadas que o implicam (tabela_hash.h), e um ranking dos suspeitos
+   por pontuação: um heap de máximo indexado (ranking[0] é o primeiro e
+   posicaoRanking[id] diz onde cada suspeito está). Como as pontuações só
+   crescem, cada suspeito de uma pista nova apenas sobe no heap, em
+   O(log k) para k suspeitos, sem reordenar os demais. Empates ficam com o
+   menor id.
+   Os nós da árvore de pistas vêm de uma arena: a da thread, se for
+   passada a iniciarSessao(), ou a da própria sessão. Por isso a sessão não
+   deve ser copiada para outro endereço depois de iniciada.
+   Em mansões com passagens uma sala pode ser visitada de novo; um bitmap
+   das salas com pista já visitadas evita consultar o conjunto de pistas a
+   cada volta. As salas marcadas também ficam numa lista, para que
+   reiniciarSessao() limpe só os bits ligados. */
+typedef struct Sessao {
+    uint32_t salaAtual;
+    ConjuntoPistas pistas;
+    uint32_t numPistas;
+    uint32_t movimentos;
+    uint32_t invalidos;
+    const TabelaHash *tabela;   // NULL: sem suspeitos (nível Aventureiro)
+    uint32_t *evidencias;
+    uint32_t suspeitoMaisProvavel;
+    uint32_t maxEvidencias;
+    uint64_t *pontuacao;        // pontuacao[id]: soma dos pesos
+    uint32_t *ranking;          // heap: posição -> suspeito
+    uint32_t *posicaoRanking;   // suspeito -> posição no heap
+    ArenaPistas arena;          // arena própria, usada sem arena externa
+    uint64_t *visitadas;        // 1 bit por sala; NULL até a primeira volta possível
+    uint32_t *salasVisitadas;
+    uint32_t numVisitadas;
+    uint32_t capVisitadas;
+} Sessao;
+
+/* Resultado de moverSessao(). */
+typedef enum {
+    MOVIMENTO_OK,
+    MOVIMENTO_INVALIDO,
+    MOVIMENTO_SAIR
+} ResultadoMovimento;
+
+void iniciarSessao(Sessao *s, uint32_t salaInicial, const TabelaHash *tabela,
+                   ArenaPistas *arena, TipoConjunto tipo);
+void reiniciarSessao(Sessao *s, uint32_t salaInicial);
+const char* coletarPistaDaSala(Sessao *s, const Mansao *m);
+ResultadoMovimento moverSessao(Sessao *s, const Mansao *m, char escolha);
+ResultadoMovimento moverPorPassagem(Sessao *s, const Mansao *m, uint32_t passagem);
+uint32_t somarEvidencia(Sessao *s, uint32_t idPista);
+int evidenciasContra(const Sessao *s, const char *suspeito);
+uint64_t pontuacaoContra(const Sessao *s, const char *suspeito);
+uint32_t percorrerRanking(const Sessao *s, uint32_t n, void (*visitar)(uint32_t suspeito, uint64_t pontos, void *contexto),
+                          void *contexto);
+int contarPistasParaSuspeito(const ConjuntoPistas *pistas, const TabelaHash *tabela, const char *suspeito);
+void encerrarSessao(Sessao *s);
+
+#endif
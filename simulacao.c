@@ -0,0 +1,161 @@
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "simulacao.h"
+
+/* Resumos já formatados de um bloco de partidas. */
+typedef struct BlocoSaida {
+    char *texto;
+    size_t tam;
+} BlocoSaida;
+
+/* Estado compartilhado entre as threads. */
+typedef struct Simulacao {
+    const MapaCarregado *mapa;
+    char **partidas;
+    size_t numPartidas;
+    BlocoSaida *blocos;
+    size_t numBlocos;
+    atomic_size_t proximoBloco;
+} Simulacao;
+
+/* Estado de cada thread. */
+typedef struct TrabalhadorSimulacao {
+    Simulacao *sim;
+    pthread_t thread;
+    ResumoLote resumo;
+} TrabalhadorSimulacao;
+
+/* lerPartidas()
+   Lê toda a entrada para um único buffer e separa as linhas de partidas
+   (sem comentários nem linhas vazias). Retorna o número de partidas. */
+static size_t lerPartidas(FILE *entrada, char **buffer, char ***partidas) {
+    size_t tam = 0, cap = 1 << 20;
+    char *dados = (char*) realocarOuSair(NULL, cap, "as partidas");
+    size_t lidos;
+    while ((lidos = fread(dados + tam, 1, cap - tam - 1, entrada)) > 0) {
+        tam += lidos;
+        if (cap - tam - 1 == 0) {
+            cap *= 2;
+            dados = (char*) realocarOuSair(dados, cap, "as partidas");
+        }
+    }
+    dados[tam] = '\0';
+
+    size_t num = 0, capPartidas = 1024;
+    char **lista = (char**) realocarOuSair(NULL, capPartidas * sizeof(char*), "as partidas");
+    char *linha = dados;
+    while (linha < dados + tam) {
+        char *fim = strchr(linha, '\n');
+        if (fim != NULL) *fim = '\0';
+        linha[strcspn(linha, "\r")] = '\0';
+        if (partidaValida(linha)) {
+            if (num == capPartidas) {
+                capPartidas *= 2;
+                lista = (char**) realocarOuSair(lista, capPartidas * sizeof(char*), "as partidas");
+            }
+            lista[num++] = linha;
+        }
+        if (fim == NULL) break;
+        linha = fim + 1;
+    }
+    *buffer = dados;
+    *partidas = lista;
+    return num;
+}
+
+/* trabalharSimulacao()
+   Laço de cada thread: pega blocos até acabarem. */
+static void* trabalharSimulacao(void *arg) {
+    TrabalhadorSimulacao *t = (TrabalhadorSimulacao*) arg;
+    Simulacao *sim = t->sim;
+    Sessao sessao;
+    iniciarSessao(&sessao, SALA_ENTRADA, &sim->mapa->tabela, NULL, sim->mapa->conjunto);
+
+    while (1) {
+        size_t bloco = atomic_fetch_add_explicit(&sim->proximoBloco, 1, memory_order_relaxed);
+        if (bloco >= sim->numBlocos) break;
+        size_t inicio = bloco * SIMULACAO_TAM_BLOCO;
+        size_t fim = inicio + SIMULACAO_TAM_BLOCO;
+        if (fim > sim->numPartidas) fim = sim->numPartidas;
+
+        BlocoSaida *saidaBloco = &sim->blocos[bloco];
+        FILE *saida = open_memstream(&saidaBloco->texto, &saidaBloco->tam);
+        if (saida == NULL) {
+            printf("Erro ao alocar memoria para a saida da simulacao.\n");
+            exit(1);
+        }
+        for (size_t i = inicio; i < fim; ++i) {
+            const char *acusado;
+            size_t tam = separarPartida(sim->partidas[i], &acusado);
+            ResultadoPartida r = jogarPartida(&sessao, sim->mapa, i + 1, sim->partidas[i], tam, acusado);
+            escreverResultado(saida, i + 1, sim->mapa, &r, acusado);
+            t->resumo.sessoes++;
+            t->resumo.movimentos += r.movimentos;
+            if (r.acusacaoValida) t->resumo.acusacoesValidas++;
+        }
+        fclose(saida);
+    }
+
+    t->resumo.nos = contadoresPool(&sessao.arena);
+    encerrarSessao(&sessao);
+    return NULL;
+}
+
+/* executarLoteParalelo()
+   Como executarLote(), mas distribui as partidas entre numThreads threads. */
+ResumoLote executarLoteParalelo(FILE *entrada, FILE *saida, const MapaCarregado *mapa, int numThreads) {
+    ResumoLote resumo;
+    memset(&resumo, 0, sizeof(resumo));
+    if (numThreads < 1) numThreads = 1;
+    if (numThreads > SIMULACAO_MAX_THREADS) numThreads = SIMULACAO_MAX_THREADS;
+
+    Simulacao sim;
+    char *buffer;
+    sim.mapa = mapa;
+    sim.numPartidas = lerPartidas(entrada, &buffer, &sim.partidas);
+    sim.numBlocos = (sim.numPartidas + SIMULACAO_TAM_BLOCO - 1) / SIMULACAO_TAM_BLOCO;
+    sim.blocos = (BlocoSaida*) calloc(sim.numBlocos ? sim.numBlocos : 1, sizeof(BlocoSaida));
+    if (sim.blocos == NULL) {
+        printf("Erro ao alocar memoria para a saida da simulacao.\n");
+        exit(1);
+    }
+    atomic_init(&sim.proximoBloco, 0);
+
+    TrabalhadorSimulacao trabalhadores[SIMULACAO_MAX_THREADS];
+    int iniciadas = 0;
+    for (int i = 0; i < numThreads; ++i) {
+        trabalhadores[i].sim = &sim;
+        memset(&trabalhadores[i].resumo, 0, sizeof(ResumoLote));
+        if (pthread_create(&trabalhadores[i].thread, NULL, trabalharSimulacao, &trabalhadores[i]) != 0) break;
+        iniciadas++;
+    }
+    // sem nenhuma thread extra, a própria thread principal faz o trabalho
+    if (iniciadas == 0) {
+        trabalharSimulacao(&trabalhadores[0]);
+    }
+    for (int i = 0; i < iniciadas; ++i) pthread_join(trabalhadores[i].thread, NULL);
+    for (int i = 0; i < (iniciadas ? iniciadas : 1); ++i) {
+        resumo.sessoes += trabalhadores[i].resumo.sessoes;
+        resumo.movimentos += trabalhadores[i].resumo.movimentos;
+        resumo.acusacoesValidas += trabalhadores[i].resumo.acusacoesValidas;
+        somarContadoresPool(&resumo.nos, &trabalhadores[i].resumo.nos);
+    }
+
+    setvbuf(saida, NULL, _IOFBF, LOTE_TAM_BUFFER_SAIDA);
+    escreverCabecalhoLote(saida);
+    for (size_t b = 0; b < sim.numBlocos; ++b) {
+        fwrite(sim.blocos[b].texto, 1, sim.blocos[b].tam, saida);
+        free(sim.blocos[b].texto);
+    }
+    fflush(saida);
+
+    free(sim.blocos);
+    free(sim.partidas);
+    free(buffer);
+    return resumo;
+}
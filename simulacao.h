@@ -0,0 +1,29 @@
+#ifndef SIMULACAO_H
+#define SIMULACAO_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "carregador.h"
+#include "modo_lote.h"
+
+/* ===================== SIMULAÇÃO PARALELA ===================== */
+
+/* Várias partidas em lote jogadas ao mesmo tempo por um grupo de threads.
+   A mansão e a tabela de suspeitos são só lidas depois de carregadas, então
+   todas as threads as compartilham sem trava. Cada thread tem uma sessão,
+   com a sua arena de pistas, reiniciada a cada partida.
+
+   As partidas são divididas em blocos; as threads pegam o próximo bloco com
+   um contador atômico e escrevem os resumos num buffer próprio do bloco.
+   No fim os buffers são gravados na ordem da entrada, então a saída é
+   idêntica à de executarLote(). */
+
+#define SIMULACAO_TAM_BLOCO 512
+#define SIMULACAO_MAX_THREADS 256
+
+ResumoLote executarLoteParalelo(FILE *entrada, FILE *saida, const MapaCarregado *mapa, int numThreads);
+
+#endif
@@ -0,0 +1,283 @@
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "tabela_hash.h"
+
+/* inicializarTabelaHash()
+   Inicializa uma tabela vazia já alocada pelo chamador, usando o pool de
+   pistas informado (normalmente o da mansão). */
+void inicializarTabelaHash(TabelaHash *tabela, Internador *pistas) {
+    tabela->pistas = pistas;
+    tabela->suspeitoPorPista = NULL;
+    tabela->capacidade = 0;
+    tabela->quantidade = 0;
+    inicializarInternador(&tabela->suspeitos);
+    tabela->mascaras = NULL;
+    tabela->palavrasMascara = 0;
+    tabela->inicioPostagens = NULL;
+    tabela->postagens = NULL;
+    tabela->numPostagens = 0;
+    tabela->ponderada = 0;
+    tabela->pesos = NULL;
+    tabela->numPesos = 0;
+    tabela->capPesos = 0;
+}
+
+/* inicializarHash()
+   Aloca e inicializa uma tabela hash vazia. */
+TabelaHash* inicializarHash(Internador *pistas) {
+    TabelaHash *tabela = (TabelaHash*) malloc(sizeof(TabelaHash));
+    if (tabela == NULL) {
+        printf("Erro ao alocar memoria para a tabela hash.\n");
+        exit(1);
+    }
+    inicializarTabelaHash(tabela, pistas);
+    return tabela;
+}
+
+/* redimensionarHash()
+   Aumenta o vetor até caber o id de pista informado; as posições novas
+   ficam sem suspeito. */
+static void redimensionarHash(TabelaHash *tabela, uint32_t idPista) {
+    uint32_t novaCap = tabela->capacidade ? tabela->capacidade : HASH_CAPACIDADE_INICIAL;
+    while (novaCap <= idPista) novaCap *= 2;
+    tabela->suspeitoPorPista = (uint32_t*) realocarOuSair(tabela->suspeitoPorPista,
+                                                          novaCap * sizeof(uint32_t), "a tabela hash");
+    for (uint32_t i = tabela->capacidade; i < novaCap; ++i)
+        tabela->suspeitoPorPista[i] = INTERNADOR_AUSENTE;
+    tabela->capacidade = novaCap;
+}
+
+/* inserirNaHash()
+   Insere a associação (pista -> suspeito) na tabela hash, internando os dois
+   textos. Se a pista já existir, o suspeito é substituído pelo novo. */
+void inserirNaHash(TabelaHash *tabela, const char *pista, const char *suspeito) {
+    if (pista == NULL || pista[0] == '\0' || suspeito == NULL) return;
+    uint32_t idPista = internarString(tabela->pistas, pista);
+    if (idPista >= tabela->capacidade) redimensionarHash(tabela, idPista);
+    if (tabela->suspeitoPorPista[idPista] == INTERNADOR_AUSENTE) tabela->quantidade++;
+    tabela->suspeitoPorPista[idPista] = internarString(&tabela->suspeitos, suspeito);
+}
+
+/* inserirPesoNaHash()
+   Acrescenta o suspeito, com o peso informado (1 .. HASH_PESO_MAXIMO), à
+   lista da pista. Se a pista ainda não tinha suspeito, ele passa a ser o
+   principal. A lista só passa a valer no próximo montarPostagens(). */
+void inserirPesoNaHash(TabelaHash *tabela, const char *pista, const char *suspeito, uint32_t peso) {
+    if (pista == NULL || pista[0] == '\0' || suspeito == NULL || peso == 0 || peso > HASH_PESO_MAXIMO) return;
+    uint32_t idPista = internarString(tabela->pistas, pista);
+    if (idPista >= tabela->capacidade) redimensionarHash(tabela, idPista);
+    uint32_t idSuspeito = internarString(&tabela->suspeitos, suspeito);
+    if (tabela->suspeitoPorPista[idPista] == INTERNADOR_AUSENTE) {
+        tabela->suspeitoPorPista[idPista] = idSuspeito;
+        tabela->quantidade++;
+    }
+    if (tabela->numPesos == tabela->capPesos) {
+        tabela->capPesos = tabela->capPesos ? tabela->capPesos * 2 : 16;
+        tabela->pesos = (uint32_t*) realocarOuSair(tabela->pesos, (size_t) tabela->capPesos * 3 * sizeof(uint32_t),
+                                                   "a tabela hash");
+    }
+    uint32_t *trio = tabela->pesos + 3 * (size_t) tabela->numPesos++;
+    trio[0] = idPista;
+    trio[1] = idSuspeito;
+    trio[2] = peso;
+}
+
+/* montarPostagens()
+   Monta o CSR das listas (suspeito, peso) em O(pistas + pesos), como
+   montarGrafo(): conta, acumula os inícios e preenche. Pistas com pesos
+   inseridos ficam com essas listas, na ordem de inserção; as demais, com o
+   suspeito principal e peso 1. Se o principal veio de inserirNaHash() e
+   não está entre os pesos da pista, ele abre a lista com peso 1, então a
+   lista sempre começa pelo principal ou o contém. Um suspeito repetido na
+   mesma pista vira uma só postagem, na posição da primeira, com a soma
+   dos pesos (limitada a HASH_PESO_MAXIMO). Os pesos inseridos
+   continuam guardados, então o CSR pode ser refeito depois de novas
+   inserções. */
+void montarPostagens(TabelaHash *tabela) {
+    uint32_t n = tabela->pistas->quantidade;
+    free(tabela->inicioPostagens);
+    free(tabela->postagens);
+
+    // inicio[p + 1] conta as postagens de p e depois vira o cursor de preenchimento
+    uint32_t *inicio = (uint32_t*) calloc((size_t) n + 1, sizeof(uint32_t));
+    uint8_t *principalNosPesos = (uint8_t*) calloc((size_t) n + 1, sizeof(uint8_t));
+    if (inicio == NULL || principalNosPesos == NULL) {
+        printf("Erro ao alocar memoria para a tabela hash.\n");
+        exit(1);
+    }
+    for (uint32_t i = 0; i < tabela->numPesos; ++i) {
+        const uint32_t *trio = tabela->pesos + 3 * (size_t) i;
+        inicio[trio[0] + 1]++;
+        if (trio[1] == suspeitoDaPista(tabela, trio[0])) principalNosPesos[trio[0]] = 1;
+    }
+    for (uint32_t p = 0; p < n; ++p)
+        if (!principalNosPesos[p] && suspeitoDaPista(tabela, p) != INTERNADOR_AUSENTE) inicio[p + 1]++;
+    uint64_t soma = 0;
+    for (uint32_t p = 0; p < n; ++p) {
+        uint32_t c = inicio[p + 1];
+        inicio[p + 1] = (uint32_t) soma;
+        soma += c;
+    }
+    if (soma >= UINT32_MAX) {
+        printf("Erro: o catalogo tem postagens demais.\n");
+        exit(1);
+    }
+
+    PostagemSuspeito *postagens = (PostagemSuspeito*) realocarOuSair(NULL, (soma ? soma : 1) * sizeof(PostagemSuspeito),
+                                                                    "a tabela hash");
+    for (uint32_t p = 0; p < n; ++p) {
+        uint32_t principal = suspeitoDaPista(tabela, p);
+        if (!principalNosPesos[p] && principal != INTERNADOR_AUSENTE)
+            postagens[inicio[p + 1]++] = (PostagemSuspeito) { principal, 1 };
+    }
+    for (uint32_t i = 0; i < tabela->numPesos; ++i) {
+        const uint32_t *trio = tabela->pesos + 3 * (size_t) i;
+        postagens[inicio[trio[0] + 1]++] = (PostagemSuspeito) { trio[1], trio[2] };
+    }
+    free(principalNosPesos);
+
+    // agora inicio[p] é o começo da lista de p; junta os suspeitos repetidos
+    uint32_t *posicao = (uint32_t*) calloc((size_t) tabela->suspeitos.quantidade + 1, sizeof(uint32_t));
+    if (posicao == NULL) {
+        printf("Erro ao alocar memoria para a tabela hash.\n");
+        exit(1);
+    }
+    uint32_t escrita = 0, ponderada = 0;
+    for (uint32_t p = 0; p < n; ++p) {
+        uint32_t comeco = escrita;
+        for (uint32_t k = inicio[p]; k < inicio[p + 1]; ++k) {
+            PostagemSuspeito atual = postagens[k];
+            if (posicao[atual.suspeito] > comeco) {
+                PostagemSuspeito *anterior = &postagens[posicao[atual.suspeito] - 1];
+                anterior->peso = HASH_PESO_MAXIMO - anterior->peso < atual.peso ? HASH_PESO_MAXIMO
+                                                                                : anterior->peso + atual.peso;
+            } else {
+                postagens[escrita++] = atual;
+                posicao[atual.suspeito] = escrita;
+            }
+        }
+        inicio[p] = comeco;
+        for (uint32_t k = comeco; k < escrita; ++k)
+            ponderada |= postagens[k].peso != 1 || postagens[k].suspeito != suspeitoDaPista(tabela, p);
+    }
+    inicio[n] = escrita;
+    free(posicao);
+
+    tabela->inicioPostagens = inicio;
+    tabela->postagens = postagens;
+    tabela->numPostagens = escrita;
+    tabela->ponderada = ponderada;
+}
+
+/* encontrarIdSuspeito()
+   Busca pelo texto da pista o id do suspeito associado.
+   Retorna INTERNADOR_AUSENTE se a pista não estiver na tabela. */
+uint32_t encontrarIdSuspeito(const TabelaHash *tabela, const char *pista) {
+    if (pista == NULL || pista[0] == '\0') return INTERNADOR_AUSENTE;
+    uint32_t idPista = buscarString(tabela->pistas, pista);
+    return idPista != INTERNADOR_AUSENTE ? suspeitoDaPista(tabela, idPista) : INTERNADOR_AUSENTE;
+}
+
+/* encontrarSuspeito()
+   Busca na tabela hash o suspeito associado à pista dada.
+   Retorna ponteiro para o nome do suspeito (string interna) ou NULL se não encontrada.
+   O ponteiro deixa de ser válido se novas associações forem inseridas depois. */
+const char* encontrarSuspeito(const TabelaHash *tabela, const char *pista) {
+    uint32_t id = encontrarIdSuspeito(tabela, pista);
+    return id != INTERNADOR_AUSENTE ? textoInternado(&tabela->suspeitos, id) : NULL;
+}
+
+/* prepararMascaras()
+   Monta a máscara de pistas de cada suspeito, indexada pela posição
+   alfabética da pista. Exige o pool de pistas ordenado e deve ser refeita
+   se novas associações forem inseridas. Catálogos maiores que
+   CONJUNTO_BITS_MAX_PISTAS ficam sem máscaras. */
+void prepararMascaras(TabelaHash *tabela) {
+    const Internador *pistas = tabela->pistas;
+    free(tabela->mascaras);
+    tabela->mascaras = NULL;
+    tabela->palavrasMascara = 0;
+    if (pistas->numOrdenados != pistas->quantidade || pistas->quantidade > CONJUNTO_BITS_MAX_PISTAS ||
+        numSuspeitos(tabela) == 0)
+        return;
+
+    uint32_t palavras = palavrasConjunto(pistas->quantidade);
+    tabela->mascaras = (uint64_t*) calloc((size_t) numSuspeitos(tabela) * palavras, sizeof(uint64_t));
+    if (tabela->mascaras == NULL) {
+        printf("Erro ao alocar memoria para as mascaras de suspeitos.\n");
+        exit(1);
+    }
+    tabela->palavrasMascara = palavras;
+    for (uint32_t idPista = 0; idPista < pistas->quantidade; ++idPista) {
+        uint32_t suspeito = suspeitoDaPista(tabela, idPista);
+        if (suspeito == INTERNADOR_AUSENTE) continue;
+        uint32_t ordem = pistas->ordem[idPista];
+        tabela->mascaras[(size_t) suspeito * palavras + (ordem >> 6)] |= 1ull << (ordem & 63);
+    }
+}
+
+/* renumerarTabelaHash()
+   Reescreve a tabela com os ids novos de pistas e suspeitos
+   (novaPista[idAntigo], novoSuspeito[idAntigo]), depois que os pools foram
+   renumerados por congelarInternador(). As máscaras e as listas de
+   suspeitos são descartadas: prepararMascaras() e montarPostagens() as
+   refazem. */
+void renumerarTabelaHash(TabelaHash *tabela, const uint32_t *novaPista, const uint32_t *novoSuspeito) {
+    uint32_t n = tabela->pistas->quantidade;
+    uint32_t cap = tabela->capacidade > n ? tabela->capacidade : n;
+    uint32_t *porPista = (uint32_t*) realocarOuSair(NULL, (size_t) (cap ? cap : 1) * sizeof(uint32_t), "a tabela hash");
+    for (uint32_t p = 0; p < cap; ++p) porPista[p] = INTERNADOR_AUSENTE;
+    for (uint32_t p = 0; p < n; ++p) {
+        uint32_t suspeito = suspeitoDaPista(tabela, p);
+        if (suspeito != INTERNADOR_AUSENTE) porPista[novaPista[p]] = novoSuspeito[suspeito];
+    }
+    free(tabela->suspeitoPorPista);
+    tabela->suspeitoPorPista = porPista;
+    tabela->capacidade = cap;
+
+    for (uint32_t i = 0; i < tabela->numPesos; ++i) {
+        uint32_t *trio = tabela->pesos + 3 * (size_t) i;
+        trio[0] = novaPista[trio[0]];
+        trio[1] = novoSuspeito[trio[1]];
+    }
+
+    free(tabela->mascaras);
+    free(tabela->inicioPostagens);
+    free(tabela->postagens);
+    tabela->mascaras = NULL;
+    tabela->palavrasMascara = 0;
+    tabela->inicioPostagens = NULL;
+    tabela->postagens = NULL;
+    tabela->numPostagens = tabela->ponderada = 0;
+}
+
+/* liberarTabelaHash()
+   Libera o vetor e os suspeitos de uma tabela inicializada com
+   inicializarTabelaHash(). O pool de pistas não é liberado. */
+void liberarTabelaHash(TabelaHash *tabela) {
+    free(tabela->suspeitoPorPista);
+    liberarInternador(&tabela->suspeitos);
+    free(tabela->mascaras);
+    free(tabela->inicioPostagens);
+    free(tabela->postagens);
+    free(tabela->pesos);
+    tabela->mascaras = NULL;
+    tabela->palavrasMascara = 0;
+    tabela->suspeitoPorPista = NULL;
+    tabela->capacidade = tabela->quantidade = 0;
+    tabela->inicioPostagens = NULL;
+    tabela->postagens = NULL;
+    tabela->pesos = NULL;
+    tabela->numPostagens = tabela->ponderada = tabela->numPesos = tabela->capPesos = 0;
+}
+
+/* liberarHash()
+   Libera toda a memória usada pela tabela hash. */
+void liberarHash(TabelaHash *tabela) {
+    if (tabela == NULL) return;
+    liberarTabelaHash(tabela);
+    free(tabela);
+}
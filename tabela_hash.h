@@ -0,0 +1,124 @@
+#ifndef TABELA_HASH_H
+#define TABELA_HASH_H
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "conjunto_pistas.h"
+#include "internador.h"
+
+/* ===================== HASH (Pista -> Suspeito) ===================== */
+
+/* Capacidade inicial (em pistas) do vetor pista -> suspeito. */
+#define HASH_CAPACIDADE_INICIAL 32
+
+/* Tabela que associa uma pista a um suspeito.
+   As pistas são ids no pool de pistas (o mesmo da mansão), que já faz o
+   hash do texto; a tabela em si é só um vetor indexado pelo id da pista,
+   então no jogo a consulta é um acesso a array, sem hash nem strcmp.
+   As buscas pelo texto (encontrarSuspeito(), buscarSuspeito() e, por ela,
+   a acusação e contarPistasParaSuspeito()) usam o hash perfeito dos pools
+   quando o mapa foi finalizado (internador.h).
+   Cada suspeito distinto também recebe um id denso
+   (0 .. numSuspeitos - 1), usado pelos contadores de evidências.
+   Para catálogos pequenos, prepararMascaras() guarda ainda uma máscara de
+   bits por suspeito com as pistas que apontam para ele, no mesmo layout do
+   conjunto de bits (conjunto_pistas.h).
+
+   Uma pista pode também implicar vários suspeitos, cada um com um peso
+   (inserirPesoNaHash()). O primeiro suspeito inserido para a pista é o
+   principal: é ele que suspeitoDaPista() devolve e que contam as
+   acusações, as máscaras, o índice de alcance e o resolvedor. As listas
+   (suspeito, peso) de todas as pistas ficam num único vetor, em CSR como
+   o grafo da mansão: as da pista p em postagens[inicioPostagens[p] ..
+   inicioPostagens[p + 1]). montarPostagens() monta esse vetor; uma pista
+   sem pesos vira a lista do seu suspeito principal com peso 1, e um
+   principal inserido sem peso (inserirNaHash()) entra com peso 1 na
+   frente dos pesos que a pista receber depois. Cada suspeito aparece uma
+   só vez por pista: pesos repetidos são somados. Como as
+   máscaras, o CSR deve ser refeito se novas associações forem inseridas. */
+typedef struct PostagemSuspeito {
+    uint32_t suspeito;
+    uint32_t peso;
+} PostagemSuspeito;
+
+typedef struct TabelaHash {
+    Internador *pistas;          // pool de pistas (não pertence à tabela)
+    uint32_t *suspeitoPorPista;  // suspeitoPorPista[idPista] -> id do suspeito
+    uint32_t capacidade;
+    uint32_t quantidade;         // pistas com suspeito
+    Internador suspeitos;
+    uint64_t *mascaras;          // mascaras[suspeito * palavrasMascara + w]
+    uint32_t palavrasMascara;    // 0: sem máscaras
+    uint32_t *inicioPostagens;   // quantidade de pistas + 1; NULL antes de montarPostagens()
+    PostagemSuspeito *postagens;
+    uint32_t numPostagens;
+    uint32_t ponderada;          // alguma pista tem mais de um suspeito ou peso diferente de 1
+    uint32_t *pesos;             // trios (pista, suspeito, peso) inseridos
+    uint32_t numPesos;
+    uint32_t capPesos;
+} TabelaHash;
+
+/* Maior peso aceito para um suspeito numa pista. */
+#define HASH_PESO_MAXIMO 1000000
+
+void inicializarTabelaHash(TabelaHash *tabela, Internador *pistas);
+TabelaHash* inicializarHash(Internador *pistas);
+void inserirNaHash(TabelaHash *tabela, const char *pista, const char *suspeito);
+void inserirPesoNaHash(TabelaHash *tabela, const char *pista, const char *suspeito, uint32_t peso);
+void montarPostagens(TabelaHash *tabela);
+
+/* suspeitoDaPista()
+   Id do suspeito associado à pista de id informado, ou INTERNADOR_AUSENTE.
+   É a consulta usada durante o jogo. */
+static inline uint32_t suspeitoDaPista(const TabelaHash *tabela, uint32_t idPista) {
+    return idPista < tabela->capacidade ? tabela->suspeitoPorPista[idPista] : INTERNADOR_AUSENTE;
+}
+
+uint32_t encontrarIdSuspeito(const TabelaHash *tabela, const char *pista);
+const char* encontrarSuspeito(const TabelaHash *tabela, const char *pista);
+
+/* buscarSuspeito()
+   Retorna o id do suspeito pelo nome ou INTERNADOR_AUSENTE se nenhuma pista
+   aponta para ele. */
+static inline uint32_t buscarSuspeito(const TabelaHash *tabela, const char *nome) {
+    return buscarString(&tabela->suspeitos, nome);
+}
+
+/* numSuspeitos() / nomeSuspeito()
+   Quantidade de suspeitos distintos e nome de um suspeito pelo id. */
+static inline uint32_t numSuspeitos(const TabelaHash *tabela) {
+    return tabela->suspeitos.quantidade;
+}
+
+static inline const char* nomeSuspeito(const TabelaHash *tabela, uint32_t id) {
+    return textoInternado(&tabela->suspeitos, id);
+}
+
+/* numPostagensPista() / postagensDaPista()
+   Lista (suspeito, peso) da pista; vazia antes de montarPostagens(). */
+static inline uint32_t numPostagensPista(const TabelaHash *tabela, uint32_t idPista) {
+    if (tabela->inicioPostagens == NULL || idPista >= tabela->pistas->quantidade) return 0;
+    return tabela->inicioPostagens[idPista + 1] - tabela->inicioPostagens[idPista];
+}
+
+static inline const PostagemSuspeito* postagensDaPista(const TabelaHash *tabela, uint32_t idPista) {
+    return tabela->postagens + tabela->inicioPostagens[idPista];
+}
+
+void prepararMascaras(TabelaHash *tabela);
+void renumerarTabelaHash(TabelaHash *tabela, const uint32_t *novaPista, const uint32_t *novoSuspeito);
+
+/* mascaraSuspeito()
+   Máscara de pistas do suspeito, ou NULL se as máscaras não foram montadas. */
+static inline const uint64_t* mascaraSuspeito(const TabelaHash *tabela, uint32_t suspeito) {
+    if (tabela->palavrasMascara == 0) return NULL;
+    return tabela->mascaras + (size_t) suspeito * tabela->palavrasMascara;
+}
+
+void liberarTabelaHash(TabelaHash *tabela);
+void liberarHash(TabelaHash *tabela);
+
+#endif
@@ -0,0 +1,22 @@
+# Roda PROGRAMA com os argumentos de ARGS (separados por espaços), a entrada
+# padrão lida de ENTRADA, e compara a saída padrão com o arquivo ESPERADO.
+# Usado pelos testes de transcrição do CMakeLists.txt:
+#
+#   cmake -DPROGRAMA=... -DARGS="..." -DENTRADA=... -DESPERADO=... -DSAIDA=...
+#         -P comparar_saida.cmake
+
+separate_arguments(lista_args UNIX_COMMAND "${ARGS}")
+execute_process(
+    COMMAND ${PROGRAMA} ${lista_args}
+    INPUT_FILE ${ENTRADA}
+    OUTPUT_FILE ${SAIDA}
+    RESULT_VARIABLE resultado)
+if(resultado MATCHES "[A-Za-z]")
+    message(FATAL_ERROR "${PROGRAMA} nao terminou: ${resultado}")
+endif()
+execute_process(
+    COMMAND ${CMAKE_COMMAND} -E compare_files ${SAIDA} ${ESPERADO}
+    RESULT_VARIABLE diferente)
+if(diferente)
+    message(FATAL_ERROR "A saida de ${PROGRAMA} ${ARGS} (${SAIDA}) difere de ${ESPERADO}")
+endif()
@@ -0,0 +1,38 @@
+# Joga ENTRADA no modo lote de PROGRAMA gravando o registro de eventos e
+# reproduz o registro com REPRODUTOR. A reprodução tem de terminar sem
+# divergências e trazer as mesmas sessões do lote (colunas até
+# mais_provavel), em qualquer ordem, já que as threads terminam as sessões
+# fora de ordem.
+#
+#   cmake -DPROGRAMA=... -DREPRODUTOR=... -DMAPA=... -DENTRADA=... -DTHREADS=...
+#         -DSAIDA=<prefixo dos arquivos gerados> -P registro_ida_e_volta.cmake
+
+file(REMOVE ${SAIDA}.dqe)
+execute_process(
+    COMMAND ${PROGRAMA} ${MAPA} --lote - --threads ${THREADS} --registro ${SAIDA}.dqe
+    INPUT_FILE ${ENTRADA}
+    OUTPUT_FILE ${SAIDA}_lote.tsv
+    ERROR_QUIET
+    RESULT_VARIABLE resultado)
+if(NOT resultado EQUAL 0)
+    message(FATAL_ERROR "${PROGRAMA} --lote --registro falhou: ${resultado}")
+endif()
+execute_process(
+    COMMAND ${REPRODUTOR} ${MAPA} ${SAIDA}.dqe
+    OUTPUT_FILE ${SAIDA}_reproducao.tsv
+    ERROR_QUIET
+    RESULT_VARIABLE resultado)
+if(NOT resultado EQUAL 0)
+    message(FATAL_ERROR "${REPRODUTOR} encontrou divergencias ou eventos corrompidos: ${resultado}")
+endif()
+
+# as linhas do lote, sem a acusação e com 0 divergências
+file(STRINGS ${SAIDA}_lote.tsv lote REGEX "^[0-9]")
+file(STRINGS ${SAIDA}_reproducao.tsv reproducao REGEX "^[0-9]")
+list(TRANSFORM lote REPLACE "^([^\t]*\t[^\t]*\t[^\t]*\t[^\t]*\t[^\t]*\t[^\t]*).*$" "\\1\t0")
+list(SORT lote)
+list(SORT reproducao)
+list(LENGTH lote sessoes)
+if(sessoes EQUAL 0 OR NOT lote STREQUAL reproducao)
+    message(FATAL_ERROR "A reproducao de ${SAIDA}.dqe nao traz as ${sessoes} sessoes do lote")
+endif()
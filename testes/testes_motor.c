@@ -0,0 +1,1237 @@
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "arvore_pistas.h"
+#include "busca_pistas.h"
+#include "carregador.h"
+#include "conjunto_pistas.h"
+#include "detective.h"
+#include "gerador_mansao.h"
+#include "indice_mansao.h"
+#include "internador.h"
+#include "resolvedor.h"
+#include "sessao.h"
+
+/* Testes de regressão do motor, um caso por execução (registrados no
+   CTest pelo CMakeLists.txt):
+
+     internador      ids, crescimento e ordem do pool de strings; tabela de
+                     suspeitos
+     arvore_pistas   a AVL continua balanceada e em ordem com inserções em
+                     ordem crescente, decrescente e sorteada
+     conjunto        partidas iguais com a árvore e o conjunto de bits, e
+                     em várias threads sobre a mesma mansão
+     resolvedor      resolverMansao() e resolverGrafo() contra a força bruta
+     indice          consultas do índice de alcance; mapas que não são árvores
+     hash_perfeito   busca de cada chave num pool congelado
+     retratos        sessões salvas e restauradas continuam iguais
+     busca           busca por trecho (escalar, SSE2 e AVX2) e por prefixo
+                     contra strstr() e strncmp()
+     estatisticas    contadores somados das threads nos relatórios JSON e
+                     Prometheus (ou o aviso de desligadas)
+     mapa_binario    o .dqm carrega a mesma mansão que o texto; corrompido,
+                     é recusado e deixa o mapa vazio
+     postagens       listas (suspeito, peso) com e sem o principal, sem
+                     suspeitos repetidos
+     api             ids fora do intervalo, escolhas inválidas e mapas que
+                     não abrem
+
+   Uso: testes_motor <caso> <diretorio dos mapas>
+
+   Os arquivos temporários ficam no diretório atual. Retorna 1 e explica
+   a primeira diferença na saída padrão se o caso falhar. */
+
+#define TAM_CAMINHO 1024
+
+/* falhar()
+   Escreve a falha e retorna 1, para os casos fazerem return falhar(...). */
+static int falhar(const char *caso, const char *detalhe, uint32_t valor) {
+    printf("FALHA em %s: %s (%u)\n", caso, detalhe, valor);
+    return 1;
+}
+
+/* carregarTexto()
+   Grava o texto num arquivo de mapa temporário e o carrega. */
+static int carregarTexto(const char *texto, MapaCarregado *mapa) {
+    FILE *arq = fopen("teste_mapa_texto.txt", "w");
+    if (arq == NULL) return -1;
+    fputs(texto, arq);
+    fclose(arq);
+    int resultado = carregarMapa("teste_mapa_texto.txt", mapa);
+    remove("teste_mapa_texto.txt");
+    return resultado;
+}
+
+/* ===================== POOL DE STRINGS ===================== */
+
+static int testarInternador(void) {
+    enum { N = 60000 };
+    Internador in;
+    inicializarInternador(&in);
+    char texto[64], inverso[64];
+    int resultado = 0;
+    // pares de anagramas e uma segunda passada que só reencontra as strings
+    for (int passada = 0; passada < 2 && resultado == 0; ++passada) {
+        for (uint32_t i = 0; i < N / 2 && resultado == 0; ++i) {
+            int tam = snprintf(texto, sizeof(texto), "pista %u abc", i);
+            for (int j = 0; j < tam; ++j) inverso[j] = texto[tam - 1 - j];
+            inverso[tam] = '\0';
+            if (internarString(&in, texto) != 2 * i || internarString(&in, inverso) != 2 * i + 1)
+                resultado = falhar("internador", "id fora da ordem de insercao", i);
+        }
+    }
+    if (resultado == 0 && in.quantidade != N) resultado = falhar("internador", "quantidade", in.quantidade);
+    if (resultado == 0 && ((in.capIndice & (in.capIndice - 1)) != 0 || in.quantidade > in.capIndice * 0.70))
+        resultado = falhar("internador", "indice nao cresceu com a ocupacao", in.capIndice);
+    double media;
+    uint32_t maximo;
+    estatisticasSondagem(&in, &media, &maximo);
+    if (resultado == 0 && (media > 3.0 || maximo > 64)) resultado = falhar("internador", "sondagens longas", maximo);
+    for (uint32_t id = 0; id < in.quantidade && resultado == 0; ++id)
+        if (buscarString(&in, textoInternado(&in, id)) != id) resultado = falhar("internador", "busca pelo texto", id);
+    if (resultado == 0 && buscarString(&in, "pista que nao existe") != INTERNADOR_AUSENTE)
+        resultado = falhar("internador", "ausente achada", 0);
+
+    ordenarInternador(&in);
+    for (uint32_t pos = 0; pos < in.quantidade && resultado == 0; ++pos) {
+        uint32_t id = in.porOrdem[pos];
+        if (in.ordem[id] != pos ||
+            (pos > 0 && strcmp(textoInternado(&in, in.porOrdem[pos - 1]), textoInternado(&in, id)) >= 0))
+            resultado = falhar("internador", "ordem alfabetica", pos);
+    }
+    liberarInternador(&in);
+    if (resultado != 0) return 1;
+
+    // tabela de suspeitos: a última associação de uma pista vale
+    Internador pistas;
+    TabelaHash t;
+    inicializarInternador(&pistas);
+    inicializarTabelaHash(&t, &pistas);
+    for (uint32_t i = 0; i < 5000; ++i) {
+        snprintf(texto, sizeof(texto), "pista %u", i);
+        snprintf(inverso, sizeof(inverso), "suspeito %u", i % 7);
+        inserirNaHash(&t, texto, inverso);
+    }
+    inserirNaHash(&t, "pista 3", "Mordomo");
+    if (t.quantidade != 5000 || numSuspeitos(&t) != 8) resultado = falhar("internador", "tabela de suspeitos", t.quantidade);
+    for (uint32_t i = 0; i < 5000 && resultado == 0; ++i) {
+        snprintf(texto, sizeof(texto), "pista %u", i);
+        snprintf(inverso, sizeof(inverso), "suspeito %u", i % 7);
+        const char *suspeito = encontrarSuspeito(&t, texto);
+        if (suspeito == NULL || strcmp(suspeito, i == 3 ? "Mordomo" : inverso) != 0)
+            resultado = falhar("internador", "suspeito da pista", i);
+    }
+    if (resultado == 0 && encontrarSuspeito(&t, "pista 5000") != NULL) resultado = falhar("internador", "pista ausente", 0);
+    liberarTabelaHash(&t);
+    liberarInternador(&pistas);
+    return resultado;
+}
+
+/* ===================== ÁRVORE DE PISTAS ===================== */
+
+/* conferirAvl()
+   Percorre a árvore com pilha explícita conferindo, em cada nó, a altura
+   guardada, o fator de balanceamento e a ordem das chaves em relação aos
+   limites herdados. Retorna o número de nós ou UINT32_MAX se algo falhar. */
+typedef struct NoComLimites {
+    const PistaNode *no;
+    uint32_t min, max;
+} NoComLimites;
+
+static uint32_t conferirAvl(const PistaNode *raiz) {
+    NoComLimites pilha[PISTA_ALTURA_MAXIMA * 2];
+    int topo = 0;
+    uint32_t nos = 0;
+    if (raiz != NULL) pilha[topo++] = (NoComLimites) { raiz, 0, UINT32_MAX };
+    while (topo > 0) {
+        NoComLimites atual = pilha[--topo];
+        const PistaNode *no = atual.no;
+        int he = alturaPista(no->esquerda), hd = alturaPista(no->direita);
+        if (no->altura != (he > hd ? he : hd) + 1 || he - hd > 1 || hd - he > 1 ||
+            no->ordem < atual.min || no->ordem > atual.max)
+            return UINT32_MAX;
+        nos++;
+        if (no->esquerda != NULL) pilha[topo++] = (NoComLimites) { no->esquerda, atual.min, no->ordem - 1 };
+        if (no->direita != NULL) pilha[topo++] = (NoComLimites) { no->direita, no->ordem + 1, atual.max };
+    }
+    return nos;
+}
+
+/* Ordens visitadas por percorrerPistas(), para conferir a sequência. */
+typedef struct SequenciaPistas {
+    uint32_t anterior;
+    uint32_t visitados;
+    int foraDeOrdem;
+} SequenciaPistas;
+
+static void visitarSequencia(const PistaNode *no, void *contexto) {
+    SequenciaPistas *seq = (SequenciaPistas*) contexto;
+    if (seq->visitados > 0 && no->ordem <= seq->anterior) seq->foraDeOrdem = 1;
+    seq->anterior = no->ordem;
+    seq->visitados++;
+}
+
+static int testarArvorePistas(void) {
+    enum { N = 200000 };
+    // crescente (o pior caso de uma árvore sem balanceamento), decrescente e sorteada
+    for (int caso = 0; caso < 3; ++caso) {
+        ArenaPistas arena;
+        inicializarArena(&arena);
+        PistaNode *raiz = NULL;
+        uint64_t estado = iniciarAleatorio(51 + caso);
+        uint32_t inseridas = 0;
+        for (uint32_t i = 0; i < N; ++i) {
+            uint32_t ordem = caso == 0 ? i : caso == 1 ? N - 1 - i : proximoAleatorio(&estado) % N;
+            inseridas += (uint32_t) inserirPistaNova(&raiz, ordem, &arena);
+        }
+        int resultado = 0;
+        // repetidas não entram de novo
+        if (inserirPistaNova(&raiz, raiz->ordem, &arena) != 0) resultado = falhar("arvore_pistas", "pista repetida", caso);
+        // altura de uma AVL com n nós: menos de 1,44 log2(n + 2)
+        uint32_t bits = 0;
+        while (((uint64_t) inseridas + 2) >> bits) bits++;
+        double limite = 1.44 * bits;
+        if (resultado == 0 && (raiz->altura > limite || conferirAvl(raiz) != inseridas))
+            resultado = falhar("arvore_pistas", "arvore desbalanceada ou fora de ordem", (uint32_t) raiz->altura);
+        SequenciaPistas seq = { 0, 0, 0 };
+        percorrerPistas(raiz, visitarSequencia, &seq);
+        if (resultado == 0 && (seq.foraDeOrdem || seq.visitados != inseridas))
+            resultado = falhar("arvore_pistas", "percurso fora de ordem", seq.visitados);
+        for (uint32_t i = 0; i < N && resultado == 0 && caso != 2; i += 997)
+            if (!contemPista(raiz, i)) resultado = falhar("arvore_pistas", "pista nao encontrada", i);
+        if (resultado == 0 && contemPista(raiz, N)) resultado = falhar("arvore_pistas", "pista ausente encontrada", N);
+        liberarArena(&arena);
+        if (resultado != 0) return 1;
+    }
+
+    // sem arena: nós com malloc(), liberados sem recursão
+    PistaNode *raiz = NULL;
+    for (uint32_t i = 0; i < N; ++i) inserirPistaNova(&raiz, i, NULL);
+    uint32_t nos = conferirAvl(raiz);
+    liberarBST(raiz);
+    return nos == N ? 0 : falhar("arvore_pistas", "arvore com malloc", nos);
+}
+
+/* ===================== CONJUNTOS E SESSÕES EM PARALELO ===================== */
+
+/* Resumo de uma sessão para comparar partidas jogadas de formas
+   diferentes: sala, contadores, evidências e pistas em ordem alfabética. */
+typedef struct ResumoSessao {
+    uint64_t hash;
+    uint32_t pistas;
+} ResumoSessao;
+
+static void misturarResumo(ResumoSessao *r, uint64_t v) {
+    r->hash = (r->hash ^ v) * 1099511628211ull;
+}
+
+static void visitarPistaResumo(uint32_t idPista, void *contexto) {
+    ResumoSessao *r = (ResumoSessao*) contexto;
+    misturarResumo(r, idPista);
+    r->pistas++;
+}
+
+static ResumoSessao resumirSessao(const Sessao *s, const MapaCarregado *mapa) {
+    ResumoSessao r = { 14695981039346656037ull, 0 };
+    misturarResumo(&r, s->salaAtual);
+    misturarResumo(&r, s->numPistas);
+    misturarResumo(&r, s->movimentos);
+    misturarResumo(&r, s->invalidos);
+    misturarResumo(&r, s->suspeitoMaisProvavel);
+    misturarResumo(&r, s->maxEvidencias);
+    for (uint32_t k = 0; k < numSuspeitos(&mapa->tabela); ++k) {
+        misturarResumo(&r, s->evidencias[k]);
+        misturarResumo(&r, (uint64_t) contarPistasParaSuspeito(&s->pistas, &mapa->tabela, nomeSuspeito(&mapa->tabela, k)));
+    }
+    percorrerConjunto(&s->pistas, &mapa->mansao.pistas, visitarPistaResumo, &r);
+    return r;
+}
+
+/* jogarPartida()
+   Joga a partida de número i, sempre com as mesmas escolhas para o mesmo
+   i, coletando a pista de cada sala. */
+static ResumoSessao jogarPartida(const MapaCarregado *mapa, TipoConjunto tipo, ArenaPistas *arena, uint32_t i) {
+    static const char escolhas[] = "eed12x";
+    Sessao s;
+    iniciarSessao(&s, 0, &mapa->tabela, arena, tipo);
+    coletarPistaDaSala(&s, &mapa->mansao);
+    uint64_t estado = iniciarAleatorio(1000 + i);
+    uint32_t movimentos = proximoAleatorio(&estado) % 64;
+    for (uint32_t k = 0; k < movimentos; ++k)
+        if (moverSessao(&s, &mapa->mansao, escolhas[proximoAleatorio(&estado) % (sizeof(escolhas) - 1)]) == MOVIMENTO_OK)
+            coletarPistaDaSala(&s, &mapa->mansao);
+    ResumoSessao r = resumirSessao(&s, mapa);
+    encerrarSessao(&s);
+    return r;
+}
+
+enum { PARTIDAS_CONJUNTO = 2000, THREADS_CONJUNTO = 4 };
+
+typedef struct TrabalhoConjunto {
+    const MapaCarregado *mapa;
+    TipoConjunto tipo;
+    uint32_t primeira;
+    ResumoSessao *resumos;
+} TrabalhoConjunto;
+
+/* jogarFatia()
+   Thread: joga as partidas primeira, primeira + THREADS_CONJUNTO, ...,
+   com uma arena própria reaproveitada entre elas. */
+static void* jogarFatia(void *arg) {
+    TrabalhoConjunto *t = (TrabalhoConjunto*) arg;
+    ArenaPistas arena;
+    inicializarArena(&arena);
+    for (uint32_t i = t->primeira; i < PARTIDAS_CONJUNTO; i += THREADS_CONJUNTO) {
+        reiniciarArena(&arena);
+        t->resumos[i] = jogarPartida(t->mapa, t->tipo, &arena, i);
+    }
+    liberarArena(&arena);
+    return NULL;
+}
+
+static int testarConjunto(void) {
+    // salas balanceadas com muitas pistas e passagens: partidas longas
+    ParametrosGerador p = { FORMA_BALANCEADA, 1u << 14, 3000, 12, 300, 0, 61 };
+    MapaCarregado *mapa = (MapaCarregado*) realocarOuSair(NULL, sizeof(MapaCarregado), "o teste");
+    gerarMansao(mapa, &p);
+    ResumoSessao *arvore = (ResumoSessao*) realocarOuSair(NULL, PARTIDAS_CONJUNTO * sizeof(ResumoSessao), "o teste");
+    ResumoSessao *paralelo = (ResumoSessao*) realocarOuSair(NULL, PARTIDAS_CONJUNTO * sizeof(ResumoSessao), "o teste");
+    int resultado = 0;
+    uint64_t pistasColetadas = 0;
+    for (uint32_t i = 0; i < PARTIDAS_CONJUNTO; ++i) {
+        arvore[i] = jogarPartida(mapa, CONJUNTO_ARVORE, NULL, i);
+        ResumoSessao bits = jogarPartida(mapa, CONJUNTO_BITS, NULL, i);
+        if (resultado == 0 && (bits.hash != arvore[i].hash || bits.pistas != arvore[i].pistas))
+            resultado = falhar("conjunto", "arvore e bits divergem", i);
+        pistasColetadas += arvore[i].pistas;
+    }
+    if (resultado == 0 && pistasColetadas < PARTIDAS_CONJUNTO * 4)
+        resultado = falhar("conjunto", "partidas curtas demais", (uint32_t) pistasColetadas);
+
+    for (int tipo = 0; tipo < 2 && resultado == 0; ++tipo) {
+        pthread_t threads[THREADS_CONJUNTO];
+        TrabalhoConjunto trabalhos[THREADS_CONJUNTO];
+        for (uint32_t t = 0; t < THREADS_CONJUNTO; ++t) {
+            trabalhos[t] = (TrabalhoConjunto) { mapa, tipo ? CONJUNTO_BITS : CONJUNTO_ARVORE, t, paralelo };
+            pthread_create(&threads[t], NULL, jogarFatia, &trabalhos[t]);
+        }
+        for (uint32_t t = 0; t < THREADS_CONJUNTO; ++t) pthread_join(threads[t], NULL);
+        for (uint32_t i = 0; i < PARTIDAS_CONJUNTO && resultado == 0; ++i)
+            if (paralelo[i].hash != arvore[i].hash) resultado = falhar("conjunto", "partida em paralelo diverge", i);
+    }
+    free(arvore);
+    free(paralelo);
+    liberarMapa(mapa);
+    free(mapa);
+    return resultado;
+}
+
+/* ===================== RESOLVEDOR ===================== */
+
+/* melhorPorForcaBruta()
+   Para cada suspeito, a menor profundidade de uma sala cujo caminho desde
+   a entrada (pelos corredores) tem ACUSACAO_MINIMA pistas distintas dele;
+   UINT32_MAX se nenhuma tiver. Refaz o caminho inteiro de cada sala. */
+static void melhorPorForcaBruta(const MapaCarregado *mapa, uint32_t *melhor) {
+    const Mansao *m = &mapa->mansao;
+    const TabelaHash *t = &mapa->tabela;
+    uint32_t n = m->numSalas;
+    uint32_t suspeitos = numSuspeitos(t);
+    uint32_t *pai = (uint32_t*) realocarOuSair(NULL, (size_t) n * sizeof(uint32_t), "o teste");
+    uint32_t *profundidade = (uint32_t*) realocarOuSair(NULL, (size_t) n * sizeof(uint32_t), "o teste");
+    uint32_t *pilha = (uint32_t*) realocarOuSair(NULL, (size_t) n * sizeof(uint32_t), "o teste");
+    uint32_t *pistas = (uint32_t*) realocarOuSair(NULL, (size_t) n * sizeof(uint32_t), "o teste");
+    uint32_t *contagem = (uint32_t*) realocarOuSair(NULL, ((size_t) suspeitos + 1) * sizeof(uint32_t), "o teste");
+    for (uint32_t s = 0; s < suspeitos; ++s) melhor[s] = UINT32_MAX;
+    for (uint32_t i = 0; i < n; ++i) pai[i] = SEM_SALA;
+
+    // os mapas gerados são árvores: cada sala tem um único caminho desde a entrada
+    uint32_t topo = 0;
+    profundidade[SALA_ENTRADA] = 0;
+    pilha[topo++] = SALA_ENTRADA;
+    while (topo > 0) {
+        uint32_t sala = pilha[--topo];
+        uint32_t filhos[2] = { m->salas[sala].esquerda, m->salas[sala].direita };
+        for (int f = 0; f < 2; ++f) {
+            if (filhos[f] == SEM_SALA) continue;
+            pai[filhos[f]] = sala;
+            profundidade[filhos[f]] = profundidade[sala] + 1;
+            pilha[topo++] = filhos[f];
+        }
+
+        uint32_t numPistas = 0;
+        for (uint32_t a = sala; a != SEM_SALA; a = pai[a]) {
+            uint32_t p = m->salas[a].pista;
+            if (p == SEM_PISTA) continue;
+            uint32_t k = 0;
+            while (k < numPistas && pistas[k] != p) k++;
+            if (k == numPistas) pistas[numPistas++] = p;
+        }
+        memset(contagem, 0, ((size_t) suspeitos + 1) * sizeof(uint32_t));
+        for (uint32_t k = 0; k < numPistas; ++k) {
+            uint32_t s = suspeitoDaPista(t, pistas[k]);
+            if (s != INTERNADOR_AUSENTE) contagem[s]++;
+        }
+        for (uint32_t s = 0; s < suspeitos; ++s)
+            if (contagem[s] >= ACUSACAO_MINIMA && profundidade[sala] < melhor[s]) melhor[s] = profundidade[sala];
+    }
+    free(pai);
+    free(profundidade);
+    free(pilha);
+    free(pistas);
+    free(contagem);
+}
+
+/* jogarSolucao()
+   Joga o caminho da solução numa sessão, coletando as pistas como o modo
+   lote, e confere que ele termina na sala final com pistas suficientes
+   para acusar o suspeito. */
+static int jogarSolucao(const MapaCarregado *mapa, uint32_t suspeito, const SolucaoSuspeito *sol) {
+    DqSessao *s = dqIniciarSessao(mapa);
+    dqColetar(s);
+    int ok = strlen(sol->caminho) == sol->movimentos;
+    for (uint32_t k = 0; k < sol->movimentos && ok; ++k) {
+        ok = dqMover(s, sol->caminho[k]) == DQ_MOVIMENTO_OK;
+        dqColetar(s);
+    }
+    ok = ok && dqIdSalaAtual(s) == sol->salaFinal && dqAcusar(s, nomeSuspeito(&mapa->tabela, suspeito), NULL);
+    dqEncerrarSessao(s);
+    return ok;
+}
+
+/* conferirContraMelhor()
+   Confere as soluções contra os melhores números de movimentos esperados. */
+static int conferirContraMelhor(const MapaCarregado *mapa, const SolucaoSuspeito *solucoes, const uint32_t *melhor,
+                                const char *caso) {
+    for (uint32_t s = 0; s < numSuspeitos(&mapa->tabela); ++s) {
+        if (solucoes[s].salaFinal == SEM_SALA) {
+            if (melhor[s] != UINT32_MAX) return falhar(caso, "suspeito sem solucao", s);
+            continue;
+        }
+        if (solucoes[s].movimentos != melhor[s]) return falhar(caso, "movimentos diferentes da forca bruta", s);
+        if (!jogarSolucao(mapa, s, &solucoes[s])) return falhar(caso, "caminho nao leva a acusacao", s);
+    }
+    return 0;
+}
+
+/* conferirSolucoes()
+   Compara o resolvedor da árvore e o do grafo com a força bruta numa
+   mansão gerada sem passagens, com uma e com várias threads, e joga os
+   caminhos devolvidos. */
+static int conferirSolucoes(const ParametrosGerador *p) {
+    MapaCarregado mapa;
+    gerarMansao(&mapa, p);
+    const Mansao *m = &mapa.mansao;
+    uint32_t suspeitos = numSuspeitos(&mapa.tabela);
+    uint32_t *melhor = (uint32_t*) realocarOuSair(NULL, ((size_t) suspeitos + 1) * sizeof(uint32_t), "o teste");
+    SolucaoSuspeito *solucoes = (SolucaoSuspeito*) realocarOuSair(NULL, ((size_t) suspeitos + 1) * sizeof(SolucaoSuspeito),
+                                                                 "o teste");
+    melhorPorForcaBruta(&mapa, melhor);
+
+    IndiceMansao indice;
+    int resultado = construirIndice(&indice, m, &mapa.tabela) != 0 ? falhar("resolvedor", "indice recusou a arvore", 0) : 0;
+    const int threads[] = { 1, 4 };
+    for (int t = 0; t < 2 && resultado == 0; ++t) {
+        ContadoresResolvedor contadores;
+        resolverMansao(m, &mapa.tabela, &indice, threads[t], solucoes, &contadores);
+        resultado = conferirContraMelhor(&mapa, solucoes, melhor, "resolvedor");
+        liberarSolucoes(solucoes, suspeitos);
+        if (resultado != 0) break;
+        resolverGrafo(m, &mapa.tabela, threads[t], solucoes, &contadores);
+        resultado = conferirContraMelhor(&mapa, solucoes, melhor, "resolvedor (grafo)");
+        liberarSolucoes(solucoes, suspeitos);
+    }
+    liberarIndice(&indice);
+    free(solucoes);
+    free(melhor);
+    liberarMapa(&mapa);
+    return resultado;
+}
+
+/* distanciasDe()
+   Busca em largura a partir da sala pelas saídas que o jogador escolhe
+   ('e', 'd', '1'..'9'), refeita com dqSalaVizinha(). */
+static void distanciasDe(const MapaCarregado *mapa, uint32_t origem, uint32_t *distancia, uint32_t *fila) {
+    static const char direcoes[] = "ed123456789";
+    uint32_t n = mapa->mansao.numSalas;
+    for (uint32_t i = 0; i < n; ++i) distancia[i] = UINT32_MAX;
+    uint32_t inicio = 0, fim = 0;
+    distancia[origem] = 0;
+    fila[fim++] = origem;
+    while (inicio < fim) {
+        uint32_t sala = fila[inicio++];
+        for (const char *d = direcoes; *d != '\0'; ++d) {
+            uint32_t v = dqSalaVizinha(mapa, sala, *d);
+            if (v == DQ_SEM_SALA || distancia[v] != UINT32_MAX) continue;
+            distancia[v] = distancia[sala] + 1;
+            fila[fim++] = v;
+        }
+    }
+}
+
+/* melhorNoGrafo()
+   Força bruta para mansões quaisquer: para cada sala A com pista contra o
+   suspeito, a distância da entrada até A mais a de A até a sala mais
+   próxima com outra pista dele. */
+static void melhorNoGrafo(const MapaCarregado *mapa, uint32_t *melhor) {
+    const Mansao *m = &mapa->mansao;
+    const TabelaHash *t = &mapa->tabela;
+    uint32_t n = m->numSalas;
+    uint32_t *daEntrada = (uint32_t*) realocarOuSair(NULL, (size_t) n * sizeof(uint32_t), "o teste");
+    uint32_t *deA = (uint32_t*) realocarOuSair(NULL, (size_t) n * sizeof(uint32_t), "o teste");
+    uint32_t *fila = (uint32_t*) realocarOuSair(NULL, (size_t) n * sizeof(uint32_t), "o teste");
+    for (uint32_t s = 0; s < numSuspeitos(t); ++s) melhor[s] = UINT32_MAX;
+    distanciasDe(mapa, SALA_ENTRADA, daEntrada, fila);
+    for (uint32_t a = 0; a < n; ++a) {
+        uint32_t pa = m->salas[a].pista;
+        uint32_t s = pa != SEM_PISTA ? suspeitoDaPista(t, pa) : INTERNADOR_AUSENTE;
+        if (s == INTERNADOR_AUSENTE || daEntrada[a] == UINT32_MAX) continue;
+        distanciasDe(mapa, a, deA, fila);
+        for (uint32_t b = 0; b < n; ++b) {
+            uint32_t pb = m->salas[b].pista;
+            if (deA[b] == UINT32_MAX || pb == SEM_PISTA || pb == pa || suspeitoDaPista(t, pb) != s) continue;
+            if (daEntrada[a] + deA[b] < melhor[s]) melhor[s] = daEntrada[a] + deA[b];
+        }
+    }
+    free(daEntrada);
+    free(deA);
+    free(fila);
+}
+
+/* conferirGrafo()
+   Resolve pelo grafo uma mansão que o índice recusa e compara com a força
+   bruta, com uma e com várias threads. */
+static int conferirGrafo(const MapaCarregado *mapa) {
+    uint32_t suspeitos = numSuspeitos(&mapa->tabela);
+    uint32_t *melhor = (uint32_t*) realocarOuSair(NULL, ((size_t) suspeitos + 1) * sizeof(uint32_t), "o teste");
+    SolucaoSuspeito *solucoes = (SolucaoSuspeito*) realocarOuSair(NULL, ((size_t) suspeitos + 1) * sizeof(SolucaoSuspeito),
+                                                                 "o teste");
+    melhorNoGrafo(mapa, melhor);
+    IndiceMansao indice;
+    int resultado = construirIndice(&indice, &mapa->mansao, &mapa->tabela) == 0
+                  ? falhar("resolvedor (grafo)", "indice aceitou mansao que nao e arvore", 0) : 0;
+    const int threads[] = { 1, 3 };
+    for (int t = 0; t < 2 && resultado == 0; ++t) {
+        ContadoresResolvedor contadores;
+        resolverGrafo(&mapa->mansao, &mapa->tabela, threads[t], solucoes, &contadores);
+        resultado = conferirContraMelhor(mapa, solucoes, melhor, "resolvedor (grafo)");
+        liberarSolucoes(solucoes, suspeitos);
+    }
+    free(solucoes);
+    free(melhor);
+    return resultado;
+}
+
+/* gerarCorredoresCruzados()
+   Mansão aleatória sem passagens em que parte das vagas de corredor das
+   salas aponta para salas que já têm pai (ou para a entrada). */
+static void gerarCorredoresCruzados(MapaCarregado *mapa, uint32_t numSalas, uint64_t semente) {
+    ParametrosGerador p = { FORMA_ALEATORIA, numSalas, numSalas / 8, 7, 0, 0, semente };
+    uint64_t estado = iniciarAleatorio(semente);
+    inicializarMapa(mapa);
+    gerarCatalogo(mapa, &p, &estado);
+    gerarSalas(mapa, &p, &estado);
+    Mansao *m = &mapa->mansao;
+    for (uint32_t i = 0; i < m->numSalas; ++i) {
+        if (proximoAleatorio(&estado) % 4 != 0) continue;
+        uint32_t destino = proximoAleatorio(&estado) % m->numSalas;
+        if (m->salas[i].esquerda == SEM_SALA) m->salas[i].esquerda = destino;
+        else if (m->salas[i].direita == SEM_SALA) m->salas[i].direita = destino;
+    }
+    finalizarMapa(mapa);
+}
+
+static int testarResolvedor(void) {
+    const ParametrosGerador casos[] = {
+        { FORMA_ALEATORIA, 20000, 300, 12, 0, 0, 11 },
+        { FORMA_ALEATORIA, 5000, 40, 5, 0, 3, 12 },
+        { FORMA_BALANCEADA, 8191, 500, 30, 0, 0, 13 },
+        { FORMA_DEGENERADA, 3000, 2000, 40, 0, 0, 14 },
+        { FORMA_ALEATORIA, 600, 300, 120, 0, 0, 16 },   // parte dos suspeitos sem solução
+        { FORMA_ALEATORIA, 1, 1, 1, 0, 0, 15 },
+    };
+    for (size_t i = 0; i < sizeof(casos) / sizeof(casos[0]); ++i)
+        if (conferirSolucoes(&casos[i]) != 0) return 1;
+
+    // M é alcançada primeiro com a pista de X e só depois com a de Y: a
+    // melhor partida (d e e e) precisa da segunda origem que chega a M
+    MapaCarregado mapa;
+    if (carregarTexto("sala|E||1|2\nsala|X|Faca|3|-\nsala|Y|Luva|4|-\nsala|M||5|-\nsala|Z||3|-\n"
+                      "sala|T|Faca|-|-\npista|Faca|Mordomo\npista|Luva|Mordomo\n", &mapa) != 0)
+        return falhar("resolvedor", mapa.erro, 0);
+    int resultado = conferirGrafo(&mapa);
+    liberarMapa(&mapa);
+    if (resultado != 0) return 1;
+
+    // corredores para salas que já têm pai: salas compartilhadas e ciclos
+    for (uint64_t semente = 31; semente < 34; ++semente) {
+        gerarCorredoresCruzados(&mapa, 1200, semente);
+        resultado = conferirGrafo(&mapa);
+        liberarMapa(&mapa);
+        if (resultado != 0) return 1;
+    }
+
+    // passagens, com ciclos e voltas à entrada
+    const ParametrosGerador grafos[] = {
+        { FORMA_ALEATORIA, 1500, 60, 8, 400, 2, 17 },
+        { FORMA_DEGENERADA, 800, 300, 20, 30, 0, 18 },
+        { FORMA_BALANCEADA, 511, 40, 6, 2000, 0, 19 },
+    };
+    for (size_t i = 0; i < sizeof(grafos) / sizeof(grafos[0]); ++i) {
+        gerarMansao(&mapa, &grafos[i]);
+        resultado = conferirGrafo(&mapa);
+        liberarMapa(&mapa);
+        if (resultado != 0) return 1;
+    }
+    return 0;
+}
+
+/* ===================== ÍNDICE DE ALCANCE ===================== */
+
+/* percorrerAbaixo()
+   Força bruta de uma sala da árvore: pelas salas da subárvore, quantas têm
+   pista do suspeito, a menor distância até uma delas e o maior número delas
+   num caminho descendo. */
+static void percorrerAbaixo(const MapaCarregado *mapa, uint32_t sala, uint32_t suspeito, uint32_t profundidade,
+                            uint32_t noCaminho, uint32_t *evidencias, uint32_t *distancia, uint32_t *caminho) {
+    const Sala *s = &mapa->mansao.salas[sala];
+    if (s->pista != SEM_PISTA && suspeitoDaPista(&mapa->tabela, s->pista) == suspeito) {
+        (*evidencias)++;
+        noCaminho++;
+        if (profundidade < *distancia) *distancia = profundidade;
+    }
+    if (noCaminho > *caminho) *caminho = noCaminho;
+    if (s->esquerda != SEM_SALA)
+        percorrerAbaixo(mapa, s->esquerda, suspeito, profundidade + 1, noCaminho, evidencias, distancia, caminho);
+    if (s->direita != SEM_SALA)
+        percorrerAbaixo(mapa, s->direita, suspeito, profundidade + 1, noCaminho, evidencias, distancia, caminho);
+}
+
+/* conferirConsultas()
+   As três consultas do índice contra a força bruta em salas sorteadas. */
+static int conferirConsultas(const MapaCarregado *mapa, const IndiceMansao *indice) {
+    uint64_t estado = iniciarAleatorio(51);
+    uint32_t suspeitos = numSuspeitos(&mapa->tabela);
+    for (uint32_t k = 0; k < 300; ++k) {
+        uint32_t sala = proximoAleatorio(&estado) % mapa->mansao.numSalas;
+        uint32_t suspeito = proximoAleatorio(&estado) % suspeitos;
+        uint32_t evidencias = 0, distancia = INDICE_INALCANCAVEL, caminho = 0;
+        percorrerAbaixo(mapa, sala, suspeito, 0, 0, &evidencias, &distancia, &caminho);
+        if (evidenciasAbaixo(indice, sala, suspeito) != evidencias) return falhar("indice", "evidencias abaixo", sala);
+        if (distanciaPistaSuspeito(indice, sala, suspeito) != distancia) return falhar("indice", "distancia", sala);
+        if (melhorCaminhoSuspeito(indice, sala, suspeito) != caminho) return falhar("indice", "melhor caminho", sala);
+    }
+    return 0;
+}
+
+static int testarIndice(void) {
+    // mapas que não são árvores: o índice recusa em vez de responder errado
+    static const char *const recusados[] = {
+        "sala|A||1|2\nsala|B||3|-\nsala|C||3|-\nsala|D|Faca|-|-\npista|Faca|Mordomo\n",  // D com dois pais
+        "sala|A||1|-\nsala|B|Faca|2|-\nsala|C||1|-\npista|Faca|Mordomo\n",                // ciclo B -> C -> B
+        "sala|A||1|-\nsala|B||0|-\n",                                                       // volta à entrada
+        "sala|A||0|-\n",                                                                       // sala para ela mesma
+        "sala|A||1|-\nsala|B||-|-\npassagem|1|0\n",                                         // passagem
+    };
+    MapaCarregado mapa;
+    IndiceMansao indice;
+    for (size_t i = 0; i < sizeof(recusados) / sizeof(recusados[0]); ++i) {
+        if (carregarTexto(recusados[i], &mapa) != 0) return falhar("indice", mapa.erro, (uint32_t) i);
+        int aceito = construirIndice(&indice, &mapa.mansao, &mapa.tabela) == 0;
+        liberarIndice(&indice);
+        liberarMapa(&mapa);
+        if (aceito) return falhar("indice", "mapa que nao e arvore aceito", (uint32_t) i);
+    }
+
+    // uma sala fora do alcance apontando para a árvore não atrapalha
+    if (carregarTexto("sala|A||1|-\nsala|B|Faca|-|-\nsala|C||1|-\npista|Faca|Mordomo\n", &mapa) != 0)
+        return falhar("indice", mapa.erro, 0);
+    int resultado = construirIndice(&indice, &mapa.mansao, &mapa.tabela) != 0 ? falhar("indice", "arvore recusada", 0)
+                  : indice.numAlcancaveis != 2 || salaAlcancavel(&indice, 2) ? falhar("indice", "alcancaveis", 2) : 0;
+    liberarIndice(&indice);
+    liberarMapa(&mapa);
+    if (resultado != 0) return 1;
+
+    ParametrosGerador p = { FORMA_ALEATORIA, 3000, 40, 6, 0, 0, 52 };
+    gerarMansao(&mapa, &p);
+    resultado = construirIndice(&indice, &mapa.mansao, &mapa.tabela) != 0 ? falhar("indice", "arvore recusada", 1)
+                                                                         : conferirConsultas(&mapa, &indice);
+    liberarIndice(&indice);
+    liberarMapa(&mapa);
+    return resultado;
+}
+
+/* ===================== HASH PERFEITO ===================== */
+
+/* conferirPoolCongelado()
+   Toda string do pool é achada pelo id dela e um texto ausente não é. */
+static int conferirPoolCongelado(const Internador *in, const char *caso) {
+    if (in->numBaldes == 0 || in->indice != NULL) return falhar(caso, "pool nao congelado", in->quantidade);
+    for (uint32_t id = 0; id < in->quantidade; ++id)
+        if (buscarString(in, textoInternado(in, id)) != id) return falhar(caso, "chave com id errado", id);
+    if (buscarString(in, "texto que nao esta no pool") != INTERNADOR_AUSENTE) return falhar(caso, "ausente achado", 0);
+    return 0;
+}
+
+static int testarHashPerfeito(const char *dirMapas) {
+    const uint32_t quantidades[] = { 1, 2, 3, 5, 64, 1000, 50000 };
+    char texto[64];
+    for (size_t q = 0; q < sizeof(quantidades) / sizeof(quantidades[0]); ++q) {
+        uint32_t n = quantidades[q];
+        Internador in;
+        inicializarInternador(&in);
+        for (uint32_t i = 0; i < n; ++i) {
+            snprintf(texto, sizeof(texto), "Pista numero %u", i);
+            internarString(&in, texto);
+        }
+        uint32_t *novoId = (uint32_t*) realocarOuSair(NULL, (size_t) n * sizeof(uint32_t), "o teste");
+        int resultado = congelarInternador(&in, novoId) != 0 ? falhar("hash_perfeito", "congelar falhou", n)
+                                                              : conferirPoolCongelado(&in, "hash_perfeito");
+        for (uint32_t i = 0; i < n && resultado == 0; ++i) {
+            snprintf(texto, sizeof(texto), "Pista numero %u", i);
+            if (buscarString(&in, texto) != novoId[i] || strcmp(textoInternado(&in, novoId[i]), texto) != 0)
+                resultado = falhar("hash_perfeito", "id novo nao corresponde ao antigo", i);
+        }
+
+        // uma string nova descongela o pool sem mudar os ids
+        if (resultado == 0 && (internarString(&in, "Pista nova") != n || in.numBaldes != 0))
+            resultado = falhar("hash_perfeito", "insercao depois de congelar", n);
+        for (uint32_t i = 0; i < n && resultado == 0; ++i) {
+            snprintf(texto, sizeof(texto), "Pista numero %u", i);
+            if (buscarString(&in, texto) != novoId[i]) resultado = falhar("hash_perfeito", "id mudou ao descongelar", i);
+        }
+        free(novoId);
+        liberarInternador(&in);
+        if (resultado != 0) return 1;
+    }
+
+    // os pools da mansão padrão, em memória e mapeados do .dqm
+    char caminho[TAM_CAMINHO];
+    snprintf(caminho, sizeof(caminho), "%s/mansao_padrao.txt", dirMapas);
+    MapaCarregado mapa;
+    if (carregarMapa(caminho, &mapa) != 0) return falhar("hash_perfeito", mapa.erro, 0);
+    int resultado = conferirPoolCongelado(&mapa.mansao.pistas, "hash_perfeito (pistas)") ||
+                    conferirPoolCongelado(&mapa.tabela.suspeitos, "hash_perfeito (suspeitos)");
+    if (resultado == 0 && salvarMapaBinario("teste_hash_perfeito.dqm", &mapa.mansao, &mapa.tabela) != 0)
+        resultado = falhar("hash_perfeito", "nao gravou o .dqm", 0);
+    liberarMapa(&mapa);
+    if (resultado != 0) return 1;
+    if (carregarMapa("teste_hash_perfeito.dqm", &mapa) != 0) return falhar("hash_perfeito", mapa.erro, 0);
+    resultado = conferirPoolCongelado(&mapa.mansao.pistas, "hash_perfeito (pistas do .dqm)") ||
+                conferirPoolCongelado(&mapa.tabela.suspeitos, "hash_perfeito (suspeitos do .dqm)");
+    liberarMapa(&mapa);
+    remove("teste_hash_perfeito.dqm");
+    return resultado;
+}
+
+/* ===================== RETRATOS ===================== */
+
+/* Pistas de uma sessão concatenadas, para comparar duas sessões. */
+typedef struct TextoPistas {
+    char texto[8192];
+    size_t tam;
+} TextoPistas;
+
+static void juntarPista(const char *pista, void *contexto) {
+    TextoPistas *t = (TextoPistas*) contexto;
+    int n = snprintf(t->texto + t->tam, sizeof(t->texto) - t->tam, "%s\n", pista);
+    if (n > 0 && t->tam + (size_t) n < sizeof(t->texto)) t->tam += (size_t) n;
+}
+
+/* sessoesIguais()
+   Mesma sala, contadores, pistas e pontuação de cada suspeito. */
+static int sessoesIguais(const DqSessao *a, const DqSessao *b) {
+    DqEstatisticas ea, eb;
+    dqEstatisticas(a, &ea);
+    dqEstatisticas(b, &eb);
+    if (dqIdSalaAtual(a) != dqIdSalaAtual(b) || ea.movimentos != eb.movimentos || ea.invalidos != eb.invalidos ||
+        ea.pistas != eb.pistas || ea.maxEvidencias != eb.maxEvidencias ||
+        (ea.maisProvavel == NULL) != (eb.maisProvavel == NULL) ||
+        (ea.maisProvavel != NULL && strcmp(ea.maisProvavel, eb.maisProvavel) != 0))
+        return 0;
+    TextoPistas ta = { "", 0 }, tb = { "", 0 };
+    dqPercorrerPistas(a, juntarPista, &ta);
+    dqPercorrerPistas(b, juntarPista, &tb);
+    return ta.tam == tb.tam && memcmp(ta.texto, tb.texto, ta.tam) == 0;
+}
+
+/* jogarAoAcaso()
+   Faz movimentos sorteados, coletando a pista de cada sala. */
+static void jogarAoAcaso(DqSessao *s, uint32_t movimentos, uint64_t *estado) {
+    static const char escolhas[] = "eed123x";
+    for (uint32_t k = 0; k < movimentos; ++k) {
+        dqMover(s, escolhas[proximoAleatorio(estado) % (sizeof(escolhas) - 1)]);
+        dqColetar(s);
+    }
+}
+
+static int testarRetratos(void) {
+    ParametrosGerador p = { FORMA_ALEATORIA, 4000, 120, 9, 300, 2, 21 };
+    MapaCarregado *mapa = (MapaCarregado*) realocarOuSair(NULL, sizeof(MapaCarregado), "o teste");
+    gerarMansao(mapa, &p);
+    const DqMansao *mansao = mapa;
+    enum { NUM_SESSOES = 64 };
+    DqSessao *sessoes[NUM_SESSOES];
+    uint64_t estado = iniciarAleatorio(p.semente);
+    for (uint32_t i = 0; i < NUM_SESSOES; ++i) {
+        sessoes[i] = dqIniciarSessao(mansao);
+        jogarAoAcaso(sessoes[i], i * 3, &estado);
+    }
+
+    int resultado = 0;
+    unsigned char *retrato = (unsigned char*) realocarOuSair(NULL, dqTamanhoMaximoRetrato(sessoes[0]), "o teste");
+    for (uint32_t i = 0; i < NUM_SESSOES && resultado == 0; ++i) {
+        DqSessao *copia = dqIniciarSessao(mansao);
+        size_t tam = dqRetratarSessao(sessoes[i], retrato);
+        if (dqRestaurarSessao(copia, retrato, tam) != 0 || !sessoesIguais(sessoes[i], copia))
+            resultado = falhar("retratos", "retrato restaurado diferente", i);
+        // depois de restaurada, a sessão segue igual à original
+        uint64_t a = estado, b = estado;
+        jogarAoAcaso(sessoes[i], 20, &a);
+        jogarAoAcaso(copia, 20, &b);
+        if (resultado == 0 && !sessoesIguais(sessoes[i], copia))
+            resultado = falhar("retratos", "sessao restaurada divergiu", i);
+        dqEncerrarSessao(copia);
+    }
+    free(retrato);
+
+    size_t numCarregadas = 0;
+    DqSessao **carregadas = NULL;
+    char erro[DQ_TAM_ERRO];
+    if (resultado == 0 && dqSalvarSessoes(mansao, "teste_retratos.dqs", sessoes, NUM_SESSOES) != 0)
+        resultado = falhar("retratos", "nao gravou as sessoes", 0);
+    if (resultado == 0) {
+        carregadas = dqCarregarSessoes(mansao, "teste_retratos.dqs", &numCarregadas, erro, sizeof(erro));
+        if (carregadas == NULL) resultado = falhar("retratos", erro, 0);
+        else if (numCarregadas != NUM_SESSOES) resultado = falhar("retratos", "sessoes carregadas", (uint32_t) numCarregadas);
+    }
+    for (size_t i = 0; i < numCarregadas && resultado == 0; ++i)
+        if (!sessoesIguais(sessoes[i], carregadas[i])) resultado = falhar("retratos", "sessao carregada diferente", (uint32_t) i);
+    for (size_t i = 0; i < numCarregadas; ++i) dqEncerrarSessao(carregadas[i]);
+    free(carregadas);
+    remove("teste_retratos.dqs");
+
+    for (uint32_t i = 0; i < NUM_SESSOES; ++i) dqEncerrarSessao(sessoes[i]);
+    liberarMapa(mapa);
+    free(mapa);
+    return resultado;
+}
+
+/* ===================== BUSCA NAS PISTAS ===================== */
+
+/* Posições alfabéticas devolvidas por buscarTrecho(). */
+typedef struct ResultadoBusca {
+    uint32_t *ordens;
+    uint32_t quantidade;
+} ResultadoBusca;
+
+static void guardarOrdem(uint32_t ordem, void *contexto) {
+    ResultadoBusca *r = (ResultadoBusca*) contexto;
+    r->ordens[r->quantidade++] = ordem;
+}
+
+/* conferirTrecho()
+   A varredura da busca acha exatamente as pistas que strstr() acha, em
+   ordem alfabética e sem repetir. */
+static int conferirTrecho(const BuscaPistas *b, const char *trecho, uint32_t *ordens) {
+    ResultadoBusca r = { ordens, 0 };
+    uint32_t n = buscarTrecho(b, trecho, guardarOrdem, &r);
+    uint32_t k = 0;
+    for (uint32_t ordem = 0; ordem < b->quantidade; ++ordem) {
+        if (strstr(textoNaBusca(b, ordem), trecho) == NULL) continue;
+        if (k >= r.quantidade || r.ordens[k] != ordem) return falhar("busca", b->implementacao, ordem);
+        k++;
+    }
+    return k == r.quantidade && n == r.quantidade ? 0 : falhar("busca", b->implementacao, r.quantidade);
+}
+
+static int testarBusca(void) {
+    // alfabeto pequeno (muitas ocorrências parciais) com bytes acima de 127,
+    // textos de 1 a 80 bytes que cruzam as fronteiras de 16 e 32 bytes
+    static const char *const pedacos[] = { "a", "b", "ab", "ba", "\xc3\xa9", "veneno", " " };
+    const uint32_t numPedacos = sizeof(pedacos) / sizeof(pedacos[0]);
+    Internador pistas;
+    inicializarInternador(&pistas);
+    uint64_t estado = iniciarAleatorio(71);
+    char texto[128];
+    for (uint32_t i = 0; i < 3000; ++i) {
+        size_t tam = 0, alvo = 1 + proximoAleatorio(&estado) % 80;
+        while (tam < alvo) {
+            const char *pedaco = pedacos[proximoAleatorio(&estado) % numPedacos];
+            size_t t = strlen(pedaco);
+            if (tam + t >= sizeof(texto)) break;
+            memcpy(texto + tam, pedaco, t);
+            tam += t;
+        }
+        texto[tam] = '\0';
+        internarString(&pistas, texto);
+    }
+    ordenarInternador(&pistas);
+    BuscaPistas b;
+    construirBusca(&b, &pistas);
+    uint32_t *ordens = (uint32_t*) realocarOuSair(NULL, (size_t) b.quantidade * sizeof(uint32_t), "o teste");
+
+    int resultado = 0;
+    static const char *const implementacoes[] = { "escalar", "sse2", "avx2" };
+    for (size_t i = 0; i < sizeof(implementacoes) / sizeof(implementacoes[0]) && resultado == 0; ++i) {
+        if (escolherImplementacaoBusca(&b, implementacoes[i]) != 0) continue;  // CPU sem a extensão
+        uint64_t e = iniciarAleatorio(72);
+        for (uint32_t k = 0; k < 500 && resultado == 0; ++k) {
+            // trechos tirados das próprias pistas, inclusive o texto inteiro
+            const char *origem = textoNaBusca(&b, proximoAleatorio(&e) % b.quantidade);
+            size_t tam = strlen(origem);
+            size_t inicio = proximoAleatorio(&e) % tam;
+            size_t fim = inicio + 1 + proximoAleatorio(&e) % (tam - inicio < 40 ? tam - inicio : 40);
+            memcpy(texto, origem + inicio, fim - inicio);
+            texto[fim - inicio] = '\0';
+            resultado = conferirTrecho(&b, texto, ordens);
+        }
+        if (resultado == 0) resultado = conferirTrecho(&b, "trecho que nao aparece", ordens);
+    }
+
+    // prefixos: o intervalo tem exatamente as pistas que começam com eles
+    for (uint32_t k = 0; k < 300 && resultado == 0; ++k) {
+        const char *origem = textoNaBusca(&b, proximoAleatorio(&estado) % b.quantidade);
+        size_t tam = 1 + proximoAleatorio(&estado) % strlen(origem);
+        memcpy(texto, origem, tam);
+        texto[tam] = '\0';
+        uint32_t primeira, fim;
+        intervaloPrefixo(&b, texto, &primeira, &fim);
+        for (uint32_t ordem = 0; ordem < b.quantidade && resultado == 0; ++ordem) {
+            int comeca = strncmp(textoNaBusca(&b, ordem), texto, tam) == 0;
+            if (comeca != (ordem >= primeira && ordem < fim)) resultado = falhar("busca", "prefixo", ordem);
+        }
+    }
+    free(ordens);
+    liberarBusca(&b);
+    liberarInternador(&pistas);
+    return resultado;
+}
+
+/* ===================== ESTATÍSTICAS ===================== */
+
+enum { PARTIDAS_ESTATISTICAS = 50, THREADS_ESTATISTICAS = 4 };
+
+/* jogarPartidasFixas()
+   Thread: joga PARTIDAS_ESTATISTICAS partidas na mansão padrão, sempre
+   e, x (inválido), d: Hall, Sala de Estar e Jardim, com duas pistas. */
+static void* jogarPartidasFixas(void *arg) {
+    const DqMansao *m = (const DqMansao*) arg;
+    for (uint32_t i = 0; i < PARTIDAS_ESTATISTICAS; ++i) {
+        DqSessao *s = dqIniciarSessao(m);
+        dqColetar(s);
+        if (dqMover(s, 'e') == DQ_MOVIMENTO_OK) dqColetar(s);
+        dqMover(s, 'x');
+        if (dqMover(s, 'd') == DQ_MOVIMENTO_OK) dqColetar(s);
+        dqEncerrarSessao(s);
+    }
+    return NULL;
+}
+
+/* conferirTrechoRelatorio()
+   O relatório contém a linha (ou o pedaço de linha) esperada. */
+static int conferirTrechoRelatorio(const char *relatorio, const char *formato, const char *esperado) {
+    if (relatorio != NULL && strstr(relatorio, esperado) != NULL) return 0;
+    printf("FALHA em estatisticas: o relatorio %s nao contem \"%s\":\n%s\n", formato, esperado,
+           relatorio != NULL ? relatorio : "(nulo)");
+    return 1;
+}
+
+static int testarEstatisticas(void) {
+    DqMansao *m = dqMansaoPadrao();
+    if (m == NULL || dqDefinirConjunto(m, "arvore") != 0) return falhar("estatisticas", "mansao padrao", 0);
+    dqZerarEstatisticas();
+    pthread_t threads[THREADS_ESTATISTICAS];
+    for (uint32_t t = 0; t < THREADS_ESTATISTICAS; ++t) pthread_create(&threads[t], NULL, jogarPartidasFixas, m);
+    for (uint32_t t = 0; t < THREADS_ESTATISTICAS; ++t) pthread_join(threads[t], NULL);
+
+    // os blocos das threads já encerradas entram na soma
+    const uint32_t partidas = PARTIDAS_ESTATISTICAS * THREADS_ESTATISTICAS;
+    char *json = dqTextoEstatisticas("json");
+    char *prometheus = dqTextoEstatisticas("prometheus");
+    char esperado[256];
+    int resultado = 0;
+    if (dqTextoEstatisticas("xml") != NULL) resultado = falhar("estatisticas", "formato desconhecido aceito", 0);
+    if (!dqEstatisticasAtivas()) {
+        resultado = resultado || conferirTrechoRelatorio(json, "json", "{\"ativadas\": false}") ||
+                    conferirTrechoRelatorio(prometheus, "prometheus", "# estatisticas desligadas");
+    } else {
+        const struct { const char *json, *prometheus; uint32_t valor; } contadores[] = {
+            { "\"movimentos\": ", "dq_movimentos_total ", 2 * partidas },
+            { "\"movimentos_invalidos\": ", "dq_movimentos_invalidos_total ", partidas },
+            { "\"sessoes\": ", "dq_sessoes_total ", partidas },
+            { "\"pistas_inseridas\": ", "dq_pistas_inseridas_total ", 2 * partidas },
+            { "\"movimentos_sessao\": {\"quantidade\": ", "dq_movimentos_sessao_count ", partidas },
+        };
+        for (size_t i = 0; i < sizeof(contadores) / sizeof(contadores[0]) && resultado == 0; ++i) {
+            snprintf(esperado, sizeof(esperado), "%s%u", contadores[i].json, contadores[i].valor);
+            resultado = conferirTrechoRelatorio(json, "json", esperado);
+            snprintf(esperado, sizeof(esperado), "%s%u\n", contadores[i].prometheus, contadores[i].valor);
+            if (resultado == 0) resultado = conferirTrechoRelatorio(prometheus, "prometheus", esperado);
+        }
+        // depois de zerar, nada mais é contado
+        dqZerarEstatisticas();
+        free(json);
+        json = dqTextoEstatisticas("json");
+        if (resultado == 0) resultado = conferirTrechoRelatorio(json, "json", "\"sessoes\": 0,");
+    }
+    free(json);
+    free(prometheus);
+    dqFecharMansao(m);
+    return resultado;
+}
+
+/* ===================== MAPA BINÁRIO ===================== */
+
+/* arquivosIguais()
+   1 se os dois arquivos têm os mesmos bytes. */
+static int arquivosIguais(const char *a, const char *b) {
+    FILE *fa = fopen(a, "rb"), *fb = fopen(b, "rb");
+    int iguais = fa != NULL && fb != NULL;
+    while (iguais) {
+        int ca = fgetc(fa), cb = fgetc(fb);
+        iguais = ca == cb;
+        if (ca == EOF) break;
+    }
+    if (fa != NULL) fclose(fa);
+    if (fb != NULL) fclose(fb);
+    return iguais;
+}
+
+/* conferirBinario()
+   Grava o mapa em .dqm e confere que o mapa recarregado dele se grava no
+   mesmo texto e no mesmo .dqm que o original, e que as partidas sorteadas
+   têm o mesmo resultado nos dois. */
+static int conferirBinario(MapaCarregado *original) {
+    if (salvarMapaBinario("teste_mapa.dqm", &original->mansao, &original->tabela) != 0 ||
+        salvarMapaTexto("teste_mapa_original.txt", &original->mansao, &original->tabela) != 0)
+        return falhar("mapa_binario", "nao gravou o mapa", 0);
+    MapaCarregado *binario = (MapaCarregado*) realocarOuSair(NULL, sizeof(MapaCarregado), "o teste");
+    if (carregarMapa("teste_mapa.dqm", binario) != 0) {
+        free(binario);
+        return falhar("mapa_binario", "nao carregou o .dqm", 0);
+    }
+    int resultado = 0;
+    if (salvarMapaTexto("teste_mapa_binario.txt", &binario->mansao, &binario->tabela) != 0 ||
+        salvarMapaBinario("teste_mapa_copia.dqm", &binario->mansao, &binario->tabela) != 0)
+        resultado = falhar("mapa_binario", "nao regravou o mapa", 0);
+    else if (!arquivosIguais("teste_mapa_original.txt", "teste_mapa_binario.txt"))
+        resultado = falhar("mapa_binario", "texto do .dqm diferente do original", 0);
+    else if (!arquivosIguais("teste_mapa.dqm", "teste_mapa_copia.dqm"))
+        resultado = falhar("mapa_binario", ".dqm regravado diferente", 0);
+
+    for (uint32_t i = 0; i < 32 && resultado == 0; ++i)
+        if (jogarPartida(original, CONJUNTO_PISTAS_PADRAO, NULL, i).hash !=
+            jogarPartida(binario, CONJUNTO_PISTAS_PADRAO, NULL, i).hash)
+            resultado = falhar("mapa_binario", "partida diferente no .dqm", i);
+    liberarMapa(binario);
+    free(binario);
+    remove("teste_mapa.dqm");
+    remove("teste_mapa_copia.dqm");
+    remove("teste_mapa_original.txt");
+    remove("teste_mapa_binario.txt");
+    return resultado;
+}
+
+/* conferirCorrompidos()
+   Grava o mapa em .dqm e recarrega cópias com quatro bytes trocados por
+   0xFF, em posições espalhadas pelo arquivo. Uma cópia recusada tem de
+   deixar o mapa vazio, sem ponteiros para o arquivo já desmapeado; uma
+   aceita tem de aguentar uma partida. Alguma das cópias tem de ser
+   recusada. */
+static int conferirCorrompidos(const MapaCarregado *original) {
+    if (salvarMapaBinario("teste_mapa.dqm", &original->mansao, &original->tabela) != 0)
+        return falhar("mapa_binario", "nao gravou o mapa", 0);
+    FILE *arq = fopen("teste_mapa.dqm", "rb");
+    if (arq == NULL) return falhar("mapa_binario", "nao abriu o .dqm", 0);
+    fseek(arq, 0, SEEK_END);
+    long tam = ftell(arq);
+    rewind(arq);
+    uint8_t *bytes = (uint8_t*) realocarOuSair(NULL, (size_t) tam, "o teste");
+    size_t lidos = fread(bytes, 1, (size_t) tam, arq);
+    fclose(arq);
+    remove("teste_mapa.dqm");
+    if (lidos != (size_t) tam) {
+        free(bytes);
+        return falhar("mapa_binario", "nao leu o .dqm", 0);
+    }
+
+    MapaCarregado *mapa = (MapaCarregado*) realocarOuSair(NULL, sizeof(MapaCarregado), "o teste");
+    int resultado = 0;
+    uint32_t recusados = 0;
+    uint64_t estado = iniciarAleatorio(43);
+    for (long pos = 0; pos + 4 <= tam && resultado == 0; pos += 1 + (long) (proximoAleatorio(&estado) % 61)) {
+        uint8_t salvos[4];
+        memcpy(salvos, bytes + pos, 4);
+        memset(bytes + pos, 0xFF, 4);
+        arq = fopen("teste_mapa_corrompido.dqm", "wb");
+        if (arq == NULL || fwrite(bytes, 1, (size_t) tam, arq) != (size_t) tam) resultado = falhar("mapa_binario", "nao gravou a copia", 0);
+        if (arq != NULL) fclose(arq);
+        memcpy(bytes + pos, salvos, 4);
+        if (resultado != 0) break;
+
+        if (carregarMapa("teste_mapa_corrompido.dqm", mapa) != 0) {
+            recusados++;
+            if (mapa->mansao.salas != NULL || mapa->mansao.numSalas != 0 ||
+                mapa->tabela.suspeitoPorPista != NULL || mapa->tabela.postagens != NULL ||
+                mapa->mapeamento != NULL)
+                resultado = falhar("mapa_binario", "copia recusada deixou ponteiros no mapa", (uint32_t) pos);
+            liberarMapa(mapa);
+        } else {
+            jogarPartida(mapa, CONJUNTO_PISTAS_PADRAO, NULL, (uint32_t) pos);
+            liberarMapa(mapa);
+        }
+    }
+    remove("teste_mapa_corrompido.dqm");
+    if (resultado == 0 && recusados == 0) resultado = falhar("mapa_binario", "nenhuma copia corrompida recusada", 0);
+    free(mapa);
+    free(bytes);
+    return resultado;
+}
+
+static int testarMapaBinario(const char *dirMapas) {
+    char caminho[TAM_CAMINHO];
+    snprintf(caminho, sizeof(caminho), "%s/mansao_padrao.txt", dirMapas);
+    MapaCarregado *mapa = (MapaCarregado*) realocarOuSair(NULL, sizeof(MapaCarregado), "o teste");
+    if (carregarMapa(caminho, mapa) != 0) {
+        free(mapa);
+        return falhar("mapa_binario", "nao carregou a mansao padrao", 0);
+    }
+    int resultado = conferirBinario(mapa);
+    if (resultado == 0) resultado = conferirCorrompidos(mapa);
+    liberarMapa(mapa);
+
+    // passagens e pistas com vários suspeitos
+    ParametrosGerador p = { FORMA_ALEATORIA, 3000, 200, 15, 400, 3, 41 };
+    gerarMansao(mapa, &p);
+    if (resultado == 0) resultado = conferirBinario(mapa);
+    liberarMapa(mapa);
+    free(mapa);
+    return resultado;
+}
+
+/* ===================== POSTAGENS ===================== */
+
+/* conferirPostagens()
+   A lista da pista tem exatamente os pares esperados, nesta ordem. */
+static int conferirPostagens(const TabelaHash *t, const char *pista, const char *const *suspeitos,
+                             const uint32_t *pesos, uint32_t n) {
+    uint32_t id = buscarString(t->pistas, pista);
+    if (id == INTERNADOR_AUSENTE || numPostagensPista(t, id) != n) return falhar("postagens", pista, n);
+    const PostagemSuspeito *lista = postagensDaPista(t, id);
+    for (uint32_t k = 0; k < n; ++k)
+        if (strcmp(nomeSuspeito(t, lista[k].suspeito), suspeitos[k]) != 0 || lista[k].peso != pesos[k])
+            return falhar("postagens", pista, k);
+    return 0;
+}
+
+static int testarPostagens(void) {
+    Internador pistas;
+    TabelaHash t;
+    inicializarInternador(&pistas);
+    inicializarTabelaHash(&t, &pistas);
+    inserirNaHash(&t, "Faca", "Mordomo");              // principal sem peso, depois pesos
+    inserirPesoNaHash(&t, "Faca", "Jardineiro", 3);
+    inserirPesoNaHash(&t, "Luva", "Mordomo", 2);       // só pesos: o primeiro é o principal
+    inserirPesoNaHash(&t, "Luva", "Cozinheira", 1);
+    inserirNaHash(&t, "Corda", "Cozinheira");          // só o principal
+    inserirPesoNaHash(&t, "Veneno", "Mordomo", 2);     // repetidos somam na posição do primeiro
+    inserirPesoNaHash(&t, "Veneno", "Jardineiro", 1);
+    inserirPesoNaHash(&t, "Veneno", "Mordomo", 3);
+    inserirPesoNaHash(&t, "Corda", "Cozinheira", HASH_PESO_MAXIMO);
+    inserirPesoNaHash(&t, "Corda", "Cozinheira", 5);   // a soma satura
+    montarPostagens(&t);
+
+    const char *const faca[] = { "Mordomo", "Jardineiro" };
+    const char *const luva[] = { "Mordomo", "Cozinheira" };
+    const char *const corda[] = { "Cozinheira" };
+    const char *const veneno[] = { "Mordomo", "Jardineiro" };
+    const uint32_t pesosFaca[] = { 1, 3 }, pesosLuva[] = { 2, 1 }, pesosCorda[] = { HASH_PESO_MAXIMO },
+                   pesosVeneno[] = { 5, 1 };
+    int resultado = conferirPostagens(&t, "Faca", faca, pesosFaca, 2) ||
+                    conferirPostagens(&t, "Luva", luva, pesosLuva, 2) ||
+                    conferirPostagens(&t, "Corda", corda, pesosCorda, 1) ||
+                    conferirPostagens(&t, "Veneno", veneno, pesosVeneno, 2);
+    if (resultado == 0 && t.numPostagens != 7) resultado = falhar("postagens", "total de postagens", t.numPostagens);
+    if (resultado == 0 && !t.ponderada) resultado = falhar("postagens", "tabela deveria ser ponderada", 0);
+    liberarTabelaHash(&t);
+    liberarInternador(&pistas);
+    if (resultado != 0) return 1;
+
+    // o mesmo suspeito repetido numa linha do mapa texto
+    MapaCarregado mapa;
+    if (carregarTexto("sala|Hall|Faca|-|-\npista|Faca|Mordomo:2|Mordomo:3\n", &mapa) != 0)
+        return falhar("postagens", mapa.erro, 0);
+    const char *const repetida[] = { "Mordomo" };
+    const uint32_t pesosRepetida[] = { 5 };
+    resultado = conferirPostagens(&mapa.tabela, "Faca", repetida, pesosRepetida, 1);
+    liberarMapa(&mapa);
+    return resultado;
+}
+
+/* ===================== API ===================== */
+
+/* testarApi()
+   Ids fora do intervalo devolvem NULL, DQ_SEM_SALA ou DQ_SEM_PISTA em vez
+   de ler fora dos arrays, a sessão começa na entrada e ignora direções
+   desconhecidas, e um mapa que não abre devolve NULL com a mensagem de
+   erro. */
+static int testarApi(void) {
+    DqMansao *m = dqMansaoPadrao();
+    if (m == NULL) return falhar("api", "mansao padrao", 0);
+    const uint32_t foraDoMapa[] = { dqNumSalas(m), dqNumSalas(m) + 1, DQ_SEM_SALA };
+    int resultado = 0;
+    for (size_t i = 0; i < sizeof(foraDoMapa) / sizeof(foraDoMapa[0]) && resultado == 0; ++i) {
+        uint32_t sala = foraDoMapa[i];
+        if (dqNomeSala(m, sala) != NULL || dqPistaSala(m, sala) != NULL ||
+            dqIdPistaSala(m, sala) != DQ_SEM_PISTA || dqSalaVizinha(m, sala, 'e') != DQ_SEM_SALA ||
+            dqSalaVizinha(m, sala, 'd') != DQ_SEM_SALA || dqNumPassagens(m, sala) != 0 ||
+            dqPassagem(m, sala, 0) != DQ_SEM_SALA)
+            resultado = falhar("api", "sala fora do mapa", sala);
+    }
+    if (resultado == 0 && (dqTextoPista(m, dqNumPistas(m)) != NULL || dqPassagem(m, 0, dqNumPassagens(m, 0)) != DQ_SEM_SALA))
+        resultado = falhar("api", "pista ou passagem fora do mapa", 0);
+    if (resultado == 0 && (dqNomeSala(m, 0) == NULL || dqSalaVizinha(m, 0, 'x') != DQ_SEM_SALA))
+        resultado = falhar("api", "sala da entrada", 0);
+
+    DqSessao *s = dqIniciarSessao(m);
+    if (resultado == 0 && (s == NULL || dqSalaAtual(s) == NULL || dqCaminho(s, 'x') != NULL ||
+                           dqMover(s, 'x') != DQ_MOVIMENTO_INVALIDO))
+        resultado = falhar("api", "sessao na entrada", 0);
+    dqEncerrarSessao(s);
+    dqFecharMansao(m);
+
+    char erro[256] = "";
+    if (resultado == 0 && (dqAbrirMansao("mapa_que_nao_existe.txt", erro, sizeof(erro)) != NULL || erro[0] == '\0'))
+        resultado = falhar("api", "mapa inexistente", 0);
+    return resultado;
+}
+
+int main(int argc, char *argv[]) {
+    if (argc != 3) {
+        printf("Uso: %s internador|arvore_pistas|conjunto|resolvedor|indice|hash_perfeito|retratos|busca|estatisticas|mapa_binario|postagens|api <diretorio dos mapas>\n", argv[0]);
+        return 2;
+    }
+    int resultado;
+    if (strcmp(argv[1], "internador") == 0) resultado = testarInternador();
+    else if (strcmp(argv[1], "arvore_pistas") == 0) resultado = testarArvorePistas();
+    else if (strcmp(argv[1], "conjunto") == 0) resultado = testarConjunto();
+    else if (strcmp(argv[1], "resolvedor") == 0) resultado = testarResolvedor();
+    else if (strcmp(argv[1], "indice") == 0) resultado = testarIndice();
+    else if (strcmp(argv[1], "hash_perfeito") == 0) resultado = testarHashPerfeito(argv[2]);
+    else if (strcmp(argv[1], "retratos") == 0) resultado = testarRetratos();
+    else if (strcmp(argv[1], "busca") == 0) resultado = testarBusca();
+    else if (strcmp(argv[1], "estatisticas") == 0) resultado = testarEstatisticas();
+    else if (strcmp(argv[1], "mapa_binario") == 0) resultado = testarMapaBinario(argv[2]);
+    else if (strcmp(argv[1], "postagens") == 0) resultado = testarPostagens();
+    else if (strcmp(argv[1], "api") == 0) resultado = testarApi();
+    else {
+        printf("Caso de teste desconhecido: %s\n", argv[1]);
+        return 2;
+    }
+    if (resultado == 0) printf("%s: ok\n", argv[1]);
+    return resultado;
+}
@@ -0,0 +1,195 @@
+#define _GNU_SOURCE
+#include <errno.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "detective.h"
+#include "internador.h"
+#include "servidor.h"
+
+/* Teste do servidor de partidas (servidor.h). Sobe o servidor num processo
+   filho, com a mansão padrão, e joga a entrada padrão em várias conexões
+   ao mesmo tempo: as linhas vão a todas as conexões em rodízio, cada uma
+   partida em duas escritas, antes de qualquer resposta ser lida. Cada
+   conexão tem de receber exatamente o mesmo texto, que é escrito na saída
+   padrão; o CTest o compara com a transcrição de
+   `algoritmo_avacadosMestres --protocolo` para a mesma entrada. Por fim o
+   servidor recebe SIGTERM e tem de sair com 0, removendo o socket.
+
+   Uso: testes_servidor <conexoes> < entrada
+
+   Retorna 1 e explica a falha na saída de erro. */
+
+#define MAX_CONEXOES 64
+
+/* Socket no diretório atual, com o pid no nome para que testes rodando em
+   paralelo não se encontrem. */
+static char socketTeste[64];
+
+/* falhar()
+   Mensagem de falha na saída de erro; retorna 1. */
+static int falhar(const char *detalhe) {
+    fprintf(stderr, "FALHA no servidor: %s\n", detalhe);
+    return 1;
+}
+
+/* conectar()
+   Conecta ao socket do servidor, esperando até 5 s que ele apareça.
+   Retorna o descritor ou -1. */
+static int conectar(void) {
+    struct sockaddr_un endereco;
+    memset(&endereco, 0, sizeof(endereco));
+    endereco.sun_family = AF_UNIX;
+    snprintf(endereco.sun_path, sizeof(endereco.sun_path), "%s", socketTeste);
+    for (int tentativa = 0; tentativa < 500; ++tentativa) {
+        int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        if (fd < 0) return -1;
+        if (connect(fd, (struct sockaddr*) &endereco, sizeof(endereco)) == 0) return fd;
+        close(fd);
+        struct timespec espera = { 0, 10 * 1000 * 1000 };
+        nanosleep(&espera, NULL);
+    }
+    return -1;
+}
+
+/* escreverTudo()
+   write() até o fim do buffer. Retorna 0 ou -1. */
+static int escreverTudo(int fd, const char *dados, size_t tam) {
+    while (tam > 0) {
+        ssize_t n = write(fd, dados, tam);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return -1;
+        dados += n;
+        tam -= (size_t) n;
+    }
+    return 0;
+}
+
+/* lerAteFechar()
+   Lê a conexão até o servidor fechá-la. Retorna o texto (terminado em
+   '\0', tamanho em *tam) ou NULL. */
+static char* lerAteFechar(int fd, size_t *tam) {
+    size_t cap = 4096;
+    char *texto = (char*) realocarOuSair(NULL, cap, "a resposta do servidor");
+    *tam = 0;
+    for (;;) {
+        if (cap - *tam < 1024) {
+            cap *= 2;
+            texto = (char*) realocarOuSair(texto, cap, "a resposta do servidor");
+        }
+        ssize_t n = read(fd, texto + *tam, cap - *tam - 1);
+        if (n < 0 && errno == EINTR) continue;
+        if (n < 0) {
+            free(texto);
+            return NULL;
+        }
+        if (n == 0) break;
+        *tam += (size_t) n;
+    }
+    texto[*tam] = '\0';
+    return texto;
+}
+
+/* jogar()
+   Manda a entrada às conexões em rodízio e confere que todas receberam o
+   mesmo texto, que vai para a saída padrão. */
+static int jogar(const char *entrada, size_t tamEntrada, int numConexoes) {
+    int fds[MAX_CONEXOES];
+    for (int c = 0; c < numConexoes; ++c) {
+        fds[c] = conectar();
+        if (fds[c] < 0) {
+            while (c-- > 0) close(fds[c]);
+            return falhar("nao conectou ao socket");
+        }
+    }
+
+    int resultado = 0;
+    for (size_t inicio = 0; inicio < tamEntrada && resultado == 0;) {
+        const char *fimLinha = memchr(entrada + inicio, '\n', tamEntrada - inicio);
+        size_t tamLinha = fimLinha != NULL ? (size_t) (fimLinha - entrada - inicio) + 1 : tamEntrada - inicio;
+        size_t metade = tamLinha / 2;
+        for (int c = 0; c < numConexoes && resultado == 0; ++c)
+            if (escreverTudo(fds[c], entrada + inicio, metade) != 0 ||
+                escreverTudo(fds[c], entrada + inicio + metade, tamLinha - metade) != 0)
+                resultado = falhar("nao enviou a escolha");
+        inicio += tamLinha;
+    }
+
+    char *primeira = NULL;
+    size_t tamPrimeira = 0;
+    for (int c = 0; c < numConexoes && resultado == 0; ++c) {
+        size_t tam;
+        char *texto = lerAteFechar(fds[c], &tam);
+        if (texto == NULL) {
+            resultado = falhar("nao leu a resposta");
+        } else if (primeira == NULL) {
+            primeira = texto;
+            tamPrimeira = tam;
+            continue;
+        } else if (tam != tamPrimeira || memcmp(texto, primeira, tam) != 0) {
+            resultado = falhar("conexoes com a mesma entrada receberam textos diferentes");
+        }
+        free(texto);
+    }
+    if (resultado == 0) fwrite(primeira, 1, tamPrimeira, stdout);
+    free(primeira);
+    for (int c = 0; c < numConexoes; ++c) close(fds[c]);
+    return resultado;
+}
+
+int main(int argc, char *argv[]) {
+    int numConexoes = argc == 2 ? atoi(argv[1]) : 0;
+    if (numConexoes < 1 || numConexoes > MAX_CONEXOES) {
+        fprintf(stderr, "Uso: %s <conexoes (1..%d)> < entrada\n", argv[0], MAX_CONEXOES);
+        return 2;
+    }
+    size_t tamEntrada = 0, capEntrada = 4096;
+    char *entrada = (char*) realocarOuSair(NULL, capEntrada, "a entrada");
+    size_t n;
+    while ((n = fread(entrada + tamEntrada, 1, capEntrada - tamEntrada, stdin)) > 0) {
+        tamEntrada += n;
+        if (tamEntrada == capEntrada) {
+            capEntrada *= 2;
+            entrada = (char*) realocarOuSair(entrada, capEntrada, "a entrada");
+        }
+    }
+
+    DqMansao *mansao = dqMansaoPadrao();
+    if (mansao == NULL) {
+        free(entrada);
+        return falhar("mansao padrao");
+    }
+    snprintf(socketTeste, sizeof(socketTeste), "teste_servidor_%ld.sock", (long) getpid());
+    signal(SIGPIPE, SIG_IGN);
+    fflush(stdout);
+    pid_t filho = fork();
+    if (filho < 0) {
+        free(entrada);
+        dqFecharMansao(mansao);
+        return falhar("fork");
+    }
+    if (filho == 0) {
+        ResumoServidor resumo;
+        _exit(executarServidor(mansao, socketTeste, &resumo) != 0 ? 1 : 0);
+    }
+
+    int resultado = jogar(entrada, tamEntrada, numConexoes);
+    int status = 0;
+    kill(filho, SIGTERM);
+    waitpid(filho, &status, 0);
+    if (resultado == 0 && (!WIFEXITED(status) || WEXITSTATUS(status) != 0))
+        resultado = falhar("o servidor nao terminou normalmente com SIGTERM");
+    if (resultado == 0 && access(socketTeste, F_OK) == 0) resultado = falhar("o socket nao foi removido");
+    unlink(socketTeste);
+    free(entrada);
+    dqFecharMansao(mansao);
+    return resultado;
+}